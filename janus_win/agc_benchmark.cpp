@@ -0,0 +1,175 @@
+#include "agc_benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "modules/audio_processing/agc/legacy/gain_control.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+namespace {
+
+enum AgcPath { kPathC, kPathSSE2, kPathAVX2, kNumPaths };
+
+const char* const kPathNames[kNumPaths] = { "C", "SSE2", "AVX2" };
+
+const size_t kBandLength = 160;
+
+// WebRtcAgc_InitDigital() picks its kernels through WebRtc_GetCPUInfo, so the
+// benchmark swaps in this one to hide the features above |g_max_path|.
+AgcPath g_max_path = kPathC;
+WebRtc_CPUInfo g_cpu_info = nullptr;
+
+int CappedCPUInfo(CPUFeature feature) {
+	if (feature == kAVX2 && g_max_path < kPathAVX2) {
+		return 0;
+	}
+	if (feature == kSSE2 && g_max_path < kPathSSE2) {
+		return 0;
+	}
+	return g_cpu_info(feature);
+}
+
+// FNV-1a over the output, compared against the C path.
+uint32_t Hash(const int16_t* data, size_t length, uint32_t hash) {
+	for (size_t i = 0; i < length; ++i) {
+		hash = (hash ^ static_cast<uint16_t>(data[i])) * 16777619u;
+	}
+	return hash;
+}
+
+// Speech-like bursts whose level swings by 40 dB, so the gain ramps up and
+// down and loud passages hit the limiter and saturation.
+std::vector<int16_t> MakeInput(int frames, int num_bands) {
+	std::mt19937 rng(1);
+	std::normal_distribution<double> noise(0.0, 30.0);
+	std::vector<int16_t> input(static_cast<size_t>(frames) * num_bands * kBandLength);
+	for (size_t i = 0; i < input.size(); ++i) {
+		double t = static_cast<double>(i) / 16000;
+		double level = (i / 16000) % 3 == 2 ? 20000 : 200;
+		double envelope = 0.5 + 0.5 * sin(2 * M_PI * 4 * t);
+		double sample = level * envelope * (sin(2 * M_PI * 160 * t) +
+			0.5 * sin(2 * M_PI * 1100 * t)) + noise(rng);
+		input[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, sample)));
+	}
+	return input;
+}
+
+// Processes |input| on a fresh instance and returns the output hash, the
+// elapsed time goes to |elapsed_us|.
+uint32_t Process(uint32_t fs, int num_bands, const std::vector<int16_t>& input,
+	int64_t* elapsed_us) {
+	size_t band_length = fs == 8000 ? 80 : kBandLength;
+	size_t frames = input.size() / (num_bands * kBandLength);
+	std::vector<int16_t> output(input.size());
+	void* agc = WebRtcAgc_Create();
+	WebRtcAgc_Init(agc, 0, 255, kAgcModeFixedDigital, fs);
+	WebRtcAgcConfig config;
+	config.targetLevelDbfs = 3;
+	config.compressionGaindB = 20;
+	config.limiterEnable = kAgcTrue;
+	WebRtcAgc_set_config(agc, config);
+
+	int64_t start_us = rtc::TimeMicros();
+	for (size_t frame = 0; frame < frames; ++frame) {
+		const int16_t* in[3];
+		int16_t* out[3];
+		for (int band = 0; band < num_bands; ++band) {
+			size_t offset = (frame * num_bands + band) * kBandLength;
+			in[band] = input.data() + offset;
+			out[band] = output.data() + offset;
+		}
+		int32_t mic_level = 0;
+		uint8_t saturation_warning = 0;
+		WebRtcAgc_Process(agc, in, num_bands, band_length, out, 0, &mic_level, 0,
+			&saturation_warning);
+	}
+	*elapsed_us = rtc::TimeMicros() - start_us;
+	WebRtcAgc_Free(agc);
+
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < output.size(); i += kBandLength) {
+		hash = Hash(output.data() + i, band_length, hash);
+	}
+	return hash;
+}
+
+}  // namespace
+
+void RunAgcBenchmark(int frames) {
+	frames = std::max(frames, 1);
+	// The SPL pointers are set once per process; keep them on the best path
+	// so only the AGC kernels differ between runs.
+	WebRtcSpl_Init();
+	g_cpu_info = WebRtc_GetCPUInfo;
+
+	bool supported[kNumPaths] = { true, g_cpu_info(kSSE2) != 0,
+		g_cpu_info(kAVX2) != 0 };
+	const uint32_t kRates[] = { 8000, 16000, 32000, 48000 };
+	const int kRounds = 3;
+
+	printf("frames=%d\n", frames);
+	printf("rate\tbands\tC us/frame\tSSE2 us/frame\tAVX2 us/frame\tbit-exact\n");
+	for (uint32_t fs : kRates) {
+		int num_bands = fs == 48000 ? 3 : fs == 32000 ? 2 : 1;
+		std::vector<int16_t> input = MakeInput(frames, num_bands);
+		uint32_t reference = 0;
+		double us_per_frame[kNumPaths] = { 0, 0, 0 };
+		bool exact = true;
+		for (int path = 0; path < kNumPaths; ++path) {
+			if (!supported[path]) {
+				continue;
+			}
+			g_max_path = static_cast<AgcPath>(path);
+			WebRtc_GetCPUInfo = CappedCPUInfo;
+			// Best of a few rounds, to keep interrupts and frequency ramps out.
+			int64_t best_us = INT64_MAX;
+			bool path_exact = true;
+			for (int round = 0; round < kRounds; ++round) {
+				int64_t elapsed_us = 0;
+				uint32_t hash = Process(fs, num_bands, input, &elapsed_us);
+				best_us = std::min(best_us, elapsed_us);
+				if (path == kPathC) {
+					reference = hash;
+				}
+				else if (hash != reference) {
+					path_exact = false;
+				}
+			}
+			WebRtc_GetCPUInfo = g_cpu_info;
+			if (!path_exact) {
+				exact = false;
+				RTC_LOG(LS_ERROR) << "AGC " << kPathNames[path] << " at " << fs
+					<< " Hz differs from the C version";
+			}
+			us_per_frame[path] = static_cast<double>(best_us) / frames;
+		}
+		printf("%u\t%d", fs, num_bands);
+		for (int path = 0; path < kNumPaths; ++path) {
+			if (supported[path]) {
+				printf("\t%.2f", us_per_frame[path]);
+			}
+			else {
+				printf("\t-");
+			}
+		}
+		printf("\t%s\n", exact ? "yes" : "NO");
+	}
+}
+
+#else
+
+void RunAgcBenchmark(int frames) {
+	printf("The AGC benchmark needs an x86 CPU\n");
+}
+
+#endif  // WEBRTC_ARCH_X86_FAMILY
@@ -0,0 +1,7 @@
+#pragma once
+
+// Runs |frames| 10 ms frames of synthetic speech through the legacy fixed
+// digital AGC at 8, 16, 32 and 48 kHz once per x86 path the CPU supports (C,
+// SSE2, AVX2), and prints microseconds per frame, and whether every path
+// produced the same output as C.
+void RunAgcBenchmark(int frames);
@@ -0,0 +1,158 @@
+#include "capture_negotiation.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "frame_adaptation.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+
+namespace {
+
+struct VideoTypeInfo {
+	webrtc::VideoType type;
+	uint32_t fourcc;
+	double cost_per_pixel;//relative work to turn one source pixel into I420
+};
+
+// Same mapping as WebRtcVideoCapturer, types it cannot start are skipped.
+const VideoTypeInfo kVideoTypes[] = {
+	{ webrtc::VideoType::kI420, cricket::FOURCC_I420, 0.25 },
+	{ webrtc::VideoType::kYV12, cricket::FOURCC_YV12, 0.25 },
+	{ webrtc::VideoType::kNV12, cricket::FOURCC_NV12, 0.5 },
+	{ webrtc::VideoType::kNV21, cricket::FOURCC_NV21, 0.5 },
+	{ webrtc::VideoType::kYUY2, cricket::FOURCC_YUY2, 0.75 },
+	{ webrtc::VideoType::kUYVY, cricket::FOURCC_UYVY, 0.75 },
+	{ webrtc::VideoType::kARGB, cricket::FOURCC_ARGB, 2.0 },
+	{ webrtc::VideoType::kRGB24, cricket::FOURCC_24BG, 2.0 },
+	{ webrtc::VideoType::kMJPEG, cricket::FOURCC_MJPG, 8.0 },
+};
+
+const VideoTypeInfo* FindVideoType(webrtc::VideoType type) {
+	for (const VideoTypeInfo& info : kVideoTypes) {
+		if (info.type == type) {
+			return &info;
+		}
+	}
+	return nullptr;
+}
+
+// Lower is better, compared in member order.
+struct ModeRank {
+	int fps_shortfall;
+	int64_t area_shortfall;
+	double cost;
+	int64_t area_excess;
+	int fps_excess;
+
+	bool operator<(const ModeRank& o) const {
+		if (fps_shortfall != o.fps_shortfall) return fps_shortfall < o.fps_shortfall;
+		if (area_shortfall != o.area_shortfall) return area_shortfall < o.area_shortfall;
+		if (cost != o.cost) return cost < o.cost;
+		if (area_excess != o.area_excess) return area_excess < o.area_excess;
+		return fps_excess < o.fps_excess;
+	}
+};
+
+}  // namespace
+
+cricket::VideoFormat CaptureMode::ToVideoFormat() const {
+	const VideoTypeInfo* type = FindVideoType(capability.videoType);
+	return cricket::VideoFormat(capability.width, capability.height,
+		cricket::VideoFormat::FpsToInterval(capability.maxFPS),
+		type ? type->fourcc : cricket::FOURCC_ANY);
+}
+
+std::string CaptureMode::ToString() const {
+	std::ostringstream os;
+	os << capability.width << "x" << capability.height << "@" << capability.maxFPS
+		<< " " << cricket::GetFourccName(ToVideoFormat().fourcc)
+		<< (capability.interlaced ? " interlaced" : "")
+		<< (needs_decode ? " decode" : "")
+		<< (needs_scale ? " scale" : "")
+		<< " cost=" << cost_mpix_per_s << " Mpix/s";
+	return os.str();
+}
+
+bool SelectCaptureMode(webrtc::VideoCaptureModule::DeviceInfo* info,
+	const char* device_unique_id,
+	const CaptureTarget& target,
+	CaptureMode* mode) {
+	int64_t target_area = static_cast<int64_t>(target.width) * target.height;
+	bool found = false;
+	ModeRank best_rank;
+	int32_t count = info->NumberOfCapabilities(device_unique_id);
+	for (int32_t i = 0; i < count; ++i) {
+		CaptureMode candidate;
+		if (info->GetCapability(device_unique_id, i, candidate.capability) != 0) {
+			continue;
+		}
+		const webrtc::VideoCaptureCapability& cap = candidate.capability;
+		const VideoTypeInfo* type = FindVideoType(cap.videoType);
+		if (!type || cap.width <= 0 || cap.height <= 0 || cap.maxFPS <= 0) {
+			continue;
+		}
+		int64_t area = static_cast<int64_t>(cap.width) * cap.height;
+		int fps = std::min(cap.maxFPS, target.fps);
+		candidate.needs_decode = cap.videoType == webrtc::VideoType::kMJPEG;
+		candidate.needs_scale = cap.width != target.width || cap.height != target.height;
+		double pixel_ops = area * type->cost_per_pixel;
+		if (candidate.needs_scale) {
+			pixel_ops += area * 0.5 + target_area;
+		}
+		if (cap.interlaced) {
+			pixel_ops += area;
+		}
+		candidate.cost_mpix_per_s = pixel_ops * fps / 1e6;
+
+		ModeRank rank;
+		rank.fps_shortfall = std::max(0, target.fps - cap.maxFPS);
+		rank.area_shortfall = std::max<int64_t>(0, target_area - area);
+		rank.cost = candidate.cost_mpix_per_s;
+		rank.area_excess = std::max<int64_t>(0, area - target_area);
+		rank.fps_excess = std::max(0, cap.maxFPS - target.fps);
+		RTC_LOG(LS_VERBOSE) << "Capture mode candidate " << candidate.ToString();
+		if (!found || rank < best_rank) {
+			found = true;
+			best_rank = rank;
+			*mode = candidate;
+		}
+	}
+	if (found) {
+		RTC_LOG(INFO) << "Capture mode for " << target.width << "x" << target.height
+			<< "@" << target.fps << ": " << mode->ToString();
+	}
+	return found;
+}
+
+NegotiatedVideoCapturer::NegotiatedVideoCapturer(const CaptureMode& mode)
+	: format_(mode.ToVideoFormat()) {
+}
+
+cricket::CaptureState NegotiatedVideoCapturer::Start(
+	const cricket::VideoFormat& capture_format) {
+	cricket::VideoFormat format = format_;
+	format.interval = std::max(format_.interval, capture_format.interval);
+	if (format.width != capture_format.width || format.height != capture_format.height ||
+		format.fourcc != capture_format.fourcc) {
+		RTC_LOG(INFO) << "Starting capture in negotiated mode " << format.ToString()
+			<< " instead of " << capture_format.ToString();
+	}
+	return cricket::WebRtcVideoCapturer::Start(format);
+}
+
+void NegotiatedVideoCapturer::OnFrame(const webrtc::VideoFrame& frame) {
+	FrameAdaptation adaptation;
+	if (!AdaptFrame(frame.width(), frame.height(), frame.timestamp_us(), rtc::TimeMicros(),
+		&adaptation.width, &adaptation.height, &adaptation.crop_width,
+		&adaptation.crop_height, &adaptation.crop_x, &adaptation.crop_y,
+		&adaptation.timestamp_us)) {
+		return;
+	}
+	cricket::VideoCapturer::OnFrame(
+		webrtc::VideoFrame(AdaptFrameBuffer(frame.video_frame_buffer(), adaptation, &adapted_pool_),
+			frame.rotation(), adaptation.timestamp_us),
+		frame.width(), frame.height());
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+
+#include "common_video/include/i420_buffer_pool.h"
+#include "media/base/videocommon.h"
+#include "media/engine/webrtcvideocapturer.h"
+#include "modules/video_capture/video_capture.h"
+
+struct CaptureTarget {
+	int width = 1280;
+	int height = 720;
+	int fps = 18;
+};
+
+struct CaptureMode {
+	webrtc::VideoCaptureCapability capability;
+	bool needs_decode = false;//MJPEG
+	bool needs_scale = false;//native size differs from the target
+	double cost_mpix_per_s = 0.0;//estimated conversion work at the target fps
+
+	cricket::VideoFormat ToVideoFormat() const;
+	std::string ToString() const;
+};
+
+// Reads the native modes of |device_unique_id| and picks the one closest to
+// |target|, in this order: reaches the target fps, is at least the target
+// size, needs the least conversion work (no MJPEG decode, no rescale), is
+// the least oversized. Returns false if the device reports no usable mode.
+bool SelectCaptureMode(webrtc::VideoCaptureModule::DeviceInfo* info,
+	const char* device_unique_id,
+	const CaptureTarget& target,
+	CaptureMode* mode);
+
+// Camera capturer that always starts in the negotiated native mode. The track
+// source may only lower the frame rate. Frames go through the video adapter
+// before they are delivered, WebRtcVideoCapturer passes them on as captured.
+class NegotiatedVideoCapturer : public cricket::WebRtcVideoCapturer {
+public:
+	explicit NegotiatedVideoCapturer(const CaptureMode& mode);
+
+	cricket::CaptureState Start(const cricket::VideoFormat& capture_format) override;
+
+	// Exposed for CPU adaptation.
+	using cricket::VideoCapturer::video_adapter;
+
+private:
+	// rtc::VideoSinkInterface implementation, called on the capture thread.
+	void OnFrame(const webrtc::VideoFrame& frame) override;
+
+	const cricket::VideoFormat format_;
+	webrtc::I420BufferPool adapted_pool_;//capture thread only
+};
@@ -14,6 +14,8 @@
 #include "modules/audio_device/include/audio_device.h"
 #include "modules/audio_processing/include/audio_processing.h"
 #include "modules/video_capture/video_capture_factory.h"
+#include "rtc_base/timeutils.h"
+#include "rtc_base/trace_event.h"
 
 
 // Names used for a IceCandidate JSON object.
@@ -31,13 +33,28 @@ std::string OptString(std::string message, list<string> key);
 long long int OptLLInt(std::string message, list<string> key);
 Json::Value optJSONValue(std::string message, list<string> keyList);
 
+// Trace span names of the UIThreadCallback cases.
+static const char* UIThreadCallbackName(int msg_id) {
+	switch (msg_id) {
+	case PEER_CONNECTION_CLOSED: return "UIThreadCallback PEER_CONNECTION_CLOSED";
+	case NEW_TRACK_ADDED: return "UIThreadCallback NEW_TRACK_ADDED";
+	case TRACK_REMOVED: return "UIThreadCallback TRACK_REMOVED";
+	case CREATE_OFFER: return "UIThreadCallback CREATE_OFFER";
+	case SET_REMOTE_ANSWER: return "UIThreadCallback SET_REMOTE_ANSWER";
+	case SET_REMOTE_OFFER: return "UIThreadCallback SET_REMOTE_OFFER";
+	default: return "UIThreadCallback";
+	}
+}
+
 
 
 ConductorWs::ConductorWs(PeerConnectionWsClient* client, MainWindow* main_wnd)
-	: peer_id_(-1), loopback_(false), client_(client), main_wnd_(main_wnd) {
+	: peer_id_(-1), loopback_(false), client_(client), main_wnd_(main_wnd),
+	janus_(client, this) {
 	client_->RegisterObserver(this);
 	main_wnd->RegisterObserver(this);
 	this->MainWnd_=main_wnd->GetHwnd();
+	render_backend_.reset(new GdiRenderBackend(MainWnd_));
 }
 
 ConductorWs::~ConductorWs() {
@@ -49,6 +66,57 @@ ConductorWs::~ConductorWs() {
 	client_->CloseJanusConn();
 }
 
+void ConductorWs::EnableRenderWorkers(int num_workers, bool pin_to_cores) {
+	render_worker_pool_.reset(new FrameWorkerPool(num_workers, pin_to_cores));
+	render_backend_->SetWorkerPool(render_worker_pool_.get());
+}
+
+void ConductorWs::EnableRenderStatsLog(int64_t interval_ms) {
+	render_backend_->SetStatsLogInterval(interval_ms);
+}
+
+bool ConductorWs::GetRenderStats(long long int handleId, RenderStatsSnapshot* stats) const {
+	auto it = m_peer_connection_map.find(handleId);
+	if (it == m_peer_connection_map.end() || !it->second || !it->second->renderer_) {
+		return false;
+	}
+	*stats = it->second->renderer_->GetStats();
+	return true;
+}
+
+void ConductorWs::SetCaptureTarget(const CaptureTarget& target) {
+	capture_target_ = target;
+}
+
+void ConductorWs::EnableSyntheticVideo(const SyntheticVideoOptions& options) {
+	synthetic_video_ = true;
+	synthetic_video_options_ = options;
+}
+
+void ConductorWs::EnableHeadlessAudio(const HeadlessAudioOptions& options) {
+	headless_audio_ = true;
+	headless_audio_options_ = options;
+}
+
+void ConductorWs::EnableCpuAdaptation() {
+	cpu_adaptation_ = true;
+}
+
+void ConductorWs::EnableScreenShare(const ScreenShareOptions& options) {
+	screen_share_ = true;
+	screen_share_options_ = options;
+}
+
+bool ConductorWs::EnableJoinRecords(const std::string& path) {
+	return join_timeline_.OpenRecordsFile(path);
+}
+
+void ConductorWs::EnableFrameDump(const std::string& dir, size_t max_file_size, size_t num_files) {
+	frame_dump_dir_ = dir;
+	frame_dump_max_file_size_ = max_file_size;
+	frame_dump_num_files_ = num_files;
+}
+
 bool ConductorWs::connection_active(long long int handleId) const {
 	return m_peer_connection_map.at(handleId)->peer_connection_ != nullptr;
 	//return peer_connection_ != nullptr;
@@ -67,9 +135,20 @@ bool ConductorWs::InitializePeerConnection(long long int handleId,bool bPublishe
 	}
 
 	if (!peer_connection_factory_) {
+		rtc::scoped_refptr<webrtc::AudioDeviceModule> adm;
+		if (headless_audio_) {
+			adm = CreateHeadlessAudioDevice(headless_audio_options_);
+			if (!adm) {
+				//no fallback to the default device, a bot must not open the microphone
+				main_wnd_->MessageBox("Error", "Failed to open the headless audio source",
+					true);
+				DeletePeerConnection(handleId);
+				return false;
+			}
+		}
 		peer_connection_factory_ = webrtc::CreatePeerConnectionFactory(
 			nullptr /* network_thread */, nullptr /* worker_thread */,
-			nullptr /* signaling_thread */, nullptr /* default_adm */,
+			nullptr /* signaling_thread */, adm /* default_adm when null */,
 			webrtc::CreateBuiltinAudioEncoderFactory(),
 			webrtc::CreateBuiltinAudioDecoderFactory(),
 			webrtc::CreateBuiltinVideoEncoderFactory(),
@@ -137,12 +216,17 @@ bool ConductorWs::CreatePeerConnection(long long int handleId,bool dtls) {
 	//add to the map
 	peer_connection->RegisterObserver(this);
 	peer_connection->SetHandleId(handleId);
+	peer_connection->SetJoinTimeline(&join_timeline_);
 	m_peer_connection_map[handleId] = peer_connection;
 
 	return m_peer_connection_map[handleId]->peer_connection_ != nullptr;
 }
 
 void ConductorWs::DeletePeerConnection(long long int handleId) {
+	if (cpu_overuse_monitor_ && cpu_overuse_handle_ == handleId) {
+		cpu_overuse_monitor_.reset();
+	}
+	join_timeline_.Remove(handleId);
 	m_peer_connection_map[handleId]->StopRenderer();
 	m_peer_connection_map[handleId]->peer_connection_ = nullptr;
 	//peer_connection_factory_ = nullptr; //TODO should destroy before quit
@@ -255,6 +339,7 @@ void ConductorWs::DisconnectFromCurrentPeer() {
 }
 
 void ConductorWs::UIThreadCallback(int msg_id, void* data) {
+	TRACE_EVENT0("janus", UIThreadCallbackName(msg_id));
 	switch (msg_id) {
 	case PEER_CONNECTION_CLOSED:
 		RTC_LOG(INFO) << "PEER_CONNECTION_CLOSED";
@@ -277,7 +362,19 @@ void ConductorWs::UIThreadCallback(int msg_id, void* data) {
 		if (track->kind() == webrtc::MediaStreamTrackInterface::kVideoKind) {
 			auto* video_track = static_cast<webrtc::VideoTrackInterface*>(track);
 			//main_wnd_->StartRemoteRenderer(video_track);
-			m_peer_connection_map[handleId]->StartRenderer(MainWnd_, video_track);
+			m_peer_connection_map[handleId]->StartRenderer(render_backend_.get(), video_track);
+			JoinTimeline* timeline = &join_timeline_;
+			m_peer_connection_map[handleId]->renderer_->SetFirstFrameCallbacks(
+				[timeline, handleId](int64_t time_us) {
+					timeline->Mark(handleId, kJoinFirstFrameDecoded, time_us);
+				},
+				[timeline, handleId](int64_t time_us) {
+					timeline->Mark(handleId, kJoinFirstFrameRendered, time_us);
+				});
+			if (!frame_dump_dir_.empty()) {
+				m_peer_connection_map[handleId]->StartFrameDump(video_track, frame_dump_dir_,
+					frame_dump_max_file_size_, frame_dump_num_files_);
+			}
 		}
 		track->Release();
 		delete pTrack;
@@ -349,106 +446,27 @@ void ConductorWs::Close() {
 	for (auto &key : m_peer_connection_map) {
 		DeletePeerConnection(key.first);
 	}
+	RTC_LOG(INFO) << "join latency:\n" << join_timeline_.Summary();
 }
 
 
 void ConductorWs::DrawVideos(PAINTSTRUCT& ps, RECT& rc) {
-	HDC dc_mem = NULL;
-	HDC all_dc[] = { ps.hdc, dc_mem };
-	HBITMAP bmp_mem = NULL;
-	HGDIOBJ bmp_old = NULL;
-	POINT logical_area;
-	dc_mem = ::CreateCompatibleDC(ps.hdc);
-	::SetStretchBltMode(dc_mem, HALFTONE);
-	// Set the map mode so that the ratio will be maintained for us.			
-	for (size_t i = 0; i < arraysize(all_dc); ++i) {
-		SetMapMode(all_dc[i], MM_ISOTROPIC);
-		SetWindowExtEx(all_dc[i], rc.right, rc.bottom, NULL);
-		SetViewportExtEx(all_dc[i], rc.right, rc.bottom, NULL);
-	}
-	bmp_mem = ::CreateCompatibleBitmap(ps.hdc, rc.right, rc.bottom);
-	bmp_old = ::SelectObject(dc_mem, bmp_mem);
-
-	logical_area = { rc.right, rc.bottom };
-	DPtoLP(ps.hdc, &logical_area, 1);
-
-	HBRUSH brush = ::CreateSolidBrush(RGB(0, 0, 0));
-	RECT logical_rect = { 0, 0, logical_area.x, logical_area.y };
-	::FillRect(dc_mem, &logical_rect, brush);
-	::DeleteObject(brush);
-
-	int nIndex = 0;
+	TRACE_EVENT0("render", "DrawVideos");
+	std::vector<VideoRenderer*> renderers;
 	for (auto &pc : m_peer_connection_map) {
 		VideoRenderer* renderer = pc.second->renderer_.get();
 		if (renderer) {
-			AutoLock<VideoRenderer> local_lock(renderer);
-			const BITMAPINFO& bmi = renderer->bmi();
-			int height = abs(bmi.bmiHeader.biHeight);
-			int width = bmi.bmiHeader.biWidth;
-			const uint8_t* image = renderer->image();
-			if (image != NULL) {
-				//the first one is local renderer
-				//int x = (logical_area.x / 2) - (width / 2);
-				//int y = (logical_area.y / 2) - (height / 2);
-				int x = (nIndex % 3)*(logical_area.x / 3);
-				int y = (nIndex / 3)*(logical_area.y / 2);
-
-				StretchDIBits(dc_mem, x, y, logical_area.x / 3, logical_area.y / 2, 0, 0, width, height, image,
-					&bmi, DIB_RGB_COLORS, SRCCOPY);
-				/*else {
-					if ((rc.right - rc.left) > 200 && (rc.bottom - rc.top) > 200) {
-						const BITMAPINFO& bmi = renderer->bmi();
-						image = renderer->image();
-						int thumb_width = bmi.bmiHeader.biWidth / 4;
-						int thumb_height = abs(bmi.bmiHeader.biHeight) / 4;
-						StretchDIBits(dc_mem, logical_area.x - thumb_width - 10,
-							logical_area.y - thumb_height*nIndex - 10, thumb_width,
-							thumb_height, 0, 0, bmi.bmiHeader.biWidth,
-							-bmi.bmiHeader.biHeight, image, &bmi, DIB_RGB_COLORS,
-							SRCCOPY);
-					}
-
-				}*/
-
-			}//end if (image != NULL)
-
-			//Ӧ÷forѭ֮
-			//else {
-			//	// We're still waiting for the video stream to be initialized.
-			//	HBRUSH brush = ::CreateSolidBrush(RGB(0, 0, 0));
-			//	::FillRect(ps.hdc, &rc, brush);
-			//	::DeleteObject(brush);
-
-			//	HGDIOBJ old_font = ::SelectObject(ps.hdc, GetDefaultFont());
-			//	::SetTextColor(ps.hdc, RGB(0xff, 0xff, 0xff));
-			//	::SetBkMode(ps.hdc, TRANSPARENT);
-
-			//	std::string text(kConnecting);
-			//	if (!local_renderer->image()) {
-			//		text += kNoVideoStreams;
-			//	}
-			//	else {
-			//		text += kNoIncomingStream;
-			//	}
-			//	::DrawTextA(ps.hdc, text.c_str(), -1, &rc,
-			//		DT_SINGLELINE | DT_CENTER | DT_VCENTER);
-			//	::SelectObject(ps.hdc, old_font);
-			//}
-			nIndex++;
+			renderers.push_back(renderer);
 		}
 	}
-
-	BitBlt(ps.hdc, 0, 0, logical_area.x, logical_area.y, dc_mem, 0, 0,
-		SRCCOPY);
-
-	// Cleanup.
-	::SelectObject(dc_mem, bmp_old);
-	::DeleteObject(bmp_mem);
-	::DeleteDC(dc_mem);
+	render_backend_->Draw(ps, rc, renderers);
 }
 
-std::unique_ptr<cricket::VideoCapturer> ConductorWs::OpenVideoCaptureDevice() {
+std::unique_ptr<cricket::VideoCapturer> ConductorWs::OpenVideoCaptureDevice(CaptureMode* mode,
+	cricket::VideoAdapter** adapter) {
 	std::vector<std::string> device_names;
+	std::vector<CaptureMode> device_modes;
+	std::vector<bool> device_negotiated;
 	{
 		std::unique_ptr<webrtc::VideoCaptureModule::DeviceInfo> info(
 			webrtc::VideoCaptureFactory::CreateDeviceInfo());
@@ -461,16 +479,36 @@ std::unique_ptr<cricket::VideoCapturer> ConductorWs::OpenVideoCaptureDevice() {
 			char name[kSize] = { 0 };
 			char id[kSize] = { 0 };
 			if (info->GetDeviceName(i, name, kSize, id, kSize) != -1) {
+				CaptureMode device_mode;
 				device_names.push_back(name);
+				device_negotiated.push_back(
+					SelectCaptureMode(info.get(), id, capture_target_, &device_mode));
+				device_modes.push_back(device_mode);
 			}
 		}
 	}
 
 	cricket::WebRtcVideoDeviceCapturerFactory factory;
 	std::unique_ptr<cricket::VideoCapturer> capturer;
-	for (const auto& name : device_names) {
-		capturer = factory.Create(cricket::Device(name, 0));
+	for (size_t i = 0; i < device_names.size(); ++i) {
+		cricket::Device device(device_names[i], 0);
+		if (device_negotiated[i]) {
+			std::unique_ptr<NegotiatedVideoCapturer> negotiated(
+				new NegotiatedVideoCapturer(device_modes[i]));
+			if (negotiated->Init(device)) {
+				RTC_LOG(INFO) << "Opened " << device_names[i] << " in "
+					<< device_modes[i].ToString();
+				*mode = device_modes[i];
+				*adapter = negotiated->video_adapter();
+				capturer = std::move(negotiated);
+				break;
+			}
+		}
+		// No usable native mode, let the track source choose one.
+		capturer = factory.Create(device);
 		if (capturer) {
+			*mode = CaptureMode();
+			*adapter = nullptr;
 			break;
 		}
 	}
@@ -492,49 +530,99 @@ void ConductorWs::AddTracks(long long int handleId) {
 			<< result_or_error.error().message();
 	}
 
-	std::unique_ptr<cricket::VideoCapturer> video_device =
-		OpenVideoCaptureDevice();
+	CaptureMode capture_mode;
+	cricket::VideoAdapter* video_adapter = nullptr;
+	std::unique_ptr<cricket::VideoCapturer> video_device;
+	if (synthetic_video_) {
+		std::unique_ptr<SyntheticVideoCapturer> synthetic(
+			new SyntheticVideoCapturer(synthetic_video_options_));
+		if (synthetic->Init()) {
+			video_adapter = synthetic->video_adapter();
+			video_device = std::move(synthetic);
+		}
+	}
+	else {
+		video_device = OpenVideoCaptureDevice(&capture_mode, &video_adapter);
+	}
 	if (video_device) {
+		//set media constraints, pinned to the negotiated mode when there is one;
+		//the synthetic source offers a single format and needs none
 		webrtc::FakeConstraints constraints;
-		std::list<std::string> keyList = { webrtc::MediaConstraintsInterface::kMinWidth, webrtc::MediaConstraintsInterface::kMaxWidth,
-			webrtc::MediaConstraintsInterface::kMinHeight, webrtc::MediaConstraintsInterface::kMaxHeight,
-			webrtc::MediaConstraintsInterface::kMinFrameRate, webrtc::MediaConstraintsInterface::kMaxFrameRate,
-			webrtc::MediaConstraintsInterface::kMinAspectRatio, webrtc::MediaConstraintsInterface::kMaxAspectRatio };
-
-		//set media constraints
-		std::map<std::string, std::string> opts;
-		opts[webrtc::MediaConstraintsInterface::kMaxFrameRate] = 18;
-		opts[webrtc::MediaConstraintsInterface::kMaxWidth] = 1280;
-		opts[webrtc::MediaConstraintsInterface::kMaxHeight] = 720;
-
-		for (auto key : keyList) {
-			if (opts.find(key) != opts.end()) {
-				constraints.AddMandatory(key, opts.at(key));
-			}
-		}
+		int width = capture_mode.capability.width > 0 ? capture_mode.capability.width : capture_target_.width;
+		int height = capture_mode.capability.height > 0 ? capture_mode.capability.height : capture_target_.height;
+		if (capture_mode.capability.width > 0) {
+			constraints.AddMandatory(webrtc::MediaConstraintsInterface::kMinWidth, width);
+			constraints.AddMandatory(webrtc::MediaConstraintsInterface::kMinHeight, height);
+		}
+		constraints.AddMandatory(webrtc::MediaConstraintsInterface::kMaxWidth, width);
+		constraints.AddMandatory(webrtc::MediaConstraintsInterface::kMaxHeight, height);
+		constraints.AddMandatory(webrtc::MediaConstraintsInterface::kMaxFrameRate, capture_target_.fps);
+
+		rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> video_source =
+			peer_connection_factory_->CreateVideoSource(
+				std::move(video_device), synthetic_video_ ? nullptr : &constraints);
 		rtc::scoped_refptr<webrtc::VideoTrackInterface> video_track_(
-			peer_connection_factory_->CreateVideoTrack(
-				kVideoLabel, peer_connection_factory_->CreateVideoSource(
-					std::move(video_device), nullptr)));
+			peer_connection_factory_->CreateVideoTrack(kVideoLabel, video_source));
 		//main_wnd_->StartLocalRenderer(video_track_);
-		m_peer_connection_map[handleId]->StartRenderer(MainWnd_, video_track_);
+		m_peer_connection_map[handleId]->StartRenderer(render_backend_.get(), video_track_);
 
 		result_or_error = m_peer_connection_map[handleId]->peer_connection_->AddTrack(video_track_, { kStreamId });
 		if (!result_or_error.ok()) {
 			RTC_LOG(LS_ERROR) << "Failed to add video track to PeerConnection: "
 				<< result_or_error.error().message();
 		}
+
+		if (cpu_adaptation_ && !video_adapter) {
+			RTC_LOG(LS_WARNING) << "No negotiated capturer, CPU adaptation disabled";
+		}
+		else if (cpu_adaptation_) {
+			cpu_overuse_monitor_.reset(new CpuOveruseMonitor(CpuOveruseOptions(),
+				video_source, video_adapter, width, height, capture_target_.fps,
+				m_peer_connection_map[handleId]->peer_connection_));
+			cpu_overuse_handle_ = handleId;
+		}
 	}
 	else {
 		RTC_LOG(LS_ERROR) << "OpenVideoCaptureDevice failed";
 	}
 
+	if (screen_share_) {
+		AddScreenTrack(handleId);
+	}
+
 	main_wnd_->SwitchToStreamingUI();
 }
 
+void ConductorWs::AddScreenTrack(long long int handleId) {
+	std::unique_ptr<cricket::VideoCapturer> capturer(
+		new DesktopVideoCapturer(screen_share_options_));
+	rtc::scoped_refptr<webrtc::VideoTrackInterface> screen_track(
+		peer_connection_factory_->CreateVideoTrack(
+			kScreenLabel, peer_connection_factory_->CreateVideoSource(std::move(capturer))));
+	screen_track->set_content_hint(webrtc::VideoTrackInterface::ContentHint::kDetailed);
+
+	auto result_or_error = m_peer_connection_map[handleId]->peer_connection_->AddTrack(screen_track, { kStreamId });
+	if (!result_or_error.ok()) {
+		RTC_LOG(LS_ERROR) << "Failed to add screen track to PeerConnection: "
+			<< result_or_error.error().message();
+		return;
+	}
+
+	// Text has to stay readable: under load drop frames, not resolution.
+	rtc::scoped_refptr<webrtc::RtpSenderInterface> sender = result_or_error.value();
+	webrtc::RtpParameters parameters = sender->GetParameters();
+	parameters.degradation_preference = webrtc::DegradationPreference::MAINTAIN_RESOLUTION;
+	webrtc::RTCError error = sender->SetParameters(parameters);
+	if (!error.ok()) {
+		RTC_LOG(LS_WARNING) << "Failed to set the screen degradation preference: "
+			<< error.message();
+	}
+}
+
 /*----------------------------------------------------------------*/
 /*-----------------janus protocol implementation------------------*/
 void ConductorWs::OnJanusConnected() {
+	join_timeline_.MarkConnection(kJoinWsConnected);
 	CreateSession();
 }
 
@@ -544,28 +632,17 @@ void ConductorWs::OnSendKeepAliveToJanus() {
 
 void ConductorWs::KeepAlive() {
 	if (m_SessionId > 0) {
-		std::string transactionID = RandomString(12);
-		Json::StyledWriter writer;
-		Json::Value jmessage;
-
-		jmessage["janus"] = "keepalive";
-		jmessage["session_id"] = m_SessionId;
-		jmessage["transaction"] = transactionID;
-		client_->SendToJanus(writer.write(jmessage));
+		janus_.KeepAlive(m_SessionId);
 	}
 }
 
 void ConductorWs::CreateSession() {
-
-	int rev_tid1 = GetCurrentThreadId();
-	std::string transactionID=RandomString(12);
 	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
-	jt->transactionId = transactionID;
 
 	//TODO Is it possible for lamda expression here?
-	jt->Success = [=](std::string message) mutable {		
-		list<string> sessionList = {"data","id" };
-		m_SessionId = OptLLInt(message, sessionList);
+	jt->Success = [=](std::string message) mutable {
+		m_SessionId = JanusSignaling::ReplyId(message);
+		join_timeline_.MarkConnection(kJoinSessionCreated);
 		//lauch the timer for keep alive breakheart
 		//Then Create the handle
 		CreateHandle("janus.plugin.videoroom",0,"pcg");
@@ -575,23 +652,16 @@ void ConductorWs::CreateSession() {
 		RTC_LOG(INFO) << "Ooops: " << code << " " << reason;
 	};
 
-	m_transactionMap[transactionID]=jt;
-
-	Json::StyledWriter writer;
-	Json::Value jmessage;
-	jmessage["janus"] = "create";
-	jmessage["transaction"] = transactionID;
-	client_->SendToJanus(writer.write(jmessage));
+	janus_.CreateSession(jt);
 }
 
 //publisher send attach
 void ConductorWs::CreateHandle(std::string pluginName, long long int feedId, std::string display) {
-	std::string transactionID = RandomString(12);
 	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
-	jt->transactionId = transactionID;
+	int64_t attach_us = rtc::TimeMicros();
 	jt->Success = [=](std::string message) {
-		list<string> handleList = { "data","id" };
-		long long int handle_id = OptLLInt(message, handleList);
+		long long int handle_id = JanusSignaling::ReplyId(message);
+		join_timeline_.Attached(handle_id, feedId == 0, feedId, attach_us);
 		//add handle to the map
 		std::shared_ptr<JanusHandle> jh(new JanusHandle());
 		jh->handleId = handle_id;
@@ -609,23 +679,13 @@ void ConductorWs::CreateHandle(std::string pluginName, long long int feedId, std
 		RTC_LOG(INFO) << "CreateHandle error:";
 	};
 
-	m_transactionMap[transactionID] = jt;
-
-	Json::StyledWriter writer;
-	Json::Value jmessage;
-	jmessage["janus"] = "attach";
-	jmessage["plugin"] = pluginName;
-	jmessage["transaction"] = transactionID;
-	jmessage["session_id"] = m_SessionId;
-	client_->SendToJanus(writer.write(jmessage));
+	janus_.Attach(m_SessionId, pluginName, jt);
 }
 
 
 void ConductorWs::JoinRoom(std::string pluginName,long long int handleId,long long int feedId) {
 	//rtcEvents.onPublisherJoined(handle.handleId);
-	std::string transactionID = RandomString(12);
 	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
-	jt->transactionId = transactionID;
 
 	jt->Event = [=](std::string message) {
 		//get sender
@@ -645,12 +705,14 @@ void ConductorWs::JoinRoom(std::string pluginName,long long int handleId,long lo
 		std::string videoroom= OptString(message, roomList);
 		//joined the room as a publisher
 		if (videoroom == "joined") {
+			join_timeline_.Mark(handleId, kJoinJoined);
 			main_wnd_->QueueUIThreadCallback(CREATE_OFFER, (void*)(&handleId));
 			//for each search every publisher and create handle to attach them
 			
 		}
 		//joined the room as a subscriber
 		if (videoroom == "attached") {
+			join_timeline_.Mark(handleId, kJoinJoined);
 			//TODO make sure this sdp is offer from remote peer
 			list<string> resultList = { "jsep","sdp" };
 			std::string jsep_str = OptString(message, resultList);
@@ -661,10 +723,6 @@ void ConductorWs::JoinRoom(std::string pluginName,long long int handleId,long lo
 		}
 	};
 
-	m_transactionMap[transactionID] = jt;
-
-	Json::StyledWriter writer;
-	Json::Value jmessage;
 	Json::Value jbody;
 	if (pluginName == "janus.plugin.videoroom") {
 		jbody["request"] = "join";
@@ -678,12 +736,7 @@ void ConductorWs::JoinRoom(std::string pluginName,long long int handleId,long lo
 			jbody["feed"] = feedId;
 			jbody["private_id"] = 0;//FIXME should be variable
 		}
-		jmessage["body"] = jbody;
-		jmessage["janus"] = "message";
-		jmessage["transaction"] = transactionID;
-		jmessage["session_id"] = m_SessionId;
-		jmessage["handle_id"] = handleId;
-		client_->SendToJanus(writer.write(jmessage));
+		janus_.Message(m_SessionId, handleId, jbody, nullptr, jt, false);
 		//After joined,Then create offer
 	}
 	else if (pluginName == "janus.plugin.audiobridge") {
@@ -692,12 +745,7 @@ void ConductorWs::JoinRoom(std::string pluginName,long long int handleId,long lo
 	else if (pluginName == "janus.plugin.echotest") {
 		jbody["audio"] = true;
 		jbody["video"] = true;
-		jmessage["body"] = jbody;
-		jmessage["janus"] = "message";
-		jmessage["transaction"] = transactionID;
-		jmessage["session_id"] = m_SessionId;
-		jmessage["handle_id"] = handleId;
-		client_->SendToJanus(writer.write(jmessage));
+		janus_.Message(m_SessionId, handleId, jbody, nullptr, jt, false);
 		//shift the process to UI thread to createOffer
 		main_wnd_->QueueUIThreadCallback(CREATE_OFFER, (void*)(handleId));
 	}
@@ -706,9 +754,7 @@ void ConductorWs::JoinRoom(std::string pluginName,long long int handleId,long lo
 }
 
 void ConductorWs::SendOffer(long long int handleId, std::string sdp_type,std::string sdp_desc) {
-	std::string transactionID = RandomString(12);
 	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
-	jt->transactionId = transactionID;
 
 	jt->Event = [=](std::string message) {
 		list<string> resultList = { "jsep","sdp" };
@@ -719,10 +765,6 @@ void ConductorWs::SendOffer(long long int handleId, std::string sdp_type,std::st
 		main_wnd_->QueueUIThreadCallback(SET_REMOTE_ANSWER, pInfo);
 	};
 
-	m_transactionMap[transactionID] = jt;
-
-	Json::StyledWriter writer;
-	Json::Value jmessage;
 	Json::Value jbody;
 	Json::Value jjsep;
 
@@ -733,29 +775,17 @@ void ConductorWs::SendOffer(long long int handleId, std::string sdp_type,std::st
 	jjsep["type"] = sdp_type;
 	jjsep["sdp"] = sdp_desc;
 
-	jmessage["body"] = jbody;
-	jmessage["jsep"] = jjsep;
-	jmessage["janus"] = "message";
-	jmessage["transaction"] = transactionID;
-	jmessage["session_id"] = m_SessionId;
-	jmessage["handle_id"] = handleId;
 	//beacause the thread is on UI,so shift thread to ws thread
-	client_->SendToJanusAsync(writer.write(jmessage));
+	janus_.Message(m_SessionId, handleId, jbody, &jjsep, jt, true);
 }
 
 void ConductorWs::SendAnswer(long long int handleId, std::string sdp_type, std::string sdp_desc) {
-	std::string transactionID = RandomString(12);
 	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
-	jt->transactionId = transactionID;
 
 	jt->Event = [=](std::string message) {
 		
 	};
 
-	m_transactionMap[transactionID] = jt;
-
-	Json::StyledWriter writer;
-	Json::Value jmessage;
 	Json::Value jbody;
 	Json::Value jjsep;
 
@@ -765,20 +795,11 @@ void ConductorWs::SendAnswer(long long int handleId, std::string sdp_type, std::
 	jjsep["type"] = sdp_type;
 	jjsep["sdp"] = sdp_desc;
 
-	jmessage["body"] = jbody;
-	jmessage["jsep"] = jjsep;
-	jmessage["janus"] = "message";
-	jmessage["transaction"] = transactionID;
-	jmessage["session_id"] = m_SessionId;
-	jmessage["handle_id"] = handleId;
 	//beacause the thread is on UI,so shift thread to ws thread
-	client_->SendToJanusAsync(writer.write(jmessage));
+	janus_.Message(m_SessionId, handleId, jbody, &jjsep, jt, true);
 }
 
 void ConductorWs::trickleCandidate(long long int handleId, const webrtc::IceCandidateInterface* candidate) {
-	std::string transactionID = RandomString(12);
-	Json::StyledWriter writer;
-	Json::Value jmessage;
 	Json::Value jcandidate;
 
 	std::string sdp;
@@ -791,34 +812,19 @@ void ConductorWs::trickleCandidate(long long int handleId, const webrtc::IceCand
 	jcandidate["sdpMLineIndex"] = candidate->sdp_mline_index();
 	jcandidate["candidate"] = sdp;
 
-	jmessage["janus"] = "trickle";
-	jmessage["candidate"] = jcandidate;	
-	jmessage["transaction"] = transactionID;
-	jmessage["session_id"] = m_SessionId;
-	jmessage["handle_id"] = handleId;
-	client_->SendToJanusAsync(writer.write(jmessage));
+	janus_.Trickle(m_SessionId, handleId, jcandidate, true);
 }
 
 void ConductorWs::trickleCandidateComplete(long long int handleId) {
-	std::string transactionID = RandomString(12);
-	Json::StyledWriter writer;
-	Json::Value jmessage;
 	Json::Value jcandidate;
 
 	jcandidate["completed"] = true;
 
-	jmessage["janus"] = "trickle";
-	jmessage["candidate"] = jcandidate;
-	jmessage["transaction"] = transactionID;
-	jmessage["session_id"] = m_SessionId;
-	jmessage["handle_id"] = handleId;
-	client_->SendToJanusAsync(writer.write(jmessage));
+	janus_.Trickle(m_SessionId, handleId, jcandidate, true);
 }
 
 void ConductorWs::SendBitrateConstraint(long long int handleId) {
-	std::string transactionID = RandomString(12);
 	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
-	jt->transactionId = transactionID;
 	jt->Success = [=](std::string message) {
 		
 	};
@@ -835,22 +841,12 @@ void ConductorWs::SendBitrateConstraint(long long int handleId) {
 		RTC_LOG(INFO) << "CreateHandle error:";
 	};
 
-
-	m_transactionMap[transactionID] = jt;
-
-	Json::StyledWriter writer;
-	Json::Value jmessage;
 	Json::Value jbody;
 
 	jbody["bitrate"] = 128000;
 	jbody["request"] = "configure";
 
-	jmessage["janus"] = "message";
-	jmessage["body"] = jbody;
-	jmessage["transaction"] = transactionID;
-	jmessage["session_id"] = m_SessionId;
-	jmessage["handle_id"] = handleId;
-	client_->SendToJanusAsync(writer.write(jmessage));
+	janus_.Message(m_SessionId, handleId, jbody, nullptr, jt, true);
 }
 
 
@@ -858,100 +854,24 @@ void ConductorWs::SendBitrateConstraint(long long int handleId) {
 //because janus self act as an end,so always define peer_id=0
 void ConductorWs::OnMessageFromJanus(int peer_id, const std::string& message) {
 	RTC_DCHECK(!message.empty());
+	TRACE_EVENT1("janus", "OnMessageFromJanus", "bytes", message.size());
 	RTC_LOG(INFO) << "got msg: " << message;
 	//TODO make sure in right state
-	//parse json
-	Json::Reader reader;
-	Json::Value jmessage;
-	if (!reader.parse(message, jmessage)) {
-		RTC_LOG(WARNING) << "Received unknown message. " << message;
-		return;
-	}
-	std::string janus_str;
-	std::string json_object;
-
-	rtc::GetStringFromJsonObject(jmessage, "janus",
-		&janus_str);
-	if (!janus_str.empty()) {
-		if (janus_str == "ack") {
-			// Just an ack, we can probably ignore
-			RTC_LOG(INFO) << "Got an ack on session. ";
-		}
-		else if (janus_str == "success") {
-			rtc::GetStringFromJsonObject(jmessage, "transaction",
-				&janus_str);
-			std::shared_ptr<JanusTransaction> jt = m_transactionMap.at(janus_str);
-			//call signal
-			if (jt) {
-				jt->Success(message);//handle_id not ready yet
-			}
-			m_transactionMap.erase(janus_str);
-		}
-		else if (janus_str == "trickle") {
-			RTC_LOG(INFO) << "Got a trickle candidate from Janus. ";
-		}
-		else if (janus_str == "webrtcup") {
-			RTC_LOG(INFO) << "The PeerConnection with the gateway is up!";
-		}
-		else if (janus_str == "hangup") {
-			RTC_LOG(INFO) << "A plugin asked the core to hangup a PeerConnection on one of our handles! ";
-		}
-		else if (janus_str == "detached") {
-			RTC_LOG(INFO) << "A plugin asked the core to detach one of our handles! ";
-		}
-		else if (janus_str == "media") {
-			RTC_LOG(INFO) << "Media started/stopped flowing. ";
-		}
-		else if (janus_str == "slowlink") {
-			RTC_LOG(INFO) << "Got a slowlink event! ";
-		}
-		else if (janus_str == "error") {
-			RTC_LOG(INFO) << "Got an error. ";
-			// Oops, something wrong happened
-			/*rtc::GetStringFromJsonObject(jmessage, "transaction",
-			&janus_str);
-			std::shared_ptr<JanusTransaction> jt = m_transactionMap.at(janus_str);
-			//call signal
-			if (jt) {
-			jt->Error("123","456");//TODO need to parse the error code and desc
-			}
-			m_transactionMap.erase(janus_str);*/
-		}
-		else {
+	janus_.OnMessage(message);
+}
 
-			if (janus_str == "event") {
-				RTC_LOG(INFO) << "Got a plugin event! ";
-				//get publishers
-				list<string> str_publishers{ "plugindata" ,"data","publishers"};
-				Json::Value value_publishers = optJSONValue(message, str_publishers);
-				std::vector<Json::Value> PublisherVec;
-
-				rtc::JsonArrayToValueVector(value_publishers, &PublisherVec);
-				//constrain the max publishers count to 5
-				for (auto pub : PublisherVec) {
-					std::string str_feedid;
-					std::string display;
-					Json::Value jvalue;
-					rtc::GetValueFromJsonObject(pub,"id",&jvalue);
-					rtc::GetStringFromJsonObject(pub, "display", &display);
-					str_feedid = rtc::JsonValueToString(jvalue);
-					long long int feedId= std::stoll(str_feedid);
-					CreateHandle("janus.plugin.videoroom", feedId, display);
-				}
-
-				bool bSuccess = rtc::GetStringFromJsonObject(jmessage, "transaction",
-					&janus_str);
-				if (bSuccess) {
-					std::shared_ptr<JanusTransaction> jt = m_transactionMap.at(janus_str);
-					if (jt) {
-						jt->Event(message);
-					}
-				}
-			}
-		}
+void ConductorWs::OnPublishers(long long int session_id,
+	const std::vector<JanusPublisher>& publishers) {
+	//constrain the max publishers count to 5
+	for (const JanusPublisher& pub : publishers) {
+		CreateHandle("janus.plugin.videoroom", pub.id, pub.display);
 	}
 }
 
+void ConductorWs::OnWebrtcUp(long long int handle_id) {
+	join_timeline_.Mark(handle_id, kJoinDtlsConnected);
+}
+
 //json handle functions
 
 //jmessage:the json to be parse
@@ -13,6 +13,15 @@
 #include "peer_connection_wsclient.h"
 #include "JanusTransaction.h"
 #include "JanusHandle.h"
+#include "janus_signaling.h"
+#include "gdi_render_backend.h"
+#include "frame_worker_pool.h"
+#include "capture_negotiation.h"
+#include "desktop_video_capturer.h"
+#include "synthetic_video_capturer.h"
+#include "headless_audio_device.h"
+#include "cpu_overuse_monitor.h"
+#include "join_timeline.h"
 
 #include "defaults.h"
 
@@ -40,6 +49,7 @@ struct REMOTE_SDP_INFO {
 class ConductorWs : public sigslot::has_slots<>,
 	public rtc::RefCountInterface,
 	public PeerConnectionWsClientObserver,
+	public JanusSignalingObserver,
 	public MainWndCallback,
     public PeerConnectionCallback {
 public:
@@ -52,6 +62,43 @@ public:
 
 	void Close() override;
 
+	// The decode threads only hand each frame to its VideoRenderer. Composition
+	// runs on the thread that paints (the UI thread on WM_PAINT for GDI); with
+	// workers it posts the rotation, scaling and ARGB conversion of each tile to
+	// a pool of |num_workers| threads and blocks until they are done.
+	void EnableRenderWorkers(int num_workers, bool pin_to_cores);
+
+	// Logs the stats of every tile every |interval_ms|, 0 disables.
+	void EnableRenderStatsLog(int64_t interval_ms);
+
+	// Snapshot of the stats of the tile of |handleId|, false if it has none.
+	bool GetRenderStats(long long int handleId, RenderStatsSnapshot* stats) const;
+
+	// Records every remote video track to rotating Y4M files in |dir|.
+	void EnableFrameDump(const std::string& dir, size_t max_file_size, size_t num_files);
+
+	// Camera mode requested from the first capture device.
+	void SetCaptureTarget(const CaptureTarget& target);
+
+	// Publishes a Y4M file or a generated pattern instead of the camera.
+	void EnableSyntheticVideo(const SyntheticVideoOptions& options);
+
+	// Replaces the sound card with a file or sine source and a discarding or
+	// checksumming sink. Takes effect when the factory is created.
+	void EnableHeadlessAudio(const HeadlessAudioOptions& options);
+
+	// Steps the camera resolution and frame rate down when the CPU is
+	// overused and back up when it recovers.
+	void EnableCpuAdaptation();
+
+	// Publishes the desktop or a window as a second video track.
+	void EnableScreenShare(const ScreenShareOptions& options);
+
+	// Appends the join latency record of every handle to |path| as JSON
+	// lines. The records are logged and their histograms logged on Close()
+	// either way.
+	bool EnableJoinRecords(const std::string& path);
+
 protected:
 	~ConductorWs();
 	bool InitializePeerConnection(long long int handleId, bool bPublisher);
@@ -59,7 +106,12 @@ protected:
 	void DeletePeerConnection(long long int handleId);
 	void EnsureStreamingUI();
 	void AddTracks(long long int handleId);
-	std::unique_ptr<cricket::VideoCapturer> OpenVideoCaptureDevice();
+	// Opens the first camera in the native mode closest to capture_target_,
+	// |mode| receives that mode (zero sized if none was negotiated) and
+	// |adapter| the capturer's adapter (null if none was negotiated).
+	std::unique_ptr<cricket::VideoCapturer> OpenVideoCaptureDevice(CaptureMode* mode,
+		cricket::VideoAdapter** adapter);
+	void AddScreenTrack(long long int handleId);
 
 	//
 	// PeerConnectionClientObserver implementation.
@@ -83,6 +135,15 @@ protected:
 
 	void OnSendKeepAliveToJanus() override;
 
+	//
+	// JanusSignalingObserver implementation.
+	//
+
+	void OnPublishers(long long int session_id,
+		const std::vector<JanusPublisher>& publishers) override;
+
+	void OnWebrtcUp(long long int handle_id) override;
+
 	//
 	// MainWndCallback implementation.
 	//
@@ -109,13 +170,31 @@ protected:
 	int peer_id_;
 	bool loopback_;
 	//rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection_;
+	//declared before the map so that renderers go away first
+	std::unique_ptr<FrameWorkerPool> render_worker_pool_;
+	std::unique_ptr<GdiRenderBackend> render_backend_;
+	//also before the map, PeerConnections and their renderers write into it
+	JoinTimeline join_timeline_;
 	std::map<long long int, rtc::scoped_refptr<PeerConnection>> m_peer_connection_map;
+	std::string frame_dump_dir_;//empty: no dump
+	size_t frame_dump_max_file_size_ = 0;
+	size_t frame_dump_num_files_ = 0;
+	CaptureTarget capture_target_;
+	bool synthetic_video_ = false;
+	SyntheticVideoOptions synthetic_video_options_;
+	bool headless_audio_ = false;
+	HeadlessAudioOptions headless_audio_options_;
+	bool cpu_adaptation_ = false;
+	std::unique_ptr<CpuOveruseMonitor> cpu_overuse_monitor_;
+	long long int cpu_overuse_handle_ = 0;//publisher the monitor adapts
+	bool screen_share_ = false;
+	ScreenShareOptions screen_share_options_;
 	rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> peer_connection_factory_;
 	PeerConnectionWsClient* client_;
 	MainWindow* main_wnd_;
 	std::deque<std::string*> pending_messages_;
 	std::string server_;
-	std::map<std::string, std::shared_ptr<JanusTransaction>> m_transactionMap;
+	JanusSignaling janus_;
 	std::map<long long int, std::shared_ptr<JanusHandle>> m_handleMap;
 	long long int m_SessionId=0LL;
 	HWND MainWnd_=NULL;
@@ -0,0 +1,181 @@
+#include "cpu_overuse_monitor.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "absl/types/optional.h"
+#include "api/statstypes.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/refcountedobject.h"
+#include "rtc_base/timeutils.h"
+
+namespace {
+
+struct AdaptationStep {
+	double pixel_ratio;
+	double fps_ratio;
+};
+
+// Frame rate goes first, text and faces stay sharp as long as possible.
+const AdaptationStep kLadder[] = {
+	{ 1.0, 1.0 },
+	{ 1.0, 2.0 / 3 },
+	{ 9.0 / 16, 2.0 / 3 },//3/4 of the width and height
+	{ 1.0 / 4, 2.0 / 3 },
+	{ 1.0 / 4, 1.0 / 2 },
+	{ 1.0 / 9, 1.0 / 2 },
+};
+const int kMaxLevel = sizeof(kLadder) / sizeof(kLadder[0]) - 1;
+
+// A step up followed by an overuse within this many samples was premature.
+const int kPrematureStepUpSamples = 10;
+const int kMaxUnderuseBackoff = 8;
+
+}  // namespace
+
+class CpuOveruseMonitor::EncodeStatsObserver : public webrtc::StatsObserver {
+public:
+	EncodeStatsObserver() : encode_usage_percent_(-1) {}
+
+	void OnComplete(const webrtc::StatsReports& reports) override {
+		for (const webrtc::StatsReport* report : reports) {
+			if (report->type() != webrtc::StatsReport::kStatsReportTypeSsrc) {
+				continue;
+			}
+			const webrtc::StatsReport::Value* value =
+				report->FindValue(webrtc::StatsReport::kStatsValueNameEncodeUsagePercent);
+			if (value) {
+				encode_usage_percent_ = value->int_val();
+				return;
+			}
+		}
+	}
+
+	// -1 until the first video send report arrived.
+	int encode_usage_percent() const { return encode_usage_percent_; }
+
+private:
+	std::atomic<int> encode_usage_percent_;
+};
+
+CpuOveruseMonitor::CpuOveruseMonitor(const CpuOveruseOptions& options,
+	rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> source,
+	cricket::VideoAdapter* adapter,
+	int width, int height, int fps,
+	rtc::scoped_refptr<webrtc::PeerConnectionInterface> pc)
+	: options_(options),
+	source_(source),
+	adapter_(adapter),
+	width_(width),
+	height_(height),
+	fps_(fps),
+	pc_(pc),
+	stats_observer_(new rtc::RefCountedObject<EncodeStatsObserver>()),
+	signaling_thread_(rtc::Thread::Current()),
+	underuse_samples_needed_(options.underuse_samples),
+	level_(0) {
+	thread_ = std::thread([this]() { Run(); });
+}
+
+CpuOveruseMonitor::~CpuOveruseMonitor() {
+	{
+		std::lock_guard<std::mutex> lock(stop_mutex_);
+		stopping_ = true;
+	}
+	stop_cv_.notify_all();
+	thread_.join();
+	if (level_ != 0) {
+		ApplyLevel(0, "monitor stopped", 0.0, -1);
+	}
+}
+
+void CpuOveruseMonitor::Run() {
+	rtc::SetCurrentThreadName("CpuOveruse");
+	unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+	int64_t last_cpu_ns = rtc::GetProcessCpuTimeNanos();
+	int64_t last_wall_ns = rtc::TimeNanos();
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(stop_mutex_);
+			if (stop_cv_.wait_for(lock, std::chrono::milliseconds(options_.interval_ms),
+				[this]() { return stopping_; })) {
+				return;
+			}
+		}
+		int64_t cpu_ns = rtc::GetProcessCpuTimeNanos();
+		int64_t wall_ns = rtc::TimeNanos();
+		double cpu_percent = wall_ns > last_wall_ns ?
+			100.0 * (cpu_ns - last_cpu_ns) / (static_cast<double>(wall_ns - last_wall_ns) * cores) : 0.0;
+		last_cpu_ns = cpu_ns;
+		last_wall_ns = wall_ns;
+
+		// The answer arrives asynchronously and is used by the next sample.
+		// Requests still queued when the monitor goes away are dropped with
+		// |invoker_|.
+		if (pc_) {
+			invoker_.AsyncInvoke<void>(RTC_FROM_HERE, signaling_thread_, [this]() {
+				pc_->GetStats(stats_observer_, nullptr,
+					webrtc::PeerConnectionInterface::kStatsOutputLevelStandard);
+			});
+		}
+		Evaluate(wall_ns / rtc::kNumNanosecsPerMillisec, cpu_percent,
+			stats_observer_->encode_usage_percent());
+	}
+}
+
+void CpuOveruseMonitor::Evaluate(int64_t now_ms, double cpu_percent, int encode_usage_percent) {
+	bool cpu_over = cpu_percent > options_.high_cpu_percent;
+	bool encode_over = encode_usage_percent > options_.high_encode_usage_percent;
+	bool under = cpu_percent < options_.low_cpu_percent &&
+		encode_usage_percent < options_.low_encode_usage_percent;
+
+	if (cpu_over || encode_over) {
+		overuse_count_++;
+		underuse_count_ = 0;
+	}
+	else if (under) {
+		underuse_count_++;
+		overuse_count_ = 0;
+	}
+	else {
+		overuse_count_ = 0;
+		underuse_count_ = 0;
+	}
+
+	int level = level_;
+	if (overuse_count_ >= options_.overuse_samples && level < kMaxLevel) {
+		if (last_step_up_ms_ >= 0 &&
+			now_ms - last_step_up_ms_ < kPrematureStepUpSamples * options_.interval_ms) {
+			underuse_samples_needed_ = std::min(underuse_samples_needed_ * 2,
+				options_.underuse_samples * kMaxUnderuseBackoff);
+		}
+		overuse_count_ = 0;
+		ApplyLevel(level + 1, cpu_over ? "process cpu" : "encode usage",
+			cpu_percent, encode_usage_percent);
+	}
+	else if (underuse_count_ >= underuse_samples_needed_ && level > 0) {
+		underuse_count_ = 0;
+		last_step_up_ms_ = now_ms;
+		ApplyLevel(level - 1, "underuse", cpu_percent, encode_usage_percent);
+	}
+}
+
+void CpuOveruseMonitor::ApplyLevel(int level, const char* cause,
+	double cpu_percent, int encode_usage_percent) {
+	const AdaptationStep& step = kLadder[level];
+	absl::optional<int> max_pixels;
+	absl::optional<int> max_fps;
+	if (level > 0) {
+		max_pixels = static_cast<int>(width_ * height_ * step.pixel_ratio);
+		max_fps = std::max(1, static_cast<int>(fps_ * step.fps_ratio + 0.5));
+	}
+	adapter_->OnOutputFormatRequest(absl::nullopt, max_pixels, max_fps);
+	RTC_LOG(INFO) << "CPU adaptation " << (level > level_ ? "down" : "up")
+		<< " to level " << level << " (max " << max_pixels.value_or(width_ * height_)
+		<< " pixels, " << max_fps.value_or(fps_) << " fps), cause: " << cause
+		<< ", cpu " << static_cast<int>(cpu_percent) << "%, encode usage "
+		<< encode_usage_percent << "%";
+	level_ = level;
+}
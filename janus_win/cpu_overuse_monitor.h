@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "api/mediastreaminterface.h"
+#include "api/peerconnectioninterface.h"
+#include "media/base/videoadapter.h"
+#include "rtc_base/asyncinvoker.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/thread.h"
+
+struct CpuOveruseOptions {
+	int interval_ms = 1000;
+	// Process CPU time as a share of all cores.
+	double high_cpu_percent = 85.0;
+	double low_cpu_percent = 50.0;
+	// Encoder usage reported by the video send stream (googEncodeUsagePercent).
+	int high_encode_usage_percent = 85;
+	int low_encode_usage_percent = 50;
+	// Consecutive samples above the high marks before stepping down, and
+	// below both low marks before stepping up.
+	int overuse_samples = 3;
+	int underuse_samples = 10;
+};
+
+// Local overuse detector for the camera track. Samples the process CPU time
+// (rtc::GetProcessCpuTimeNanos) and the encode usage of the publisher on its
+// own thread, and walks the capturer's cricket::VideoAdapter down and up a
+// ladder of frame rate and resolution limits. Stepping up needs a much
+// longer quiet period than stepping down; when a step up is followed by an
+// overuse right away, the quiet period doubles. Every step is logged with
+// the measurements that caused it.
+class CpuOveruseMonitor {
+public:
+	// |source| is kept alive because it owns the capturer of |adapter|.
+	// |pc| provides the encode usage and may be null. Must be created and
+	// destroyed on the signaling thread of |pc|.
+	CpuOveruseMonitor(const CpuOveruseOptions& options,
+		rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> source,
+		cricket::VideoAdapter* adapter,
+		int width, int height, int fps,
+		rtc::scoped_refptr<webrtc::PeerConnectionInterface> pc);
+	~CpuOveruseMonitor();
+
+	int level() const { return level_; }
+
+private:
+	class EncodeStatsObserver;
+
+	void Run();
+	void Evaluate(int64_t now_ms, double cpu_percent, int encode_usage_percent);
+	void ApplyLevel(int level, const char* cause, double cpu_percent, int encode_usage_percent);
+
+	const CpuOveruseOptions options_;
+	rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> source_;
+	cricket::VideoAdapter* const adapter_;
+	const int width_;
+	const int height_;
+	const int fps_;
+	rtc::scoped_refptr<webrtc::PeerConnectionInterface> pc_;
+	rtc::scoped_refptr<EncodeStatsObserver> stats_observer_;
+	// GetStats() is posted here instead of being called from the monitor
+	// thread, where its proxy would block on the signaling thread while that
+	// thread joins the monitor thread in the destructor.
+	rtc::Thread* const signaling_thread_;
+	rtc::AsyncInvoker invoker_;
+
+	// Monitor thread only.
+	int overuse_count_ = 0;
+	int underuse_count_ = 0;
+	int underuse_samples_needed_;
+	int64_t last_step_up_ms_ = -1;
+
+	std::atomic<int> level_;
+
+	std::mutex stop_mutex_;
+	std::condition_variable stop_cv_;
+	bool stopping_ = false;//guarded by stop_mutex_
+	std::thread thread_;
+};
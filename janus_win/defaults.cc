@@ -23,6 +23,7 @@
 
 const char kAudioLabel[] = "audio_label";
 const char kVideoLabel[] = "video_label";
+const char kScreenLabel[] = "screen_label";
 const char kStreamId[] = "stream_id";
 const uint16_t kDefaultServerPort = 8188;
 
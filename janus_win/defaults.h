@@ -22,6 +22,7 @@
 
 extern const char kAudioLabel[];
 extern const char kVideoLabel[];
+extern const char kScreenLabel[];
 extern const char kStreamId[];
 extern const uint16_t kDefaultServerPort;
 
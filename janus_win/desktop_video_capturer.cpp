@@ -0,0 +1,176 @@
+#include "desktop_video_capturer.h"
+
+#include <algorithm>
+
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "frame_adaptation.h"
+#include "modules/desktop_capture/desktop_and_cursor_composer.h"
+#include "modules/desktop_capture/desktop_capture_options.h"
+#include "modules/desktop_capture/desktop_capturer_differ_wrapper.h"
+#include "modules/desktop_capture/desktop_frame.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/timeutils.h"
+#include "third_party/libyuv/include/libyuv/convert.h"
+
+namespace {
+
+// A static screen still sends one frame per interval, so late joiners and
+// key frame requests get a picture.
+const int64_t kRefreshIntervalMs = 1000;
+
+}  // namespace
+
+DesktopVideoCapturer::DesktopVideoCapturer(const ScreenShareOptions& options)
+	: options_(options),
+	frames_captured_(0),
+	frames_unchanged_(0),
+	frames_delivered_(0),
+	capture_time_us_(0) {
+}
+
+DesktopVideoCapturer::~DesktopVideoCapturer() {
+	Stop();
+}
+
+cricket::CaptureState DesktopVideoCapturer::Start(
+	const cricket::VideoFormat& capture_format) {
+	if (thread_.joinable()) {
+		return cricket::CS_RUNNING;
+	}
+	cricket::VideoFormat format = capture_format;
+	format.interval = cricket::VideoFormat::FpsToInterval(std::max(options_.fps, 1));
+	SetCaptureFormat(&format);
+	{
+		std::lock_guard<std::mutex> lock(stop_mutex_);
+		stopping_ = false;
+	}
+	thread_ = std::thread([this]() { Run(); });
+	SetCaptureState(cricket::CS_RUNNING);
+	return cricket::CS_RUNNING;
+}
+
+void DesktopVideoCapturer::Stop() {
+	if (!thread_.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(stop_mutex_);
+		stopping_ = true;
+	}
+	stop_cv_.notify_all();
+	thread_.join();
+	SetCaptureFormat(nullptr);
+	SetCaptureState(cricket::CS_STOPPED);
+	RTC_LOG(INFO) << "Screen capture stopped: " << frames_captured_ << " captured, "
+		<< frames_unchanged_ << " unchanged, " << frames_delivered_ << " delivered";
+}
+
+bool DesktopVideoCapturer::IsRunning() {
+	return thread_.joinable();
+}
+
+bool DesktopVideoCapturer::GetPreferredFourccs(std::vector<uint32_t>* fourccs) {
+	fourccs->push_back(cricket::FOURCC_I420);
+	return true;
+}
+
+void DesktopVideoCapturer::Run() {
+	rtc::SetCurrentThreadName("ScreenCapture");
+
+	// The platform capturers are created, used and destroyed on this thread.
+	webrtc::DesktopCaptureOptions capture_options =
+		webrtc::DesktopCaptureOptions::CreateDefault();
+	// Keeps the factories from adding their own differ, it is added below.
+	capture_options.set_detect_updated_region(false);
+	std::unique_ptr<webrtc::DesktopCapturer> capturer;
+	if (options_.window_id != 0) {
+		capturer = webrtc::DesktopCapturer::CreateWindowCapturer(capture_options);
+		if (capturer && !capturer->SelectSource(options_.window_id)) {
+			RTC_LOG(LS_ERROR) << "Window " << options_.window_id << " cannot be captured";
+			capturer.reset();
+		}
+	}
+	else {
+		capturer = webrtc::DesktopCapturer::CreateScreenCapturer(capture_options);
+	}
+	if (!capturer) {
+		RTC_LOG(LS_ERROR) << "Failed to create the desktop capturer";
+		SetCaptureState(cricket::CS_FAILED);
+		return;
+	}
+	capturer.reset(new webrtc::DesktopCapturerDifferWrapper(std::move(capturer)));
+	if (options_.cursor) {
+		capturer.reset(new webrtc::DesktopAndCursorComposer(std::move(capturer),
+			capture_options));
+	}
+	capturer_ = std::move(capturer);
+	capturer_->Start(this);
+
+	const int64_t interval_us = rtc::kNumMicrosecsPerSec / std::max(options_.fps, 1);
+	int64_t next_capture_us = rtc::TimeMicros();
+	for (;;) {
+		int64_t start_us = rtc::TimeMicros();
+		capturer_->CaptureFrame();
+		capture_time_us_ += rtc::TimeMicros() - start_us;
+
+		next_capture_us += interval_us;
+		int64_t wait_us = next_capture_us - rtc::TimeMicros();
+		if (wait_us < 0) {
+			// Fell behind, do not try to catch up with a burst.
+			next_capture_us = rtc::TimeMicros();
+			wait_us = 0;
+		}
+		std::unique_lock<std::mutex> lock(stop_mutex_);
+		if (stop_cv_.wait_for(lock, std::chrono::microseconds(wait_us),
+			[this]() { return stopping_; })) {
+			break;
+		}
+	}
+	capturer_.reset();
+}
+
+void DesktopVideoCapturer::OnCaptureResult(webrtc::DesktopCapturer::Result result,
+	std::unique_ptr<webrtc::DesktopFrame> frame) {
+	if (result != webrtc::DesktopCapturer::Result::SUCCESS) {
+		if (result == webrtc::DesktopCapturer::Result::ERROR_PERMANENT) {
+			RTC_LOG(LS_ERROR) << "Desktop capture failed permanently";
+		}
+		return;
+	}
+	frames_captured_++;
+
+	int64_t now_ms = rtc::TimeMillis();
+	if (frame->updated_region().is_empty() && !update_dropped_ &&
+		now_ms - last_delivered_ms_ < kRefreshIntervalMs) {
+		frames_unchanged_++;
+		return;
+	}
+
+	int width = frame->size().width();
+	int height = frame->size().height();
+	int64_t now_us = rtc::TimeMicros();
+	FrameAdaptation adaptation;
+	if (!AdaptFrame(width, height, now_us, now_us,
+		&adaptation.width, &adaptation.height, &adaptation.crop_width,
+		&adaptation.crop_height, &adaptation.crop_x, &adaptation.crop_y,
+		&adaptation.timestamp_us)) {
+		// Dropped by the adapter; the next frame is sent even if unchanged.
+		update_dropped_ = true;
+		return;
+	}
+	last_delivered_ms_ = now_ms;
+	update_dropped_ = false;
+
+	rtc::scoped_refptr<webrtc::I420Buffer> buffer = buffer_pool_.CreateBuffer(width, height);
+	libyuv::ARGBToI420(frame->data(), frame->stride(),
+		buffer->MutableDataY(), buffer->StrideY(),
+		buffer->MutableDataU(), buffer->StrideU(),
+		buffer->MutableDataV(), buffer->StrideV(),
+		width, height);
+	frames_delivered_++;
+	OnFrame(webrtc::VideoFrame(AdaptFrameBuffer(buffer, adaptation, &adapted_pool_),
+		webrtc::kVideoRotation_0, adaptation.timestamp_us),
+		width, height);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common_video/include/i420_buffer_pool.h"
+#include "media/base/videocapturer.h"
+#include "modules/desktop_capture/desktop_capturer.h"
+
+struct ScreenShareOptions {
+	// Captures the window with this id instead of the screen when non zero.
+	webrtc::DesktopCapturer::SourceId window_id = 0;
+	bool cursor = true;
+	int fps = 5;
+};
+
+// cricket::VideoCapturer over modules/desktop_capture. The platform capturer
+// is wrapped in DesktopCapturerDifferWrapper, so a frame whose updated region
+// is empty is not converted nor passed on to the encoder (a refresh frame
+// still goes out every second). The cursor, when enabled, is painted by
+// DesktopAndCursorComposer on top of the differ, which marks its area as
+// updated when it moves. Changed frames go through the video adapter like
+// the other capturers, so CPU adaptation and sink wants scale or drop them.
+class DesktopVideoCapturer : public cricket::VideoCapturer,
+	public webrtc::DesktopCapturer::Callback {
+public:
+	explicit DesktopVideoCapturer(const ScreenShareOptions& options);
+	~DesktopVideoCapturer() override;
+
+	// cricket::VideoCapturer implementation. The format passed to Start()
+	// is ignored, frames come at the screen size and the configured fps.
+	cricket::CaptureState Start(const cricket::VideoFormat& capture_format) override;
+	void Stop() override;
+	bool IsRunning() override;
+	bool IsScreencast() const override { return true; }
+
+	int64_t frames_captured() const { return frames_captured_; }
+	int64_t frames_unchanged() const { return frames_unchanged_; }
+	int64_t frames_delivered() const { return frames_delivered_; }
+	int64_t capture_time_us() const { return capture_time_us_; }//summed
+
+protected:
+	bool GetPreferredFourccs(std::vector<uint32_t>* fourccs) override;
+
+private:
+	// webrtc::DesktopCapturer::Callback implementation
+	void OnCaptureResult(webrtc::DesktopCapturer::Result result,
+		std::unique_ptr<webrtc::DesktopFrame> frame) override;
+
+	void Run();
+
+	const ScreenShareOptions options_;
+	std::unique_ptr<webrtc::DesktopCapturer> capturer_;//capture thread only
+	webrtc::I420BufferPool buffer_pool_;//capture thread only
+	webrtc::I420BufferPool adapted_pool_;//capture thread only
+	int64_t last_delivered_ms_ = 0;//capture thread only
+	// The adapter dropped a frame, whose updated region the differ will not
+	// report again.
+	bool update_dropped_ = false;//capture thread only
+
+	std::mutex stop_mutex_;
+	std::condition_variable stop_cv_;
+	bool stopping_ = false;//guarded by stop_mutex_
+	std::thread thread_;
+
+	std::atomic<int64_t> frames_captured_;
+	std::atomic<int64_t> frames_unchanged_;
+	std::atomic<int64_t> frames_delivered_;
+	std::atomic<int64_t> capture_time_us_;
+};
@@ -0,0 +1,582 @@
+#include "dsp_benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "common_audio/signal_processing/resample_by_2_internal.h"
+#include "common_audio/vad/include/webrtc_vad.h"
+#include "modules/audio_processing/agc/legacy/digital_agc.h"
+#include "modules/audio_processing/agc/legacy/gain_control.h"
+#include "modules/audio_processing/ns/noise_suppression_x.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+namespace {
+
+enum DspPath { kPathC, kPathSSE2, kPathAVX2, kNumPaths };
+
+const char* const kPathNames[kNumPaths] = { "C", "SSE2", "AVX2" };
+
+// The corpus is 48 kHz audio; every call reads the 10 ms frame after the one
+// of the previous call, wrapping around at the end.
+const int kCorpusRate = 48000;
+const size_t kCorpusSeconds = 10;
+const size_t kFrame = 480;
+// Samples before a frame that the FIR kernels read as history.
+const size_t kHistory = 64;
+// The most any call reads past the start of its frame.
+const size_t kMaxSpan = 16384;
+const uint32_t kCorpusSeed = 1;
+
+// VAD and AGC instances pick their kernels through WebRtc_GetCPUInfo when
+// they are initialized, so the benchmark swaps in this one to hide the
+// features above |g_max_path|. The SPL pointers are set once per process and
+// stay on the best path.
+DspPath g_max_path = kPathC;
+WebRtc_CPUInfo g_cpu_info = nullptr;
+
+int CappedCPUInfo(CPUFeature feature) {
+	if (feature == kAVX2 && g_max_path < kPathAVX2) {
+		return 0;
+	}
+	if (feature == kSSE2 && g_max_path < kPathSSE2) {
+		return 0;
+	}
+	return g_cpu_info(feature);
+}
+
+// FNV-1a over the output, compared against the C path.
+uint32_t Hash(const void* data, size_t bytes, uint32_t hash) {
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < bytes; ++i) {
+		hash = (hash ^ p[i]) * 16777619u;
+	}
+	return hash;
+}
+
+// Quarter seconds of voiced speech, noise, near silence and clipped speech
+// in turn, at levels that change with every segment, so the saturating and
+// the small-signal branches of the kernels are all exercised.
+std::vector<int16_t> MakeCorpus() {
+	std::mt19937 rng(kCorpusSeed);
+	std::normal_distribution<double> noise(0.0, 1.0);
+	std::uniform_real_distribution<double> level_db(-40.0, 0.0);
+	const size_t kSegment = kCorpusRate / 4;
+	std::vector<int16_t> corpus(kCorpusSeconds * kCorpusRate);
+	double phase = 0;
+	double level = 0;
+	for (size_t i = 0; i < corpus.size(); ++i) {
+		size_t segment = i / kSegment;
+		if (i % kSegment == 0) {
+			level = 32768 * pow(10.0, level_db(rng) / 20);
+		}
+		double t = static_cast<double>(i) / kCorpusRate;
+		double pitch = 120 + 60 * sin(2 * M_PI * 0.7 * t);
+		phase += 2 * M_PI * pitch / kCorpusRate;
+		double syllables = 0.5 + 0.5 * sin(2 * M_PI * 4 * t);
+		double voiced = syllables * (sin(phase) + 0.5 * sin(3 * phase) +
+			0.25 * sin(7 * phase));
+		double sample = 0;
+		switch (segment % 4) {
+		case 0:
+			sample = level * voiced + 30 * noise(rng);
+			break;
+		case 1:
+			sample = level * noise(rng);
+			break;
+		case 2:
+			// Digital silence for half of the segment.
+			sample = i % kSegment < kSegment / 2 ? 0 : 3 * noise(rng);
+			break;
+		default:
+			sample = 4 * 32768 * voiced;
+			break;
+		}
+		corpus[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, sample)));
+	}
+	return corpus;
+}
+
+// Whatever the kernels write, hashed after every call.
+struct Outputs {
+	int32_t scalar = 0;
+	std::vector<int16_t> out16 = std::vector<int16_t>(kMaxSpan);
+	std::vector<int32_t> out32 = std::vector<int32_t>(kMaxSpan);
+	std::vector<int> decisions = std::vector<int>(64);
+
+	void Clear() {
+		scalar = 0;
+		std::fill(out16.begin(), out16.end(), 0);
+		std::fill(out32.begin(), out32.end(), 0);
+		std::fill(decisions.begin(), decisions.end(), 0);
+	}
+};
+
+uint32_t Hash(const Outputs& out, uint32_t hash) {
+	hash = Hash(&out.scalar, sizeof(out.scalar), hash);
+	hash = Hash(out.out16.data(), out.out16.size() * sizeof(out.out16[0]), hash);
+	hash = Hash(out.out32.data(), out.out32.size() * sizeof(out.out32[0]), hash);
+	return Hash(out.decisions.data(),
+		out.decisions.size() * sizeof(out.decisions[0]), hash);
+}
+
+struct DspKernel {
+	const char* module;
+	const char* name;
+	// Input samples per call, over all channels and bands.
+	size_t samples_per_call;
+	// The last path the kernel has.
+	DspPath max_path;
+	// Points the kernel at |path| and resets its state.
+	std::function<void(DspPath path)> select;
+	// Runs the kernel on the input of call number |call|.
+	std::function<void(size_t call)> run;
+};
+
+struct PathResult {
+	bool run = false;
+	double ns_per_call = 0;
+	double samples_per_s = 0;
+	double speedup = 0;
+	uint32_t hash = 0;
+	bool exact = true;
+};
+
+void WriteJson(FILE* file, int calls, const std::vector<DspKernel>& kernels,
+	const std::vector<std::vector<PathResult>>& results, bool all_exact) {
+	fprintf(file, "{\n  \"calls\": %d,\n  \"corpus_seed\": %u,\n", calls,
+		kCorpusSeed);
+	fprintf(file, "  \"cpu\": {\"sse2\": %s, \"avx2\": %s},\n",
+		g_cpu_info(kSSE2) ? "true" : "false",
+		g_cpu_info(kAVX2) ? "true" : "false");
+	fprintf(file, "  \"kernels\": [");
+	for (size_t k = 0; k < kernels.size(); ++k) {
+		const DspKernel& kernel = kernels[k];
+		fprintf(file, "%s\n    {\"module\": \"%s\", \"name\": \"%s\", "
+			"\"samples_per_call\": %zu, \"paths\": [", k ? "," : "",
+			kernel.module, kernel.name, kernel.samples_per_call);
+		bool first = true;
+		for (int path = 0; path < kNumPaths; ++path) {
+			const PathResult& result = results[k][path];
+			if (!result.run) {
+				continue;
+			}
+			fprintf(file, "%s\n      {\"path\": \"%s\", \"ns_per_call\": %.1f, "
+				"\"samples_per_s\": %.0f, \"speedup\": %.2f, "
+				"\"hash\": \"%08x\", \"bit_exact\": %s}", first ? "" : ",",
+				kPathNames[path], result.ns_per_call, result.samples_per_s,
+				result.speedup, result.hash, result.exact ? "true" : "false");
+			first = false;
+		}
+		fprintf(file, "]}");
+	}
+	fprintf(file, "\n  ],\n  \"all_bit_exact\": %s\n}\n",
+		all_exact ? "true" : "false");
+}
+
+}  // namespace
+
+bool RunDspBenchmark(int calls, const char* json_path) {
+	calls = std::max(calls, 1);
+	WebRtcSpl_Init();
+	g_cpu_info = WebRtc_GetCPUInfo;
+	const CalculateEnvelope initial_envelope = WebRtcAgc_CalculateEnvelope;
+	const ApplyDigitalGains initial_gains = WebRtcAgc_ApplyDigitalGains;
+
+	// The corpus, and the same signal in the Q15 plus 16384 format the 32-bit
+	// resampler stages pass between each other.
+	const std::vector<int16_t> x = MakeCorpus();
+	std::vector<int32_t> x32(x.size());
+	for (size_t i = 0; i < x.size(); ++i) {
+		x32[i] = x[i] * 32768 + 16384;
+	}
+	// Eleven Q16 gains per AGC frame, from -12 to +36 dB.
+	const size_t kGainSets = 1000;
+	std::vector<int32_t> gains(kGainSets * 11);
+	std::mt19937 rng(kCorpusSeed);
+	std::uniform_real_distribution<double> gain_db(-12.0, 36.0);
+	for (int32_t& gain : gains) {
+		gain = static_cast<int32_t>(65536 * pow(10.0, gain_db(rng) / 20));
+	}
+
+	const size_t kFrames = (x.size() - kHistory - kMaxSpan) / kFrame;
+	auto frame16 = [&](size_t call) {
+		return x.data() + kHistory + (call % kFrames) * kFrame;
+	};
+	auto frame32 = [&](size_t call) {
+		return x32.data() + kHistory + (call % kFrames) * kFrame;
+	};
+	// A second, unrelated input for the two-operand kernels.
+	auto other16 = [&](size_t call) {
+		return frame16(call + kFrames / 2);
+	};
+
+	Outputs out;
+	// Copies of the input for the kernels that work in place.
+	std::vector<int16_t> scratch16(kMaxSpan);
+	std::vector<int32_t> scratch32(kMaxSpan);
+	int32_t state[16];
+	std::vector<int16_t> taps(32);
+	for (size_t i = 0; i < taps.size(); ++i) {
+		taps[i] = static_cast<int16_t>(2048 * sin(0.3 * (i + 1)) / (i + 1));
+	}
+
+	const size_t kVadChannels = 16;
+	const size_t kVadChannelOffset = 997;
+	std::vector<VadInst*> vads(kVadChannels);
+	for (VadInst*& vad : vads) {
+		vad = WebRtcVad_Create();
+	}
+	NsxHandle* nsx16 = WebRtcNsx_Create();
+	NsxHandle* nsx32 = WebRtcNsx_Create();
+	void* agc = WebRtcAgc_Create();
+
+	// Initializes an instance with WebRtc_GetCPUInfo capped at |path|.
+	auto capped = [&](DspPath path, const std::function<void()>& init) {
+		g_max_path = path;
+		WebRtc_GetCPUInfo = CappedCPUInfo;
+		init();
+		WebRtc_GetCPUInfo = g_cpu_info;
+	};
+	DspPath selected = kPathC;
+	auto select_path = [&](DspPath path) { selected = path; };
+	auto select_by2 = [&](DspPath path) {
+		selected = path;
+		memset(state, 0, sizeof(state));
+	};
+
+	std::vector<DspKernel> kernels = {
+		{ "signal_processing", "MaxAbsValueW16", kFrame, kPathAVX2, select_path,
+			[&](size_t call) {
+				static const MaxAbsValueW16 f[] = { WebRtcSpl_MaxAbsValueW16C,
+					WebRtcSpl_MaxAbsValueW16SSE2, WebRtcSpl_MaxAbsValueW16AVX2 };
+				out.scalar = f[selected](frame16(call), kFrame);
+			} },
+		{ "signal_processing", "MaxAbsValueW32", kFrame, kPathAVX2, select_path,
+			[&](size_t call) {
+				static const MaxAbsValueW32 f[] = { WebRtcSpl_MaxAbsValueW32C,
+					WebRtcSpl_MaxAbsValueW32SSE2, WebRtcSpl_MaxAbsValueW32AVX2 };
+				out.scalar = f[selected](frame32(call), kFrame);
+			} },
+		{ "signal_processing", "MaxValueW16", kFrame, kPathAVX2, select_path,
+			[&](size_t call) {
+				static const MaxValueW16 f[] = { WebRtcSpl_MaxValueW16C,
+					WebRtcSpl_MaxValueW16SSE2, WebRtcSpl_MaxValueW16AVX2 };
+				out.scalar = f[selected](frame16(call), kFrame);
+			} },
+		{ "signal_processing", "MaxValueW32", kFrame, kPathAVX2, select_path,
+			[&](size_t call) {
+				static const MaxValueW32 f[] = { WebRtcSpl_MaxValueW32C,
+					WebRtcSpl_MaxValueW32SSE2, WebRtcSpl_MaxValueW32AVX2 };
+				out.scalar = f[selected](frame32(call), kFrame);
+			} },
+		{ "signal_processing", "MinValueW16", kFrame, kPathAVX2, select_path,
+			[&](size_t call) {
+				static const MinValueW16 f[] = { WebRtcSpl_MinValueW16C,
+					WebRtcSpl_MinValueW16SSE2, WebRtcSpl_MinValueW16AVX2 };
+				out.scalar = f[selected](frame16(call), kFrame);
+			} },
+		{ "signal_processing", "MinValueW32", kFrame, kPathAVX2, select_path,
+			[&](size_t call) {
+				static const MinValueW32 f[] = { WebRtcSpl_MinValueW32C,
+					WebRtcSpl_MinValueW32SSE2, WebRtcSpl_MinValueW32AVX2 };
+				out.scalar = f[selected](frame32(call), kFrame);
+			} },
+		// Sixteen lags, as the iLBC and VAD callers use.
+		{ "signal_processing", "CrossCorrelation", kFrame, kPathAVX2, select_path,
+			[&](size_t call) {
+				static const CrossCorrelation f[] = { WebRtcSpl_CrossCorrelationC,
+					WebRtcSpl_CrossCorrelationSSE2, WebRtcSpl_CrossCorrelationAVX2 };
+				f[selected](out.out32.data(), frame16(call), other16(call), kFrame,
+					16, 2, 1);
+			} },
+		// 32 taps, decimating by two.
+		{ "signal_processing", "DownsampleFast", kFrame, kPathAVX2, select_path,
+			[&](size_t call) {
+				static const DownsampleFast f[] = { WebRtcSpl_DownsampleFastC,
+					WebRtcSpl_DownsampleFastSSE2, WebRtcSpl_DownsampleFastAVX2 };
+				f[selected](frame16(call), kFrame, out.out16.data(), kFrame / 2,
+					taps.data(), taps.size(), 2, 0);
+			} },
+		{ "signal_processing", "ScaleAndAddVectorsWithRound", kFrame, kPathAVX2,
+			select_path, [&](size_t call) {
+				static const ScaleAndAddVectorsWithRound f[] = {
+					WebRtcSpl_ScaleAndAddVectorsWithRoundC,
+					WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2,
+					WebRtcSpl_ScaleAndAddVectorsWithRoundAVX2 };
+				f[selected](frame16(call), 12345, other16(call), -23456, 14,
+					out.out16.data(), kFrame);
+			} },
+		{ "signal_processing", "Resample48khzTo32khz", kFrame, kPathAVX2,
+			select_path, [&](size_t call) {
+				static const Resample48khzTo32khz f[] = {
+					WebRtcSpl_Resample48khzTo32khzC, WebRtcSpl_Resample48khzTo32khzSSE2,
+					WebRtcSpl_Resample48khzTo32khzAVX2 };
+				f[selected](frame32(call), out.out32.data(), kFrame / 3);
+			} },
+		{ "signal_processing", "Resample32khzTo24khz", kFrame, kPathAVX2,
+			select_path, [&](size_t call) {
+				static const Resample32khzTo24khz f[] = {
+					WebRtcSpl_Resample32khzTo24khzC, WebRtcSpl_Resample32khzTo24khzSSE2,
+					WebRtcSpl_Resample32khzTo24khzAVX2 };
+				f[selected](frame32(call), out.out32.data(), kFrame / 4);
+			} },
+		// The allpass filters carry their state from call to call and overwrite
+		// the input of DownBy2IntToShort, which is copied on every path alike.
+		{ "signal_processing", "DownBy2IntToShort", kFrame, kPathSSE2, select_by2,
+			[&](size_t call) {
+				static const DownBy2IntToShort f[] = { WebRtcSpl_DownBy2IntToShortC,
+					WebRtcSpl_DownBy2IntToShortSSE2 };
+				memcpy(scratch32.data(), frame32(call), kFrame * sizeof(int32_t));
+				f[selected](scratch32.data(), kFrame, out.out16.data(), state);
+			} },
+		{ "signal_processing", "DownBy2ShortToInt", kFrame, kPathSSE2, select_by2,
+			[&](size_t call) {
+				static const DownBy2ShortToInt f[] = { WebRtcSpl_DownBy2ShortToIntC,
+					WebRtcSpl_DownBy2ShortToIntSSE2 };
+				f[selected](frame16(call), kFrame, out.out32.data(), state);
+			} },
+		{ "signal_processing", "UpBy2ShortToInt", kFrame, kPathSSE2, select_by2,
+			[&](size_t call) {
+				static const UpBy2ShortToInt f[] = { WebRtcSpl_UpBy2ShortToIntC,
+					WebRtcSpl_UpBy2ShortToIntSSE2 };
+				f[selected](frame16(call), kFrame, out.out32.data(), state);
+			} },
+		{ "signal_processing", "UpBy2IntToInt", kFrame, kPathSSE2, select_by2,
+			[&](size_t call) {
+				static const UpBy2IntToInt f[] = { WebRtcSpl_UpBy2IntToIntC,
+					WebRtcSpl_UpBy2IntToIntSSE2 };
+				f[selected](frame32(call), kFrame, out.out32.data(), state);
+			} },
+		{ "signal_processing", "UpBy2IntToShort", kFrame, kPathSSE2, select_by2,
+			[&](size_t call) {
+				static const UpBy2IntToShort f[] = { WebRtcSpl_UpBy2IntToShortC,
+					WebRtcSpl_UpBy2IntToShortSSE2 };
+				f[selected](frame32(call), kFrame, out.out16.data(), state);
+			} },
+		{ "signal_processing", "LPBy2ShortToInt", kFrame, kPathSSE2, select_by2,
+			[&](size_t call) {
+				static const LPBy2ShortToInt f[] = { WebRtcSpl_LPBy2ShortToIntC,
+					WebRtcSpl_LPBy2ShortToIntSSE2 };
+				f[selected](frame16(call), kFrame, out.out32.data(), state);
+			} },
+		{ "signal_processing", "LPBy2IntToInt", kFrame, kPathSSE2, select_by2,
+			[&](size_t call) {
+				static const LPBy2IntToInt f[] = { WebRtcSpl_LPBy2IntToIntC,
+					WebRtcSpl_LPBy2IntToIntSSE2 };
+				f[selected](frame32(call), kFrame, out.out32.data(), state);
+			} },
+		// Sixteen 16 kHz channels per call, each with its own mode.
+		{ "vad", "ProcessBatch", kVadChannels * 160, kPathAVX2,
+			[&](DspPath path) {
+				capped(path, [&]() {
+					for (size_t ch = 0; ch < kVadChannels; ++ch) {
+						WebRtcVad_Init(vads[ch]);
+						WebRtcVad_set_mode(vads[ch], static_cast<int>(ch % 4));
+					}
+				});
+			},
+			[&](size_t call) {
+				const int16_t* frames[kVadChannels];
+				for (size_t ch = 0; ch < kVadChannels; ++ch) {
+					frames[ch] = frame16(call) + ch * kVadChannelOffset;
+				}
+				WebRtcVad_ProcessBatch(vads.data(), kVadChannels, 16000, frames, 160,
+					out.decisions.data());
+			} },
+		{ "ns", "WebRtcNsx_Process 16 kHz", 160, kPathAVX2,
+			[&](DspPath path) {
+				capped(path, [&]() {
+					WebRtcNsx_Init(nsx16, 16000);
+					WebRtcNsx_set_policy(nsx16, 2);
+				});
+			},
+			[&](size_t call) {
+				const int16_t* in[1] = { frame16(call) };
+				int16_t* const output[1] = { out.out16.data() };
+				WebRtcNsx_Process(nsx16, in, 1, output);
+			} },
+		{ "ns", "WebRtcNsx_Process 32 kHz", 320, kPathAVX2,
+			[&](DspPath path) {
+				capped(path, [&]() {
+					WebRtcNsx_Init(nsx32, 32000);
+					WebRtcNsx_set_policy(nsx32, 2);
+				});
+			},
+			[&](size_t call) {
+				const int16_t* in[2] = { frame16(call), frame16(call) + 160 };
+				int16_t* const output[2] = { out.out16.data(),
+					out.out16.data() + 160 };
+				WebRtcNsx_Process(nsx32, in, 2, output);
+			} },
+		// The per-sample loops of WebRtcAgc_ProcessDigital(), on 8 kHz and
+		// wideband subframes. ApplyDigitalGains works in place, so its input is
+		// copied on every path alike.
+		{ "agc", "CalculateEnvelope 8 kHz", 80, kPathAVX2,
+			[&](DspPath path) {
+				static const CalculateEnvelope f[] = { WebRtcAgc_CalculateEnvelopeC,
+					WebRtcAgc_CalculateEnvelopeSSE2, WebRtcAgc_CalculateEnvelopeAVX2 };
+				WebRtcAgc_CalculateEnvelope = f[path];
+			},
+			[&](size_t call) {
+				WebRtcAgc_CalculateEnvelope(frame16(call), 8, out.out32.data());
+			} },
+		{ "agc", "CalculateEnvelope 16 kHz", 160, kPathAVX2,
+			[&](DspPath path) {
+				static const CalculateEnvelope f[] = { WebRtcAgc_CalculateEnvelopeC,
+					WebRtcAgc_CalculateEnvelopeSSE2, WebRtcAgc_CalculateEnvelopeAVX2 };
+				WebRtcAgc_CalculateEnvelope = f[path];
+			},
+			[&](size_t call) {
+				WebRtcAgc_CalculateEnvelope(frame16(call), 16, out.out32.data());
+			} },
+		{ "agc", "ApplyDigitalGains 8 kHz", 80, kPathAVX2,
+			[&](DspPath path) {
+				static const ApplyDigitalGains f[] = { WebRtcAgc_ApplyDigitalGainsC,
+					WebRtcAgc_ApplyDigitalGainsSSE2, WebRtcAgc_ApplyDigitalGainsAVX2 };
+				WebRtcAgc_ApplyDigitalGains = f[path];
+			},
+			[&](size_t call) {
+				int16_t* const bands[1] = { out.out16.data() };
+				memcpy(bands[0], frame16(call), 80 * sizeof(int16_t));
+				WebRtcAgc_ApplyDigitalGains(&gains[(call % kGainSets) * 11], 1, 8,
+					bands);
+			} },
+		{ "agc", "ApplyDigitalGains 48 kHz", 480, kPathAVX2,
+			[&](DspPath path) {
+				static const ApplyDigitalGains f[] = { WebRtcAgc_ApplyDigitalGainsC,
+					WebRtcAgc_ApplyDigitalGainsSSE2, WebRtcAgc_ApplyDigitalGainsAVX2 };
+				WebRtcAgc_ApplyDigitalGains = f[path];
+			},
+			[&](size_t call) {
+				int16_t* const bands[3] = { out.out16.data(), out.out16.data() + 160,
+					out.out16.data() + 320 };
+				memcpy(bands[0], frame16(call), 480 * sizeof(int16_t));
+				WebRtcAgc_ApplyDigitalGains(&gains[(call % kGainSets) * 11], 3, 16,
+					bands);
+			} },
+		{ "agc", "WebRtcAgc_Process 48 kHz", 480, kPathAVX2,
+			[&](DspPath path) {
+				capped(path, [&]() {
+					WebRtcAgc_Init(agc, 0, 255, kAgcModeFixedDigital, 48000);
+					WebRtcAgcConfig config;
+					config.targetLevelDbfs = 3;
+					config.compressionGaindB = 20;
+					config.limiterEnable = kAgcTrue;
+					WebRtcAgc_set_config(agc, config);
+				});
+			},
+			[&](size_t call) {
+				const int16_t* in[3] = { frame16(call), frame16(call) + 160,
+					frame16(call) + 320 };
+				int16_t* const output[3] = { out.out16.data(), out.out16.data() + 160,
+					out.out16.data() + 320 };
+				int32_t mic_level = 0;
+				uint8_t saturation_warning = 0;
+				WebRtcAgc_Process(agc, in, 3, 160, output, 0, &mic_level, 0,
+					&saturation_warning);
+			} },
+	};
+
+	bool supported[kNumPaths] = { true, g_cpu_info(kSSE2) != 0,
+		g_cpu_info(kAVX2) != 0 };
+	const int kRounds = 3;
+	bool all_exact = true;
+	std::vector<std::vector<PathResult>> results(kernels.size(),
+		std::vector<PathResult>(kNumPaths));
+	for (size_t k = 0; k < kernels.size(); ++k) {
+		const DspKernel& kernel = kernels[k];
+		for (int p = 0; p <= kernel.max_path; ++p) {
+			if (!supported[p]) {
+				continue;
+			}
+			DspPath path = static_cast<DspPath>(p);
+			PathResult& result = results[k][p];
+			result.run = true;
+			// An untimed pass hashes every output, then the timed passes only run
+			// the kernel; best of a few rounds, to keep interrupts and frequency
+			// ramps out.
+			out.Clear();
+			kernel.select(path);
+			result.hash = 2166136261u;
+			for (int call = 0; call < calls; ++call) {
+				kernel.run(call);
+				result.hash = Hash(out, result.hash);
+			}
+			int64_t best_ns = INT64_MAX;
+			for (int round = 0; round < kRounds; ++round) {
+				kernel.select(path);
+				int64_t start_ns = rtc::TimeNanos();
+				for (int call = 0; call < calls; ++call) {
+					kernel.run(call);
+				}
+				best_ns = std::min(best_ns, rtc::TimeNanos() - start_ns);
+			}
+			best_ns = std::max<int64_t>(best_ns, 1);
+			result.ns_per_call = static_cast<double>(best_ns) / calls;
+			result.samples_per_s =
+				1e9 * kernel.samples_per_call * calls / best_ns;
+			result.speedup = results[k][kPathC].ns_per_call / result.ns_per_call;
+			result.exact = result.hash == results[k][kPathC].hash;
+			if (!result.exact) {
+				all_exact = false;
+				RTC_LOG(LS_ERROR) << kernel.module << " " << kernel.name << " "
+					<< kPathNames[p] << " differs from the C version";
+			}
+		}
+	}
+
+	WebRtcAgc_CalculateEnvelope = initial_envelope;
+	WebRtcAgc_ApplyDigitalGains = initial_gains;
+	WebRtcAgc_Free(agc);
+	WebRtcNsx_Free(nsx32);
+	WebRtcNsx_Free(nsx16);
+	for (VadInst* vad : vads) {
+		WebRtcVad_Free(vad);
+	}
+
+	if (!json_path || !json_path[0]) {
+		WriteJson(stdout, calls, kernels, results, all_exact);
+		return all_exact;
+	}
+	FILE* file = fopen(json_path, "w");
+	if (!file) {
+		RTC_LOG(LS_ERROR) << "Can not write " << json_path;
+		return false;
+	}
+	WriteJson(file, calls, kernels, results, all_exact);
+	fclose(file);
+	printf("calls=%d json=%s\n", calls, json_path);
+	printf("module\tkernel\tpath\tns/call\tspeedup\tbit-exact\n");
+	for (size_t k = 0; k < kernels.size(); ++k) {
+		for (int p = 0; p < kNumPaths; ++p) {
+			const PathResult& result = results[k][p];
+			if (result.run) {
+				printf("%s\t%s\t%s\t%.1f\t%.2f\t%s\n", kernels[k].module,
+					kernels[k].name, kPathNames[p], result.ns_per_call, result.speedup,
+					result.exact ? "yes" : "NO");
+			}
+		}
+	}
+	return all_exact;
+}
+
+#else
+
+bool RunDspBenchmark(int calls, const char* json_path) {
+	printf("The DSP benchmark needs an x86 CPU\n");
+	return true;
+}
+
+#endif  // WEBRTC_ARCH_X86_FAMILY
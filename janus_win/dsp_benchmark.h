@@ -0,0 +1,11 @@
+#pragma once
+
+// Runs every dispatched kernel of the vendored audio DSP code (SPL, the
+// fractional and by-2 resamplers, VAD, fixed-point noise suppression and the
+// legacy digital AGC) on the C path and on each SIMD path the CPU supports,
+// over a deterministic corpus. Writes the ns per call, samples per second,
+// speedup over C and output hash of every path as JSON to |json_path|, or to
+// stdout when it is empty. |calls| is the number of calls per measurement.
+// Returns false when a path is not bit exact with C or the JSON can not be
+// written, so a CI run can fail on it.
+bool RunDspBenchmark(int calls, const char* json_path);
@@ -0,0 +1,206 @@
+#include "fft_benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <complex>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "common_audio/real_fourier.h"
+#include "common_audio/real_fourier_factory.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "common_audio/signal_processing/include/real_fft.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "common_audio/real_fourier_avx2.h"
+#endif
+
+namespace {
+
+const int kMinOrder = 6;
+const int kMaxOrder = 10;
+const int kRounds = 3;
+
+// Fixed-point inputs use this much of the int16 range.
+const float kFixedScale = 8192.0f;
+
+struct FftResult {
+	double forward_ns = 0;
+	double inverse_ns = 0;
+	double error = 0;
+	double round_trip_error = 0;
+};
+
+// A few tones plus noise, within [-1, 1].
+std::vector<float> MakeInput(size_t length) {
+	std::mt19937 rng(static_cast<unsigned>(length));
+	std::uniform_real_distribution<float> noise(-0.05f, 0.05f);
+	std::vector<float> input(length);
+	for (size_t i = 0; i < length; ++i) {
+		double t = static_cast<double>(i) / length;
+		input[i] = static_cast<float>(0.5 * sin(2 * M_PI * 3 * t) +
+			0.25 * cos(2 * M_PI * 17.5 * t) + 0.1 * sin(2 * M_PI * 0.4 * length * t)) +
+			noise(rng);
+	}
+	return input;
+}
+
+// Largest |ref - scale * test| relative to the largest |ref|. With
+// |fit_scale|, the scale is the least squares fit, for outputs whose scaling
+// depends on the signal.
+double MaxError(const float* ref, const float* test, size_t length,
+	bool fit_scale) {
+	double scale = 1.0;
+	if (fit_scale) {
+		double cross = 0, energy = 0;
+		for (size_t i = 0; i < length; ++i) {
+			cross += static_cast<double>(ref[i]) * test[i];
+			energy += static_cast<double>(test[i]) * test[i];
+		}
+		scale = energy > 0 ? cross / energy : 0;
+	}
+	double peak = 0, error = 0;
+	for (size_t i = 0; i < length; ++i) {
+		peak = std::max(peak, fabs(static_cast<double>(ref[i])));
+		error = std::max(error, fabs(ref[i] - scale * test[i]));
+	}
+	return peak > 0 ? error / peak : error;
+}
+
+// Best of a few rounds of |iterations| calls of |transform|, in nanoseconds
+// per call.
+template <typename Transform>
+double Time(int iterations, const Transform& transform) {
+	int64_t best_us = INT64_MAX;
+	for (int round = 0; round < kRounds; ++round) {
+		int64_t start_us = rtc::TimeMicros();
+		for (int i = 0; i < iterations; ++i) {
+			transform();
+		}
+		best_us = std::min(best_us, rtc::TimeMicros() - start_us);
+	}
+	return best_us * 1000.0 / iterations;
+}
+
+FftResult RunFloat(const webrtc::RealFourier& fft, int iterations,
+	const std::vector<float>& input, const std::vector<std::complex<float>>& reference) {
+	const int order = fft.order();
+	const size_t length = webrtc::RealFourier::FftLength(order);
+	const size_t complex_length = webrtc::RealFourier::ComplexLength(order);
+	webrtc::RealFourier::fft_real_scoper real =
+		webrtc::RealFourier::AllocRealBuffer(static_cast<int>(length));
+	webrtc::RealFourier::fft_cplx_scoper spectrum =
+		webrtc::RealFourier::AllocCplxBuffer(static_cast<int>(complex_length));
+	std::copy(input.begin(), input.end(), real.get());
+
+	FftResult result;
+	fft.Forward(real.get(), spectrum.get());
+	result.error = MaxError(reinterpret_cast<const float*>(reference.data()),
+		reinterpret_cast<const float*>(spectrum.get()), 2 * complex_length, false);
+	fft.Inverse(spectrum.get(), real.get());
+	result.round_trip_error = MaxError(input.data(), real.get(), length, false);
+
+	result.forward_ns = Time(iterations, [&] {
+		fft.Forward(real.get(), spectrum.get());
+	});
+	result.inverse_ns = Time(iterations, [&] {
+		fft.Inverse(spectrum.get(), real.get());
+	});
+	return result;
+}
+
+// The SPL FFT works on int16 with block floating point, so its output is
+// compared after fitting its scale.
+FftResult RunFixed(int order, int iterations, const std::vector<float>& input,
+	const std::vector<std::complex<float>>& reference) {
+	const size_t length = webrtc::RealFourier::FftLength(order);
+	std::vector<int16_t> real(length);
+	std::vector<int16_t> spectrum(length + 2);
+	for (size_t i = 0; i < length; ++i) {
+		real[i] = static_cast<int16_t>(lrintf(input[i] * kFixedScale));
+	}
+	RealFFT* fft = WebRtcSpl_CreateRealFFT(order);
+
+	FftResult result;
+	WebRtcSpl_RealForwardFFT(fft, real.data(), spectrum.data());
+	std::vector<float> output(spectrum.begin(), spectrum.end());
+	result.error = MaxError(reinterpret_cast<const float*>(reference.data()),
+		output.data(), length + 2, true);
+	std::vector<int16_t> round_trip(length);
+	WebRtcSpl_RealInverseFFT(fft, spectrum.data(), round_trip.data());
+	output.assign(round_trip.begin(), round_trip.end());
+	result.round_trip_error = MaxError(input.data(), output.data(), length, true);
+
+	result.forward_ns = Time(iterations, [&] {
+		WebRtcSpl_RealForwardFFT(fft, real.data(), spectrum.data());
+	});
+	result.inverse_ns = Time(iterations, [&] {
+		WebRtcSpl_RealInverseFFT(fft, spectrum.data(), round_trip.data());
+	});
+	WebRtcSpl_FreeRealFFT(fft);
+	return result;
+}
+
+void Print(size_t length, const char* backend, const FftResult& result) {
+	printf("%zu\t%s\t%.1f\t%.1f\t%.2e\t%.2e\n", length, backend,
+		result.forward_ns, result.inverse_ns, result.error,
+		result.round_trip_error);
+}
+
+}  // namespace
+
+void RunFftBenchmark(int iterations) {
+	iterations = std::max(iterations, 1);
+	WebRtcSpl_Init();
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+	const bool has_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
+#endif
+
+	printf("iterations=%d\n", iterations);
+	printf("points\tbackend\tforward ns\tinverse ns\tmax error\tround trip error\n");
+	for (int order = kMinOrder; order <= kMaxOrder; ++order) {
+		const size_t length = webrtc::RealFourier::FftLength(order);
+		std::vector<float> input = MakeInput(length);
+		std::unique_ptr<webrtc::RealFourier> ooura = webrtc::RealFourier::Create(order);
+
+		// Ooura is the reference the other backends are measured against.
+		std::vector<std::complex<float>> reference(
+			webrtc::RealFourier::ComplexLength(order));
+		webrtc::RealFourier::fft_real_scoper real =
+			webrtc::RealFourier::AllocRealBuffer(static_cast<int>(length));
+		webrtc::RealFourier::fft_cplx_scoper spectrum =
+			webrtc::RealFourier::AllocCplxBuffer(static_cast<int>(reference.size()));
+		std::copy(input.begin(), input.end(), real.get());
+		ooura->Forward(real.get(), spectrum.get());
+		std::copy(spectrum.get(), spectrum.get() + reference.size(), reference.begin());
+
+		Print(length, "Ooura", RunFloat(*ooura, iterations, input, reference));
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+		if (has_avx2) {
+			webrtc::RealFourierAVX2 avx2(order);
+			Print(length, "AVX2", RunFloat(avx2, iterations, input, reference));
+		}
+		else {
+			printf("%zu\tAVX2\t-\t-\t-\t-\n", length);
+		}
+#endif
+		Print(length, "SPL fixed", RunFixed(order, iterations, input, reference));
+	}
+
+	std::unique_ptr<webrtc::RealFourier> selected =
+		webrtc::CreateRealFourier(kMinOrder);
+	const bool picks_avx2 =
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+		dynamic_cast<webrtc::RealFourierAVX2*>(selected.get()) != nullptr;
+#else
+		false;
+#endif
+	printf("CreateRealFourier() picks %s for %d to %d points\n",
+		picks_avx2 ? "AVX2" : "Ooura", 1 << kMinOrder, 1 << kMaxOrder);
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+// Times |iterations| forward and inverse real FFTs of 64 to 1024 points on
+// each backend: Ooura (RealFourier::Create()), RealFourierAVX2 when the CPU
+// has AVX2, and the fixed-point SPL real FFT. Prints nanoseconds per
+// transform and the largest error of each backend against Ooura, relative to
+// the peak magnitude, plus which backend CreateRealFourier() picks.
+void RunFftBenchmark(int iterations);
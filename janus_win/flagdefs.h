@@ -35,4 +35,186 @@ DEFINE_bool(
     "the server without user intervention.  Note: this flag should only be set "
     "to true on one of the two clients.");
 
+DEFINE_int(capture_width, 1280, "Camera width to negotiate.");
+DEFINE_int(capture_height, 720, "Camera height to negotiate.");
+DEFINE_int(capture_fps, 18, "Camera frame rate to negotiate.");
+
+DEFINE_bool(synthetic_video,
+            false,
+            "Publish a generated pattern at the --capture_* size and rate "
+            "instead of the camera.");
+DEFINE_string(video_file,
+              "",
+              "Publish this 4:2:0 Y4M file in a loop instead of the camera.");
+
+DEFINE_bool(headless_audio,
+            false,
+            "Use a file or sine wave instead of the microphone and discard "
+            "playout, no audio hardware is opened.");
+DEFINE_string(audio_file,
+              "",
+              "Loop this 16-bit WAV file instead of the microphone, implies "
+              "--headless_audio. The client exits if it cannot be read.");
+DEFINE_int(audio_sine_hz, 440, "Sine frequency when --audio_file is empty.");
+DEFINE_bool(audio_checksum_playout,
+            false,
+            "Log a running checksum of the played out audio.");
+
+DEFINE_bool(cpu_adaptation,
+            false,
+            "Lower the camera frame rate and resolution while the process "
+            "CPU or the encoder is overused.");
+
+DEFINE_bool(screen_share, false, "Publish the desktop as a second video track.");
+DEFINE_int(screen_share_window,
+           0,
+           "Publish the window with this id instead of the desktop.");
+DEFINE_int(screen_share_fps, 5, "Screen capture frame rate.");
+DEFINE_bool(screen_share_cursor, true, "Paint the cursor into the screen track.");
+
+DEFINE_int(render_workers,
+           0,
+           "Convert and scale the tiles of each composed frame in parallel "
+           "on a pool of N workers. 0 converts them one after another on "
+           "the compositing thread.");
+DEFINE_bool(render_pin_cores, false, "Pin each render worker to one core.");
+DEFINE_int(render_stats_interval_s,
+           0,
+           "Log fps, freezes, jitter and conversion time of every tile every "
+           "N seconds. 0 disables.");
+DEFINE_string(frame_dump_dir,
+              "",
+              "Directory that receives every remote video track as rotating "
+              "Y4M files. Empty disables.");
+DEFINE_int(frame_dump_max_mb, 512, "Maximum size of one Y4M dump file.");
+DEFINE_int(frame_dump_files, 4, "Number of Y4M dump files kept per track.");
+DEFINE_string(join_records_file,
+              "",
+              "File that receives the join latency waterfall of every handle "
+              "as JSON lines. Empty only logs them.");
+DEFINE_string(trace_file,
+              "",
+              "File that receives a Chrome trace (chrome://tracing) of the "
+              "signaling, render and WebRTC trace events. Recording starts at "
+              "launch; F9 in the client stops it and writes the file, or "
+              "starts a new trace. Empty disables.");
+DEFINE_string(trace_categories,
+              "*",
+              "Comma separated trace categories to record, e.g. "
+              "\"janus,render,webrtc\". \"*\" records all but the "
+              "disabled-by-default ones.");
+DEFINE_int(trace_buffer_events,
+           65536,
+           "Number of trace events kept; older ones are overwritten.");
+
+// Headless renderer benchmark, see headless_main.cc.
+DEFINE_int(render_bench_tiles,
+           0,
+           "Benchmark the headless compositor with 1..N tiles (e.g. 16). "
+           "0 disables.");
+DEFINE_int(render_bench_frames, 300, "Composites per tile count.");
+DEFINE_string(composite_dump_dir,
+              "",
+              "Directory that receives sampled composites as PPM files.");
+DEFINE_int(composite_dump_interval,
+           0,
+           "Write every Nth composite to --composite_dump_dir. 0 disables.");
+DEFINE_int(screen_bench_seconds,
+           0,
+           "Benchmark screen capture for N seconds using the --screen_share_* "
+           "flags. 0 disables.");
+DEFINE_int(spl_bench_iterations,
+           0,
+           "Benchmark the C, SSE2 and AVX2 paths of the SPL kernels with N "
+           "calls per measurement (e.g. 2000). 0 disables.");
+DEFINE_int(spl_bench_samples, 480, "Vector length of the SPL benchmark.");
+DEFINE_int(nsx_bench_frames,
+           0,
+           "Benchmark the C, SSE2 and AVX2 paths of the fixed-point noise "
+           "suppressor over N 10 ms frames (e.g. 3000). 0 disables.");
+DEFINE_int(isac_bench_seconds,
+           0,
+           "Benchmark the C, SSE4.1 and AVX2 paths of the fixed-point iSAC "
+           "codec on N seconds of audio (e.g. 20). 0 disables.");
+DEFINE_int(vad_bench_frames,
+           0,
+           "Benchmark per-channel and batched VAD on 1 to 64 channels over N "
+           "10 ms frames (e.g. 1000). 0 disables.");
+DEFINE_int(ilbc_bench_seconds,
+           0,
+           "Benchmark the C, SSE2 and AVX2 paths of the iLBC encoder on N "
+           "seconds of audio in 20 and 30 ms modes (e.g. 60). 0 disables.");
+DEFINE_int(resample_bench_seconds,
+           0,
+           "Benchmark the C, SSE2 and AVX2 paths of the 48 <-> 16 kHz and "
+           "48 <-> 8 kHz resamplers on N seconds of audio (e.g. 60). 0 "
+           "disables.");
+DEFINE_int(agc_bench_frames,
+           0,
+           "Benchmark the C, SSE2 and AVX2 paths of the legacy digital AGC "
+           "over N 10 ms frames (e.g. 3000). 0 disables.");
+DEFINE_int(fft_bench_iterations,
+           0,
+           "Benchmark the Ooura, AVX2 and fixed-point real FFTs of 64 to 1024 "
+           "points with N transforms per measurement (e.g. 20000). 0 "
+           "disables.");
+DEFINE_int(dsp_bench_calls,
+           0,
+           "Check the C, SSE2 and AVX2 paths of every dispatched SPL, VAD, NS "
+           "and AGC kernel for bit exactness and time them with N calls per "
+           "measurement (e.g. 2000). Exits with 1 on a mismatch. 0 disables.");
+DEFINE_string(dsp_bench_json,
+              "",
+              "File the --dsp_bench_calls results are written to as JSON. "
+              "Empty writes them to stdout.");
+DEFINE_int(mock_janus_port,
+           0,
+           "Serve a local mock Janus videoroom gateway on this port until "
+           "killed, for offline signaling benchmarks. 0 disables.");
+DEFINE_int(mock_janus_delay_ms,
+           0,
+           "Delay of every reply of the mock Janus gateway.");
+DEFINE_int(mock_janus_jitter_ms,
+           0,
+           "Random extra delay of up to N ms per reply of the mock Janus "
+           "gateway.");
+DEFINE_int(signaling_load_sessions,
+           0,
+           "Drive N concurrent Janus sessions through join/leave churn and "
+           "report messages/s, transaction RTT and CPU per session. 0 "
+           "disables.");
+DEFINE_string(signaling_load_server,
+              "",
+              "Janus WebSocket address of the signaling load. Empty runs it "
+              "against an in-process mock Janus on --signaling_load_port, with "
+              "the --mock_janus_delay_ms and --mock_janus_jitter_ms delays.");
+DEFINE_int(signaling_load_port, 8188, "Port of the in-process mock Janus.");
+DEFINE_int(signaling_load_connections,
+           1,
+           "WebSocket connections the signaling load sessions share.");
+DEFINE_int(signaling_load_seconds, 10, "Duration of the signaling load.");
+DEFINE_int(signaling_load_hold_ms,
+           1000,
+           "Time a signaling load session stays published before it leaves "
+           "and starts over.");
+DEFINE_int(signaling_load_room_size,
+           4,
+           "Publishers per videoroom in the signaling load.");
+DEFINE_int(latency_bench_seconds,
+           0,
+           "Measure capture to render latency and frame loss of stamped "
+           "synthetic video for N seconds per codec and resolution. 0 "
+           "disables.");
+DEFINE_string(latency_bench_codecs,
+              "VP8,VP9,H264",
+              "Codecs of the latency benchmark.");
+DEFINE_string(latency_bench_resolutions,
+              "320x180,640x360,1280x720",
+              "Capture sizes of the latency benchmark, at least 160 wide.");
+DEFINE_int(latency_bench_fps, 30, "Frame rate of the latency benchmark.");
+DEFINE_string(latency_bench_janus,
+              "",
+              "Janus WebSocket address whose echotest plugin sends the video "
+              "back. Empty connects two PeerConnections in the process.");
+
 #endif  // EXAMPLES_PEERCONNECTION_CLIENT_FLAGDEFS_H_
@@ -0,0 +1,17 @@
+#include "frame_adaptation.h"
+
+#include "api/video/i420_buffer.h"
+
+rtc::scoped_refptr<webrtc::VideoFrameBuffer> AdaptFrameBuffer(
+	const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer,
+	const FrameAdaptation& adaptation,
+	webrtc::I420BufferPool* pool) {
+	if (adaptation.width == buffer->width() && adaptation.height == buffer->height()) {
+		return buffer;
+	}
+	rtc::scoped_refptr<webrtc::I420Buffer> scaled =
+		pool->CreateBuffer(adaptation.width, adaptation.height);
+	scaled->CropAndScaleFrom(*buffer->ToI420(), adaptation.crop_x, adaptation.crop_y,
+		adaptation.crop_width, adaptation.crop_height);
+	return scaled;
+}
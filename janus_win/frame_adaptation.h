@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "api/video/video_frame_buffer.h"
+#include "common_video/include/i420_buffer_pool.h"
+#include "rtc_base/scoped_ref_ptr.h"
+
+// Output of cricket::VideoCapturer::AdaptFrame(). Capturers that call
+// OnFrame() themselves have to apply it, the base class only broadcasts.
+struct FrameAdaptation {
+	int width = 0;
+	int height = 0;
+	int crop_width = 0;
+	int crop_height = 0;
+	int crop_x = 0;
+	int crop_y = 0;
+	int64_t timestamp_us = 0;
+};
+
+// Crops and scales |buffer| as |adaptation| says, into a buffer from |pool|.
+// Returns |buffer| itself when it already has the adapted size.
+rtc::scoped_refptr<webrtc::VideoFrameBuffer> AdaptFrameBuffer(
+	const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer,
+	const FrameAdaptation& adaptation,
+	webrtc::I420BufferPool* pool);
@@ -0,0 +1,80 @@
+#include "frame_stamp.h"
+
+#include "third_party/libyuv/include/libyuv/planar_functions.h"
+
+namespace {
+
+const int kChecksumBits = 4;
+const int kCells = kFrameStampBits + kChecksumBits;
+const int kBlack = 16;
+const int kWhite = 235;
+
+uint32_t Checksum(uint32_t stamp) {
+	uint32_t sum = 0;
+	for (int shift = 0; shift < kFrameStampBits; shift += kChecksumBits) {
+		sum += (stamp >> shift) & 0xf;
+	}
+	return sum & 0xf;
+}
+
+// Cell geometry, even so that the chroma planes line up.
+void CellSize(int width, int height, int* cell_width, int* band_height) {
+	*cell_width = (width / kCells) & ~1;
+	*band_height = (height / 10) & ~1;
+	if (*band_height < 8) {
+		*band_height = 8;
+	}
+}
+
+}  // namespace
+
+void StampFrame(webrtc::I420Buffer* buffer, uint32_t stamp) {
+	int cell_width;
+	int band_height;
+	CellSize(buffer->width(), buffer->height(), &cell_width, &band_height);
+	if (buffer->width() < kFrameStampMinWidth || band_height > buffer->height()) {
+		return;
+	}
+	stamp &= (1u << kFrameStampBits) - 1;
+	uint32_t code = (stamp << kChecksumBits) | Checksum(stamp);
+	for (int cell = 0; cell < kCells; ++cell) {
+		bool bit = (code >> (kCells - 1 - cell)) & 1;
+		libyuv::I420Rect(buffer->MutableDataY(), buffer->StrideY(),
+			buffer->MutableDataU(), buffer->StrideU(),
+			buffer->MutableDataV(), buffer->StrideV(),
+			cell * cell_width, 0, cell_width, band_height,
+			bit ? kWhite : kBlack, 128, 128);
+	}
+}
+
+bool ReadFrameStamp(const uint8_t* argb, int stride, int width, int height,
+	uint32_t* stamp) {
+	int cell_width;
+	int band_height;
+	CellSize(width, height, &cell_width, &band_height);
+	if (width < kFrameStampMinWidth || band_height > height) {
+		return false;
+	}
+	// Only the middle of each cell, its edges are smeared by the codec.
+	uint32_t code = 0;
+	for (int cell = 0; cell < kCells; ++cell) {
+		int x0 = cell * cell_width + cell_width / 4;
+		int x1 = cell * cell_width + cell_width * 3 / 4;
+		int sum = 0;
+		int count = 0;
+		for (int y = band_height / 4; y < band_height * 3 / 4; ++y) {
+			const uint8_t* row = argb + y * stride;
+			for (int x = x0; x < x1; ++x) {
+				sum += row[x * 4 + 1];  // green
+				count++;
+			}
+		}
+		code = (code << 1) | (count > 0 && sum / count >= 128 ? 1 : 0);
+	}
+	uint32_t value = code >> kChecksumBits;
+	if ((code & 0xf) != Checksum(value)) {
+		return false;
+	}
+	*stamp = value;
+	return true;
+}
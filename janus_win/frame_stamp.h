@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "api/video/i420_buffer.h"
+
+// A 16-bit frame counter drawn into the top band of a frame as 20 black or
+// white cells: 16 data bits and a 4-bit checksum, most significant first.
+// The cells scale with the frame and cover many macroblocks, so the counter
+// survives encoding at any bitrate and resizing by the sender's adapter, and
+// the checksum rejects frames where it did not. Frames need at least
+// kFrameStampMinWidth columns.
+const int kFrameStampBits = 16;
+const int kFrameStampMinWidth = 160;
+
+// Draws |stamp| modulo 2^16 over the top rows of |buffer|.
+void StampFrame(webrtc::I420Buffer* buffer, uint32_t stamp);
+
+// Recovers the stamp of a frame rendered to |width| x |height| ARGB pixels.
+// False if the frame is too small or the checksum does not match.
+bool ReadFrameStamp(const uint8_t* argb, int stride, int width, int height,
+	uint32_t* stamp);
@@ -0,0 +1,137 @@
+#include "frame_worker_pool.h"
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#elif defined(WEBRTC_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread_types.h"
+
+namespace {
+
+void PinCurrentThreadToCore(int index) {
+	unsigned int cores = std::thread::hardware_concurrency();
+	int core = cores > 0 ? index % static_cast<int>(cores) : index;
+#if defined(WEBRTC_WIN)
+	if (::SetThreadAffinityMask(::GetCurrentThread(),
+		static_cast<DWORD_PTR>(1) << core) == 0) {
+		RTC_LOG(LS_WARNING) << "Failed to pin frame worker to core " << core;
+	}
+#elif defined(WEBRTC_LINUX)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(core, &set);
+	if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+		RTC_LOG(LS_WARNING) << "Failed to pin frame worker to core " << core;
+	}
+#else
+	RTC_LOG(LS_WARNING) << "Core pinning is not supported on this platform";
+#endif
+}
+
+}  // namespace
+
+FrameWorkerPool::FrameWorkerPool(int num_workers, bool pin_to_cores)
+	: queued_(0) {
+	RTC_DCHECK_GT(num_workers, 0);
+	for (int i = 0; i < num_workers; ++i) {
+		workers_.emplace_back(new Worker());
+	}
+	for (int i = 0; i < num_workers; ++i) {
+		workers_[i]->thread = std::thread([this, i, pin_to_cores]() {
+			Run(i, pin_to_cores);
+		});
+	}
+}
+
+FrameWorkerPool::~FrameWorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(wait_mutex_);
+		stopping_ = true;
+	}
+	work_cv_.notify_all();
+	for (auto& worker : workers_) {
+		if (worker->thread.joinable()) {
+			worker->thread.join();
+		}
+	}
+}
+
+void FrameWorkerPool::PostTask(int hint, std::function<void()> task) {
+	{
+		std::lock_guard<std::mutex> lock(wait_mutex_);
+		pending_++;
+	}
+	Worker* worker = workers_[static_cast<unsigned int>(hint) % workers_.size()].get();
+	{
+		rtc::CritScope cs(&worker->lock);
+		worker->tasks.push_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(wait_mutex_);
+		queued_++;
+	}
+	work_cv_.notify_one();
+}
+
+void FrameWorkerPool::WaitIdle() {
+	std::unique_lock<std::mutex> lock(wait_mutex_);
+	idle_cv_.wait(lock, [this]() { return pending_ == 0; });
+}
+
+bool FrameWorkerPool::PopOrSteal(int index, std::function<void()>* task) {
+	if (queued_ == 0) {
+		return false;
+	}
+	{
+		Worker* own = workers_[index].get();
+		rtc::CritScope cs(&own->lock);
+		if (!own->tasks.empty()) {
+			*task = std::move(own->tasks.back());
+			own->tasks.pop_back();
+			queued_--;
+			return true;
+		}
+	}
+	for (size_t i = 1; i < workers_.size(); ++i) {
+		Worker* victim = workers_[(index + i) % workers_.size()].get();
+		rtc::CritScope cs(&victim->lock);
+		if (!victim->tasks.empty()) {
+			*task = std::move(victim->tasks.front());
+			victim->tasks.pop_front();
+			queued_--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void FrameWorkerPool::Run(int index, bool pin_to_cores) {
+	rtc::SetCurrentThreadName("FrameWorker");
+	if (pin_to_cores) {
+		PinCurrentThreadToCore(index);
+	}
+
+	std::function<void()> task;
+	for (;;) {
+		if (PopOrSteal(index, &task)) {
+			task();
+			task = nullptr;
+			std::lock_guard<std::mutex> lock(wait_mutex_);
+			if (--pending_ == 0) {
+				idle_cv_.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wait_mutex_);
+		work_cv_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+		if (stopping_ && queued_ == 0) {
+			return;
+		}
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rtc_base/criticalsection.h"
+
+// Small work-stealing pool for per-tile frame conversion (rotation, scaling
+// and ARGB conversion). Every worker owns a deque: tasks are posted to the
+// worker picked by a hint (the tile), the owner pops from the back and idle
+// workers steal from the front of their siblings.
+class FrameWorkerPool {
+public:
+	// |pin_to_cores| pins worker i to core i modulo the number of cores.
+	FrameWorkerPool(int num_workers, bool pin_to_cores);
+	~FrameWorkerPool();
+
+	int num_workers() const { return static_cast<int>(workers_.size()); }
+
+	void PostTask(int hint, std::function<void()> task);
+
+	// Blocks until every posted task has run.
+	void WaitIdle();
+
+private:
+	struct Worker {
+		rtc::CriticalSection lock;
+		std::deque<std::function<void()>> tasks;
+		std::thread thread;
+	};
+
+	void Run(int index, bool pin_to_cores);
+	bool PopOrSteal(int index, std::function<void()>* task);
+
+	std::vector<std::unique_ptr<Worker>> workers_;
+	std::mutex wait_mutex_;
+	std::condition_variable work_cv_;
+	std::condition_variable idle_cv_;
+	std::atomic<int> queued_;//posted but not yet picked up
+	int pending_ = 0;//posted but not yet finished, guarded by wait_mutex_
+	bool stopping_ = false;//guarded by wait_mutex_
+};
@@ -0,0 +1,40 @@
+#include "gdi_render_backend.h"
+
+#if defined(WEBRTC_WIN)
+
+GdiRenderBackend::GdiRenderBackend(HWND wnd) : wnd_(wnd) {
+}
+
+void GdiRenderBackend::OnFrameAvailable(VideoRenderer* renderer) {
+	InvalidateRect(wnd_, NULL, TRUE);
+}
+
+void GdiRenderBackend::Draw(PAINTSTRUCT& ps, RECT& rc, const std::vector<VideoRenderer*>& renderers) {
+	int width = rc.right - rc.left;
+	int height = rc.bottom - rc.top;
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+	if (width != surface_width_ || height != surface_height_) {
+		surface_.reset(new uint8_t[width * height * 4]);
+		surface_width_ = width;
+		surface_height_ = height;
+	}
+
+	ComposeTiles(renderers, worker_pool(), surface_.get(), width * 4, width, height);
+
+	BITMAPINFO bmi;
+	ZeroMemory(&bmi, sizeof(bmi));
+	bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bmi.bmiHeader.biPlanes = 1;
+	bmi.bmiHeader.biBitCount = 32;
+	bmi.bmiHeader.biCompression = BI_RGB;
+	bmi.bmiHeader.biWidth = width;
+	bmi.bmiHeader.biHeight = -height;
+	bmi.bmiHeader.biSizeImage = width * height * 4;
+
+	::SetDIBitsToDevice(ps.hdc, rc.left, rc.top, width, height, 0, 0, 0, height,
+		surface_.get(), &bmi, DIB_RGB_COLORS);
+}
+
+#endif  // WEBRTC_WIN
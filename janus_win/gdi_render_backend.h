@@ -0,0 +1,31 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "video_renderer.h"
+#if defined(WEBRTC_WIN)
+#include "rtc_base/win32.h"
+#endif  // WEBRTC_WIN
+
+#if defined(WEBRTC_WIN)
+
+// Win32 backend: invalidates the main window on every frame and, on
+// WM_PAINT, composes the visible tiles into a window-sized ARGB surface that
+// is copied to the window in a single blit.
+class GdiRenderBackend : public VideoRenderBackend {
+public:
+	explicit GdiRenderBackend(HWND wnd);
+
+	void OnFrameAvailable(VideoRenderer* renderer) override;
+
+	void Draw(PAINTSTRUCT& ps, RECT& rc, const std::vector<VideoRenderer*>& renderers);
+
+private:
+	HWND wnd_;
+	std::unique_ptr<uint8_t[]> surface_;
+	int surface_width_ = 0;
+	int surface_height_ = 0;
+};
+
+#endif  // WEBRTC_WIN
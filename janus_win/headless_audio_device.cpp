@@ -0,0 +1,178 @@
+#include "headless_audio_device.h"
+
+#include <stdio.h>
+
+#include <memory>
+
+#include "api/audio/audio_frame.h"
+#include "common_audio/wav_file.h"
+#include "common_audio/wav_header.h"
+#include "modules/audio_device/include/test_audio_device.h"
+#include "modules/audio_mixer/sine_wave_generator.h"
+#include "rtc_base/logging.h"
+
+namespace {
+
+const int16_t kSineAmplitude = 8000;
+const int kChecksumLogIntervalFrames = 500;//5 s
+
+class SineWaveCapturer : public webrtc::TestAudioDeviceModule::Capturer {
+public:
+	SineWaveCapturer(float frequency_hz, int sample_rate_hz, int channels)
+		: generator_(frequency_hz, kSineAmplitude),
+		sample_rate_hz_(sample_rate_hz),
+		channels_(channels) {
+	}
+
+	int SamplingFrequency() const override { return sample_rate_hz_; }
+	int NumChannels() const override { return channels_; }
+
+	bool Capture(rtc::BufferT<int16_t>* buffer) override {
+		frame_.sample_rate_hz_ = sample_rate_hz_;
+		frame_.num_channels_ = channels_;
+		frame_.samples_per_channel_ =
+			webrtc::TestAudioDeviceModule::SamplesPerFrame(sample_rate_hz_);
+		generator_.GenerateNextFrame(&frame_);
+		buffer->SetData(frame_.data(), frame_.samples_per_channel_ * channels_);
+		return true;
+	}
+
+private:
+	webrtc::SineWaveGenerator generator_;
+	const int sample_rate_hz_;
+	const int channels_;
+	webrtc::AudioFrame frame_;
+};
+
+// Restarts the file at its end, so a short clip can feed a long run.
+class LoopingWavCapturer : public webrtc::TestAudioDeviceModule::Capturer {
+public:
+	explicit LoopingWavCapturer(const std::string& path)
+		: path_(path), reader_(new webrtc::WavReader(path)) {
+	}
+
+	int SamplingFrequency() const override { return reader_->sample_rate(); }
+	int NumChannels() const override { return static_cast<int>(reader_->num_channels()); }
+
+	bool Capture(rtc::BufferT<int16_t>* buffer) override {
+		size_t wanted = webrtc::TestAudioDeviceModule::SamplesPerFrame(
+			reader_->sample_rate()) * reader_->num_channels();
+		buffer->SetSize(wanted);
+		size_t read = reader_->ReadSamples(wanted, buffer->data());
+		if (read < wanted) {
+			reader_.reset(new webrtc::WavReader(path_));
+			read += reader_->ReadSamples(wanted - read, buffer->data() + read);
+		}
+		return read == wanted;
+	}
+
+private:
+	const std::string path_;
+	std::unique_ptr<webrtc::WavReader> reader_;
+};
+
+class ReadableWavFile : public webrtc::ReadableWav {
+public:
+	explicit ReadableWavFile(FILE* file) : file_(file) {}
+	size_t Read(void* buf, size_t num_bytes) override {
+		return fread(buf, 1, num_bytes, file_);
+	}
+
+private:
+	FILE* file_;
+};
+
+// FNV-1a over the played out samples.
+class ChecksumRenderer : public webrtc::TestAudioDeviceModule::Renderer {
+public:
+	ChecksumRenderer(int sample_rate_hz, int channels)
+		: sample_rate_hz_(sample_rate_hz), channels_(channels) {
+	}
+	~ChecksumRenderer() override { Log(); }
+
+	int SamplingFrequency() const override { return sample_rate_hz_; }
+	int NumChannels() const override { return channels_; }
+
+	bool Render(rtc::ArrayView<const int16_t> data) override {
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+		for (size_t i = 0; i < data.size() * sizeof(int16_t); ++i) {
+			checksum_ = (checksum_ ^ bytes[i]) * 1099511628211ULL;
+		}
+		if (++frames_ % kChecksumLogIntervalFrames == 0) {
+			Log();
+		}
+		return true;
+	}
+
+private:
+	void Log() const {
+		char hex[17];
+		snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(checksum_));
+		RTC_LOG(INFO) << "Playout checksum after " << frames_ << " frames: " << hex;
+	}
+
+	const int sample_rate_hz_;
+	const int channels_;
+	uint64_t checksum_ = 14695981039346656037ULL;
+	int64_t frames_ = 0;
+};
+
+}  // namespace
+
+rtc::scoped_refptr<webrtc::AudioDeviceModule> CreateHeadlessAudioDevice(
+	const HeadlessAudioOptions& options) {
+	std::unique_ptr<webrtc::TestAudioDeviceModule::Capturer> capturer;
+	if (!options.wav_path.empty()) {
+		std::string error;
+		if (!CheckLoopableWav(options.wav_path, &error)) {
+			RTC_LOG(LS_ERROR) << error;
+			return nullptr;
+		}
+		capturer.reset(new LoopingWavCapturer(options.wav_path));
+	}
+	else {
+		capturer.reset(new SineWaveCapturer(options.sine_hz, options.sample_rate_hz,
+			options.channels));
+	}
+
+	std::unique_ptr<webrtc::TestAudioDeviceModule::Renderer> renderer;
+	if (options.checksum_playout) {
+		renderer.reset(new ChecksumRenderer(options.sample_rate_hz, options.channels));
+	}
+	else {
+		renderer = webrtc::TestAudioDeviceModule::CreateDiscardRenderer(
+			options.sample_rate_hz, options.channels);
+	}
+	return webrtc::TestAudioDeviceModule::CreateTestAudioDeviceModule(
+		std::move(capturer), std::move(renderer));
+}
+
+bool CheckLoopableWav(const std::string& path, std::string* error) {
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file) {
+		*error = "Cannot open " + path;
+		return false;
+	}
+	ReadableWavFile readable(file);
+	size_t num_channels = 0;
+	int sample_rate = 0;
+	webrtc::WavFormat format;
+	size_t bytes_per_sample = 0;
+	size_t num_samples = 0;
+	bool valid = webrtc::ReadWavHeader(&readable, &num_channels, &sample_rate, &format,
+		&bytes_per_sample, &num_samples);
+	fclose(file);
+	if (!valid) {
+		*error = path + " is not a WAV file";
+		return false;
+	}
+	if (format != webrtc::kWavFormatPcm || bytes_per_sample != 2) {
+		*error = path + " is not 16-bit PCM";
+		return false;
+	}
+	if (num_samples == 0) {
+		*error = path + " holds no audio";
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "modules/audio_device/include/audio_device.h"
+#include "rtc_base/scoped_ref_ptr.h"
+
+struct HeadlessAudioOptions {
+	std::string wav_path;//empty: sine wave
+	float sine_hz = 440.f;
+	int sample_rate_hz = 48000;
+	int channels = 1;
+	bool checksum_playout = false;//false: playout is discarded
+};
+
+// Audio device for bots and headless machines, no sound card is opened.
+// Recording loops a 16-bit WAV file (at the file's rate and channel count)
+// or generates a sine wave. Playout is discarded or folded into a running
+// checksum that is logged every few seconds, so received audio can be
+// compared across runs. Both directions run on the 10 ms clock of
+// TestAudioDeviceModule, so many instances can share one process.
+// Returns null if the WAV file cannot be looped, see CheckLoopableWav().
+rtc::scoped_refptr<webrtc::AudioDeviceModule> CreateHeadlessAudioDevice(
+	const HeadlessAudioOptions& options);
+
+// True if |path| opens as a non-empty 16-bit PCM WAV file; otherwise
+// |error| says why. WavReader aborts the process on anything else, so callers
+// check the file before they rely on it.
+bool CheckLoopableWav(const std::string& path, std::string* error);
@@ -0,0 +1,146 @@
+// Console entry point without MainWnd, for benchmarks on Windows machines
+// that have no interactive desktop, such as build agents. Shares the flags of
+// the client. Built by janus_headless.vcxproj together with the benchmarks,
+// the mock gateway and the load generator, none of which the client links.
+// Like the client it is Windows only: there is no Linux build of either.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "agc_benchmark.h"
+#include "dsp_benchmark.h"
+#include "fft_benchmark.h"
+#include "flagdefs.h"
+#include "ilbc_benchmark.h"
+#include "isac_benchmark.h"
+#include "latency_benchmark.h"
+#include "mock_janus.h"
+#include "nsx_benchmark.h"
+#include "render_benchmark.h"
+#include "resample_benchmark.h"
+#include "screen_benchmark.h"
+#include "signaling_load.h"
+#include "spl_benchmark.h"
+#include "trace_recorder.h"
+#include "vad_benchmark.h"
+#include "rtc_base/flags.h"
+
+static void WriteTraceAtExit() {
+  FinishTracing();
+}
+
+int main(int argc, char* argv[]) {
+  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+  if (FLAG_help) {
+    rtc::FlagList::Print(NULL, false);
+    return 0;
+  }
+
+  if (strlen(FLAG_trace_file) > 0) {
+    InstallTraceRecorder(FLAG_trace_file, FLAG_trace_categories,
+                         static_cast<size_t>(FLAG_trace_buffer_events));
+    StartTracing();
+    atexit(WriteTraceAtExit);
+  }
+
+  if (FLAG_render_bench_tiles > 0) {
+    RenderBenchmarkConfig config;
+    config.max_tiles = FLAG_render_bench_tiles;
+    config.frames = FLAG_render_bench_frames;
+    config.dump_dir = FLAG_composite_dump_dir;
+    config.dump_interval = FLAG_composite_dump_interval;
+    config.workers = FLAG_render_workers;
+    config.pin_cores = FLAG_render_pin_cores;
+    RunRenderBenchmark(config);
+    return 0;
+  }
+
+  if (FLAG_screen_bench_seconds > 0) {
+    ScreenShareOptions options;
+    options.window_id = FLAG_screen_share_window;
+    options.fps = FLAG_screen_share_fps;
+    options.cursor = FLAG_screen_share_cursor;
+    RunScreenBenchmark(options, FLAG_screen_bench_seconds);
+    return 0;
+  }
+
+  if (FLAG_spl_bench_iterations > 0) {
+    RunSplBenchmark(FLAG_spl_bench_samples, FLAG_spl_bench_iterations);
+    return 0;
+  }
+
+  if (FLAG_nsx_bench_frames > 0) {
+    RunNsxBenchmark(FLAG_nsx_bench_frames);
+    return 0;
+  }
+
+  if (FLAG_isac_bench_seconds > 0) {
+    RunIsacBenchmark(FLAG_isac_bench_seconds);
+    return 0;
+  }
+
+  if (FLAG_vad_bench_frames > 0) {
+    RunVadBenchmark(FLAG_vad_bench_frames);
+    return 0;
+  }
+
+  if (FLAG_ilbc_bench_seconds > 0) {
+    RunIlbcBenchmark(FLAG_ilbc_bench_seconds);
+    return 0;
+  }
+
+  if (FLAG_resample_bench_seconds > 0) {
+    RunResampleBenchmark(FLAG_resample_bench_seconds);
+    return 0;
+  }
+
+  if (FLAG_agc_bench_frames > 0) {
+    RunAgcBenchmark(FLAG_agc_bench_frames);
+    return 0;
+  }
+
+  if (FLAG_fft_bench_iterations > 0) {
+    RunFftBenchmark(FLAG_fft_bench_iterations);
+    return 0;
+  }
+
+  if (FLAG_dsp_bench_calls > 0) {
+    return RunDspBenchmark(FLAG_dsp_bench_calls, FLAG_dsp_bench_json) ? 0 : 1;
+  }
+
+  if (FLAG_mock_janus_port > 0) {
+    MockJanusOptions options;
+    options.port = FLAG_mock_janus_port;
+    options.delay_ms = FLAG_mock_janus_delay_ms;
+    options.jitter_ms = FLAG_mock_janus_jitter_ms;
+    return RunMockJanus(options) ? 0 : 1;
+  }
+
+  if (FLAG_signaling_load_sessions > 0) {
+    SignalingLoadOptions options;
+    options.server = FLAG_signaling_load_server;
+    options.mock.port = FLAG_signaling_load_port;
+    options.mock.delay_ms = FLAG_mock_janus_delay_ms;
+    options.mock.jitter_ms = FLAG_mock_janus_jitter_ms;
+    options.connections = FLAG_signaling_load_connections;
+    options.sessions = FLAG_signaling_load_sessions;
+    options.seconds = FLAG_signaling_load_seconds;
+    options.hold_ms = FLAG_signaling_load_hold_ms;
+    options.room_size = FLAG_signaling_load_room_size;
+    return RunSignalingLoad(options) ? 0 : 1;
+  }
+
+  if (FLAG_latency_bench_seconds > 0) {
+    LatencyBenchmarkConfig config;
+    config.janus_server = FLAG_latency_bench_janus;
+    config.codecs = FLAG_latency_bench_codecs;
+    config.resolutions = FLAG_latency_bench_resolutions;
+    config.fps = FLAG_latency_bench_fps;
+    config.seconds = FLAG_latency_bench_seconds;
+    return RunLatencyBenchmark(config) ? 0 : 1;
+  }
+
+  printf("Nothing to run, see --help.\n");
+  return 0;
+}
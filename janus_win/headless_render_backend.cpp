@@ -0,0 +1,61 @@
+#include "headless_render_backend.h"
+
+#include <stdio.h>
+
+#include "rtc_base/logging.h"
+#include "rtc_base/stringutils.h"
+
+using rtc::sprintfn;
+
+HeadlessRenderBackend::HeadlessRenderBackend(int width, int height)
+	: width_(width),
+	height_(height),
+	surface_(new uint8_t[width * height * 4]),
+	frames_received_(0) {
+}
+
+void HeadlessRenderBackend::OnFrameAvailable(VideoRenderer* renderer) {
+	frames_received_++;
+}
+
+void HeadlessRenderBackend::SetDumpOptions(const std::string& dir, int interval) {
+	dump_dir_ = dir;
+	dump_interval_ = interval;
+}
+
+void HeadlessRenderBackend::Compose(const std::vector<VideoRenderer*>& renderers) {
+	ComposeTiles(renderers, worker_pool(), surface_.get(), width_ * 4, width_,
+		height_);
+
+	if (dump_interval_ > 0 && !dump_dir_.empty() &&
+		frames_composed_ % dump_interval_ == 0) {
+		char name[64] = { 0 };
+		sprintfn(name, sizeof(name), "/composite_%06d.ppm",
+			static_cast<int>(frames_composed_));
+		if (!DumpSurface(dump_dir_ + name)) {
+			RTC_LOG(LS_WARNING) << "Failed to write composite to " << dump_dir_;
+		}
+	}
+	frames_composed_++;
+}
+
+bool HeadlessRenderBackend::DumpSurface(const std::string& path) const {
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	fprintf(file, "P6\n%d %d\n255\n", width_, height_);
+	// ARGB is stored as B, G, R, A in memory.
+	std::unique_ptr<uint8_t[]> row(new uint8_t[width_ * 3]);
+	for (int y = 0; y < height_; ++y) {
+		const uint8_t* src = surface_.get() + y * width_ * 4;
+		for (int x = 0; x < width_; ++x) {
+			row[x * 3 + 0] = src[x * 4 + 2];
+			row[x * 3 + 1] = src[x * 4 + 1];
+			row[x * 3 + 2] = src[x * 4 + 0];
+		}
+		fwrite(row.get(), 1, width_ * 3, file);
+	}
+	fclose(file);
+	return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "video_renderer.h"
+
+// Platform-neutral backend: composes the same tile grid as the GDI backend
+// into an in-memory ARGB surface. Composition is pulled by the caller, so it
+// can be driven from a benchmark loop without a window or message pump.
+class HeadlessRenderBackend : public VideoRenderBackend {
+public:
+	HeadlessRenderBackend(int width, int height);
+
+	void OnFrameAvailable(VideoRenderer* renderer) override;
+
+	// Writes every |interval|-th composite to |dir| as a binary PPM.
+	// An empty |dir| or |interval| <= 0 disables dumping.
+	void SetDumpOptions(const std::string& dir, int interval);
+
+	void Compose(const std::vector<VideoRenderer*>& renderers);
+
+	int width() const { return width_; }
+	int height() const { return height_; }
+	const uint8_t* surface() const { return surface_.get(); }
+	int64_t frames_received() const { return frames_received_; }
+	int64_t frames_composed() const { return frames_composed_; }
+
+private:
+	bool DumpSurface(const std::string& path) const;
+
+	int width_;
+	int height_;
+	std::unique_ptr<uint8_t[]> surface_;
+	std::string dump_dir_;
+	int dump_interval_ = 0;
+	std::atomic<int64_t> frames_received_;
+	int64_t frames_composed_ = 0;
+};
@@ -0,0 +1,173 @@
+#include "ilbc_benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "modules/audio_coding/codecs/ilbc/ilbc.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+namespace {
+
+enum IlbcPath { kPathC, kPathSSE2, kPathAVX2, kNumPaths };
+
+const char* const kPathNames[kNumPaths] = { "C", "SSE2", "AVX2" };
+
+const int kSampleRateHz = 8000;
+const int kModesMs[] = { 20, 30 };
+const size_t kMaxPayloadBytes = 50;
+
+// The encoder picks its codebook search kernels through WebRtc_GetCPUInfo
+// when it is initialized, so the benchmark swaps in this one to hide the
+// features above |g_max_path|.
+IlbcPath g_max_path = kPathC;
+WebRtc_CPUInfo g_cpu_info = nullptr;
+
+int CappedCPUInfo(CPUFeature feature) {
+	if (feature == kAVX2 && g_max_path < kPathAVX2) {
+		return 0;
+	}
+	if (feature == kSSE2 && g_max_path < kPathSSE2) {
+		return 0;
+	}
+	return g_cpu_info(feature);
+}
+
+// FNV-1a, compared against the C path.
+uint32_t Hash(const void* data, size_t bytes, uint32_t hash) {
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < bytes; ++i) {
+		hash = (hash ^ p[i]) * 16777619u;
+	}
+	return hash;
+}
+
+// Voiced bursts with a moving pitch over a noise floor.
+std::vector<int16_t> MakeInput(int seconds) {
+	std::mt19937 rng(1);
+	std::normal_distribution<double> noise(0.0, 200.0);
+	std::vector<int16_t> input(static_cast<size_t>(seconds) * kSampleRateHz);
+	double phase = 0;
+	for (size_t i = 0; i < input.size(); ++i) {
+		double t = static_cast<double>(i) / kSampleRateHz;
+		double pitch = 140 + 40 * sin(2 * M_PI * 0.5 * t);
+		phase += 2 * M_PI * pitch / kSampleRateHz;
+		double envelope = (i / 6000) % 3 == 2 ? 0.0 : 0.5 - 0.5 * cos(2 * M_PI * 2 * t);
+		double sample = 6000 * envelope * (sin(phase) + 0.5 * sin(3 * phase) +
+			0.25 * sin(5 * phase)) + noise(rng);
+		input[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, sample)));
+	}
+	return input;
+}
+
+struct IlbcRun {
+	int64_t encode_us = 0;
+	uint32_t hash = 2166136261u;
+	bool ok = true;
+};
+
+// Encodes |input| in |mode_ms| frames; only the encode calls are timed.
+IlbcRun Encode(const std::vector<int16_t>& input, int mode_ms) {
+	IlbcRun run;
+	IlbcEncoderInstance* encoder = nullptr;
+	if (WebRtcIlbcfix_EncoderCreate(&encoder) != 0 ||
+		WebRtcIlbcfix_EncoderInit(encoder, static_cast<int16_t>(mode_ms)) != 0) {
+		WebRtcIlbcfix_EncoderFree(encoder);
+		run.ok = false;
+		return run;
+	}
+
+	const size_t frame_length = static_cast<size_t>(mode_ms) * kSampleRateHz / 1000;
+	uint8_t payload[kMaxPayloadBytes];
+	for (size_t offset = 0; offset + frame_length <= input.size();
+		offset += frame_length) {
+		int64_t start_us = rtc::TimeMicros();
+		int bytes = WebRtcIlbcfix_Encode(encoder, &input[offset], frame_length,
+			payload);
+		run.encode_us += rtc::TimeMicros() - start_us;
+		if (bytes <= 0) {
+			run.ok = false;
+			break;
+		}
+		run.hash = Hash(payload, bytes, run.hash);
+	}
+
+	WebRtcIlbcfix_EncoderFree(encoder);
+	return run;
+}
+
+}  // namespace
+
+void RunIlbcBenchmark(int seconds) {
+	seconds = std::max(seconds, 1);
+	// The SPL pointers are set once per process; keep them on the best path
+	// so only the iLBC kernels differ between runs.
+	WebRtcSpl_Init();
+	g_cpu_info = WebRtc_GetCPUInfo;
+
+	bool supported[kNumPaths] = { true, g_cpu_info(kSSE2) != 0,
+		g_cpu_info(kAVX2) != 0 };
+	std::vector<int16_t> input = MakeInput(seconds);
+	const int kRounds = 3;
+
+	printf("seconds=%d\n", seconds);
+	printf("mode\tpath\tus/frame\treal-time factor\tch/core\tbit-exact\n");
+	for (int mode_ms : kModesMs) {
+		const int64_t frames = static_cast<int64_t>(seconds) * 1000 / mode_ms;
+		uint32_t reference = 0;
+		for (int path = 0; path < kNumPaths; ++path) {
+			if (!supported[path]) {
+				printf("%d ms\t%s\t-\t-\t-\t-\n", mode_ms, kPathNames[path]);
+				continue;
+			}
+			g_max_path = static_cast<IlbcPath>(path);
+			WebRtc_GetCPUInfo = CappedCPUInfo;
+			// Best of a few rounds, to keep interrupts and frequency ramps out.
+			int64_t best_us = INT64_MAX;
+			bool exact = true;
+			for (int round = 0; round < kRounds; ++round) {
+				IlbcRun run = Encode(input, mode_ms);
+				if (!run.ok) {
+					RTC_LOG(LS_ERROR) << "iLBC " << kPathNames[path] << " failed";
+					exact = false;
+					break;
+				}
+				best_us = std::min(best_us, run.encode_us);
+				if (path == kPathC && round == 0) {
+					reference = run.hash;
+				}
+				else if (run.hash != reference) {
+					exact = false;
+				}
+			}
+			WebRtc_GetCPUInfo = g_cpu_info;
+			if (!exact) {
+				RTC_LOG(LS_ERROR) << "iLBC " << kPathNames[path]
+					<< " differs from the C version";
+			}
+			// Encode time over audio time for one channel; its inverse is how
+			// many channels one core keeps up with.
+			double rtf = best_us / (seconds * 1e6);
+			printf("%d ms\t%s\t%.1f\t%.5f\t%.0f\t%s\n", mode_ms, kPathNames[path],
+				static_cast<double>(best_us) / frames, rtf,
+				rtf > 0 ? 1 / rtf : 0.0, exact ? "yes" : "NO");
+		}
+	}
+}
+
+#else
+
+void RunIlbcBenchmark(int seconds) {
+	printf("The iLBC benchmark needs an x86 CPU\n");
+}
+
+#endif  // WEBRTC_ARCH_X86_FAMILY
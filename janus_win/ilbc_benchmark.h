@@ -0,0 +1,7 @@
+#pragma once
+
+// Encodes |seconds| of synthetic 8 kHz speech with the iLBC encoder in its
+// 20 ms and 30 ms modes, once per x86 path the CPU supports (C, SSE2, AVX2),
+// and prints the real-time factor of one channel, the channels one core
+// could encode, and whether every path produced the same payloads as C.
+void RunIlbcBenchmark(int seconds);
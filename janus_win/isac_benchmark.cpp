@@ -0,0 +1,199 @@
+#include "isac_benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "modules/audio_coding/codecs/isac/fix/include/isacfix.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+namespace {
+
+enum IsacPath { kPathC, kPathSSE41, kPathAVX2, kNumPaths };
+
+const char* const kPathNames[kNumPaths] = { "C", "SSE4.1", "AVX2" };
+
+const int kSampleRateHz = 16000;
+const size_t kFrameLength = 160;  // 10 ms
+const size_t kMaxPayloadBytes = 400;
+const size_t kMaxDecodedSamples = 960;  // 60 ms
+
+// The encoder and decoder pick their kernels through WebRtc_GetCPUInfo when
+// they are initialized, so the benchmark swaps in this one to hide the
+// features above |g_max_path|.
+IsacPath g_max_path = kPathC;
+WebRtc_CPUInfo g_cpu_info = nullptr;
+
+int CappedCPUInfo(CPUFeature feature) {
+	if (feature == kAVX2 && g_max_path < kPathAVX2) {
+		return 0;
+	}
+	if (feature == kSSE4_1 && g_max_path < kPathSSE41) {
+		return 0;
+	}
+	return g_cpu_info(feature);
+}
+
+// FNV-1a, compared against the C path.
+uint32_t Hash(const void* data, size_t bytes, uint32_t hash) {
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < bytes; ++i) {
+		hash = (hash ^ p[i]) * 16777619u;
+	}
+	return hash;
+}
+
+// Voiced bursts with a moving pitch over a noise floor.
+std::vector<int16_t> MakeInput(int seconds) {
+	std::mt19937 rng(1);
+	std::normal_distribution<double> noise(0.0, 200.0);
+	std::vector<int16_t> input(static_cast<size_t>(seconds) * kSampleRateHz);
+	double phase = 0;
+	for (size_t i = 0; i < input.size(); ++i) {
+		double t = static_cast<double>(i) / kSampleRateHz;
+		double pitch = 140 + 40 * sin(2 * M_PI * 0.5 * t);
+		phase += 2 * M_PI * pitch / kSampleRateHz;
+		double envelope = (i / 12000) % 3 == 2 ? 0.0 : 0.5 - 0.5 * cos(2 * M_PI * 2 * t);
+		double sample = 6000 * envelope * (sin(phase) + 0.5 * sin(3 * phase) +
+			0.25 * sin(5 * phase)) + noise(rng);
+		input[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, sample)));
+	}
+	return input;
+}
+
+struct IsacRun {
+	int64_t encode_us = 0;
+	int64_t decode_us = 0;
+	uint32_t hash = 2166136261u;
+	bool ok = true;
+};
+
+// Encodes |input| in channel-independent mode at 32 kbps, 30 ms frames,
+// then decodes every payload. Both halves are timed separately.
+IsacRun EncodeDecode(const std::vector<int16_t>& input) {
+	IsacRun run;
+	ISACFIX_MainStruct* encoder = nullptr;
+	ISACFIX_MainStruct* decoder = nullptr;
+	if (WebRtcIsacfix_Create(&encoder) != 0 || WebRtcIsacfix_Create(&decoder) != 0) {
+		run.ok = false;
+		return run;
+	}
+	WebRtcIsacfix_EncoderInit(encoder, 1);
+	WebRtcIsacfix_Control(encoder, 32000, 30);
+	WebRtcIsacfix_DecoderInit(decoder);
+
+	std::vector<std::vector<uint8_t>> payloads;
+	uint8_t payload[kMaxPayloadBytes];
+	int64_t start_us = rtc::TimeMicros();
+	for (size_t offset = 0; offset + kFrameLength <= input.size();
+		offset += kFrameLength) {
+		int bytes = WebRtcIsacfix_Encode(encoder, &input[offset], payload);
+		if (bytes < 0) {
+			run.ok = false;
+			break;
+		}
+		if (bytes > 0) {
+			payloads.emplace_back(payload, payload + bytes);
+		}
+	}
+	run.encode_us = rtc::TimeMicros() - start_us;
+
+	std::vector<int16_t> decoded(kMaxDecodedSamples);
+	start_us = rtc::TimeMicros();
+	for (const std::vector<uint8_t>& p : payloads) {
+		int16_t speech_type = 0;
+		int samples = WebRtcIsacfix_Decode(decoder, p.data(), p.size(),
+			decoded.data(), &speech_type);
+		if (samples < 0) {
+			run.ok = false;
+			break;
+		}
+		run.hash = Hash(p.data(), p.size(), run.hash);
+		run.hash = Hash(decoded.data(), samples * sizeof(int16_t), run.hash);
+	}
+	run.decode_us = rtc::TimeMicros() - start_us;
+
+	WebRtcIsacfix_Free(encoder);
+	WebRtcIsacfix_Free(decoder);
+	return run;
+}
+
+// Real-time channels one core sustains when |us| were spent on |seconds|.
+double ChannelsPerCore(int seconds, int64_t us) {
+	return us > 0 ? seconds * 1e6 / us : 0;
+}
+
+}  // namespace
+
+void RunIsacBenchmark(int seconds) {
+	seconds = std::max(seconds, 1);
+	// The SPL pointers are set once per process; keep them on the best path
+	// so only the iSAC kernels differ between runs.
+	WebRtcSpl_Init();
+	g_cpu_info = WebRtc_GetCPUInfo;
+
+	bool supported[kNumPaths] = { true, g_cpu_info(kSSE4_1) != 0,
+		g_cpu_info(kAVX2) != 0 && g_cpu_info(kSSE4_1) != 0 };
+	std::vector<int16_t> input = MakeInput(seconds);
+	const int kRounds = 3;
+
+	printf("seconds=%d\n", seconds);
+	printf("path\tencode ch/core\tdecode ch/core\tencode+decode ch/core\tbit-exact\n");
+	uint32_t reference = 0;
+	for (int path = 0; path < kNumPaths; ++path) {
+		if (!supported[path]) {
+			printf("%s\t-\t-\t-\t-\n", kPathNames[path]);
+			continue;
+		}
+		g_max_path = static_cast<IsacPath>(path);
+		WebRtc_GetCPUInfo = CappedCPUInfo;
+		// Best of a few rounds, to keep interrupts and frequency ramps out.
+		IsacRun best;
+		best.encode_us = INT64_MAX;
+		best.decode_us = INT64_MAX;
+		bool exact = true;
+		for (int round = 0; round < kRounds; ++round) {
+			IsacRun run = EncodeDecode(input);
+			if (!run.ok) {
+				RTC_LOG(LS_ERROR) << "iSAC " << kPathNames[path] << " failed";
+				exact = false;
+				break;
+			}
+			best.encode_us = std::min(best.encode_us, run.encode_us);
+			best.decode_us = std::min(best.decode_us, run.decode_us);
+			if (path == kPathC && round == 0) {
+				reference = run.hash;
+			}
+			else if (run.hash != reference) {
+				exact = false;
+			}
+		}
+		WebRtc_GetCPUInfo = g_cpu_info;
+		if (!exact) {
+			RTC_LOG(LS_ERROR) << "iSAC " << kPathNames[path]
+				<< " differs from the C version";
+		}
+		printf("%s\t%.1f\t%.1f\t%.1f\t%s\n", kPathNames[path],
+			ChannelsPerCore(seconds, best.encode_us),
+			ChannelsPerCore(seconds, best.decode_us),
+			ChannelsPerCore(seconds, best.encode_us + best.decode_us),
+			exact ? "yes" : "NO");
+	}
+}
+
+#else
+
+void RunIsacBenchmark(int seconds) {
+	printf("The iSAC benchmark needs an x86 CPU\n");
+}
+
+#endif  // WEBRTC_ARCH_X86_FAMILY
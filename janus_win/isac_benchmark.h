@@ -0,0 +1,8 @@
+#pragma once
+
+// Encodes and decodes |seconds| of synthetic 16 kHz speech with the
+// fixed-point iSAC codec once per x86 path the CPU supports (C, SSE4.1,
+// AVX2) and prints how many real-time channels one core could encode,
+// decode and both, and whether every path produced the same payloads and
+// decoded audio as C.
+void RunIsacBenchmark(int seconds);
@@ -0,0 +1,239 @@
+#include "janus_signaling.h"
+
+#include "defaults.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+#include "rtc_base/trace_event.h"
+
+namespace {
+
+long long int GetId(const Json::Value& jvalue) {
+	return jvalue.isIntegral() ? jvalue.asInt64() : 0;
+}
+
+}  // namespace
+
+JanusSignaling::JanusSignaling(PeerConnectionWsClient* client,
+	JanusSignalingObserver* observer)
+	: client_(client), observer_(observer), messages_sent_(0) {
+}
+
+void JanusSignaling::OnMessage(const std::string& message) {
+	Json::Reader reader;
+	Json::Value jmessage;
+	if (!reader.parse(message, jmessage) || !jmessage.isObject()) {
+		RTC_LOG(WARNING) << "Received unknown message. " << message;
+		return;
+	}
+	std::string janus_str;
+	std::string transaction;
+	rtc::GetStringFromJsonObject(jmessage, "janus", &janus_str);
+	rtc::GetStringFromJsonObject(jmessage, "transaction", &transaction);
+	if (janus_str == "ack") {
+		// Just an ack, we can probably ignore
+		RTC_LOG(INFO) << "Got an ack on session. ";
+	}
+	else if (janus_str == "success") {
+		std::shared_ptr<JanusTransaction> jt = Complete(transaction, false);
+		if (jt && jt->Success) {
+			TRACE_EVENT1("janus", "TransactionSuccess", "transaction", transaction);
+			jt->Success(message);
+		}
+	}
+	else if (janus_str == "trickle") {
+		RTC_LOG(INFO) << "Got a trickle candidate from Janus. ";
+	}
+	else if (janus_str == "webrtcup") {
+		//sent once the DTLS handshake of the handle completed
+		RTC_LOG(INFO) << "The PeerConnection with the gateway is up!";
+		if (observer_) {
+			observer_->OnWebrtcUp(GetId(jmessage["sender"]));
+		}
+	}
+	else if (janus_str == "hangup") {
+		RTC_LOG(INFO) << "A plugin asked the core to hangup a PeerConnection on one of our handles! ";
+	}
+	else if (janus_str == "detached") {
+		RTC_LOG(INFO) << "A plugin asked the core to detach one of our handles! ";
+	}
+	else if (janus_str == "media") {
+		RTC_LOG(INFO) << "Media started/stopped flowing. ";
+	}
+	else if (janus_str == "slowlink") {
+		RTC_LOG(INFO) << "Got a slowlink event! ";
+	}
+	else if (janus_str == "error") {
+		RTC_LOG(INFO) << "Got an error. ";
+		std::shared_ptr<JanusTransaction> jt = Complete(transaction, true);
+		if (jt && jt->Error) {
+			jt->Error(rtc::JsonValueToString(jmessage["error"]["code"]),
+				jmessage["error"]["reason"].asString());
+		}
+	}
+	else if (janus_str == "event") {
+		RTC_LOG(INFO) << "Got a plugin event! ";
+		const Json::Value& data = jmessage["plugindata"]["data"];
+		if (observer_ && data.isMember("publishers")) {
+			std::vector<Json::Value> PublisherVec;
+			rtc::JsonArrayToValueVector(data["publishers"], &PublisherVec);
+			std::vector<JanusPublisher> publishers;
+			for (const Json::Value& pub : PublisherVec) {
+				JanusPublisher publisher;
+				publisher.id = GetId(pub["id"]);
+				rtc::GetStringFromJsonObject(pub, "display", &publisher.display);
+				publishers.push_back(publisher);
+			}
+			observer_->OnPublishers(GetId(jmessage["session_id"]), publishers);
+		}
+		if (transaction.empty()) {
+			return;
+		}
+		std::shared_ptr<JanusTransaction> jt =
+			FindEvent(transaction, data.isMember("error_code"));
+		if (jt && jt->Event) {
+			TRACE_EVENT1("janus", "TransactionEvent", "transaction", transaction);
+			jt->Event(message);
+		}
+	}
+}
+
+void JanusSignaling::CreateSession(std::shared_ptr<JanusTransaction> jt) {
+	Json::Value jmessage;
+	jmessage["janus"] = "create";
+	Send(&jmessage, jt, false);
+}
+
+void JanusSignaling::Attach(long long int session_id, const std::string& plugin,
+	std::shared_ptr<JanusTransaction> jt) {
+	Json::Value jmessage;
+	jmessage["janus"] = "attach";
+	jmessage["plugin"] = plugin;
+	jmessage["session_id"] = session_id;
+	Send(&jmessage, jt, false);
+}
+
+void JanusSignaling::Message(long long int session_id, long long int handle_id,
+	const Json::Value& body, const Json::Value* jsep,
+	std::shared_ptr<JanusTransaction> jt, bool async) {
+	Json::Value jmessage;
+	jmessage["janus"] = "message";
+	jmessage["body"] = body;
+	if (jsep) {
+		jmessage["jsep"] = *jsep;
+	}
+	jmessage["session_id"] = session_id;
+	jmessage["handle_id"] = handle_id;
+	Send(&jmessage, jt, async);
+}
+
+void JanusSignaling::Trickle(long long int session_id, long long int handle_id,
+	const Json::Value& candidate, bool async) {
+	Json::Value jmessage;
+	jmessage["janus"] = "trickle";
+	jmessage["candidate"] = candidate;
+	jmessage["session_id"] = session_id;
+	jmessage["handle_id"] = handle_id;
+	Send(&jmessage, nullptr, async);
+}
+
+void JanusSignaling::KeepAlive(long long int session_id) {
+	Json::Value jmessage;
+	jmessage["janus"] = "keepalive";
+	jmessage["session_id"] = session_id;
+	Send(&jmessage, nullptr, false);
+}
+
+void JanusSignaling::DestroySession(long long int session_id,
+	std::shared_ptr<JanusTransaction> jt) {
+	Json::Value jmessage;
+	jmessage["janus"] = "destroy";
+	jmessage["session_id"] = session_id;
+	Send(&jmessage, jt, false);
+}
+
+long long int JanusSignaling::ReplyId(const std::string& message) {
+	Json::Reader reader;
+	Json::Value jmessage;
+	if (!reader.parse(message, jmessage) || !jmessage.isObject()) {
+		return 0;
+	}
+	return GetId(jmessage["data"]["id"]);
+}
+
+void JanusSignaling::Send(Json::Value* jmessage, std::shared_ptr<JanusTransaction> jt,
+	bool async) {
+	if (jt) {
+		if (jt->transactionId.empty()) {
+			jt->transactionId = RandomString(12);
+		}
+		(*jmessage)["transaction"] = jt->transactionId;
+		PendingTransaction pending;
+		pending.jt = jt;
+		pending.session_id = GetId(jmessage->get("session_id", Json::Value()));
+		pending.destroys_session = (*jmessage)["janus"].asString() == "destroy";
+		pending.sent_us = rtc::TimeMicros();
+		std::lock_guard<std::mutex> lock(mutex_);
+		m_transactionMap[jt->transactionId] = pending;
+	}
+	else {
+		(*jmessage)["transaction"] = RandomString(12);
+	}
+	Json::StyledWriter writer;
+	messages_sent_++;
+	if (async) {
+		client_->SendToJanusAsync(writer.write(*jmessage));
+	}
+	else {
+		client_->SendToJanus(writer.write(*jmessage));
+	}
+}
+
+std::shared_ptr<JanusTransaction> JanusSignaling::Complete(const std::string& transaction,
+	bool failed) {
+	PendingTransaction pending;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = m_transactionMap.find(transaction);
+		if (it == m_transactionMap.end()) {
+			return nullptr;
+		}
+		pending = it->second;
+		m_transactionMap.erase(it);
+		if (pending.destroys_session) {
+			// Event transactions stay on the map, they go with their session.
+			for (auto p = m_transactionMap.begin(); p != m_transactionMap.end();) {
+				if (p->second.session_id == pending.session_id) {
+					p = m_transactionMap.erase(p);
+				}
+				else {
+					++p;
+				}
+			}
+		}
+	}
+	Answered(&pending, failed);
+	return pending.jt;
+}
+
+std::shared_ptr<JanusTransaction> JanusSignaling::FindEvent(const std::string& transaction,
+	bool failed) {
+	PendingTransaction pending;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		auto it = m_transactionMap.find(transaction);
+		if (it == m_transactionMap.end()) {
+			return nullptr;
+		}
+		pending = it->second;
+		it->second.answered = true;
+	}
+	Answered(&pending, failed);
+	return pending.jt;
+}
+
+void JanusSignaling::Answered(PendingTransaction* pending, bool failed) {
+	if (observer_ && !pending->answered) {
+		pending->answered = true;
+		observer_->OnTransactionDone(rtc::TimeMicros() - pending->sent_us, failed);
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "JanusTransaction.h"
+#include "peer_connection_wsclient.h"
+#include "rtc_base/json.h"
+
+struct JanusPublisher {
+	long long int id = 0;
+	std::string display;
+};
+
+// Notifications of the gateway that belong to no request, on the loop thread
+// of the client.
+struct JanusSignalingObserver {
+	// A plugin event listed publishers of the room that |session_id| is in.
+	virtual void OnPublishers(long long int session_id,
+		const std::vector<JanusPublisher>& publishers) {}
+	// The PeerConnection of |handle_id| with the gateway is up.
+	virtual void OnWebrtcUp(long long int handle_id) {}
+	// The first reply to a transaction came |rtt_us| after its request was
+	// sent. |failed| for an error and for a plugin event carrying an
+	// error_code.
+	virtual void OnTransactionDone(int64_t rtt_us, bool failed) {}
+
+protected:
+	virtual ~JanusSignalingObserver() {}
+};
+
+// The Janus protocol over one PeerConnectionWsClient, for any number of
+// sessions: builds the requests, keeps their transactions and hands every
+// reply to the JanusTransaction that made the request. A "success" calls its
+// Success and an "error" its Error, and either completes the transaction. A
+// plugin event calls its Event, an error_code in the plugin data included,
+// and leaves the transaction pending for further events; the transactions of
+// a session are dropped once its destroy request is answered.
+//
+// Requests may be sent from any thread, with |async| set when not on the loop
+// thread of the client. Replies and the observer run on the loop thread.
+class JanusSignaling {
+public:
+	// |observer| may be null.
+	JanusSignaling(PeerConnectionWsClient* client, JanusSignalingObserver* observer);
+
+	// Dispatches a message of PeerConnectionWsClientObserver::OnMessageFromJanus().
+	void OnMessage(const std::string& message);
+
+	// The session id is ReplyId() of the success.
+	void CreateSession(std::shared_ptr<JanusTransaction> jt);
+	// Attaches |plugin|, the handle id is ReplyId() of the success.
+	void Attach(long long int session_id, const std::string& plugin,
+		std::shared_ptr<JanusTransaction> jt);
+	// Sends |body| to the plugin of |handle_id|, with |jsep| unless it is null.
+	void Message(long long int session_id, long long int handle_id,
+		const Json::Value& body, const Json::Value* jsep,
+		std::shared_ptr<JanusTransaction> jt, bool async);
+	void Trickle(long long int session_id, long long int handle_id,
+		const Json::Value& candidate, bool async);
+	void KeepAlive(long long int session_id);
+	void DestroySession(long long int session_id, std::shared_ptr<JanusTransaction> jt);
+
+	// data.id of a success, 0 if there is none.
+	static long long int ReplyId(const std::string& message);
+
+	int64_t messages_sent() const { return messages_sent_; }
+
+private:
+	struct PendingTransaction {
+		std::shared_ptr<JanusTransaction> jt;
+		long long int session_id = 0;
+		bool destroys_session = false;
+		int64_t sent_us = 0;
+		bool answered = false;//the observer has the round trip
+	};
+
+	// Sends |jmessage| as the transaction of |jt|, or on its own if |jt| is
+	// null. A |jt| without an id gets one.
+	void Send(Json::Value* jmessage, std::shared_ptr<JanusTransaction> jt, bool async);
+	// Takes the transaction off the map, null if it is not there.
+	std::shared_ptr<JanusTransaction> Complete(const std::string& transaction, bool failed);
+	// The transaction of a plugin event, which stays on the map. Null if it is
+	// not there.
+	std::shared_ptr<JanusTransaction> FindEvent(const std::string& transaction, bool failed);
+	// Reports the round trip of |pending| unless it already was.
+	void Answered(PendingTransaction* pending, bool failed);
+
+	PeerConnectionWsClient* const client_;
+	JanusSignalingObserver* const observer_;
+	std::mutex mutex_;
+	std::map<std::string, PendingTransaction> m_transactionMap;//guarded by mutex_
+	std::atomic<int64_t> messages_sent_;
+};
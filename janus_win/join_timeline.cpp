@@ -0,0 +1,236 @@
+#include "join_timeline.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "rtc_base/json.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+
+namespace {
+
+const char* const kPhaseNames[kJoinPhaseCount] = {
+	"ws_connected",
+	"session_created",
+	"attached",
+	"joined",
+	"offer_created",
+	"answer_applied",
+	"ice_connected",
+	"dtls_connected",
+	"first_frame_decoded",
+	"first_frame_rendered",
+};
+
+// Upper bounds of the histogram buckets, the last bucket is open ended.
+const int64_t kBucketLimitsMs[] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000 };
+const int kNumBuckets = sizeof(kBucketLimitsMs) / sizeof(kBucketLimitsMs[0]) + 1;
+
+const char* RoleName(bool publisher) {
+	return publisher ? "publisher" : "subscriber";
+}
+
+double ToMs(int64_t us) {
+	return us / 1000.0;
+}
+
+int64_t Percentile(std::vector<int64_t> sorted, double fraction) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	std::sort(sorted.begin(), sorted.end());
+	size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+}  // namespace
+
+const char* JoinPhaseName(JoinPhase phase) {
+	return phase >= 0 && phase < kJoinPhaseCount ? kPhaseNames[phase] : "total";
+}
+
+JoinTimeline::JoinTimeline() {
+	std::fill(connection_us_, connection_us_ + kJoinPhaseCount, -1);
+	std::fill(complete_joins_, complete_joins_ + 2, 0);
+	std::fill(incomplete_joins_, incomplete_joins_ + 2, 0);
+}
+
+JoinTimeline::~JoinTimeline() {
+	if (records_file_) {
+		fclose(records_file_);
+	}
+}
+
+bool JoinTimeline::OpenRecordsFile(const std::string& path) {
+	rtc::CritScope cs(&lock_);
+	if (records_file_) {
+		fclose(records_file_);
+	}
+	records_file_ = fopen(path.c_str(), "a");
+	if (!records_file_) {
+		RTC_LOG(LS_ERROR) << "Failed to open the join records file " << path;
+		return false;
+	}
+	return true;
+}
+
+void JoinTimeline::MarkConnection(JoinPhase phase) {
+	int64_t now_us = rtc::TimeMicros();
+	rtc::CritScope cs(&lock_);
+	if (phase == kJoinWsConnected) {
+		// A reconnect starts the connection over.
+		std::fill(connection_us_, connection_us_ + kJoinPhaseCount, -1);
+	}
+	if (connection_us_[phase] < 0) {
+		connection_us_[phase] = now_us;
+	}
+}
+
+void JoinTimeline::Attached(long long int handleId, bool publisher, long long int feedId,
+	int64_t start_us) {
+	int64_t now_us = rtc::TimeMicros();
+	rtc::CritScope cs(&lock_);
+	Record record;
+	record.publisher = publisher;
+	record.feed_id = feedId;
+	record.start_us = start_us;
+	std::fill(record.phase_us, record.phase_us + kJoinPhaseCount, -1);
+	if (publisher) {
+		record.phase_us[kJoinWsConnected] = connection_us_[kJoinWsConnected];
+		record.phase_us[kJoinSessionCreated] = connection_us_[kJoinSessionCreated];
+		if (connection_us_[kJoinWsConnected] >= 0) {
+			record.start_us = connection_us_[kJoinWsConnected];
+		}
+	}
+	record.phase_us[kJoinAttached] = now_us;
+	records_[handleId] = record;
+}
+
+void JoinTimeline::Mark(long long int handleId, JoinPhase phase, int64_t time_us) {
+	if (time_us < 0) {
+		time_us = rtc::TimeMicros();
+	}
+	rtc::CritScope cs(&lock_);
+	auto it = records_.find(handleId);
+	if (it == records_.end() || it->second.phase_us[phase] >= 0) {
+		return;
+	}
+	it->second.phase_us[phase] = time_us;
+	if (IsComplete(it->second)) {
+		Emit(handleId, it->second, true);
+		records_.erase(it);
+	}
+}
+
+void JoinTimeline::Remove(long long int handleId) {
+	rtc::CritScope cs(&lock_);
+	auto it = records_.find(handleId);
+	if (it == records_.end()) {
+		return;
+	}
+	Emit(handleId, it->second, false);
+	records_.erase(it);
+}
+
+bool JoinTimeline::IsComplete(const Record& record) const {
+	int last = record.publisher ? kJoinDtlsConnected : kJoinFirstFrameRendered;
+	for (int phase = kJoinAttached; phase <= last; ++phase) {
+		if (record.phase_us[phase] < 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void JoinTimeline::Emit(long long int handleId, const Record& record, bool complete) {
+	Json::Value jrecord;
+	Json::Value jphases(Json::objectValue);
+	Json::Value jsteps(Json::objectValue);
+	jrecord["handle"] = handleId;
+	jrecord["role"] = RoleName(record.publisher);
+	jrecord["feed"] = record.feed_id;
+	jrecord["complete"] = complete;
+
+	// Each step runs from the latest earlier stamp, the callbacks of the
+	// network and signaling threads may arrive slightly out of order.
+	int64_t previous_us = record.start_us;
+	for (int phase = 0; phase < kJoinPhaseCount; ++phase) {
+		int64_t time_us = record.phase_us[phase];
+		if (time_us < 0) {
+			continue;
+		}
+		int64_t step_us = std::max<int64_t>(time_us - previous_us, 0);
+		previous_us = std::max(previous_us, time_us);
+		jphases[kPhaseNames[phase]] = ToMs(time_us - record.start_us);
+		jsteps[kPhaseNames[phase]] = ToMs(step_us);
+		if (complete) {
+			AddSample(record.publisher, phase, step_us);
+		}
+	}
+	jrecord["phases_ms"] = jphases;
+	jrecord["steps_ms"] = jsteps;
+	jrecord["total_ms"] = ToMs(previous_us - record.start_us);
+
+	if (complete) {
+		AddSample(record.publisher, kJoinPhaseCount, previous_us - record.start_us);
+		complete_joins_[record.publisher]++;
+	}
+	else {
+		incomplete_joins_[record.publisher]++;
+	}
+
+	Json::FastWriter writer;
+	std::string line = writer.write(jrecord);
+	RTC_LOG(INFO) << "join " << line;
+	if (records_file_) {
+		fwrite(line.data(), 1, line.size(), records_file_);
+		fflush(records_file_);
+	}
+}
+
+void JoinTimeline::AddSample(bool publisher, int phase, int64_t step_us) {
+	Histogram& histogram = histograms_[publisher][phase];
+	if (histogram.buckets.empty()) {
+		histogram.buckets.resize(kNumBuckets, 0);
+	}
+	int bucket = 0;
+	while (bucket < kNumBuckets - 1 && step_us >= kBucketLimitsMs[bucket] * 1000) {
+		bucket++;
+	}
+	histogram.buckets[bucket]++;
+	histogram.samples_us.push_back(step_us);
+}
+
+std::string JoinTimeline::Summary() const {
+	rtc::CritScope cs(&lock_);
+	std::ostringstream os;
+	os.precision(1);
+	os << std::fixed;
+	for (int role = 1; role >= 0; --role) {
+		os << RoleName(role != 0) << " joins: " << complete_joins_[role]
+			<< " complete, " << incomplete_joins_[role] << " incomplete\n";
+		for (const auto& entry : histograms_[role]) {
+			const Histogram& histogram = entry.second;
+			os << "  " << JoinPhaseName(static_cast<JoinPhase>(entry.first))
+				<< ": p50=" << ToMs(Percentile(histogram.samples_us, 0.5))
+				<< " p90=" << ToMs(Percentile(histogram.samples_us, 0.9))
+				<< " max=" << ToMs(*std::max_element(histogram.samples_us.begin(),
+					histogram.samples_us.end()))
+				<< " ms [";
+			for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+				if (bucket > 0) {
+					os << " ";
+				}
+				if (bucket < kNumBuckets - 1) {
+					os << "<" << kBucketLimitsMs[bucket] << ":";
+				}
+				else {
+					os << ">=" << kBucketLimitsMs[bucket - 1] << ":";
+				}
+				os << histogram.buckets[bucket];
+			}
+			os << "]\n";
+		}
+	}
+	return os.str();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "rtc_base/criticalsection.h"
+
+// Steps of joining a room, in the order they happen. For a publisher the
+// offer is created locally and the answer of Janus applied; a subscriber
+// applies the offer of Janus and creates the answer, so the same two phases
+// stand for "offer ready" and "answer ready" on both sides.
+enum JoinPhase {
+	kJoinWsConnected = 0,
+	kJoinSessionCreated,
+	kJoinAttached,
+	kJoinJoined,
+	kJoinOfferCreated,
+	kJoinAnswerApplied,
+	kJoinIceConnected,
+	kJoinDtlsConnected,
+	kJoinFirstFrameDecoded,
+	kJoinFirstFrameRendered,
+	kJoinPhaseCount
+};
+
+const char* JoinPhaseName(JoinPhase phase);
+
+// Join latency waterfall of every handle of a ConductorWs. Each phase is
+// stamped once per handle with rtc::TimeMicros(); WebSocket connected and
+// session created belong to the connection and are copied into the record of
+// the publisher. A subscriber record starts when its attach is requested.
+//
+// A record is complete once every phase of its role is stamped: a publisher
+// ends at DTLS connected, a subscriber at its first rendered frame. It is
+// then logged as one JSON line (and appended to the records file, if any),
+// and the time each phase took since the previous stamped one goes into the
+// histograms of its role. A handle removed before that emits an incomplete
+// record, which stays out of the histograms. Thread safe.
+class JoinTimeline {
+public:
+	JoinTimeline();
+	~JoinTimeline();
+
+	// Also appends every record as a JSON line to |path|.
+	bool OpenRecordsFile(const std::string& path);
+
+	// Stamps a phase of the connection (WebSocket connected, session created).
+	void MarkConnection(JoinPhase phase);
+	// Starts the record of |handleId| at |start_us|, the time its attach was
+	// sent. Called once attach succeeded.
+	void Attached(long long int handleId, bool publisher, long long int feedId,
+		int64_t start_us);
+	// Stamps |phase| of |handleId| at |time_us|, now when negative. Only the
+	// first stamp of a phase counts; unknown handles are ignored.
+	void Mark(long long int handleId, JoinPhase phase, int64_t time_us = -1);
+	// Emits the record of |handleId| as incomplete if it is still open.
+	void Remove(long long int handleId);
+
+	// The histograms of both roles as text, one line per phase.
+	std::string Summary() const;
+
+private:
+	struct Record {
+		bool publisher = false;
+		long long int feed_id = 0;
+		int64_t start_us = 0;
+		int64_t phase_us[kJoinPhaseCount];
+	};
+
+	// Step durations of one phase over the complete joins of a role.
+	struct Histogram {
+		std::vector<int64_t> samples_us;
+		std::vector<int> buckets;
+	};
+
+	bool IsComplete(const Record& record) const;
+	void Emit(long long int handleId, const Record& record, bool complete);
+	void AddSample(bool publisher, int phase, int64_t step_us);
+
+	rtc::CriticalSection lock_;
+	int64_t connection_us_[kJoinPhaseCount];
+	std::map<long long int, Record> records_;
+	// kJoinPhaseCount is the whole join.
+	std::map<int, Histogram> histograms_[2];
+	int complete_joins_[2];
+	int incomplete_joins_[2];
+	FILE* records_file_ = nullptr;
+};
@@ -0,0 +1,345 @@
+#include "latency_benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "JanusTransaction.h"
+#include "api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "api/audio_codecs/builtin_audio_encoder_factory.h"
+#include "api/peerconnectioninterface.h"
+#include "api/video_codecs/builtin_video_decoder_factory.h"
+#include "api/video_codecs/builtin_video_encoder_factory.h"
+#include "frame_stamp.h"
+#include "headless_audio_device.h"
+#include "janus_signaling.h"
+#include "loopback_peer.h"
+#include "peer_connection_wsclient.h"
+#include "synthetic_video_capturer.h"
+#include "video_renderer.h"
+#include "rtc_base/event.h"
+#include "rtc_base/json.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/ssladapter.h"
+#include "rtc_base/stringencode.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
+
+namespace {
+
+const char kVideoLabel[] = "latency_video";
+const char kEchotestPlugin[] = "janus.plugin.echotest";
+const int kSetupTimeoutMs = 10000;
+// Lets the bandwidth estimate ramp up before anything is measured.
+const int64_t kWarmupMs = 2000;
+// Frames captured this close to the end may still be on their way.
+const int64_t kTailMs = 1000;
+const int kStartBitrateBps = 1000000;
+const int kMaxBitrateBps = 4000000;
+const uint32_t kNumStamps = 1u << kFrameStampBits;
+
+bool ParseSize(const std::string& size, int* width, int* height) {
+	return sscanf(size.c_str(), "%dx%d", width, height) == 2 &&
+		*width >= kFrameStampMinWidth && *height > 0;
+}
+
+int64_t Percentile(const std::vector<int64_t>& sorted, double fraction) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Negotiates one PeerConnection with the echotest plugin of Janus, which
+// sends the media back to where it came from.
+class EchotestClient : public PeerConnectionWsClientObserver {
+public:
+	EchotestClient() : janus_(&client_, nullptr), attached_(false, false),
+		answered_(false, false) {
+		client_.RegisterObserver(this);
+	}
+
+	// Connects to |server| and attaches the echotest plugin.
+	bool Attach(const std::string& server) {
+		client_.Connect(server, "latency");
+		if (!attached_.Wait(kSetupTimeoutMs) || handle_id_ == 0) {
+			RTC_LOG(LS_ERROR) << "Failed to attach " << kEchotestPlugin << " at " << server;
+			return false;
+		}
+		return true;
+	}
+
+	// Sends |offer_sdp| to the echotest and returns its answer, empty on
+	// failure.
+	std::string Negotiate(const std::string& offer_sdp) {
+		std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
+		jt->Event = [this](std::string message) {
+			Json::Reader reader;
+			Json::Value jmessage;
+			if (reader.parse(message, jmessage)) {
+				const Json::Value& data = jmessage["plugindata"]["data"];
+				if (data.isMember("error_code")) {
+					RTC_LOG(LS_ERROR) << "Echotest error "
+						<< rtc::JsonValueToString(data["error_code"]) << ": "
+						<< data["error"].asString();
+				}
+				answer_ = jmessage["jsep"]["sdp"].asString();
+			}
+			answered_.Set();
+		};
+		jt->Error = [this](std::string code, std::string reason) {
+			RTC_LOG(LS_ERROR) << "Echotest error " << code << ": " << reason;
+			answered_.Set();
+		};
+
+		Json::Value jbody;
+		Json::Value jjsep;
+		jbody["audio"] = false;
+		jbody["video"] = true;
+		jjsep["type"] = "offer";
+		jjsep["sdp"] = offer_sdp;
+		jjsep["trickle"] = false;
+		//not on the loop thread, so through its async
+		janus_.Message(m_SessionId, handle_id_, jbody, &jjsep, jt, true);
+
+		if (!answered_.Wait(kSetupTimeoutMs)) {
+			RTC_LOG(LS_ERROR) << "The echotest did not answer";
+		}
+		return answer_;
+	}
+
+	void Close() { client_.CloseJanusConn(); }
+
+	// PeerConnectionWsClientObserver implementation, on the loop thread.
+	void OnSignedIn() override {}
+	void OnDisconnected() override {}
+	void OnPeerConnected(int id, const std::string& name) override {}
+	void OnMessageSent(int err) override {}
+	void OnServerConnectionFailure() override { attached_.Set(); }
+	void OnJanusConnected() override { CreateSession(); }
+	void OnJanusDisconnected() override {
+		attached_.Set();
+		answered_.Set();
+	}
+
+	void OnSendKeepAliveToJanus() override {
+		if (m_SessionId > 0) {
+			janus_.KeepAlive(m_SessionId);
+		}
+	}
+
+	void OnMessageFromJanus(int peer_id, const std::string& message) override {
+		janus_.OnMessage(message);
+	}
+
+private:
+	void CreateSession() {
+		std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
+		jt->Success = [this](std::string message) {
+			m_SessionId = JanusSignaling::ReplyId(message);
+			CreateHandle();
+		};
+		jt->Error = [this](std::string code, std::string reason) {
+			RTC_LOG(LS_ERROR) << "Create session error " << code << ": " << reason;
+			attached_.Set();
+		};
+		janus_.CreateSession(jt);
+	}
+
+	void CreateHandle() {
+		std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
+		jt->Success = [this](std::string message) {
+			handle_id_ = JanusSignaling::ReplyId(message);
+			attached_.Set();
+		};
+		jt->Error = [this](std::string code, std::string reason) {
+			RTC_LOG(LS_ERROR) << "Attach error " << code << ": " << reason;
+			attached_.Set();
+		};
+		janus_.Attach(m_SessionId, kEchotestPlugin, jt);
+	}
+
+	PeerConnectionWsClient client_;
+	JanusSignaling janus_;
+	// Written on the loop thread before the event that publishes them.
+	long long int m_SessionId = 0;
+	long long int handle_id_ = 0;
+	std::string answer_;
+	rtc::Event attached_;
+	rtc::Event answered_;
+};
+
+struct CallResult {
+	bool unsupported = false;
+	int64_t sent = 0;
+	int64_t received = 0;
+	int64_t unreadable = 0;
+	std::vector<int64_t> latencies_us;
+};
+
+// Sends |width| x |height| stamped video with |codec| for the warm-up plus
+// |config.seconds| and collects what arrives. False if the call could not
+// be set up.
+bool RunCall(webrtc::PeerConnectionFactoryInterface* factory,
+	const LatencyBenchmarkConfig& config, const std::string& codec, int width,
+	int height, CallResult* result) {
+	SyntheticVideoOptions options;
+	options.width = width;
+	options.height = height;
+	options.fps = config.fps;
+	options.stamp_frames = true;
+	std::unique_ptr<SyntheticVideoCapturer> capturer_owner(new SyntheticVideoCapturer(options));
+	if (!capturer_owner->Init()) {
+		return false;
+	}
+	//owned by the source from here on
+	SyntheticVideoCapturer* capturer = capturer_owner.get();
+	rtc::scoped_refptr<webrtc::VideoTrackSourceInterface> source =
+		factory->CreateVideoSource(std::move(capturer_owner), nullptr);
+	rtc::scoped_refptr<webrtc::VideoTrackInterface> track =
+		factory->CreateVideoTrack(kVideoLabel, source);
+
+	StampReader reader;
+	bool loopback = config.janus_server.empty();
+	// The echotest sends the video back to the sender.
+	std::unique_ptr<LoopbackPeer> sender(new LoopbackPeer(loopback ? nullptr : &reader));
+	std::unique_ptr<LoopbackPeer> receiver;
+	std::unique_ptr<EchotestClient> echotest;
+	bool ok = sender->Create(factory, kStartBitrateBps, kMaxBitrateBps) && sender->AddTrack(track);
+	if (ok && loopback) {
+		receiver.reset(new LoopbackPeer(&reader));
+		ok = receiver->Create(factory, kStartBitrateBps, kMaxBitrateBps);
+		std::string offer = ok ? sender->CreateLocalDescription(true, codec, &result->unsupported) : "";
+		ok = !offer.empty() && receiver->SetRemoteDescription(webrtc::SdpType::kOffer, offer);
+		std::string answer = ok ? receiver->CreateLocalDescription(false, "", nullptr) : "";
+		ok = !answer.empty() && sender->SetRemoteDescription(webrtc::SdpType::kAnswer, answer);
+	}
+	else if (ok) {
+		echotest.reset(new EchotestClient());
+		ok = echotest->Attach(config.janus_server);
+		std::string offer = ok ? sender->CreateLocalDescription(true, codec, &result->unsupported) : "";
+		std::string answer = !offer.empty() ? echotest->Negotiate(offer) : "";
+		ok = !answer.empty() && sender->SetRemoteDescription(webrtc::SdpType::kAnswer, answer);
+	}
+
+	if (ok) {
+		int64_t start_us = rtc::TimeMicros();
+		std::this_thread::sleep_for(std::chrono::milliseconds(kWarmupMs + config.seconds * 1000LL));
+		int64_t window_begin_us = start_us + kWarmupMs * rtc::kNumMicrosecsPerMillisec;
+		int64_t window_end_us = rtc::TimeMicros() - kTailMs * rtc::kNumMicrosecsPerMillisec;
+
+		// Loss counts the frames captured in the window that never rendered,
+		// whether the encoder dropped them or the network lost them.
+		for (uint32_t stamp = 0; stamp < kNumStamps; ++stamp) {
+			int64_t capture_us = capturer->StampCaptureTimeUs(stamp);
+			if (capture_us >= window_begin_us && capture_us < window_end_us) {
+				result->sent++;
+			}
+		}
+		std::vector<bool> seen(kNumStamps, false);
+		for (const auto& arrival : reader.TakeArrivals()) {
+			int64_t capture_us = capturer->StampCaptureTimeUs(arrival.stamp);
+			if (capture_us >= window_begin_us && capture_us < window_end_us &&
+				!seen[arrival.stamp]) {
+				seen[arrival.stamp] = true;
+				result->received++;
+				result->latencies_us.push_back(arrival.render_us - capture_us);
+			}
+		}
+		result->unreadable = reader.unreadable();
+	}
+
+	if (receiver) {
+		receiver->Close();
+	}
+	sender->Close();
+	if (echotest) {
+		echotest->Close();
+	}
+	return ok || result->unsupported;
+}
+
+}  // namespace
+
+bool RunLatencyBenchmark(const LatencyBenchmarkConfig& config) {
+	std::vector<std::string> codecs;
+	std::vector<std::string> resolutions;
+	rtc::split(config.codecs, ',', &codecs);
+	rtc::split(config.resolutions, ',', &resolutions);
+
+	rtc::ThreadManager::Instance()->WrapCurrentThread();
+	rtc::InitializeSSL();
+	std::unique_ptr<rtc::Thread> signaling_thread = rtc::Thread::Create();
+	signaling_thread->SetName("LatencySignaling", nullptr);
+	signaling_thread->Start();
+	rtc::scoped_refptr<webrtc::PeerConnectionFactoryInterface> factory =
+		webrtc::CreatePeerConnectionFactory(
+			nullptr /* network_thread */, nullptr /* worker_thread */,
+			signaling_thread.get(), CreateHeadlessAudioDevice(HeadlessAudioOptions()),
+			webrtc::CreateBuiltinAudioEncoderFactory(),
+			webrtc::CreateBuiltinAudioDecoderFactory(),
+			webrtc::CreateBuiltinVideoEncoderFactory(),
+			webrtc::CreateBuiltinVideoDecoderFactory(), nullptr /* audio_mixer */,
+			nullptr /* audio_processing */);
+
+	bool ok = factory != nullptr;
+	if (!factory) {
+		printf("Failed to create the PeerConnectionFactory\n");
+	}
+	else {
+		printf("%s, %d fps, %d s per run\n", config.janus_server.empty() ?
+			"loopback" : ("echotest at " + config.janus_server).c_str(), config.fps, config.seconds);
+		printf("codec\tsize\tsent\treceived\tlost %%\tunreadable\tp50 ms\tp90 ms\tp99 ms\tmax ms\n");
+	}
+	for (size_t c = 0; factory && c < codecs.size(); ++c) {
+		for (const auto& resolution : resolutions) {
+			int width = 0;
+			int height = 0;
+			if (!ParseSize(resolution, &width, &height)) {
+				printf("%s\t%s\tinvalid size, at least %d wide\n", codecs[c].c_str(),
+					resolution.c_str(), kFrameStampMinWidth);
+				ok = false;
+				continue;
+			}
+			CallResult result;
+			if (!RunCall(factory, config, codecs[c], width, height, &result)) {
+				printf("%s\t%dx%d\tsetup failed\n", codecs[c].c_str(), width, height);
+				ok = false;
+				continue;
+			}
+			if (result.unsupported) {
+				printf("%s\t%dx%d\tunsupported\n", codecs[c].c_str(), width, height);
+				continue;
+			}
+			if (result.received == 0) {
+				ok = false;
+			}
+			std::sort(result.latencies_us.begin(), result.latencies_us.end());
+			double lost_percent = result.sent > 0 ?
+				100.0 * std::max<int64_t>(result.sent - result.received, 0) / result.sent : 0.0;
+			printf("%s\t%dx%d\t%lld\t%lld\t%.1f\t%lld\t%.1f\t%.1f\t%.1f\t%.1f\n",
+				codecs[c].c_str(), width, height, static_cast<long long>(result.sent),
+				static_cast<long long>(result.received), lost_percent,
+				static_cast<long long>(result.unreadable),
+				Percentile(result.latencies_us, 0.5) / 1000.0,
+				Percentile(result.latencies_us, 0.9) / 1000.0,
+				Percentile(result.latencies_us, 0.99) / 1000.0,
+				result.latencies_us.empty() ? 0.0 : result.latencies_us.back() / 1000.0);
+			fflush(stdout);
+			RTC_LOG(INFO) << "latency benchmark " << codecs[c] << " " << width << "x"
+				<< height << ": " << result.received << "/" << result.sent << " frames";
+		}
+	}
+
+	factory = nullptr;
+	signaling_thread->Stop();
+	rtc::CleanupSSL();
+	rtc::ThreadManager::Instance()->UnwrapCurrentThread();
+	return ok;
+}
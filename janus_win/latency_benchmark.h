@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+struct LatencyBenchmarkConfig {
+	// ws:// address of a Janus with the echotest plugin. Empty connects a
+	// publisher and a subscriber PeerConnection directly in the process.
+	std::string janus_server;
+	// Comma separated video codec names, as in the SDP.
+	std::string codecs = "VP8,VP9,H264";
+	// Comma separated WxH capture sizes.
+	std::string resolutions = "320x180,640x360,1280x720";
+	int fps = 30;
+	// Measured per codec and resolution, after a warm-up.
+	int seconds = 10;
+};
+
+// Glass-to-glass latency of the video path. A synthetic source stamps the
+// frame index into every frame (frame_stamp.h); the receiving VideoRenderer
+// draws each decoded frame as soon as it arrives and reads the stamp back.
+// For every codec and resolution, prints the percentiles of capture to
+// render latency, the frames lost on the way and the frames whose stamp was
+// unreadable. The offer lists only the codec under test, a codec the
+// factories do not support is reported and skipped. Returns false if a call
+// could not be set up or received no frame.
+bool RunLatencyBenchmark(const LatencyBenchmarkConfig& config);
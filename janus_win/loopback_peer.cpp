@@ -0,0 +1,326 @@
+#include "loopback_peer.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <set>
+
+#include "frame_stamp.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/refcountedobject.h"
+#include "rtc_base/stringencode.h"
+#include "rtc_base/timeutils.h"
+
+namespace {
+
+const char kStreamId[] = "loopback";
+const int kSetupTimeoutMs = 10000;
+
+bool StartsWith(const std::string& str, const char* prefix) {
+	return str.compare(0, strlen(prefix), prefix) == 0;
+}
+
+bool EqualsIgnoreCase(const std::string& a, const std::string& b) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); ++i) {
+		if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Payload type of an a=rtpmap:, a=fmtp: or a=rtcp-fb: line, -1 for "*".
+int PayloadType(const std::string& line) {
+	size_t colon = line.find(':');
+	if (colon == std::string::npos || line.compare(colon + 1, 1, "*") == 0) {
+		return -1;
+	}
+	return atoi(line.c_str() + colon + 1);
+}
+
+class CreateDescriptionObserver : public webrtc::CreateSessionDescriptionObserver {
+public:
+	void OnSuccess(webrtc::SessionDescriptionInterface* desc) override {
+		desc_.reset(desc);
+		done_.Set();
+	}
+	void OnFailure(webrtc::RTCError error) override {
+		RTC_LOG(LS_ERROR) << "Creating the description failed: " << error.message();
+		done_.Set();
+	}
+
+	// The description, null on failure or timeout.
+	std::unique_ptr<webrtc::SessionDescriptionInterface> Wait() {
+		if (!done_.Wait(kSetupTimeoutMs)) {
+			return nullptr;
+		}
+		return std::move(desc_);
+	}
+
+protected:
+	CreateDescriptionObserver() : done_(false, false) {}
+
+private:
+	rtc::Event done_;
+	std::unique_ptr<webrtc::SessionDescriptionInterface> desc_;
+};
+
+class SetDescriptionObserver : public webrtc::SetSessionDescriptionObserver {
+public:
+	void OnSuccess() override {
+		ok_ = true;
+		done_.Set();
+	}
+	void OnFailure(webrtc::RTCError error) override {
+		RTC_LOG(LS_ERROR) << "Setting the description failed: " << error.message();
+		done_.Set();
+	}
+
+	bool Wait() { return done_.Wait(kSetupTimeoutMs) && ok_; }
+
+protected:
+	SetDescriptionObserver() : done_(false, false) {}
+
+private:
+	rtc::Event done_;
+	std::atomic<bool> ok_{ false };
+};
+
+}  // namespace
+
+bool PreferVideoCodec(const std::string& sdp, const std::string& codec, std::string* munged) {
+	std::vector<std::string> lines;
+	rtc::split(sdp, '\n', &lines);
+	for (auto& line : lines) {
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+	}
+
+	std::map<int, std::string> names;
+	std::map<int, int> repaired;//rtx payload type to the one it repairs
+	bool video = false;
+	for (const auto& line : lines) {
+		if (StartsWith(line, "m=")) {
+			video = StartsWith(line, "m=video");
+		}
+		else if (video && StartsWith(line, "a=rtpmap:")) {
+			size_t space = line.find(' ');
+			if (space != std::string::npos) {
+				names[PayloadType(line)] = line.substr(space + 1, line.find('/', space) - space - 1);
+			}
+		}
+		else if (video && StartsWith(line, "a=fmtp:")) {
+			size_t apt = line.find("apt=");
+			if (apt != std::string::npos) {
+				repaired[PayloadType(line)] = atoi(line.c_str() + apt + 4);
+			}
+		}
+	}
+
+	std::set<int> keep;
+	for (const auto& name : names) {
+		if (EqualsIgnoreCase(name.second, codec)) {
+			keep.insert(name.first);
+		}
+	}
+	if (keep.empty()) {
+		return false;
+	}
+	for (const auto& rtx : repaired) {
+		if (keep.count(rtx.second) && EqualsIgnoreCase(names[rtx.first], "rtx")) {
+			keep.insert(rtx.first);
+		}
+	}
+
+	munged->clear();
+	video = false;
+	for (const auto& line : lines) {
+		if (line.empty()) {
+			continue;
+		}
+		if (StartsWith(line, "m=")) {
+			video = StartsWith(line, "m=video");
+			if (video) {
+				// m=video <port> <proto> <payload types>
+				std::vector<std::string> fields;
+				rtc::split(line, ' ', &fields);
+				std::string mline;
+				for (size_t i = 0; i < fields.size(); ++i) {
+					if (i < 3 || keep.count(atoi(fields[i].c_str()))) {
+						mline += (i > 0 ? " " : "") + fields[i];
+					}
+				}
+				*munged += mline + "\r\n";
+				continue;
+			}
+		}
+		else if (video && (StartsWith(line, "a=rtpmap:") || StartsWith(line, "a=fmtp:") ||
+			StartsWith(line, "a=rtcp-fb:"))) {
+			int payload_type = PayloadType(line);
+			if (payload_type >= 0 && !keep.count(payload_type)) {
+				continue;
+			}
+		}
+		*munged += line + "\r\n";
+	}
+	return true;
+}
+
+void StampReader::OnFrameAvailable(VideoRenderer* renderer) {
+	RenderStatsSnapshot stats = renderer->GetStats();
+	{
+		rtc::CritScope cs(&lock_);
+		stats_ = stats;
+	}
+	if (stats.width <= 0 || stats.height <= 0) {
+		return;
+	}
+	argb_.resize(static_cast<size_t>(stats.width) * stats.height * 4);
+	if (!renderer->RenderTo(argb_.data(), stats.width * 4, stats.width, stats.height)) {
+		return;
+	}
+	int64_t now_us = rtc::TimeMicros();
+	uint32_t stamp;
+	if (!ReadFrameStamp(argb_.data(), stats.width * 4, stats.width, stats.height, &stamp)) {
+		unreadable_++;
+		return;
+	}
+	rtc::CritScope cs(&lock_);
+	arrivals_.push_back({ stamp, now_us });
+}
+
+std::vector<StampReader::Arrival> StampReader::TakeArrivals() {
+	rtc::CritScope cs(&lock_);
+	std::vector<Arrival> arrivals;
+	arrivals.swap(arrivals_);
+	return arrivals;
+}
+
+RenderStatsSnapshot StampReader::stats() const {
+	rtc::CritScope cs(&lock_);
+	return stats_;
+}
+
+LoopbackPeer::LoopbackPeer(VideoRenderBackend* backend)
+	: backend_(backend), gathered_(false, false) {}
+
+LoopbackPeer::~LoopbackPeer() {
+	Close();
+}
+
+bool LoopbackPeer::Create(webrtc::PeerConnectionFactoryInterface* factory,
+	int start_bitrate_bps, int max_bitrate_bps) {
+	webrtc::PeerConnectionInterface::RTCConfiguration config;
+	config.tcp_candidate_policy = webrtc::PeerConnectionInterface::TcpCandidatePolicy::kTcpCandidatePolicyDisabled;
+	config.bundle_policy = webrtc::PeerConnectionInterface::BundlePolicy::kBundlePolicyMaxBundle;
+	config.rtcp_mux_policy = webrtc::PeerConnectionInterface::RtcpMuxPolicy::kRtcpMuxPolicyRequire;
+	config.sdp_semantics = webrtc::SdpSemantics::kUnifiedPlan;
+	config.disable_ipv6 = true;
+	// Host candidates only, a STUN server would hold up the gathering.
+	pc_ = factory->CreatePeerConnection(config, nullptr, nullptr, this);
+	if (!pc_) {
+		return false;
+	}
+	webrtc::PeerConnectionInterface::BitrateParameters bitrate;
+	bitrate.current_bitrate_bps = absl::optional<int>(start_bitrate_bps);
+	bitrate.max_bitrate_bps = absl::optional<int>(max_bitrate_bps);
+	pc_->SetBitrate(bitrate);
+	return true;
+}
+
+bool LoopbackPeer::AddTrack(webrtc::VideoTrackInterface* track) {
+	auto result_or_error = pc_->AddTrack(track, { kStreamId });
+	if (!result_or_error.ok()) {
+		RTC_LOG(LS_ERROR) << "Failed to add the video track: "
+			<< result_or_error.error().message();
+		return false;
+	}
+	return true;
+}
+
+std::string LoopbackPeer::CreateLocalDescription(bool offer, const std::string& codec,
+	bool* unsupported) {
+	rtc::scoped_refptr<CreateDescriptionObserver> create(
+		new rtc::RefCountedObject<CreateDescriptionObserver>());
+	if (offer) {
+		pc_->CreateOffer(create, webrtc::PeerConnectionInterface::RTCOfferAnswerOptions());
+	}
+	else {
+		pc_->CreateAnswer(create, webrtc::PeerConnectionInterface::RTCOfferAnswerOptions());
+	}
+	std::unique_ptr<webrtc::SessionDescriptionInterface> desc = create->Wait();
+	if (!desc) {
+		return std::string();
+	}
+	std::string sdp;
+	desc->ToString(&sdp);
+	if (!codec.empty()) {
+		std::string munged;
+		if (!PreferVideoCodec(sdp, codec, &munged)) {
+			*unsupported = true;
+			return std::string();
+		}
+		sdp = munged;
+	}
+	if (!SetDescription(true, offer ? webrtc::SdpType::kOffer : webrtc::SdpType::kAnswer, sdp)) {
+		return std::string();
+	}
+	if (!gathered_.Wait(kSetupTimeoutMs)) {
+		RTC_LOG(LS_ERROR) << "ICE gathering did not complete";
+		return std::string();
+	}
+	std::string complete;
+	pc_->local_description()->ToString(&complete);
+	return complete;
+}
+
+bool LoopbackPeer::SetRemoteDescription(webrtc::SdpType type, const std::string& sdp) {
+	return SetDescription(false, type, sdp);
+}
+
+void LoopbackPeer::Close() {
+	renderer_.reset();
+	if (pc_) {
+		pc_->Close();
+		pc_ = nullptr;
+	}
+}
+
+void LoopbackPeer::OnIceGatheringChange(webrtc::PeerConnectionInterface::IceGatheringState new_state) {
+	if (new_state == webrtc::PeerConnectionInterface::kIceGatheringComplete) {
+		gathered_.Set();
+	}
+}
+
+void LoopbackPeer::OnTrack(rtc::scoped_refptr<webrtc::RtpTransceiverInterface> transceiver) {
+	rtc::scoped_refptr<webrtc::MediaStreamTrackInterface> track =
+		transceiver->receiver()->track();
+	if (backend_ && track->kind() == webrtc::MediaStreamTrackInterface::kVideoKind) {
+		renderer_.reset(new VideoRenderer(backend_,
+			static_cast<webrtc::VideoTrackInterface*>(track.get())));
+	}
+}
+
+bool LoopbackPeer::SetDescription(bool local, webrtc::SdpType type, const std::string& sdp) {
+	std::unique_ptr<webrtc::SessionDescriptionInterface> desc =
+		webrtc::CreateSessionDescription(type, sdp);
+	if (!desc) {
+		RTC_LOG(LS_ERROR) << "Failed to parse the description: " << sdp;
+		return false;
+	}
+	rtc::scoped_refptr<SetDescriptionObserver> observer(
+		new rtc::RefCountedObject<SetDescriptionObserver>());
+	if (local) {
+		pc_->SetLocalDescription(observer, desc.release());
+	}
+	else {
+		pc_->SetRemoteDescription(observer, desc.release());
+	}
+	return observer->Wait();
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/peerconnectioninterface.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "video_renderer.h"
+
+// Rewrites the video section of |sdp| to offer |codec| only, along with the
+// rtx payload types that repair it. False if |sdp| does not offer |codec|.
+// This WebRTC has no SetCodecPreferences, so the SDP is munged instead.
+bool PreferVideoCodec(const std::string& sdp, const std::string& codec, std::string* munged);
+
+// Backend that draws every decoded frame the moment it arrives, at its own
+// size, and reads the stamp back from the ARGB output (frame_stamp.h).
+class StampReader : public VideoRenderBackend {
+public:
+	struct Arrival {
+		uint32_t stamp;
+		int64_t render_us;
+	};
+
+	StampReader() : unreadable_(0) {}
+
+	// Called on the decode thread.
+	void OnFrameAvailable(VideoRenderer* renderer) override;
+
+	// The frames read since the last call.
+	std::vector<Arrival> TakeArrivals();
+
+	int64_t unreadable() const { return unreadable_; }
+
+	// Renderer stats as of the last frame that arrived.
+	RenderStatsSnapshot stats() const;
+
+private:
+	std::vector<uint8_t> argb_;//decode thread only
+	rtc::CriticalSection lock_;
+	std::vector<Arrival> arrivals_;
+	RenderStatsSnapshot stats_;
+	std::atomic<int64_t> unreadable_;
+};
+
+// One PeerConnection of a call set up inside the process, and the renderer
+// of the video it receives. Candidates are not trickled: descriptions are
+// exchanged once gathering is complete, with every candidate in them. The
+// calls block, so they must not be made on the signaling thread.
+class LoopbackPeer : public webrtc::PeerConnectionObserver {
+public:
+	// Received video goes to |backend|, if any.
+	explicit LoopbackPeer(VideoRenderBackend* backend);
+	~LoopbackPeer() override;
+
+	bool Create(webrtc::PeerConnectionFactoryInterface* factory, int start_bitrate_bps,
+		int max_bitrate_bps);
+
+	bool AddTrack(webrtc::VideoTrackInterface* track);
+
+	// Creates and applies the offer or answer, with only |codec| in the video
+	// section unless it is empty, and returns it once the candidates are
+	// gathered. Empty on failure; |unsupported| tells that the factories do
+	// not support |codec|.
+	std::string CreateLocalDescription(bool offer, const std::string& codec, bool* unsupported);
+
+	bool SetRemoteDescription(webrtc::SdpType type, const std::string& sdp);
+
+	void Close();
+
+	// PeerConnectionObserver implementation, on the signaling thread.
+	void OnSignalingChange(webrtc::PeerConnectionInterface::SignalingState new_state) override {}
+	void OnDataChannel(rtc::scoped_refptr<webrtc::DataChannelInterface> channel) override {}
+	void OnRenegotiationNeeded() override {}
+	void OnIceConnectionChange(webrtc::PeerConnectionInterface::IceConnectionState new_state) override {}
+	void OnIceGatheringChange(webrtc::PeerConnectionInterface::IceGatheringState new_state) override;
+	void OnIceCandidate(const webrtc::IceCandidateInterface* candidate) override {}
+	void OnTrack(rtc::scoped_refptr<webrtc::RtpTransceiverInterface> transceiver) override;
+
+private:
+	bool SetDescription(bool local, webrtc::SdpType type, const std::string& sdp);
+
+	VideoRenderBackend* backend_;
+	rtc::scoped_refptr<webrtc::PeerConnectionInterface> pc_;
+	rtc::Event gathered_;
+	std::unique_ptr<VideoRenderer> renderer_;
+};
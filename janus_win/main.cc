@@ -11,6 +11,7 @@
 #include "conductor.h"
 #include "conductor_ws.h"
 #include "flagdefs.h"
+#include "headless_audio_device.h"
 #include "main_wnd.h"
 #include "peer_connection_client.h"
 #include "peer_connection_wsclient.h"
@@ -18,6 +19,7 @@
 #include "rtc_base/ssladapter.h"
 #include "rtc_base/win32socketinit.h"
 #include "rtc_base/win32socketserver.h"
+#include "trace_recorder.h"
 
 #include "defaults.h"
 
@@ -48,6 +50,22 @@ int PASCAL wWinMain(HINSTANCE instance,
     return -1;
   }
 
+  // A bot that asked for a file must not fall back to the microphone.
+  std::string wav_error;
+  if (strlen(FLAG_audio_file) > 0 &&
+      !CheckLoopableWav(FLAG_audio_file, &wav_error)) {
+    printf("Error: %s\n", wav_error.c_str());
+    return -1;
+  }
+
+  // Before anything creates a WebRTC object, which would look its trace
+  // categories up without the recorder.
+  if (strlen(FLAG_trace_file) > 0) {
+    InstallTraceRecorder(FLAG_trace_file, FLAG_trace_categories,
+                         static_cast<size_t>(FLAG_trace_buffer_events));
+    StartTracing();
+  }
+
   MainWnd wnd(FLAG_server, FLAG_port, FLAG_autoconnect, FLAG_autocall);
   if (!wnd.Create()) {
     RTC_NOTREACHED();
@@ -59,6 +77,50 @@ int PASCAL wWinMain(HINSTANCE instance,
   PeerConnectionWsClient client;
   rtc::scoped_refptr<ConductorWs> conductor(
 	  new rtc::RefCountedObject<ConductorWs>(&client, &wnd));
+  CaptureTarget capture_target;
+  capture_target.width = FLAG_capture_width;
+  capture_target.height = FLAG_capture_height;
+  capture_target.fps = FLAG_capture_fps;
+  conductor->SetCaptureTarget(capture_target);
+  if (FLAG_synthetic_video || strlen(FLAG_video_file) > 0) {
+    SyntheticVideoOptions video_options;
+    video_options.y4m_path = FLAG_video_file;
+    video_options.width = FLAG_capture_width;
+    video_options.height = FLAG_capture_height;
+    video_options.fps = FLAG_capture_fps;
+    conductor->EnableSyntheticVideo(video_options);
+  }
+  if (FLAG_headless_audio || strlen(FLAG_audio_file) > 0) {
+    HeadlessAudioOptions audio_options;
+    audio_options.wav_path = FLAG_audio_file;
+    audio_options.sine_hz = static_cast<float>(FLAG_audio_sine_hz);
+    audio_options.checksum_playout = FLAG_audio_checksum_playout;
+    conductor->EnableHeadlessAudio(audio_options);
+  }
+  if (FLAG_cpu_adaptation) {
+    conductor->EnableCpuAdaptation();
+  }
+  if (FLAG_screen_share) {
+    ScreenShareOptions screen_options;
+    screen_options.window_id = FLAG_screen_share_window;
+    screen_options.fps = FLAG_screen_share_fps;
+    screen_options.cursor = FLAG_screen_share_cursor;
+    conductor->EnableScreenShare(screen_options);
+  }
+  if (FLAG_render_workers > 0) {
+    conductor->EnableRenderWorkers(FLAG_render_workers, FLAG_render_pin_cores);
+  }
+  if (FLAG_render_stats_interval_s > 0) {
+    conductor->EnableRenderStatsLog(FLAG_render_stats_interval_s * 1000);
+  }
+  if (strlen(FLAG_frame_dump_dir) > 0) {
+    conductor->EnableFrameDump(FLAG_frame_dump_dir,
+                               static_cast<size_t>(FLAG_frame_dump_max_mb) << 20,
+                               FLAG_frame_dump_files);
+  }
+  if (strlen(FLAG_join_records_file) > 0) {
+    conductor->EnableJoinRecords(FLAG_join_records_file);
+  }
 #else
   PeerConnectionClient client;
   rtc::scoped_refptr<Conductor> conductor(
@@ -86,6 +148,7 @@ int PASCAL wWinMain(HINSTANCE instance,
     }
   }
 
+  FinishTracing();
   rtc::CleanupSSL();
   return 0;
 }
@@ -18,6 +18,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/stringutils.h"
+#include "trace_recorder.h"
 #include "third_party/libyuv/include/libyuv/convert_argb.h"
 
 ATOM MainWnd::wnd_class_ = 0;
@@ -151,6 +152,10 @@ bool MainWnd::PreTranslateMessage(MSG* msg) {
         }
       }
     }
+  } else if (msg->message == WM_KEYDOWN && msg->wParam == VK_F9) {
+    // Starts tracing, or stops it and writes the trace file.
+    ToggleTracing();
+    ret = true;
   } else if (msg->hwnd == NULL && msg->message == UI_THREAD_CALLBACK) {
     callback_->UIThreadCallback(static_cast<int>(msg->wParam),
                                 reinterpret_cast<void*>(msg->lParam));
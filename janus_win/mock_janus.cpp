@@ -0,0 +1,632 @@
+#include "mock_janus.h"
+
+#include <stdio.h>
+
+#include <chrono>
+#include <sstream>
+#include <vector>
+
+#include "rtc_base/logging.h"
+
+namespace {
+
+const char kVideoRoomPlugin[] = "janus.plugin.videoroom";
+
+// Janus core error codes.
+const int kErrorUnknownRequest = 453;
+const int kErrorInvalidJson = 454;
+const int kErrorMissingElement = 456;
+const int kErrorSessionNotFound = 458;
+const int kErrorHandleNotFound = 459;
+const int kErrorPluginNotFound = 460;
+
+// Videoroom plugin error codes.
+const int kVideoRoomErrorUnknownRequest = 499;
+const int kVideoRoomErrorJoinFirst = 424;
+const int kVideoRoomErrorAlreadyJoined = 425;
+const int kVideoRoomErrorNoSuchFeed = 428;
+const int kVideoRoomErrorMissingElement = 429;
+const int kVideoRoomErrorInvalidElement = 430;
+
+// A parsable SDP with one audio and one video section; its candidates never
+// answer, as the mock only does signaling.
+std::string FakeSdp(bool offer, long long int id) {
+	std::ostringstream sdp;
+	sdp << "v=0\r\n"
+		<< "o=- " << id << " 2 IN IP4 127.0.0.1\r\n"
+		<< "s=VideoRoom\r\n"
+		<< "t=0 0\r\n"
+		<< "a=group:BUNDLE audio video\r\n"
+		<< "a=msid-semantic: WMS janus\r\n";
+	const char* const kMids[] = { "audio", "video" };
+	for (const char* mid : kMids) {
+		bool audio = mid == kMids[0];
+		sdp << "m=" << mid << " 9 UDP/TLS/RTP/SAVPF " << (audio ? 111 : 96) << "\r\n"
+			<< "c=IN IP4 127.0.0.1\r\n"
+			<< "a=ice-ufrag:mock\r\n"
+			<< "a=ice-pwd:mockjanusmockjanusmockja\r\n"
+			<< "a=ice-options:trickle\r\n"
+			<< "a=fingerprint:sha-256 ";
+		for (int i = 0; i < 32; ++i) {
+			sdp << (i ? ":" : "") << "5A";
+		}
+		sdp << "\r\n"
+			<< "a=setup:" << (offer ? "actpass" : "active") << "\r\n"
+			<< "a=mid:" << mid << "\r\n"
+			<< "a=" << (offer ? "sendonly" : "recvonly") << "\r\n"
+			<< "a=rtcp-mux\r\n";
+		if (audio) {
+			sdp << "a=rtpmap:111 opus/48000/2\r\n";
+		}
+		else {
+			sdp << "a=rtpmap:96 VP8/90000\r\n";
+		}
+		if (offer) {
+			long long int ssrc = id % 100000000 * 2 + (audio ? 0 : 1);
+			sdp << "a=ssrc:" << ssrc << " cname:janus" << id << "\r\n"
+				<< "a=ssrc:" << ssrc << " msid:janus" << id << " janus" << mid << "\r\n";
+		}
+	}
+	return sdp.str();
+}
+
+Json::Value Jsep(bool offer, long long int id) {
+	Json::Value jsep;
+	jsep["type"] = offer ? "offer" : "answer";
+	jsep["sdp"] = FakeSdp(offer, id);
+	return jsep;
+}
+
+}  // namespace
+
+MockJanus::MockJanus(const MockJanusOptions& options)
+	: options_(options),
+	rng_(options.seed),
+	// Ids count up from a base that depends on the seed, and stay below 2^31
+	// since JanusHandle keeps them as ints.
+	next_id_(100000 + (options.seed % 1000) * 1000000LL),
+	connections_(0),
+	requests_(0),
+	replies_(0),
+	events_(0),
+	errors_(0) {
+}
+
+MockJanus::~MockJanus() {
+	Stop();
+}
+
+bool MockJanus::Start() {
+	hub_.onConnection([this](Socket* ws, uWS::HttpRequest req) {
+		// Janus refuses WebSocket clients without its subprotocol.
+		uWS::Header protocol = req.getHeader("sec-websocket-protocol");
+		if (!protocol ||
+			protocol.toString().find("janus-protocol") == std::string::npos) {
+			RTC_LOG(WARNING) << "Mock Janus: connection without janus-protocol";
+			ws->close(1002);
+			return;
+		}
+		connections_++;
+	});
+	hub_.onMessage([this](Socket* ws, char* message, size_t length, uWS::OpCode) {
+		OnMessage(ws, std::string(message, length));
+	});
+	hub_.onDisconnection([this](Socket* ws, int code, char* message, size_t length) {
+		OnDisconnection(ws);
+	});
+	if (!hub_.listen("127.0.0.1", options_.port)) {
+		RTC_LOG(LS_ERROR) << "Mock Janus can not listen on port " << options_.port;
+		return false;
+	}
+
+	// Stop() wakes the loop with this to close everything from its own thread.
+	stop_async_ = new uS::Async(hub_.getLoop());
+	stop_async_->setData(this);
+	stop_async_->start([](uS::Async* async) {
+		MockJanus* janus = static_cast<MockJanus*>(async->getData());
+		for (PendingReply* pending : janus->pending_) {
+			pending->timer->stop();
+			pending->timer->close();
+			delete pending;
+		}
+		janus->pending_.clear();
+		janus->sessions_.clear();
+		janus->handles_.clear();
+		janus->rooms_.clear();
+		janus->hub_.getDefaultGroup<uWS::SERVER>().close();
+		async->close();
+	});
+
+	thread_ = std::thread([this]() {
+		hub_.run();
+	});
+	RTC_LOG(INFO) << "Mock Janus listening on " << url();
+	return true;
+}
+
+void MockJanus::Stop() {
+	if (!thread_.joinable()) {
+		return;
+	}
+	stop_async_->send();
+	thread_.join();
+}
+
+std::string MockJanus::url() const {
+	return "ws://127.0.0.1:" + std::to_string(options_.port);
+}
+
+MockJanusStats MockJanus::stats() const {
+	MockJanusStats stats;
+	stats.connections = connections_;
+	stats.requests = requests_;
+	stats.replies = replies_;
+	stats.events = events_;
+	stats.errors = errors_;
+	return stats;
+}
+
+void MockJanus::OnMessage(Socket* ws, const std::string& message) {
+	requests_++;
+	Json::Reader reader;
+	Json::Value request;
+	if (!reader.parse(message, request) || !request.isObject()) {
+		SendError(ws, 0, "", kErrorInvalidJson, "JSON error");
+		return;
+	}
+	std::string janus;
+	std::string transaction;
+	rtc::GetStringFromJsonObject(request, "janus", &janus);
+	rtc::GetStringFromJsonObject(request, "transaction", &transaction);
+	if (janus.empty() || transaction.empty()) {
+		SendError(ws, 0, transaction, kErrorMissingElement,
+			"Missing mandatory element (janus or transaction)");
+		return;
+	}
+
+	if (janus == "create") {
+		long long int session_id = next_id_++;
+		sessions_[session_id].ws = ws;
+		Json::Value reply;
+		reply["janus"] = "success";
+		reply["transaction"] = transaction;
+		reply["data"]["id"] = session_id;
+		Send(ws, reply);
+		return;
+	}
+
+	long long int session_id = request["session_id"].isIntegral() ?
+		request["session_id"].asInt64() : 0;
+	auto session = sessions_.find(session_id);
+	if (session == sessions_.end() || session->second.ws != ws) {
+		SendError(ws, session_id, transaction, kErrorSessionNotFound,
+			"No such session " + std::to_string(session_id));
+		return;
+	}
+
+	Json::Value reply;
+	reply["session_id"] = session_id;
+	reply["transaction"] = transaction;
+	if (janus == "keepalive") {
+		reply["janus"] = "ack";
+		Send(ws, reply);
+	}
+	else if (janus == "attach") {
+		HandleAttach(ws, request, session_id);
+	}
+	else if (janus == "destroy") {
+		DestroySession(session_id);
+		reply["janus"] = "success";
+		Send(ws, reply);
+	}
+	else if (janus == "detach" || janus == "message" || janus == "trickle") {
+		long long int handle_id = request["handle_id"].isIntegral() ?
+			request["handle_id"].asInt64() : 0;
+		if (!session->second.handles.count(handle_id)) {
+			SendError(ws, session_id, transaction, kErrorHandleNotFound,
+				"No such handle " + std::to_string(handle_id));
+			return;
+		}
+		if (janus == "detach") {
+			DetachHandle(handle_id);
+			reply["janus"] = "success";
+			Send(ws, reply);
+		}
+		else if (janus == "message") {
+			HandleMessage(ws, request, session_id);
+		}
+		else {
+			// Candidates are only acknowledged, there is no media to connect.
+			reply["janus"] = "ack";
+			Send(ws, reply);
+		}
+	}
+	else {
+		SendError(ws, session_id, transaction, kErrorUnknownRequest,
+			"Unknown request '" + janus + "'");
+	}
+}
+
+void MockJanus::OnDisconnection(Socket* ws) {
+	for (auto it = pending_.begin(); it != pending_.end();) {
+		PendingReply* pending = *it;
+		if (pending->ws == ws) {
+			pending->timer->stop();
+			pending->timer->close();
+			delete pending;
+			it = pending_.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+	// Like Janus, tear down the sessions of the connection, which the other
+	// participants of their rooms hear about.
+	std::vector<long long int> closed;
+	for (auto& session : sessions_) {
+		if (session.second.ws == ws) {
+			session.second.ws = nullptr;
+			closed.push_back(session.first);
+		}
+	}
+	for (long long int session_id : closed) {
+		DestroySession(session_id);
+	}
+}
+
+void MockJanus::HandleAttach(Socket* ws, const Json::Value& request,
+	long long int session_id) {
+	std::string plugin;
+	rtc::GetStringFromJsonObject(request, "plugin", &plugin);
+	std::string transaction = request["transaction"].asString();
+	if (plugin != kVideoRoomPlugin) {
+		SendError(ws, session_id, transaction, kErrorPluginNotFound,
+			"No such plugin '" + plugin + "'");
+		return;
+	}
+	long long int handle_id = next_id_++;
+	Handle& handle = handles_[handle_id];
+	handle.session_id = session_id;
+	handle.plugin = plugin;
+	sessions_[session_id].handles.insert(handle_id);
+
+	Json::Value reply;
+	reply["janus"] = "success";
+	reply["session_id"] = session_id;
+	reply["transaction"] = transaction;
+	reply["data"]["id"] = handle_id;
+	Send(ws, reply);
+}
+
+void MockJanus::HandleMessage(Socket* ws, const Json::Value& request,
+	long long int session_id) {
+	long long int handle_id = request["handle_id"].asInt64();
+	std::string transaction = request["transaction"].asString();
+	const Json::Value& body = request["body"];
+	if (!body.isObject()) {
+		SendError(ws, session_id, transaction, kErrorMissingElement,
+			"Missing mandatory element (body)");
+		return;
+	}
+
+	// Janus acks at once and lets the plugin answer with an event later.
+	Json::Value ack;
+	ack["janus"] = "ack";
+	ack["session_id"] = session_id;
+	ack["transaction"] = transaction;
+	int after_ms = Send(ws, ack);
+
+	std::string what;
+	rtc::GetStringFromJsonObject(body, "request", &what);
+	if (what == "join") {
+		HandleJoin(handle_id, body, transaction, after_ms);
+	}
+	else if (what == "configure" || what == "publish") {
+		HandleConfigure(handle_id, request["jsep"], transaction, after_ms);
+	}
+	else if (what == "start") {
+		HandleStart(handle_id, transaction, after_ms);
+	}
+	else if (what == "leave" || what == "unpublish") {
+		HandleLeave(handle_id, transaction, after_ms);
+	}
+	else {
+		SendPluginError(handle_id, kVideoRoomErrorUnknownRequest,
+			"Unknown request '" + what + "'", transaction, after_ms);
+	}
+}
+
+void MockJanus::HandleJoin(long long int handle_id, const Json::Value& body,
+	const std::string& transaction, int after_ms) {
+	Handle& handle = handles_[handle_id];
+	if (handle.room) {
+		SendPluginError(handle_id, kVideoRoomErrorAlreadyJoined,
+			"Already in a room", transaction, after_ms);
+		return;
+	}
+	if (!body["room"].isIntegral()) {
+		SendPluginError(handle_id, kVideoRoomErrorMissingElement,
+			"Missing element (room)", transaction, after_ms);
+		return;
+	}
+	// Rooms are created on first use.
+	long long int room = body["room"].asInt64();
+	std::string ptype;
+	rtc::GetStringFromJsonObject(body, "ptype", &ptype);
+	Json::Value data;
+	data["room"] = room;
+	if (ptype == "publisher") {
+		std::map<long long int, long long int>& feeds = rooms_[room];
+		long long int feed = body["id"].isIntegral() ? body["id"].asInt64() : 0;
+		if (!feed || feeds.count(feed)) {
+			feed = next_id_++;
+		}
+		handle.room = room;
+		handle.feed = feed;
+		handle.publisher = true;
+		rtc::GetStringFromJsonObject(body, "display", &handle.display);
+		feeds[feed] = handle_id;
+
+		data["videoroom"] = "joined";
+		data["description"] = "Room " + std::to_string(room);
+		data["id"] = feed;
+		data["private_id"] = static_cast<Json::UInt>(rng_());
+		data["publishers"] = Publishers(room, feed);
+		SendEvent(handle_id, data, transaction, after_ms);
+	}
+	else if (ptype == "subscriber" || ptype == "listener") {
+		long long int feed = body["feed"].isIntegral() ? body["feed"].asInt64() : 0;
+		auto feeds = rooms_.find(room);
+		if (feeds == rooms_.end() || !feeds->second.count(feed) ||
+			!handles_[feeds->second[feed]].published) {
+			SendPluginError(handle_id, kVideoRoomErrorNoSuchFeed,
+				"No such feed (" + std::to_string(feed) + ")", transaction, after_ms);
+			return;
+		}
+		handle.room = room;
+		handle.feed = feed;
+		handle.publisher = false;
+
+		data["videoroom"] = "attached";
+		data["id"] = feed;
+		data["display"] = handles_[feeds->second[feed]].display;
+		SendEvent(handle_id, data, transaction, after_ms, Jsep(true, feed));
+	}
+	else {
+		SendPluginError(handle_id, kVideoRoomErrorInvalidElement,
+			"Invalid element (ptype)", transaction, after_ms);
+	}
+}
+
+void MockJanus::HandleConfigure(long long int handle_id, const Json::Value& jsep,
+	const std::string& transaction, int after_ms) {
+	Handle& handle = handles_[handle_id];
+	if (!handle.room) {
+		SendPluginError(handle_id, kVideoRoomErrorJoinFirst,
+			"Can't configure, not in a room", transaction, after_ms);
+		return;
+	}
+	Json::Value data;
+	data["videoroom"] = "event";
+	data["room"] = handle.room;
+	data["configured"] = "ok";
+	std::string type;
+	rtc::GetStringFromJsonObject(jsep, "type", &type);
+	if (!handle.publisher || type != "offer") {
+		SendEvent(handle_id, data, transaction, after_ms);
+		return;
+	}
+	SendEvent(handle_id, data, transaction, after_ms, Jsep(false, handle.feed));
+	if (!handle.published) {
+		// The first offer publishes the feed to the rest of the room.
+		handle.published = true;
+		Json::Value publisher;
+		publisher["id"] = handle.feed;
+		publisher["display"] = handle.display;
+		Json::Value notification;
+		notification["videoroom"] = "event";
+		notification["room"] = handle.room;
+		notification["publishers"].append(publisher);
+		NotifyRoom(handle_id, notification, after_ms);
+	}
+}
+
+void MockJanus::HandleStart(long long int handle_id, const std::string& transaction,
+	int after_ms) {
+	const Handle& handle = handles_[handle_id];
+	if (!handle.room || handle.publisher) {
+		SendPluginError(handle_id, kVideoRoomErrorJoinFirst,
+			"Can't start, not a subscriber", transaction, after_ms);
+		return;
+	}
+	Json::Value data;
+	data["videoroom"] = "event";
+	data["room"] = handle.room;
+	data["started"] = "ok";
+	SendEvent(handle_id, data, transaction, after_ms);
+}
+
+void MockJanus::HandleLeave(long long int handle_id, const std::string& transaction,
+	int after_ms) {
+	const Handle& handle = handles_[handle_id];
+	if (!handle.room) {
+		SendPluginError(handle_id, kVideoRoomErrorJoinFirst,
+			"Can't leave, not in a room", transaction, after_ms);
+		return;
+	}
+	Json::Value data;
+	data["videoroom"] = "event";
+	data["room"] = handle.room;
+	if (handle.publisher) {
+		data["leaving"] = "ok";
+	}
+	else {
+		data["left"] = "ok";
+	}
+	LeaveRoom(handle_id, after_ms);
+	SendEvent(handle_id, data, transaction, after_ms);
+}
+
+void MockJanus::LeaveRoom(long long int handle_id, int after_ms) {
+	Handle& handle = handles_[handle_id];
+	if (handle.room && handle.publisher) {
+		Json::Value notification;
+		notification["videoroom"] = "event";
+		notification["room"] = handle.room;
+		if (handle.published) {
+			notification["unpublished"] = handle.feed;
+			NotifyRoom(handle_id, notification, after_ms);
+			notification.removeMember("unpublished");
+		}
+		notification["leaving"] = handle.feed;
+		NotifyRoom(handle_id, notification, after_ms);
+		rooms_[handle.room].erase(handle.feed);
+		if (rooms_[handle.room].empty()) {
+			rooms_.erase(handle.room);
+		}
+	}
+	handle.room = 0;
+	handle.feed = 0;
+	handle.publisher = false;
+	handle.published = false;
+}
+
+void MockJanus::DetachHandle(long long int handle_id) {
+	LeaveRoom(handle_id, 0);
+	sessions_[handles_[handle_id].session_id].handles.erase(handle_id);
+	handles_.erase(handle_id);
+}
+
+void MockJanus::DestroySession(long long int session_id) {
+	std::set<long long int> handles = sessions_[session_id].handles;
+	for (long long int handle_id : handles) {
+		DetachHandle(handle_id);
+	}
+	sessions_.erase(session_id);
+}
+
+void MockJanus::SendEvent(long long int handle_id, const Json::Value& data,
+	const std::string& transaction, int after_ms, const Json::Value& jsep) {
+	const Handle& handle = handles_[handle_id];
+	auto session = sessions_.find(handle.session_id);
+	if (session == sessions_.end() || !session->second.ws) {
+		return;
+	}
+	Json::Value event;
+	event["janus"] = "event";
+	event["session_id"] = handle.session_id;
+	event["sender"] = handle_id;
+	if (!transaction.empty()) {
+		event["transaction"] = transaction;
+	}
+	event["plugindata"]["plugin"] = handle.plugin;
+	event["plugindata"]["data"] = data;
+	if (!jsep.isNull()) {
+		event["jsep"] = jsep;
+	}
+	events_++;
+	Send(session->second.ws, event, after_ms);
+}
+
+void MockJanus::SendPluginError(long long int handle_id, int code,
+	const std::string& reason, const std::string& transaction, int after_ms) {
+	Json::Value data;
+	data["videoroom"] = "event";
+	data["error_code"] = code;
+	data["error"] = reason;
+	errors_++;
+	SendEvent(handle_id, data, transaction, after_ms);
+}
+
+void MockJanus::SendError(Socket* ws, long long int session_id,
+	const std::string& transaction, int code, const std::string& reason) {
+	Json::Value reply;
+	reply["janus"] = "error";
+	if (session_id) {
+		reply["session_id"] = session_id;
+	}
+	if (!transaction.empty()) {
+		reply["transaction"] = transaction;
+	}
+	reply["error"]["code"] = code;
+	reply["error"]["reason"] = reason;
+	errors_++;
+	Send(ws, reply);
+}
+
+void MockJanus::NotifyRoom(long long int handle_id, const Json::Value& data,
+	int after_ms) {
+	const Handle& handle = handles_[handle_id];
+	auto feeds = rooms_.find(handle.room);
+	if (feeds == rooms_.end()) {
+		return;
+	}
+	for (const auto& feed : feeds->second) {
+		if (feed.second != handle_id) {
+			SendEvent(feed.second, data, "", after_ms);
+		}
+	}
+}
+
+Json::Value MockJanus::Publishers(long long int room, long long int except_feed) const {
+	Json::Value publishers(Json::arrayValue);
+	auto feeds = rooms_.find(room);
+	if (feeds == rooms_.end()) {
+		return publishers;
+	}
+	for (const auto& feed : feeds->second) {
+		const Handle& handle = handles_.at(feed.second);
+		if (feed.first != except_feed && handle.published) {
+			Json::Value publisher;
+			publisher["id"] = feed.first;
+			publisher["display"] = handle.display;
+			publishers.append(publisher);
+		}
+	}
+	return publishers;
+}
+
+int MockJanus::Send(Socket* ws, const Json::Value& reply, int after_ms) {
+	int delay_ms = after_ms + options_.delay_ms;
+	if (options_.jitter_ms > 0) {
+		delay_ms += static_cast<int>(rng_() % (options_.jitter_ms + 1));
+	}
+	Json::FastWriter writer;
+	std::string text = writer.write(reply);
+	if (delay_ms <= 0) {
+		ws->send(text.data(), text.size(), uWS::TEXT);
+		replies_++;
+		return 0;
+	}
+
+	PendingReply* pending = new PendingReply{ this, ws, text,
+		new uS::Timer(hub_.getLoop()) };
+	pending_.insert(pending);
+	pending->timer->setData(pending);
+	pending->timer->start([](uS::Timer* timer) {
+		PendingReply* pending = static_cast<PendingReply*>(timer->getData());
+		pending->ws->send(pending->text.data(), pending->text.size(), uWS::TEXT);
+		pending->janus->replies_++;
+		pending->janus->pending_.erase(pending);
+		timer->stop();
+		timer->close();
+		delete pending;
+	}, delay_ms, 0);
+	return delay_ms;
+}
+
+bool RunMockJanus(const MockJanusOptions& options) {
+	MockJanus janus(options);
+	if (!janus.Start()) {
+		return false;
+	}
+	printf("Mock Janus on %s, delay %d ms, jitter %d ms\n", janus.url().c_str(),
+		options.delay_ms, options.jitter_ms);
+	for (;;) {
+		std::this_thread::sleep_for(std::chrono::seconds(10));
+		MockJanusStats stats = janus.stats();
+		RTC_LOG(INFO) << "Mock Janus: connections=" << stats.connections
+			<< " requests=" << stats.requests << " replies=" << stats.replies
+			<< " events=" << stats.events << " errors=" << stats.errors;
+	}
+}
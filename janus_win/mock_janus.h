@@ -0,0 +1,141 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "rtc_base/json.h"
+
+#include "uWs.h"
+
+struct MockJanusOptions {
+	int port = 8188;
+	// Every reply leaves |delay_ms| plus up to |jitter_ms| after its request,
+	// and a plugin event as long again after its ack.
+	int delay_ms = 0;
+	int jitter_ms = 0;
+	// Seeds the jitter and the ids, so that runs are reproducible.
+	uint32_t seed = 1;
+};
+
+struct MockJanusStats {
+	int64_t connections = 0;
+	int64_t requests = 0;
+	int64_t replies = 0;
+	int64_t events = 0;
+	int64_t errors = 0;
+};
+
+// Local stand-in for a Janus gateway with the videoroom plugin, for signaling
+// benchmarks that must not depend on a live server. Speaks the
+// janus-protocol WebSocket subprotocol on a uWS::Hub of its own thread and
+// answers create, attach, detach, destroy, message (join, configure, start,
+// leave), trickle and keepalive the way Janus does, including the publisher
+// events of the other participants of a room. The SDPs it sends are canned;
+// no media is ever set up.
+class MockJanus {
+public:
+	explicit MockJanus(const MockJanusOptions& options);
+	~MockJanus();
+
+	// Listens on 127.0.0.1 and starts the loop thread, false if the port can
+	// not be bound.
+	bool Start();
+	// Closes every connection and joins the loop thread.
+	void Stop();
+
+	// ws:// address for PeerConnectionWsClient::Connect().
+	std::string url() const;
+	MockJanusStats stats() const;
+
+private:
+	typedef uWS::WebSocket<uWS::SERVER> Socket;
+
+	struct Session {
+		Socket* ws;
+		std::set<long long int> handles;
+	};
+
+	struct Handle {
+		long long int session_id;
+		std::string plugin;
+		long long int room = 0;
+		// The feed this handle publishes, or subscribes to.
+		long long int feed = 0;
+		bool publisher = false;
+		bool published = false;
+		std::string display;
+	};
+
+	// A reply waiting for its timer.
+	struct PendingReply {
+		MockJanus* janus;
+		Socket* ws;
+		std::string text;
+		uS::Timer* timer;
+	};
+
+	void OnMessage(Socket* ws, const std::string& message);
+	void OnDisconnection(Socket* ws);
+
+	void HandleAttach(Socket* ws, const Json::Value& request, long long int session_id);
+	void HandleMessage(Socket* ws, const Json::Value& request, long long int session_id);
+	// The videoroom requests. |after_ms| is the delay of the ack, which the
+	// events they send must not overtake.
+	void HandleJoin(long long int handle_id, const Json::Value& body,
+		const std::string& transaction, int after_ms);
+	void HandleConfigure(long long int handle_id, const Json::Value& jsep,
+		const std::string& transaction, int after_ms);
+	void HandleStart(long long int handle_id, const std::string& transaction,
+		int after_ms);
+	void HandleLeave(long long int handle_id, const std::string& transaction,
+		int after_ms);
+	// Leaves the room of |handle_id|, if any, telling the other publishers.
+	void LeaveRoom(long long int handle_id, int after_ms);
+	void DetachHandle(long long int handle_id);
+	void DestroySession(long long int session_id);
+
+	// Sends a plugin event from |handle_id| to its session. |transaction| is
+	// empty for the notifications Janus sends on its own.
+	void SendEvent(long long int handle_id, const Json::Value& data,
+		const std::string& transaction, int after_ms,
+		const Json::Value& jsep = Json::Value());
+	void SendPluginError(long long int handle_id, int code, const std::string& reason,
+		const std::string& transaction, int after_ms);
+	void SendError(Socket* ws, long long int session_id, const std::string& transaction,
+		int code, const std::string& reason);
+	// Sends |data| to the other publishers of the room of |handle_id|.
+	void NotifyRoom(long long int handle_id, const Json::Value& data, int after_ms);
+	// The published feeds of |room| but |except_feed|, as Janus lists them.
+	Json::Value Publishers(long long int room, long long int except_feed) const;
+
+	// Sends |reply| |after_ms| plus a delay drawn from the options from now,
+	// and returns that delay.
+	int Send(Socket* ws, const Json::Value& reply, int after_ms = 0);
+
+	const MockJanusOptions options_;
+	uWS::Hub hub_;
+	std::thread thread_;
+	uS::Async* stop_async_ = nullptr;
+	std::mt19937 rng_;
+	long long int next_id_;
+	std::map<long long int, Session> sessions_;
+	std::map<long long int, Handle> handles_;
+	// Feed to handle of the publishers in each room.
+	std::map<long long int, std::map<long long int, long long int>> rooms_;
+	std::set<PendingReply*> pending_;
+	std::atomic<int64_t> connections_;
+	std::atomic<int64_t> requests_;
+	std::atomic<int64_t> replies_;
+	std::atomic<int64_t> events_;
+	std::atomic<int64_t> errors_;
+};
+
+// Serves |options| until the process is killed, logging the stats every ten
+// seconds. Returns false if the server can not be started.
+bool RunMockJanus(const MockJanusOptions& options);
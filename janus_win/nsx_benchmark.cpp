@@ -0,0 +1,166 @@
+#include "nsx_benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "modules/audio_processing/ns/noise_suppression_x.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+namespace {
+
+enum NsxPath { kPathC, kPathSSE2, kPathAVX2, kNumPaths };
+
+const char* const kPathNames[kNumPaths] = { "C", "SSE2", "AVX2" };
+
+const size_t kBandLength = 160;
+
+// WebRtcNsx_InitCore() picks its kernels through WebRtc_GetCPUInfo, so the
+// benchmark swaps in this one to hide the features above |g_max_path|.
+NsxPath g_max_path = kPathC;
+WebRtc_CPUInfo g_cpu_info = nullptr;
+
+int CappedCPUInfo(CPUFeature feature) {
+	if (feature == kAVX2 && g_max_path < kPathAVX2) {
+		return 0;
+	}
+	if (feature == kSSE2 && g_max_path < kPathSSE2) {
+		return 0;
+	}
+	return g_cpu_info(feature);
+}
+
+// FNV-1a over the output, compared against the C path.
+uint32_t Hash(const int16_t* data, size_t length, uint32_t hash) {
+	for (size_t i = 0; i < length; ++i) {
+		hash = (hash ^ static_cast<uint16_t>(data[i])) * 16777619u;
+	}
+	return hash;
+}
+
+// Voiced bursts over a noise floor, so the noise estimate keeps tracking.
+std::vector<int16_t> MakeInput(int frames, int num_bands) {
+	std::mt19937 rng(1);
+	std::normal_distribution<double> noise(0.0, 300.0);
+	std::vector<int16_t> input(static_cast<size_t>(frames) * num_bands * kBandLength);
+	for (size_t i = 0; i < input.size(); ++i) {
+		double t = static_cast<double>(i) / 16000;
+		double envelope = (i / 8000) % 2 ? 0.0 : 0.5 + 0.5 * sin(2 * M_PI * 3 * t);
+		double sample = 8000 * envelope * (sin(2 * M_PI * 180 * t) +
+			0.5 * sin(2 * M_PI * 720 * t)) + noise(rng);
+		input[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, sample)));
+	}
+	return input;
+}
+
+// Processes |input| on a fresh instance and returns the output hash, the
+// elapsed time goes to |elapsed_us|.
+uint32_t Process(uint32_t fs, int num_bands, const std::vector<int16_t>& input,
+	int64_t* elapsed_us) {
+	size_t band_length = fs == 8000 ? 80 : kBandLength;
+	size_t frames = input.size() / (num_bands * kBandLength);
+	std::vector<int16_t> output(input.size());
+	NsxHandle* nsx = WebRtcNsx_Create();
+	WebRtcNsx_Init(nsx, fs);
+	WebRtcNsx_set_policy(nsx, 2);
+
+	int64_t start_us = rtc::TimeMicros();
+	for (size_t frame = 0; frame < frames; ++frame) {
+		const int16_t* in[2];
+		int16_t* out[2];
+		for (int band = 0; band < num_bands; ++band) {
+			size_t offset = (frame * num_bands + band) * kBandLength;
+			in[band] = input.data() + offset;
+			out[band] = output.data() + offset;
+		}
+		WebRtcNsx_Process(nsx, in, num_bands, out);
+	}
+	*elapsed_us = rtc::TimeMicros() - start_us;
+	WebRtcNsx_Free(nsx);
+
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < output.size(); i += kBandLength) {
+		hash = Hash(output.data() + i, band_length, hash);
+	}
+	return hash;
+}
+
+}  // namespace
+
+void RunNsxBenchmark(int frames) {
+	frames = std::max(frames, 1);
+	// The SPL pointers are set once per process; keep them on the best path
+	// so only the noise suppression kernels differ between runs.
+	WebRtcSpl_Init();
+	g_cpu_info = WebRtc_GetCPUInfo;
+
+	bool supported[kNumPaths] = { true, g_cpu_info(kSSE2) != 0,
+		g_cpu_info(kAVX2) != 0 };
+	const uint32_t kRates[] = { 8000, 16000, 32000 };
+	const int kRounds = 3;
+
+	printf("frames=%d\n", frames);
+	printf("rate\tC us/frame\tSSE2 us/frame\tAVX2 us/frame\tbit-exact\n");
+	for (uint32_t fs : kRates) {
+		int num_bands = fs > 16000 ? 2 : 1;
+		std::vector<int16_t> input = MakeInput(frames, num_bands);
+		uint32_t reference = 0;
+		double us_per_frame[kNumPaths] = { 0, 0, 0 };
+		bool exact = true;
+		for (int path = 0; path < kNumPaths; ++path) {
+			if (!supported[path]) {
+				continue;
+			}
+			g_max_path = static_cast<NsxPath>(path);
+			WebRtc_GetCPUInfo = CappedCPUInfo;
+			// Best of a few rounds, to keep interrupts and frequency ramps out.
+			int64_t best_us = INT64_MAX;
+			bool path_exact = true;
+			for (int round = 0; round < kRounds; ++round) {
+				int64_t elapsed_us = 0;
+				uint32_t hash = Process(fs, num_bands, input, &elapsed_us);
+				best_us = std::min(best_us, elapsed_us);
+				if (path == kPathC) {
+					reference = hash;
+				}
+				else if (hash != reference) {
+					path_exact = false;
+				}
+			}
+			WebRtc_GetCPUInfo = g_cpu_info;
+			if (!path_exact) {
+				exact = false;
+				RTC_LOG(LS_ERROR) << "NSX " << kPathNames[path] << " at " << fs
+					<< " Hz differs from the C version";
+			}
+			us_per_frame[path] = static_cast<double>(best_us) / frames;
+		}
+		printf("%u", fs);
+		for (int path = 0; path < kNumPaths; ++path) {
+			if (supported[path]) {
+				printf("\t%.2f", us_per_frame[path]);
+			}
+			else {
+				printf("\t-");
+			}
+		}
+		printf("\t%s\n", exact ? "yes" : "NO");
+	}
+}
+
+#else
+
+void RunNsxBenchmark(int frames) {
+	printf("The noise suppression benchmark needs an x86 CPU\n");
+}
+
+#endif  // WEBRTC_ARCH_X86_FAMILY
@@ -10,6 +10,9 @@
 #include "modules/audio_processing/include/audio_processing.h"
 #include "modules/video_capture/video_capture_factory.h"
 
+// Frames buffered for the dump writer before new ones are dropped.
+const size_t kFrameDumpQueueSize = 16;
+
 class DummySetSessionDescriptionObserver
 	: public webrtc::SetSessionDescriptionObserver {
 public:
@@ -23,6 +26,31 @@ public:
 	}
 };
 
+// Stamps |phase| of a handle once the remote description is applied.
+class TimedSetSessionDescriptionObserver
+	: public DummySetSessionDescriptionObserver {
+public:
+	static TimedSetSessionDescriptionObserver* Create(JoinTimeline* timeline,
+		long long int handleId, JoinPhase phase) {
+		return new rtc::RefCountedObject<TimedSetSessionDescriptionObserver>(
+			timeline, handleId, phase);
+	}
+	void OnSuccess() override {
+		DummySetSessionDescriptionObserver::OnSuccess();
+		timeline_->Mark(handle_id_, phase_);
+	}
+
+protected:
+	TimedSetSessionDescriptionObserver(JoinTimeline* timeline, long long int handleId,
+		JoinPhase phase)
+		: timeline_(timeline), handle_id_(handleId), phase_(phase) {}
+
+private:
+	JoinTimeline* timeline_;
+	long long int handle_id_;
+	JoinPhase phase_;
+};
+
 PeerConnection::PeerConnection()
 {
 }
@@ -44,8 +72,16 @@ long long int PeerConnection::GetHandleId() {
 	return m_HandleId;
 }
 
+void PeerConnection::SetJoinTimeline(JoinTimeline* timeline) {
+	join_timeline_ = timeline;
+}
+
 //CreateSessionDescriptionObserver implementation.
 void PeerConnection::OnSuccess(webrtc::SessionDescriptionInterface* desc) {
+	if (join_timeline_) {
+		join_timeline_->Mark(m_HandleId,
+			desc->GetType() == webrtc::SdpType::kOffer ? kJoinOfferCreated : kJoinAnswerApplied);
+	}
 	peer_connection_->SetLocalDescription(
 		DummySetSessionDescriptionObserver::Create(), desc);
 
@@ -83,6 +119,15 @@ void PeerConnection::OnRemoveTrack(
 	//main_wnd_->QueueUIThreadCallback(TRACK_REMOVED, receiver->track().release());
 }
 
+void PeerConnection::OnIceConnectionChange(
+	webrtc::PeerConnectionInterface::IceConnectionState new_state) {
+	if (join_timeline_ &&
+		(new_state == webrtc::PeerConnectionInterface::kIceConnectionConnected ||
+			new_state == webrtc::PeerConnectionInterface::kIceConnectionCompleted)) {
+		join_timeline_->Mark(m_HandleId, kJoinIceConnected);
+	}
+}
+
 void PeerConnection::OnIceCandidate(const webrtc::IceCandidateInterface* candidate) {
 	RTC_LOG(INFO) << __FUNCTION__ << " " << candidate->sdp_mline_index();
 
@@ -111,80 +156,30 @@ void PeerConnection::CreateAnswer() {
 
 
 void PeerConnection::SetRemoteDescription(webrtc::SessionDescriptionInterface* session_description) {
-	peer_connection_->SetRemoteDescription(
-		DummySetSessionDescriptionObserver::Create(),
-		session_description);
+	rtc::scoped_refptr<webrtc::SetSessionDescriptionObserver> observer;
+	if (join_timeline_) {
+		observer = TimedSetSessionDescriptionObserver::Create(join_timeline_, m_HandleId,
+			session_description->GetType() == webrtc::SdpType::kOffer ?
+			kJoinOfferCreated : kJoinAnswerApplied);
+	}
+	else {
+		observer = DummySetSessionDescriptionObserver::Create();
+	}
+	peer_connection_->SetRemoteDescription(observer, session_description);
 }
 
-void PeerConnection::StartRenderer(HWND wnd,webrtc::VideoTrackInterface* remote_video) {
-	renderer_.reset(new VideoRenderer(wnd, 1, 1, remote_video));
+void PeerConnection::StartRenderer(VideoRenderBackend* backend,webrtc::VideoTrackInterface* remote_video) {
+	renderer_.reset(new VideoRenderer(backend, remote_video));
+	renderer_->SetLabel(std::to_string(m_HandleId));
 }
 
 void PeerConnection::StopRenderer() {
+	dump_sink_.reset();
 	renderer_.reset();
 }
 
-// VideoRenderer Class Implementation
-//
-
-VideoRenderer::VideoRenderer(
-	HWND wnd,
-	int width,
-	int height,
-	webrtc::VideoTrackInterface* track_to_render)
-	: wnd_(wnd), rendered_track_(track_to_render) {
-	::InitializeCriticalSection(&buffer_lock_);
-	ZeroMemory(&bmi_, sizeof(bmi_));
-	bmi_.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-	bmi_.bmiHeader.biPlanes = 1;
-	bmi_.bmiHeader.biBitCount = 32;
-	bmi_.bmiHeader.biCompression = BI_RGB;
-	bmi_.bmiHeader.biWidth = width;
-	bmi_.bmiHeader.biHeight = -height;
-	bmi_.bmiHeader.biSizeImage =
-		width * height * (bmi_.bmiHeader.biBitCount >> 3);
-	rendered_track_->AddOrUpdateSink(this, rtc::VideoSinkWants());
-}
-
-VideoRenderer::~VideoRenderer() {
-	rendered_track_->RemoveSink(this);
-	::DeleteCriticalSection(&buffer_lock_);
-}
-
-void VideoRenderer::SetSize(int width, int height) {
-	AutoLock<VideoRenderer> lock(this);
-
-	if (width == bmi_.bmiHeader.biWidth && height == bmi_.bmiHeader.biHeight) {
-		return;
-	}
-
-	bmi_.bmiHeader.biWidth = width;
-	bmi_.bmiHeader.biHeight = -height;
-	bmi_.bmiHeader.biSizeImage =
-		width * height * (bmi_.bmiHeader.biBitCount >> 3);
-	image_.reset(new uint8_t[bmi_.bmiHeader.biSizeImage]);
-}
-
-void VideoRenderer::OnFrame(const webrtc::VideoFrame& video_frame) {
-	{
-		AutoLock<VideoRenderer> lock(this);
-
-		rtc::scoped_refptr<webrtc::I420BufferInterface> buffer(
-			video_frame.video_frame_buffer()->ToI420());
-		if (video_frame.rotation() != webrtc::kVideoRotation_0) {
-			buffer = webrtc::I420Buffer::Rotate(*buffer, video_frame.rotation());
-		}
-
-		SetSize(buffer->width(), buffer->height());
-
-		RTC_DCHECK(image_.get() != NULL);
-		libyuv::I420ToARGB(buffer->DataY(), buffer->StrideY(), buffer->DataU(),
-			buffer->StrideU(), buffer->DataV(), buffer->StrideV(),
-			image_.get(),
-			bmi_.bmiHeader.biWidth * bmi_.bmiHeader.biBitCount / 8,
-			buffer->width(), buffer->height());
-	}
-	InvalidateRect(wnd_, NULL, TRUE);
+void PeerConnection::StartFrameDump(webrtc::VideoTrackInterface* video, const std::string& dir,
+	size_t max_file_size, size_t num_files) {
+	dump_sink_.reset(new Y4mDumpSink(video, dir, "handle_" + std::to_string(m_HandleId),
+		max_file_size, num_files, kFrameDumpQueueSize));
 }
-
-
@@ -9,11 +9,10 @@
 
 #include "api/mediastreaminterface.h"
 #include "api/video/video_frame.h"
-#include "api/video/i420_buffer.h"
-#include "third_party/libyuv/include/libyuv/convert_argb.h"
 #include "api/peerconnectioninterface.h"
-#include "main_wnd.h"
-#include "peer_connection_wsclient.h"
+#include "video_renderer.h"
+#include "join_timeline.h"
+#include "y4m_dump_sink.h"
 #include "JanusTransaction.h"
 #include "JanusHandle.h"
 
@@ -40,51 +39,6 @@ struct NEW_TRACK {
 	webrtc::MediaStreamTrackInterface* pInterface;
 };
 
-// A little helper class to make sure we always to proper locking and
-// unlocking when working with VideoRenderer buffers.
-template <typename T>
-class AutoLock {
-public:
-	explicit AutoLock(T* obj) : obj_(obj) { obj_->Lock(); }
-	~AutoLock() { obj_->Unlock(); }
-
-protected:
-	T * obj_;
-};
-
-class VideoRenderer : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
-public:
-	VideoRenderer(HWND wnd,
-		int width,
-		int height,
-		webrtc::VideoTrackInterface* track_to_render);
-	virtual ~VideoRenderer();
-
-	void Lock() { ::EnterCriticalSection(&buffer_lock_); }
-
-	void Unlock() { ::LeaveCriticalSection(&buffer_lock_); }
-
-	// VideoSinkInterface implementation
-	void OnFrame(const webrtc::VideoFrame& frame) override;
-
-	const BITMAPINFO& bmi() const { return bmi_; }
-	const uint8_t* image() const { return image_.get(); }
-
-protected:
-	void SetSize(int width, int height);
-
-	enum {
-		SET_SIZE,
-		RENDER_FRAME,
-	};
-
-	HWND wnd_;
-	BITMAPINFO bmi_;
-	std::unique_ptr<uint8_t[]> image_;
-	CRITICAL_SECTION buffer_lock_;
-	rtc::scoped_refptr<webrtc::VideoTrackInterface> rendered_track_;
-};
-
 class PeerConnectionCallback {
 public:
 	virtual void PCSendSDP(long long int handleId,std::string sdpType,std::string sdp) = 0;
@@ -105,11 +59,16 @@ public:
 	void RegisterObserver(PeerConnectionCallback* callback);
 	void SetHandleId(long long int handleId);
 	long long int GetHandleId();
+	// Stamps the SDP and ICE phases of this handle on |timeline|.
+	void SetJoinTimeline(JoinTimeline* timeline);
 	void CreateOffer();
 	void CreateAnswer();
 	void SetRemoteDescription(webrtc::SessionDescriptionInterface* session_description);
-	void StartRenderer(HWND wnd,webrtc::VideoTrackInterface* remote_video);
+	void StartRenderer(VideoRenderBackend* backend,webrtc::VideoTrackInterface* remote_video);
 	void StopRenderer();
+	// Records |video| to Y4M files named after the handle in |dir|.
+	void StartFrameDump(webrtc::VideoTrackInterface* video, const std::string& dir,
+		size_t max_file_size, size_t num_files);
 protected:
 	// PeerConnectionObserver implementation.
 	void OnSignalingChange(
@@ -124,7 +83,7 @@ protected:
 		rtc::scoped_refptr<webrtc::DataChannelInterface> channel) override {}
 	void OnRenegotiationNeeded() override {}
 	void OnIceConnectionChange(
-		webrtc::PeerConnectionInterface::IceConnectionState new_state) override {};
+		webrtc::PeerConnectionInterface::IceConnectionState new_state) override;
 	void OnIceGatheringChange(
 		webrtc::PeerConnectionInterface::IceGatheringState new_state) override {};
 	void OnIceCandidate(const webrtc::IceCandidateInterface* candidate) override;
@@ -137,8 +96,10 @@ public:
 	rtc::scoped_refptr<webrtc::PeerConnectionInterface> peer_connection_;
 	bool b_publisher_=false;//pub or sub
 	std::unique_ptr<VideoRenderer> renderer_;//b_publisher decide local_render or remote_render
+	std::unique_ptr<Y4mDumpSink> dump_sink_;
 private:
 	PeerConnectionCallback *m_pConductorCallback=NULL;
 	long long int m_HandleId=0;//coresponding to the janus handleId	
+	JoinTimeline* join_timeline_=NULL;
 };
 
@@ -0,0 +1,99 @@
+#include "render_benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "frame_worker_pool.h"
+#include "headless_render_backend.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+
+namespace {
+
+// Moving gradient so that consecutive frames differ.
+rtc::scoped_refptr<webrtc::I420Buffer> CreatePatternBuffer(int width, int height, int seq) {
+	rtc::scoped_refptr<webrtc::I420Buffer> buffer =
+		webrtc::I420Buffer::Create(width, height);
+	for (int y = 0; y < height; ++y) {
+		uint8_t* row = buffer->MutableDataY() + y * buffer->StrideY();
+		for (int x = 0; x < width; ++x) {
+			row[x] = static_cast<uint8_t>(x + y + seq * 4);
+		}
+	}
+	int chroma_height = (height + 1) / 2;
+	int chroma_width = (width + 1) / 2;
+	for (int y = 0; y < chroma_height; ++y) {
+		memset(buffer->MutableDataU() + y * buffer->StrideU(), 128 + (seq & 63), chroma_width);
+		memset(buffer->MutableDataV() + y * buffer->StrideV(), 128 - (seq & 63), chroma_width);
+	}
+	return buffer;
+}
+
+}  // namespace
+
+void RunRenderBenchmark(const RenderBenchmarkConfig& config) {
+	const int kPatterns = 8;
+	std::vector<rtc::scoped_refptr<webrtc::I420Buffer>> patterns;
+	for (int i = 0; i < kPatterns; ++i) {
+		patterns.push_back(CreatePatternBuffer(config.frame_width, config.frame_height, i));
+	}
+
+	std::unique_ptr<FrameWorkerPool> pool;
+	if (config.workers > 0) {
+		pool.reset(new FrameWorkerPool(config.workers, config.pin_cores));
+	}
+
+	printf("workers=%d\n", config.workers);
+	printf("tiles\tcomposites/s\tms/composite\tframes/s\tdropped\tKB/renderer\tp99 us/tile\n");
+	for (int tiles = 1; tiles <= config.max_tiles; ++tiles) {
+		HeadlessRenderBackend backend(config.surface_width, config.surface_height);
+		backend.SetDumpOptions(config.dump_dir, config.dump_interval);
+		backend.SetWorkerPool(pool.get());
+
+		std::vector<std::unique_ptr<VideoRenderer>> owned;
+		std::vector<VideoRenderer*> renderers;
+		for (int i = 0; i < tiles; ++i) {
+			owned.emplace_back(new VideoRenderer(&backend, nullptr));
+			renderers.push_back(owned.back().get());
+		}
+
+		int64_t start_us = rtc::TimeMicros();
+		for (int n = 0; n < config.frames; ++n) {
+			for (int i = 0; i < tiles; ++i) {
+				webrtc::VideoFrame frame = webrtc::VideoFrame::Builder()
+					.set_video_frame_buffer(patterns[(n + i) % kPatterns])
+					.set_timestamp_us(rtc::TimeMicros())
+					.build();
+				renderers[i]->OnFrame(frame);
+			}
+			backend.Compose(renderers);
+		}
+		int64_t elapsed_us = rtc::TimeMicros() - start_us;
+		if (elapsed_us <= 0) {
+			elapsed_us = 1;
+		}
+
+		int64_t dropped = 0;
+		size_t resident = 0;
+		int64_t conversion_p99_us = 0;
+		for (VideoRenderer* renderer : renderers) {
+			RenderStatsSnapshot stats = renderer->GetStats();
+			dropped += stats.frames_dropped;
+			resident += stats.resident_bytes;
+			conversion_p99_us = std::max(conversion_p99_us, stats.conversion_p99_us);
+		}
+		double composites_per_s = config.frames * 1e6 / elapsed_us;
+		printf("%d\t%.1f\t%.3f\t%.1f\t%lld\t%.1f\t%lld\n", tiles, composites_per_s,
+			elapsed_us / 1000.0 / config.frames, composites_per_s * tiles,
+			static_cast<long long>(dropped), resident / 1024.0 / tiles,
+			static_cast<long long>(conversion_p99_us));
+		RTC_LOG(INFO) << "render benchmark: " << tiles << " tiles, "
+			<< composites_per_s << " composites/s";
+	}
+}
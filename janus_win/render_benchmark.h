@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+struct RenderBenchmarkConfig {
+	int max_tiles = 16;
+	int frames = 300;//composites per tile count
+	int frame_width = 1280;
+	int frame_height = 720;
+	int surface_width = 1920;
+	int surface_height = 1080;
+	std::string dump_dir;//empty: no composites written
+	int dump_interval = 0;
+	int workers = 0;//0: convert on the feeding thread
+	bool pin_cores = false;
+};
+
+// Feeds synthetic I420 frames into 1..max_tiles headless renderers, composes
+// them and logs the composite rate and resident memory per renderer for each
+// tile count. With workers, the tiles of one composite are converted in
+// parallel, so the rate shows how the conversion scales across workers.
+void RunRenderBenchmark(const RenderBenchmarkConfig& config);
@@ -0,0 +1,115 @@
+#include "render_stats.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <sstream>
+
+namespace {
+
+const int64_t kRateBucketMs = 100;
+const size_t kRateBuckets = 50;//5 s window
+const size_t kIntervalWindow = 60;
+const size_t kConversionWindow = 300;
+const int64_t kMinFreezeExtraMs = 150;
+
+}  // namespace
+
+std::string RenderStatsSnapshot::ToString() const {
+	std::ostringstream os;
+	os.precision(1);
+	os << std::fixed << width << "x" << height
+		<< " recv_fps=" << received_fps
+		<< " render_fps=" << rendered_fps
+		<< " frames=" << frames_received << "/" << frames_rendered
+		<< " dropped=" << frames_dropped
+		<< " freezes=" << freeze_count << " (" << total_freeze_ms << " ms)"
+		<< " jitter_ms=" << jitter_ms
+		<< " conv_us p50=" << conversion_p50_us << " p99=" << conversion_p99_us
+		<< " res_changes=" << resolution_changes
+		<< " resident_kb=" << resident_bytes / 1024;
+	return os.str();
+}
+
+RenderStats::RenderStats()
+	: received_rate_(kRateBucketMs, kRateBuckets),
+	rendered_rate_(kRateBucketMs, kRateBuckets),
+	intervals_ms_(kIntervalWindow),
+	conversion_p50_(0.5f),
+	conversion_p99_(0.99f) {
+}
+
+void RenderStats::OnFrameReceived(int64_t now_ms, int width, int height) {
+	rtc::CritScope cs(&lock_);
+	received_rate_.AddSamples(1);
+	frames_received_++;
+
+	if (width != width_ || height != height_) {
+		if (width_ != 0) {
+			resolution_changes_++;
+		}
+		width_ = width;
+		height_ = height;
+	}
+
+	if (last_frame_ms_ >= 0) {
+		int64_t interval_ms = now_ms - last_frame_ms_;
+		if (intervals_ms_.count() > 0) {
+			double average_ms = intervals_ms_.ComputeMean();
+			double threshold_ms = std::max(3 * average_ms, average_ms + kMinFreezeExtraMs);
+			if (interval_ms > threshold_ms) {
+				freeze_count_++;
+				total_freeze_ms_ += interval_ms;
+			}
+		}
+		if (last_interval_ms_ >= 0) {
+			// Smoothed like the RTP interarrival jitter (RFC 3550).
+			double deviation = static_cast<double>(llabs(interval_ms - last_interval_ms_));
+			jitter_ms_ += (deviation - jitter_ms_) / 16.0;
+		}
+		intervals_ms_.AddSample(interval_ms);
+		last_interval_ms_ = interval_ms;
+	}
+	last_frame_ms_ = now_ms;
+}
+
+void RenderStats::OnFrameDropped() {
+	rtc::CritScope cs(&lock_);
+	frames_dropped_++;
+}
+
+void RenderStats::OnFrameRendered(bool new_frame, int64_t conversion_us) {
+	rtc::CritScope cs(&lock_);
+	if (new_frame) {
+		rendered_rate_.AddSamples(1);
+		frames_rendered_++;
+	}
+
+	conversion_window_us_.push_back(conversion_us);
+	conversion_p50_.Insert(conversion_us);
+	conversion_p99_.Insert(conversion_us);
+	if (conversion_window_us_.size() > kConversionWindow) {
+		conversion_p50_.Erase(conversion_window_us_.front());
+		conversion_p99_.Erase(conversion_window_us_.front());
+		conversion_window_us_.pop_front();
+	}
+}
+
+RenderStatsSnapshot RenderStats::GetSnapshot() const {
+	rtc::CritScope cs(&lock_);
+	RenderStatsSnapshot snapshot;
+	snapshot.received_fps = received_rate_.ComputeRate();
+	snapshot.rendered_fps = rendered_rate_.ComputeRate();
+	snapshot.frames_received = frames_received_;
+	snapshot.frames_rendered = frames_rendered_;
+	snapshot.frames_dropped = frames_dropped_;
+	snapshot.freeze_count = freeze_count_;
+	snapshot.total_freeze_ms = total_freeze_ms_;
+	snapshot.jitter_ms = jitter_ms_;
+	snapshot.conversion_p50_us = conversion_p50_.GetPercentileValue();
+	snapshot.conversion_p99_us = conversion_p99_.GetPercentileValue();
+	snapshot.width = width_;
+	snapshot.height = height_;
+	snapshot.resolution_changes = resolution_changes_;
+	return snapshot;
+}
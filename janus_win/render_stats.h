@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <deque>
+#include <string>
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/numerics/percentile_filter.h"
+#include "rtc_base/ratetracker.h"
+#include "rtc_base/rollingaccumulator.h"
+
+struct RenderStatsSnapshot {
+	double received_fps = 0.0;
+	double rendered_fps = 0.0;
+	int64_t frames_received = 0;
+	int64_t frames_rendered = 0;
+	int64_t frames_dropped = 0;
+	int freeze_count = 0;
+	int64_t total_freeze_ms = 0;
+	double jitter_ms = 0.0;//mean deviation of the inter-frame interval
+	int64_t conversion_p50_us = 0;
+	int64_t conversion_p99_us = 0;
+	int width = 0;
+	int height = 0;
+	int resolution_changes = 0;
+	size_t resident_bytes = 0;
+
+	std::string ToString() const;
+};
+
+// Rolling quality-of-experience metrics of one renderer. Frame arrivals feed
+// the received rate, jitter and freeze detection; renders feed the rendered
+// rate and the conversion time percentiles.
+//
+// A freeze is an inter-frame interval longer than
+// max(3 * average interval, average interval + 150 ms).
+class RenderStats {
+public:
+	RenderStats();
+
+	void OnFrameReceived(int64_t now_ms, int width, int height);
+	void OnFrameDropped();
+	// |new_frame| is false when an already rendered frame is drawn again.
+	void OnFrameRendered(bool new_frame, int64_t conversion_us);
+
+	RenderStatsSnapshot GetSnapshot() const;
+
+private:
+	rtc::CriticalSection lock_;
+	rtc::RateTracker received_rate_;
+	rtc::RateTracker rendered_rate_;
+	rtc::RollingAccumulator<int64_t> intervals_ms_;
+	int64_t last_frame_ms_ = -1;
+	int64_t last_interval_ms_ = -1;
+	double jitter_ms_ = 0.0;
+	int64_t frames_received_ = 0;
+	int64_t frames_rendered_ = 0;
+	int64_t frames_dropped_ = 0;
+	int freeze_count_ = 0;
+	int64_t total_freeze_ms_ = 0;
+	int width_ = 0;
+	int height_ = 0;
+	int resolution_changes_ = 0;
+	std::deque<int64_t> conversion_window_us_;
+	webrtc::PercentileFilter<int64_t> conversion_p50_;
+	webrtc::PercentileFilter<int64_t> conversion_p99_;
+};
@@ -0,0 +1,251 @@
+#include "resample_benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "common_audio/signal_processing/resample_by_2_internal.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+namespace {
+
+enum ResamplePath { kPathC, kPathSSE2, kPathAVX2, kNumPaths };
+
+const char* const kPathNames[kNumPaths] = { "C", "SSE2", "AVX2" };
+
+// Large enough for the scratch memory of every 10 ms resampler.
+const size_t kTmpMemSize = 1024;
+
+// The resamplers work on 10 ms frames.
+struct Conversion {
+	const char* name;
+	int in_rate_hz;
+	int out_rate_hz;
+};
+
+const Conversion kConversions[] = {
+	{ "48->16", 48000, 16000 },
+	{ "16->48", 16000, 48000 },
+	{ "48->8", 48000, 8000 },
+	{ "8->48", 8000, 48000 },
+};
+
+// The resampling kernels are SPL function pointers that WebRtcSpl_Init()
+// sets once per process, so the benchmark points them at each path itself
+// and restores them afterwards. The allpass filters have no AVX2 versions.
+struct ResamplePointers {
+	Resample48khzTo32khz resample_48_32;
+	Resample32khzTo24khz resample_32_24;
+	DownBy2IntToShort down_int_short;
+	DownBy2ShortToInt down_short_int;
+	UpBy2ShortToInt up_short_int;
+	UpBy2IntToInt up_int_int;
+	UpBy2IntToShort up_int_short;
+	LPBy2ShortToInt lp_short_int;
+	LPBy2IntToInt lp_int_int;
+};
+
+ResamplePointers GetPointers() {
+	ResamplePointers p;
+	p.resample_48_32 = WebRtcSpl_Resample48khzTo32khz;
+	p.resample_32_24 = WebRtcSpl_Resample32khzTo24khz;
+	p.down_int_short = WebRtcSpl_DownBy2IntToShort;
+	p.down_short_int = WebRtcSpl_DownBy2ShortToInt;
+	p.up_short_int = WebRtcSpl_UpBy2ShortToInt;
+	p.up_int_int = WebRtcSpl_UpBy2IntToInt;
+	p.up_int_short = WebRtcSpl_UpBy2IntToShort;
+	p.lp_short_int = WebRtcSpl_LPBy2ShortToInt;
+	p.lp_int_int = WebRtcSpl_LPBy2IntToInt;
+	return p;
+}
+
+void SetPointers(const ResamplePointers& p) {
+	WebRtcSpl_Resample48khzTo32khz = p.resample_48_32;
+	WebRtcSpl_Resample32khzTo24khz = p.resample_32_24;
+	WebRtcSpl_DownBy2IntToShort = p.down_int_short;
+	WebRtcSpl_DownBy2ShortToInt = p.down_short_int;
+	WebRtcSpl_UpBy2ShortToInt = p.up_short_int;
+	WebRtcSpl_UpBy2IntToInt = p.up_int_int;
+	WebRtcSpl_UpBy2IntToShort = p.up_int_short;
+	WebRtcSpl_LPBy2ShortToInt = p.lp_short_int;
+	WebRtcSpl_LPBy2IntToInt = p.lp_int_int;
+}
+
+ResamplePointers PointersFor(ResamplePath path) {
+	ResamplePointers p;
+	if (path == kPathC) {
+		p.resample_48_32 = WebRtcSpl_Resample48khzTo32khzC;
+		p.resample_32_24 = WebRtcSpl_Resample32khzTo24khzC;
+		p.down_int_short = WebRtcSpl_DownBy2IntToShortC;
+		p.down_short_int = WebRtcSpl_DownBy2ShortToIntC;
+		p.up_short_int = WebRtcSpl_UpBy2ShortToIntC;
+		p.up_int_int = WebRtcSpl_UpBy2IntToIntC;
+		p.up_int_short = WebRtcSpl_UpBy2IntToShortC;
+		p.lp_short_int = WebRtcSpl_LPBy2ShortToIntC;
+		p.lp_int_int = WebRtcSpl_LPBy2IntToIntC;
+		return p;
+	}
+	if (path == kPathAVX2) {
+		p.resample_48_32 = WebRtcSpl_Resample48khzTo32khzAVX2;
+		p.resample_32_24 = WebRtcSpl_Resample32khzTo24khzAVX2;
+	}
+	else {
+		p.resample_48_32 = WebRtcSpl_Resample48khzTo32khzSSE2;
+		p.resample_32_24 = WebRtcSpl_Resample32khzTo24khzSSE2;
+	}
+	p.down_int_short = WebRtcSpl_DownBy2IntToShortSSE2;
+	p.down_short_int = WebRtcSpl_DownBy2ShortToIntSSE2;
+	p.up_short_int = WebRtcSpl_UpBy2ShortToIntSSE2;
+	p.up_int_int = WebRtcSpl_UpBy2IntToIntSSE2;
+	p.up_int_short = WebRtcSpl_UpBy2IntToShortSSE2;
+	p.lp_short_int = WebRtcSpl_LPBy2ShortToIntSSE2;
+	p.lp_int_int = WebRtcSpl_LPBy2IntToIntSSE2;
+	return p;
+}
+
+// FNV-1a, compared against the C path.
+uint32_t Hash(const void* data, size_t bytes, uint32_t hash) {
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < bytes; ++i) {
+		hash = (hash ^ p[i]) * 16777619u;
+	}
+	return hash;
+}
+
+// Voiced bursts with a moving pitch over a noise floor, at full scale now
+// and then so the saturating paths are exercised too.
+std::vector<int16_t> MakeInput(int seconds, int rate_hz) {
+	std::mt19937 rng(rate_hz);
+	std::normal_distribution<double> noise(0.0, 300.0);
+	std::vector<int16_t> input(static_cast<size_t>(seconds) * rate_hz);
+	double phase = 0;
+	for (size_t i = 0; i < input.size(); ++i) {
+		double t = static_cast<double>(i) / rate_hz;
+		double pitch = 140 + 40 * sin(2 * M_PI * 0.5 * t);
+		phase += 2 * M_PI * pitch / rate_hz;
+		double level = (i / rate_hz) % 4 == 3 ? 40000 : 8000;
+		double sample = level * (sin(phase) + 0.5 * sin(3 * phase) +
+			0.25 * sin(5 * phase)) + noise(rng);
+		input[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, sample)));
+	}
+	return input;
+}
+
+struct ResampleRun {
+	int64_t elapsed_us = 0;
+	uint32_t hash = 2166136261u;
+};
+
+// Converts |input| frame by frame with fresh state; only the resampler calls
+// are timed.
+ResampleRun Convert(const Conversion& conversion,
+	const std::vector<int16_t>& input) {
+	ResampleRun run;
+	const size_t in_frame = conversion.in_rate_hz / 100;
+	const size_t out_frame = conversion.out_rate_hz / 100;
+	std::vector<int16_t> output(out_frame);
+	std::vector<int32_t> tmpmem(kTmpMemSize);
+	WebRtcSpl_State48khzTo16khz state_48_16;
+	WebRtcSpl_State16khzTo48khz state_16_48;
+	WebRtcSpl_State48khzTo8khz state_48_8;
+	WebRtcSpl_State8khzTo48khz state_8_48;
+	WebRtcSpl_ResetResample48khzTo16khz(&state_48_16);
+	WebRtcSpl_ResetResample16khzTo48khz(&state_16_48);
+	WebRtcSpl_ResetResample48khzTo8khz(&state_48_8);
+	WebRtcSpl_ResetResample8khzTo48khz(&state_8_48);
+
+	for (size_t offset = 0; offset + in_frame <= input.size();
+		offset += in_frame) {
+		const int16_t* in = &input[offset];
+		int64_t start_us = rtc::TimeMicros();
+		if (conversion.in_rate_hz == 48000 && conversion.out_rate_hz == 16000) {
+			WebRtcSpl_Resample48khzTo16khz(in, &output[0], &state_48_16,
+				&tmpmem[0]);
+		}
+		else if (conversion.in_rate_hz == 16000) {
+			WebRtcSpl_Resample16khzTo48khz(in, &output[0], &state_16_48,
+				&tmpmem[0]);
+		}
+		else if (conversion.in_rate_hz == 48000) {
+			WebRtcSpl_Resample48khzTo8khz(in, &output[0], &state_48_8,
+				&tmpmem[0]);
+		}
+		else {
+			WebRtcSpl_Resample8khzTo48khz(in, &output[0], &state_8_48,
+				&tmpmem[0]);
+		}
+		run.elapsed_us += rtc::TimeMicros() - start_us;
+		run.hash = Hash(&output[0], out_frame * sizeof(int16_t), run.hash);
+	}
+	return run;
+}
+
+}  // namespace
+
+void RunResampleBenchmark(int seconds) {
+	seconds = std::max(seconds, 1);
+	WebRtcSpl_Init();
+	const ResamplePointers initial = GetPointers();
+
+	bool supported[kNumPaths] = { true, WebRtc_GetCPUInfo(kSSE2) != 0,
+		WebRtc_GetCPUInfo(kAVX2) != 0 };
+	const int kRounds = 3;
+
+	printf("seconds=%d\n", seconds);
+	printf("conversion\tpath\tus/frame\tMsamples/s\tch/core\tbit-exact\n");
+	for (const Conversion& conversion : kConversions) {
+		std::vector<int16_t> input = MakeInput(seconds, conversion.in_rate_hz);
+		const int64_t frames = static_cast<int64_t>(seconds) * 100;
+		uint32_t reference = 0;
+		for (int path = 0; path < kNumPaths; ++path) {
+			if (!supported[path]) {
+				printf("%s\t%s\t-\t-\t-\t-\n", conversion.name, kPathNames[path]);
+				continue;
+			}
+			SetPointers(PointersFor(static_cast<ResamplePath>(path)));
+			// Best of a few rounds, to keep interrupts and frequency ramps out.
+			int64_t best_us = INT64_MAX;
+			bool exact = true;
+			for (int round = 0; round < kRounds; ++round) {
+				ResampleRun run = Convert(conversion, input);
+				best_us = std::min(best_us, run.elapsed_us);
+				if (path == kPathC && round == 0) {
+					reference = run.hash;
+				}
+				else if (run.hash != reference) {
+					exact = false;
+				}
+			}
+			SetPointers(initial);
+			if (!exact) {
+				RTC_LOG(LS_ERROR) << "Resampler " << conversion.name << " "
+					<< kPathNames[path] << " differs from the C version";
+			}
+			// Input samples per second of one core, and how many channels that
+			// keeps up with in real time.
+			double elapsed_s = std::max<int64_t>(best_us, 1) / 1e6;
+			double samples_per_s = input.size() / elapsed_s;
+			printf("%s\t%s\t%.2f\t%.1f\t%.0f\t%s\n", conversion.name,
+				kPathNames[path], static_cast<double>(best_us) / frames,
+				samples_per_s / 1e6, samples_per_s / conversion.in_rate_hz,
+				exact ? "yes" : "NO");
+		}
+	}
+}
+
+#else
+
+void RunResampleBenchmark(int seconds) {
+	printf("The resampler benchmark needs an x86 CPU\n");
+}
+
+#endif  // WEBRTC_ARCH_X86_FAMILY
@@ -0,0 +1,8 @@
+#pragma once
+
+// Runs |seconds| of synthetic speech through the fixed-point 48 <-> 16 kHz
+// and 48 <-> 8 kHz resamplers once per x86 path the CPU supports (C, SSE2,
+// AVX2), and prints the input samples per second one core converts, the
+// channels one core could convert in real time, and whether every path
+// produced the same output as C.
+void RunResampleBenchmark(int seconds);
@@ -0,0 +1,59 @@
+#include "screen_benchmark.h"
+
+#include <stdio.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "api/video/video_frame.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+
+namespace {
+
+class CountingSink : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+public:
+	void OnFrame(const webrtc::VideoFrame& frame) override {
+		frames_++;
+		width_ = frame.width();
+		height_ = frame.height();
+	}
+
+	int64_t frames() const { return frames_; }
+	int width() const { return width_; }
+	int height() const { return height_; }
+
+private:
+	std::atomic<int64_t> frames_{ 0 };
+	std::atomic<int> width_{ 0 };
+	std::atomic<int> height_{ 0 };
+};
+
+}  // namespace
+
+void RunScreenBenchmark(const ScreenShareOptions& options, int seconds) {
+	DesktopVideoCapturer capturer(options);
+	CountingSink sink;
+	capturer.AddOrUpdateSink(&sink, rtc::VideoSinkWants());
+
+	int64_t start_ms = rtc::TimeMillis();
+	if (capturer.Start(cricket::VideoFormat()) != cricket::CS_RUNNING) {
+		printf("Failed to start screen capture\n");
+		return;
+	}
+	std::this_thread::sleep_for(std::chrono::seconds(seconds));
+	capturer.Stop();
+	int64_t elapsed_ms = rtc::TimeMillis() - start_ms;
+	capturer.RemoveSink(&sink);
+
+	int64_t captured = capturer.frames_captured();
+	double skipped_percent = captured > 0 ? 100.0 * capturer.frames_unchanged() / captured : 0.0;
+	printf("size\tcaptured\tunchanged %%\tdelivered fps\tms/capture\n");
+	printf("%dx%d\t%lld\t%.1f\t%.2f\t%.3f\n", sink.width(), sink.height(),
+		static_cast<long long>(captured), skipped_percent,
+		sink.frames() * 1000.0 / (elapsed_ms > 0 ? elapsed_ms : 1),
+		captured > 0 ? capturer.capture_time_us() / 1000.0 / captured : 0.0);
+	RTC_LOG(INFO) << "screen benchmark: " << captured << " captured, "
+		<< capturer.frames_unchanged() << " unchanged";
+}
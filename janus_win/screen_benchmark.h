@@ -0,0 +1,7 @@
+#pragma once
+
+#include "desktop_video_capturer.h"
+
+// Captures the screen (or a window) for |seconds| and logs how many frames
+// the differ skipped, the delivered frame rate and the time spent capturing.
+void RunScreenBenchmark(const ScreenShareOptions& options, int seconds);
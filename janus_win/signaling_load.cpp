@@ -0,0 +1,610 @@
+#include "signaling_load.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "JanusTransaction.h"
+#include "janus_signaling.h"
+#include "peer_connection_wsclient.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/json.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+
+namespace {
+
+const char kVideoRoomPlugin[] = "janus.plugin.videoroom";
+const long long int kFirstRoom = 1234;
+// Host candidates trickled after every offer.
+const int kCandidates = 4;
+// How often each connection checks for sessions whose hold time or retry
+// delay is over.
+const int kTickMs = 10;
+// A session whose create request fails retries after 100 ms, doubling up to
+// 5 s, and stops after 8 failures in a row.
+const int kFirstRetryDelayMs = 100;
+const int kMaxRetryDelayMs = 5000;
+const int kMaxCreateRetries = 8;
+
+// Stands in for the offer of the PeerConnection that ConductorWs creates.
+const char kOfferSdp[] =
+	"v=0\r\n"
+	"o=- 4611731400430051336 2 IN IP4 127.0.0.1\r\n"
+	"s=-\r\n"
+	"t=0 0\r\n"
+	"a=group:BUNDLE audio video\r\n"
+	"a=msid-semantic: WMS stream_id\r\n"
+	"m=audio 9 UDP/TLS/RTP/SAVPF 111\r\n"
+	"c=IN IP4 0.0.0.0\r\n"
+	"a=ice-ufrag:load\r\n"
+	"a=ice-pwd:loadloadloadloadloadload\r\n"
+	"a=ice-options:trickle\r\n"
+	"a=setup:actpass\r\n"
+	"a=mid:audio\r\n"
+	"a=sendrecv\r\n"
+	"a=rtcp-mux\r\n"
+	"a=rtpmap:111 opus/48000/2\r\n"
+	"m=video 9 UDP/TLS/RTP/SAVPF 96\r\n"
+	"c=IN IP4 0.0.0.0\r\n"
+	"a=ice-ufrag:load\r\n"
+	"a=ice-pwd:loadloadloadloadloadload\r\n"
+	"a=ice-options:trickle\r\n"
+	"a=setup:actpass\r\n"
+	"a=mid:video\r\n"
+	"a=sendrecv\r\n"
+	"a=rtcp-mux\r\n"
+	"a=rtpmap:96 VP8/90000\r\n";
+
+bool ParseJson(const std::string& message, Json::Value* jmessage) {
+	Json::Reader reader;
+	return reader.parse(message, *jmessage) && jmessage->isObject();
+}
+
+// Counters of one connection. Only its loop thread touches them until the
+// connection is closed.
+struct LoadStats {
+	int64_t sent = 0;
+	int64_t received = 0;
+	int64_t errors = 0;
+	int64_t cycles = 0;
+	int64_t handles = 0;
+	int64_t create_failures = 0;
+	// Sessions that stopped after kMaxCreateRetries.
+	int64_t abandoned = 0;
+	// Round trip of every transaction, request to success, error or event.
+	std::vector<int64_t> rtt_us;
+};
+
+class LoadConnection;
+
+// The Janus requests ConductorWs makes for one session, with kOfferSdp where
+// ConductorWs would ask its PeerConnection. Runs on the loop thread of its
+// connection.
+class LoadSession {
+public:
+	LoadSession(LoadConnection* connection, int index, const SignalingLoadOptions& options)
+		: connection_(connection), index_(index), options_(options),
+		room_(kFirstRoom + index / std::max(options.room_size, 1)) {}
+
+	void Start();
+	// Subscribes to the publishers of a joined or publishers event, as
+	// ConductorWs does.
+	void OnPublishers(const std::vector<JanusPublisher>& publishers);
+	void KeepAlive();
+	// Leaves the room once the hold time is over, and retries a failed create
+	// once the retry delay is.
+	void OnTick(int64_t now_us);
+
+	bool stopped() const { return state_ == kStopped; }
+
+private:
+	enum State { kIdle, kRetrying, kJoining, kHolding, kLeaving, kStopped };
+
+	void CreateSession();
+	void CreateHandle(long long int feedId, const std::string& display);
+	void JoinRoom(long long int handleId, long long int feedId);
+	void SendOffer(long long int handleId);
+	void SendAnswer(long long int handleId);
+	void TrickleCandidates(long long int handleId);
+	void Leave();
+	void DestroySession();
+	// Wraps the callbacks of |jt| so that replies arriving after the session
+	// started over are dropped.
+	std::shared_ptr<JanusTransaction> Guard(std::shared_ptr<JanusTransaction> jt);
+	JanusSignaling* janus();
+
+	LoadConnection* const connection_;
+	const int index_;
+	const SignalingLoadOptions& options_;
+	const long long int room_;
+	State state_ = kIdle;
+	long long int m_SessionId = 0;
+	long long int publisher_handle_ = 0;
+	int64_t leave_us_ = 0;
+	int64_t retry_us_ = 0;
+	int create_failures_ = 0;//in a row
+	// Counts the times the session started over.
+	int64_t cycle_ = 0;
+};
+
+class LoadConnection : public PeerConnectionWsClientObserver,
+	public JanusSignalingObserver {
+public:
+	LoadConnection(const SignalingLoadOptions& options, const std::atomic<bool>* stopping)
+		: options_(options), stopping_(stopping), janus_(&client_, this),
+		connected_(false), failed_(false), done_(false), closing_(false) {
+		client_.RegisterObserver(this);
+	}
+
+	void AddSession(int index) {
+		sessions_.emplace_back(new LoadSession(this, index, options_));
+	}
+
+	void Connect(const std::string& server) {
+		client_.Connect(server, "load");
+	}
+
+	void Close() {
+		closing_ = true;
+		client_.CloseJanusConn();
+		stats_.sent = janus_.messages_sent();
+	}
+
+	void RegisterSession(long long int session_id, LoadSession* session) {
+		by_session_id_[session_id] = session;
+	}
+
+	void UnregisterSession(long long int session_id) {
+		by_session_id_.erase(session_id);
+	}
+
+	JanusSignaling* janus() { return &janus_; }
+	bool stopping() const { return *stopping_; }
+	bool connected() const { return connected_; }
+	bool failed() const { return failed_; }
+	bool done() const { return done_; }
+	LoadStats* stats() { return &stats_; }
+
+	// PeerConnectionWsClientObserver implementation, on the loop thread.
+	void OnSignedIn() override {}
+	void OnDisconnected() override {}
+	void OnPeerConnected(int id, const std::string& name) override {}
+	void OnMessageSent(int err) override {}
+	void OnServerConnectionFailure() override { failed_ = true; }
+
+	void OnJanusConnected() override {
+		connected_ = true;
+		tick_ = new uS::Timer(client_.m_hub.getLoop());
+		tick_->setData(this);
+		tick_->start([](uS::Timer* timer) {
+			static_cast<LoadConnection*>(timer->getData())->OnTick();
+		}, kTickMs, kTickMs);
+		for (auto& session : sessions_) {
+			session->Start();
+		}
+	}
+
+	void OnJanusDisconnected() override {
+		if (!closing_ && !done_) {
+			RTC_LOG(LS_ERROR) << "Signaling load: connection lost";
+			failed_ = true;
+			StopTick();
+			done_ = true;
+		}
+	}
+
+	void OnSendKeepAliveToJanus() override {
+		for (auto& session : sessions_) {
+			session->KeepAlive();
+		}
+	}
+
+	void OnMessageFromJanus(int peer_id, const std::string& message) override {
+		stats_.received++;
+		janus_.OnMessage(message);
+	}
+
+	// JanusSignalingObserver implementation, on the loop thread.
+	void OnPublishers(long long int session_id,
+		const std::vector<JanusPublisher>& publishers) override {
+		auto session = by_session_id_.find(session_id);
+		if (session != by_session_id_.end()) {
+			session->second->OnPublishers(publishers);
+		}
+	}
+
+	void OnTransactionDone(int64_t rtt_us, bool failed) override {
+		stats_.rtt_us.push_back(rtt_us);
+		if (failed) {
+			stats_.errors++;
+		}
+	}
+
+private:
+	void OnTick() {
+		int64_t now_us = rtc::TimeMicros();
+		bool all_stopped = true;
+		for (auto& session : sessions_) {
+			session->OnTick(now_us);
+			all_stopped = all_stopped && session->stopped();
+		}
+		if (all_stopped) {
+			StopTick();
+			done_ = true;
+		}
+	}
+
+	void StopTick() {
+		if (tick_) {
+			tick_->stop();
+			tick_->close();
+			tick_ = nullptr;
+		}
+	}
+
+	const SignalingLoadOptions& options_;
+	const std::atomic<bool>* stopping_;
+	PeerConnectionWsClient client_;
+	JanusSignaling janus_;
+	std::vector<std::unique_ptr<LoadSession>> sessions_;
+	std::map<long long int, LoadSession*> by_session_id_;
+	uS::Timer* tick_ = nullptr;
+	std::atomic<bool> connected_;
+	std::atomic<bool> failed_;
+	std::atomic<bool> done_;
+	std::atomic<bool> closing_;
+	LoadStats stats_;
+};
+
+void LoadSession::Start() {
+	if (connection_->stopping()) {
+		state_ = kStopped;
+		return;
+	}
+	state_ = kJoining;
+	CreateSession();
+}
+
+std::shared_ptr<JanusTransaction> LoadSession::Guard(std::shared_ptr<JanusTransaction> jt) {
+	const int64_t cycle = cycle_;
+	if (jt->Success) {
+		auto success = jt->Success;
+		jt->Success = [this, cycle, success](std::string message) {
+			if (cycle == cycle_) {
+				success(message);
+			}
+		};
+	}
+	if (jt->Event) {
+		auto event = jt->Event;
+		jt->Event = [this, cycle, event](std::string message) {
+			if (cycle == cycle_) {
+				event(message);
+			}
+		};
+	}
+	if (jt->Error) {
+		auto error = jt->Error;
+		jt->Error = [this, cycle, error](std::string code, std::string reason) {
+			if (cycle == cycle_) {
+				error(code, reason);
+			}
+		};
+	}
+	return jt;
+}
+
+JanusSignaling* LoadSession::janus() {
+	return connection_->janus();
+}
+
+void LoadSession::KeepAlive() {
+	if (m_SessionId > 0) {
+		janus()->KeepAlive(m_SessionId);
+	}
+}
+
+void LoadSession::CreateSession() {
+	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
+	jt->Success = [this](std::string message) {
+		m_SessionId = JanusSignaling::ReplyId(message);
+		create_failures_ = 0;
+		connection_->RegisterSession(m_SessionId, this);
+		CreateHandle(0, "load" + std::to_string(index_));
+	};
+	jt->Error = [this](std::string code, std::string reason) {
+		// Retrying at once would flood a gateway that rejects sessions.
+		connection_->stats()->create_failures++;
+		if (++create_failures_ > kMaxCreateRetries) {
+			RTC_LOG(LS_WARNING) << "Signaling load: session " << index_
+				<< " stopped, create failed " << create_failures_ << " times: "
+				<< code << " " << reason;
+			connection_->stats()->abandoned++;
+			state_ = kStopped;
+			return;
+		}
+		int delay_ms = std::min(kFirstRetryDelayMs << (create_failures_ - 1),
+			kMaxRetryDelayMs);
+		retry_us_ = rtc::TimeMicros() + delay_ms * rtc::kNumMicrosecsPerMillisec;
+		state_ = kRetrying;
+	};
+	janus()->CreateSession(Guard(jt));
+}
+
+void LoadSession::CreateHandle(long long int feedId, const std::string& display) {
+	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
+	jt->Success = [this, feedId](std::string message) {
+		long long int handle_id = JanusSignaling::ReplyId(message);
+		connection_->stats()->handles++;
+		if (feedId == 0) {
+			publisher_handle_ = handle_id;
+		}
+		JoinRoom(handle_id, feedId);
+	};
+	jt->Error = [this, feedId](std::string code, std::string reason) {
+		if (feedId == 0) {
+			DestroySession();
+		}
+	};
+	janus()->Attach(m_SessionId, kVideoRoomPlugin, Guard(jt));
+}
+
+void LoadSession::JoinRoom(long long int handleId, long long int feedId) {
+	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
+	jt->Event = [this, handleId, feedId](std::string message) {
+		Json::Value jmessage;
+		ParseJson(message, &jmessage);
+		const Json::Value& data = jmessage["plugindata"]["data"];
+		if (data.isMember("error_code")) {
+			// A feed that left in the meantime only costs the subscription.
+			if (feedId == 0) {
+				DestroySession();
+			}
+			return;
+		}
+		std::string videoroom = data["videoroom"].asString();
+		if (videoroom == "joined") {
+			SendOffer(handleId);
+		}
+		else if (videoroom == "attached") {
+			SendAnswer(handleId);
+		}
+	};
+	jt->Error = [this, feedId](std::string code, std::string reason) {
+		if (feedId == 0) {
+			DestroySession();
+		}
+	};
+
+	Json::Value jbody;
+	jbody["request"] = "join";
+	jbody["room"] = room_;
+	if (feedId == 0) {
+		jbody["ptype"] = "publisher";
+		jbody["display"] = "load" + std::to_string(index_);
+	}
+	else {
+		jbody["ptype"] = "subscriber";
+		jbody["feed"] = feedId;
+		jbody["private_id"] = 0;
+	}
+	janus()->Message(m_SessionId, handleId, jbody, nullptr, Guard(jt), false);
+}
+
+void LoadSession::SendOffer(long long int handleId) {
+	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
+	jt->Event = [this](std::string message) {
+		Json::Value jmessage;
+		ParseJson(message, &jmessage);
+		if (jmessage["plugindata"]["data"].isMember("error_code")) {
+			DestroySession();
+			return;
+		}
+		// The answer is in; hold the room for a while.
+		state_ = kHolding;
+		leave_us_ = rtc::TimeMicros() +
+			static_cast<int64_t>(options_.hold_ms) * rtc::kNumMicrosecsPerMillisec;
+	};
+	jt->Error = [this](std::string code, std::string reason) {
+		DestroySession();
+	};
+
+	Json::Value jbody;
+	jbody["request"] = "configure";
+	jbody["audio"] = true;
+	jbody["video"] = true;
+	Json::Value jjsep;
+	jjsep["type"] = "offer";
+	jjsep["sdp"] = kOfferSdp;
+	janus()->Message(m_SessionId, handleId, jbody, &jjsep, Guard(jt), false);
+	TrickleCandidates(handleId);
+}
+
+void LoadSession::SendAnswer(long long int handleId) {
+	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
+	jt->Event = [](std::string message) {};
+
+	Json::Value jbody;
+	jbody["request"] = "start";
+	jbody["room"] = room_;
+	Json::Value jjsep;
+	jjsep["type"] = "answer";
+	jjsep["sdp"] = kOfferSdp;
+	janus()->Message(m_SessionId, handleId, jbody, &jjsep, Guard(jt), false);
+	TrickleCandidates(handleId);
+}
+
+void LoadSession::TrickleCandidates(long long int handleId) {
+	for (int i = 0; i <= kCandidates; ++i) {
+		Json::Value jcandidate;
+		if (i < kCandidates) {
+			jcandidate["sdpMid"] = i % 2 ? "video" : "audio";
+			jcandidate["sdpMLineIndex"] = i % 2;
+			jcandidate["candidate"] = "candidate:" + std::to_string(i) +
+				" 1 udp 2122260223 192.168.1." + std::to_string(10 + i) + " " +
+				std::to_string(50000 + index_ % 10000) + " typ host generation 0";
+		}
+		else {
+			jcandidate["completed"] = true;
+		}
+		janus()->Trickle(m_SessionId, handleId, jcandidate, false);
+	}
+}
+
+void LoadSession::OnPublishers(const std::vector<JanusPublisher>& publishers) {
+	if (state_ != kJoining && state_ != kHolding) {
+		return;
+	}
+	for (const JanusPublisher& pub : publishers) {
+		CreateHandle(pub.id, pub.display);
+	}
+}
+
+void LoadSession::OnTick(int64_t now_us) {
+	if (state_ == kHolding && (now_us >= leave_us_ || connection_->stopping())) {
+		Leave();
+	}
+	else if (state_ == kRetrying && (now_us >= retry_us_ || connection_->stopping())) {
+		Start();
+	}
+}
+
+void LoadSession::Leave() {
+	state_ = kLeaving;
+	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
+	jt->Event = [this](std::string message) {
+		DestroySession();
+	};
+	jt->Error = [this](std::string code, std::string reason) {
+		DestroySession();
+	};
+
+	Json::Value jbody;
+	jbody["request"] = "leave";
+	janus()->Message(m_SessionId, publisher_handle_, jbody, nullptr, Guard(jt), false);
+}
+
+void LoadSession::DestroySession() {
+	state_ = kLeaving;
+	std::shared_ptr<JanusTransaction> jt(new JanusTransaction());
+	// Starts over with a new session either way.
+	auto restart = [this]() {
+		connection_->UnregisterSession(m_SessionId);
+		m_SessionId = 0;
+		publisher_handle_ = 0;
+		cycle_++;
+		connection_->stats()->cycles++;
+		Start();
+	};
+	jt->Success = [restart](std::string message) { restart(); };
+	jt->Error = [restart](std::string code, std::string reason) { restart(); };
+	janus()->DestroySession(m_SessionId, Guard(jt));
+}
+
+double Percentile(const std::vector<int64_t>& sorted, double p) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	size_t i = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+	return sorted[i] / 1000.0;
+}
+
+}  // namespace
+
+bool RunSignalingLoad(const SignalingLoadOptions& options) {
+	std::unique_ptr<MockJanus> mock;
+	std::string server = options.server;
+	if (server.empty()) {
+		mock.reset(new MockJanus(options.mock));
+		if (!mock->Start()) {
+			return false;
+		}
+		server = mock->url();
+	}
+
+	const int num_connections = std::max(options.connections, 1);
+	const int num_sessions = std::max(options.sessions, 1);
+	std::atomic<bool> stopping(false);
+	std::vector<std::unique_ptr<LoadConnection>> connections;
+	for (int i = 0; i < num_connections; ++i) {
+		connections.emplace_back(new LoadConnection(options, &stopping));
+	}
+	for (int i = 0; i < num_sessions; ++i) {
+		connections[i % num_connections]->AddSession(i);
+	}
+
+	int64_t start_us = rtc::TimeMicros();
+	int64_t start_cpu_ns = rtc::GetProcessCpuTimeNanos();
+	for (auto& connection : connections) {
+		connection->Connect(server);
+	}
+	std::this_thread::sleep_for(std::chrono::seconds(std::max(options.seconds, 1)));
+	stopping = true;
+	// Let the sessions leave their rooms, for a bounded time.
+	for (int i = 0; i < 1000; ++i) {
+		bool done = true;
+		for (auto& connection : connections) {
+			done = done && (connection->done() || !connection->connected());
+		}
+		if (done) {
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	double elapsed_s = (rtc::TimeMicros() - start_us) / 1e6;
+	double cpu_s = (rtc::GetProcessCpuTimeNanos() - start_cpu_ns) / 1e9;
+
+	bool ok = true;
+	LoadStats total;
+	for (auto& connection : connections) {
+		connection->Close();
+		if (!connection->connected() || connection->failed()) {
+			ok = false;
+		}
+		const LoadStats& stats = *connection->stats();
+		total.sent += stats.sent;
+		total.received += stats.received;
+		total.errors += stats.errors;
+		total.cycles += stats.cycles;
+		total.handles += stats.handles;
+		total.create_failures += stats.create_failures;
+		total.abandoned += stats.abandoned;
+		total.rtt_us.insert(total.rtt_us.end(), stats.rtt_us.begin(),
+			stats.rtt_us.end());
+	}
+	if (mock) {
+		mock->Stop();
+	}
+	std::sort(total.rtt_us.begin(), total.rtt_us.end());
+
+	printf("server=%s connections=%d sessions=%d seconds=%.1f hold_ms=%d "
+		"room_size=%d\n", server.c_str(), num_connections, num_sessions, elapsed_s,
+		options.hold_ms, options.room_size);
+	printf("cycles=%lld handles=%lld transactions=%zu errors=%lld "
+		"create_failures=%lld abandoned_sessions=%lld\n",
+		static_cast<long long>(total.cycles), static_cast<long long>(total.handles),
+		total.rtt_us.size(), static_cast<long long>(total.errors),
+		static_cast<long long>(total.create_failures),
+		static_cast<long long>(total.abandoned));
+	printf("messages sent=%lld received=%lld messages/s=%.0f\n",
+		static_cast<long long>(total.sent), static_cast<long long>(total.received),
+		(total.sent + total.received) / elapsed_s);
+	printf("rtt_ms p50=%.2f p99=%.2f max=%.2f\n", Percentile(total.rtt_us, 0.5),
+		Percentile(total.rtt_us, 0.99), Percentile(total.rtt_us, 1.0));
+	// The mock runs in this process too, so without --signaling_load_server
+	// the CPU time includes the gateway side.
+	printf("cpu %%=%.1f cpu_ms/s per session=%.3f%s\n", 100 * cpu_s / elapsed_s,
+		1000 * cpu_s / elapsed_s / num_sessions, mock ? " (with mock)" : "");
+	if (!ok) {
+		RTC_LOG(LS_ERROR) << "Signaling load: a connection to " << server
+			<< " failed";
+	}
+	return ok;
+}
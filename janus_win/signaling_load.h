@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "mock_janus.h"
+
+struct SignalingLoadOptions {
+	// ws:// address of the gateway; empty starts a MockJanus in the process.
+	std::string server;
+	// Options of that MockJanus.
+	MockJanusOptions mock;
+	// PeerConnectionWsClient connections the sessions are spread over.
+	int connections = 1;
+	// Sessions kept going at the same time.
+	int sessions = 10;
+	int seconds = 10;
+	// Publishers per videoroom; every one of them subscribes to the others.
+	int room_size = 4;
+	// How long a session stays published before it leaves and starts over.
+	int hold_ms = 1000;
+};
+
+// Drives |sessions| Janus sessions through the JanusSignaling of ConductorWs
+// (create, attach, join, configure with an offer, trickle, subscribing to
+// every publisher of the room) and then leave and destroy, over and over for
+// |seconds|. Prints the messages per second, the p50 and p99 transaction
+// round trip times and the CPU time per session. Returns false if a
+// connection failed.
+bool RunSignalingLoad(const SignalingLoadOptions& options);
@@ -0,0 +1,193 @@
+#include "spl_benchmark.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+namespace {
+
+enum SplPath { kPathC, kPathSSE2, kPathAVX2, kNumPaths };
+
+const char* const kPathNames[kNumPaths] = { "C", "SSE2", "AVX2" };
+
+// FNV-1a over the output, compared against the C path.
+uint32_t Hash(const void* data, size_t bytes, uint32_t hash = 2166136261u) {
+	const uint8_t* p = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < bytes; ++i) {
+		hash = (hash ^ p[i]) * 16777619u;
+	}
+	return hash;
+}
+
+struct SplKernel {
+	const char* name;
+	// Runs the kernel once on |path|, leaving its output in the shared buffers.
+	std::function<void(SplPath path)> run;
+};
+
+}  // namespace
+
+void RunSplBenchmark(int samples, int iterations) {
+	const size_t kLength = static_cast<size_t>(std::max(samples, 16));
+	const size_t kCorrelations = 16;
+	const size_t kTaps = 32;
+	const int kFactor = 2;
+
+	// Full scale noise plus the values the C version special-cases.
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<int> dist16(-32768, 32767);
+	std::vector<int16_t> x(kLength * 2 + kTaps + kCorrelations);
+	std::vector<int16_t> y(x.size());
+	std::vector<int32_t> x32(kLength);
+	for (size_t i = 0; i < x.size(); ++i) {
+		x[i] = static_cast<int16_t>(dist16(rng));
+		y[i] = static_cast<int16_t>(dist16(rng));
+	}
+	for (size_t i = 0; i < kLength; ++i) {
+		x32[i] = static_cast<int32_t>(rng());
+	}
+	x[kLength / 2] = -32768;
+	x32[kLength / 3] = static_cast<int32_t>(0x80000000);
+	std::vector<int16_t> taps(kTaps);
+	for (size_t i = 0; i < kTaps; ++i) {
+		taps[i] = static_cast<int16_t>(dist16(rng) / 16);
+	}
+
+	int32_t scalar_out = 0;
+	std::vector<int16_t> out16(kLength);
+	std::vector<int32_t> out32(kCorrelations);
+	// Clears the outputs, runs |path| once and hashes whatever it wrote.
+	auto output_hash = [&](const SplKernel& kernel, SplPath path) {
+		scalar_out = 0;
+		std::fill(out16.begin(), out16.end(), 0);
+		std::fill(out32.begin(), out32.end(), 0);
+		kernel.run(path);
+		uint32_t hash = Hash(&scalar_out, sizeof(scalar_out));
+		hash = Hash(out16.data(), out16.size() * sizeof(out16[0]), hash);
+		return Hash(out32.data(), out32.size() * sizeof(out32[0]), hash);
+	};
+	const int16_t* filter_in = x.data() + kTaps;
+	size_t downsampled = (kLength - 1) / kFactor + 1;
+
+	std::vector<SplKernel> kernels = {
+		{ "MaxAbsValueW16", [&](SplPath path) {
+			static const MaxAbsValueW16 f[] = { WebRtcSpl_MaxAbsValueW16C,
+				WebRtcSpl_MaxAbsValueW16SSE2, WebRtcSpl_MaxAbsValueW16AVX2 };
+			scalar_out = f[path](x.data(), kLength);
+		} },
+		{ "MaxAbsValueW32", [&](SplPath path) {
+			static const MaxAbsValueW32 f[] = { WebRtcSpl_MaxAbsValueW32C,
+				WebRtcSpl_MaxAbsValueW32SSE2, WebRtcSpl_MaxAbsValueW32AVX2 };
+			scalar_out = f[path](x32.data(), kLength);
+		} },
+		{ "MaxValueW16", [&](SplPath path) {
+			static const MaxValueW16 f[] = { WebRtcSpl_MaxValueW16C,
+				WebRtcSpl_MaxValueW16SSE2, WebRtcSpl_MaxValueW16AVX2 };
+			scalar_out = f[path](x.data(), kLength);
+		} },
+		{ "MaxValueW32", [&](SplPath path) {
+			static const MaxValueW32 f[] = { WebRtcSpl_MaxValueW32C,
+				WebRtcSpl_MaxValueW32SSE2, WebRtcSpl_MaxValueW32AVX2 };
+			scalar_out = f[path](x32.data(), kLength);
+		} },
+		{ "MinValueW16", [&](SplPath path) {
+			static const MinValueW16 f[] = { WebRtcSpl_MinValueW16C,
+				WebRtcSpl_MinValueW16SSE2, WebRtcSpl_MinValueW16AVX2 };
+			scalar_out = f[path](x.data(), kLength);
+		} },
+		{ "MinValueW32", [&](SplPath path) {
+			static const MinValueW32 f[] = { WebRtcSpl_MinValueW32C,
+				WebRtcSpl_MinValueW32SSE2, WebRtcSpl_MinValueW32AVX2 };
+			scalar_out = f[path](x32.data(), kLength);
+		} },
+		// Per sample of |seq1|, over all correlation lags.
+		{ "CrossCorrelation", [&](SplPath path) {
+			static const CrossCorrelation f[] = { WebRtcSpl_CrossCorrelationC,
+				WebRtcSpl_CrossCorrelationSSE2, WebRtcSpl_CrossCorrelationAVX2 };
+			f[path](out32.data(), x.data(), y.data(), kLength, kCorrelations, 2, 1);
+		} },
+		// Per input sample, 32 taps decimated by two.
+		{ "DownsampleFast", [&](SplPath path) {
+			static const DownsampleFast f[] = { WebRtcSpl_DownsampleFastC,
+				WebRtcSpl_DownsampleFastSSE2, WebRtcSpl_DownsampleFastAVX2 };
+			f[path](filter_in, kLength, out16.data(), downsampled, taps.data(),
+				kTaps, kFactor, 0);
+		} },
+		{ "ScaleAndAddVectors", [&](SplPath path) {
+			static const ScaleAndAddVectorsWithRound f[] = {
+				WebRtcSpl_ScaleAndAddVectorsWithRoundC,
+				WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2,
+				WebRtcSpl_ScaleAndAddVectorsWithRoundAVX2 };
+			f[path](x.data(), 12345, y.data(), -23456, 14, out16.data(), kLength);
+		} },
+	};
+
+	bool supported[kNumPaths] = { true, WebRtc_GetCPUInfo(kSSE2) != 0,
+		WebRtc_GetCPUInfo(kAVX2) != 0 };
+	const int kRounds = 5;
+
+	printf("samples=%zu iterations=%d\n", kLength, iterations);
+	printf("kernel\tC cyc/sample\tSSE2 cyc/sample\tAVX2 cyc/sample\tbit-exact\n");
+	for (const SplKernel& kernel : kernels) {
+		uint32_t reference = output_hash(kernel, kPathC);
+		double cycles_per_sample[kNumPaths] = { 0, 0, 0 };
+		bool exact = true;
+		for (int path = 0; path < kNumPaths; ++path) {
+			if (!supported[path]) {
+				continue;
+			}
+			SplPath p = static_cast<SplPath>(path);
+			if (output_hash(kernel, p) != reference) {
+				exact = false;
+				RTC_LOG(LS_ERROR) << kernel.name << " " << kPathNames[path]
+					<< " differs from the C version";
+			}
+			// Best of a few rounds, to keep interrupts and frequency ramps out.
+			uint64_t best = UINT64_MAX;
+			for (int round = 0; round < kRounds; ++round) {
+				uint64_t start = __rdtsc();
+				for (int i = 0; i < iterations; ++i) {
+					kernel.run(p);
+				}
+				best = std::min<uint64_t>(best, __rdtsc() - start);
+			}
+			cycles_per_sample[path] = static_cast<double>(best) / iterations / kLength;
+		}
+		printf("%s", kernel.name);
+		for (int path = 0; path < kNumPaths; ++path) {
+			if (supported[path]) {
+				printf("\t%.3f", cycles_per_sample[path]);
+			}
+			else {
+				printf("\t-");
+			}
+		}
+		printf("\t%s\n", exact ? "yes" : "NO");
+	}
+}
+
+#else
+
+void RunSplBenchmark(int samples, int iterations) {
+	printf("The SPL benchmark needs an x86 CPU\n");
+}
+
+#endif  // WEBRTC_ARCH_X86_FAMILY
@@ -0,0 +1,8 @@
+#pragma once
+
+// Times the C, SSE2 and AVX2 paths of the SPL kernels that WebRtcSpl_Init()
+// dispatches (max/min, cross-correlation, DownsampleFast and
+// ScaleAndAddVectorsWithRound) on |samples| long vectors and prints cycles
+// per sample, and whether every path produced the same output as C. Paths
+// the CPU does not support are skipped.
+void RunSplBenchmark(int samples, int iterations);
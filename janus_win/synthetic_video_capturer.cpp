@@ -0,0 +1,278 @@
+#include "synthetic_video_capturer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "frame_adaptation.h"
+#include "frame_stamp.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/timeutils.h"
+#include "third_party/libyuv/include/libyuv/planar_functions.h"
+
+namespace {
+
+// Moving box drawn on the pattern, so the encoder has motion to code.
+const int kBoxSize = 64;
+
+bool ParseY4mHeader(const std::string& header, int* width, int* height, int* fps) {
+	if (header.compare(0, 9, "YUV4MPEG2") != 0) {
+		return false;
+	}
+	size_t pos = 9;
+	while (pos < header.size()) {
+		size_t end = header.find(' ', pos + 1);
+		std::string param = header.substr(pos + 1,
+			end == std::string::npos ? std::string::npos : end - pos - 1);
+		if (!param.empty()) {
+			switch (param[0]) {
+			case 'W':
+				*width = atoi(param.c_str() + 1);
+				break;
+			case 'H':
+				*height = atoi(param.c_str() + 1);
+				break;
+			case 'F': {
+				int num = 0;
+				int den = 1;
+				if (sscanf(param.c_str() + 1, "%d:%d", &num, &den) == 2 && den > 0) {
+					*fps = (num + den / 2) / den;
+				}
+				break;
+			}
+			case 'C':
+				if (param.compare(0, 4, "C420") != 0) {
+					return false;
+				}
+				break;
+			}
+		}
+		pos = end;
+	}
+	return *width > 0 && *height > 0;
+}
+
+}  // namespace
+
+SyntheticVideoCapturer::SyntheticVideoCapturer(const SyntheticVideoOptions& options)
+	: options_(options),
+	frames_produced_(0),
+	deadlines_missed_(0) {
+}
+
+SyntheticVideoCapturer::~SyntheticVideoCapturer() {
+	Stop();
+	if (file_) {
+		fclose(file_);
+	}
+}
+
+bool SyntheticVideoCapturer::Init() {
+	width_ = options_.width;
+	height_ = options_.height;
+	if (!options_.y4m_path.empty()) {
+		file_ = fopen(options_.y4m_path.c_str(), "rb");
+		if (!file_) {
+			RTC_LOG(LS_ERROR) << "Cannot open " << options_.y4m_path;
+			return false;
+		}
+		char line[256];
+		if (!fgets(line, sizeof(line), file_) ||
+			!ParseY4mHeader(std::string(line, strcspn(line, "\n")), &width_, &height_, &file_fps_)) {
+			RTC_LOG(LS_ERROR) << options_.y4m_path << " is not a 4:2:0 Y4M file";
+			fclose(file_);
+			file_ = nullptr;
+			return false;
+		}
+		first_frame_offset_ = ftell(file_);
+	}
+	if (options_.stamp_frames) {
+		stamp_times_us_.assign(1 << kFrameStampBits, -1);
+	}
+	int fps = options_.fps > 0 ? options_.fps : (file_fps_ > 0 ? file_fps_ : 30);
+	std::vector<cricket::VideoFormat> formats;
+	formats.push_back(cricket::VideoFormat(width_, height_,
+		cricket::VideoFormat::FpsToInterval(fps), cricket::FOURCC_I420));
+	SetSupportedFormats(formats);
+	RTC_LOG(INFO) << "Synthetic video " << width_ << "x" << height_ << "@" << fps
+		<< (file_ ? " from " + options_.y4m_path : std::string(" pattern"));
+	return true;
+}
+
+cricket::CaptureState SyntheticVideoCapturer::Start(
+	const cricket::VideoFormat& capture_format) {
+	if (thread_.joinable()) {
+		return cricket::CS_RUNNING;
+	}
+	const std::vector<cricket::VideoFormat>* formats = GetSupportedFormats();
+	if (!formats || formats->empty()) {
+		return cricket::CS_FAILED;
+	}
+	cricket::VideoFormat format = formats->front();
+	// The track source may only ask for a lower rate.
+	format.interval = std::max(format.interval, capture_format.interval);
+	SetCaptureFormat(&format);
+	{
+		std::lock_guard<std::mutex> lock(stop_mutex_);
+		stopping_ = false;
+	}
+	int64_t interval_us = format.interval / rtc::kNumNanosecsPerMicrosec;
+	thread_ = std::thread([this, interval_us]() { Run(interval_us); });
+	SetCaptureState(cricket::CS_RUNNING);
+	return cricket::CS_RUNNING;
+}
+
+void SyntheticVideoCapturer::Stop() {
+	if (!thread_.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(stop_mutex_);
+		stopping_ = true;
+	}
+	stop_cv_.notify_all();
+	thread_.join();
+	SetCaptureFormat(nullptr);
+	SetCaptureState(cricket::CS_STOPPED);
+}
+
+bool SyntheticVideoCapturer::IsRunning() {
+	return thread_.joinable();
+}
+
+bool SyntheticVideoCapturer::GetPreferredFourccs(std::vector<uint32_t>* fourccs) {
+	fourccs->push_back(cricket::FOURCC_I420);
+	return true;
+}
+
+void SyntheticVideoCapturer::Run(int64_t interval_us) {
+	rtc::SetCurrentThreadName("SyntheticVideo");
+	if (!file_) {
+		frame_source_.reset(new cricket::FakeFrameSource(width_, height_,
+			static_cast<int>(interval_us)));
+	}
+
+	int64_t next_frame_us = rtc::TimeMicros();
+	for (;;) {
+		std::unique_lock<std::mutex> lock(stop_mutex_);
+		int64_t wait_us = next_frame_us - rtc::TimeMicros();
+		if (stop_cv_.wait_for(lock, std::chrono::microseconds(std::max<int64_t>(wait_us, 0)),
+			[this]() { return stopping_; })) {
+			break;
+		}
+		lock.unlock();
+
+		uint32_t stamp = static_cast<uint32_t>(frame_index_) & ((1 << kFrameStampBits) - 1);
+		rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer = NextBuffer();
+		if (!buffer) {
+			break;
+		}
+		int64_t now_us = rtc::TimeMicros();
+		if (options_.stamp_frames) {
+			std::lock_guard<std::mutex> stamp_lock(stamp_mutex_);
+			stamp_times_us_[stamp] = now_us;
+		}
+		// The adapter drops frames for the frame rate limit and hands out the
+		// crop and size for the resolution limit.
+		FrameAdaptation adaptation;
+		if (AdaptFrame(buffer->width(), buffer->height(), now_us, now_us,
+			&adaptation.width, &adaptation.height, &adaptation.crop_width,
+			&adaptation.crop_height, &adaptation.crop_x, &adaptation.crop_y,
+			&adaptation.timestamp_us)) {
+			// Keeps |now_us| rather than the translated time, the stamp times
+			// above are matched against it.
+			OnFrame(webrtc::VideoFrame(AdaptFrameBuffer(buffer, adaptation, &adapted_pool_),
+				webrtc::kVideoRotation_0, now_us),
+				buffer->width(), buffer->height());
+		}
+		frames_produced_++;
+
+		next_frame_us += interval_us;
+		if (next_frame_us < now_us) {
+			// Producing a frame took longer than the interval, skip ahead
+			// rather than bursting.
+			deadlines_missed_++;
+			next_frame_us = now_us + interval_us;
+		}
+	}
+	frame_source_.reset();
+}
+
+rtc::scoped_refptr<webrtc::VideoFrameBuffer> SyntheticVideoCapturer::NextBuffer() {
+	rtc::scoped_refptr<webrtc::I420Buffer> buffer = buffer_pool_.CreateBuffer(width_, height_);
+	if (file_) {
+		if (!ReadY4mFrame(buffer)) {
+			// Loop the clip.
+			if (fseek(file_, first_frame_offset_, SEEK_SET) != 0 || !ReadY4mFrame(buffer)) {
+				RTC_LOG(LS_ERROR) << "Failed to read a frame from " << options_.y4m_path;
+				return nullptr;
+			}
+		}
+		if (options_.stamp_frames) {
+			StampFrame(buffer, static_cast<uint32_t>(frame_index_));
+		}
+		frame_index_++;
+		return buffer;
+	}
+
+	// Black frame from FakeFrameSource with a box moving along the diagonal.
+	rtc::scoped_refptr<webrtc::I420BufferInterface> black =
+		frame_source_->GetFrame().video_frame_buffer()->GetI420();
+	libyuv::I420Copy(black->DataY(), black->StrideY(), black->DataU(), black->StrideU(),
+		black->DataV(), black->StrideV(), buffer->MutableDataY(), buffer->StrideY(),
+		buffer->MutableDataU(), buffer->StrideU(), buffer->MutableDataV(), buffer->StrideV(),
+		width_, height_);
+	int box = std::min(kBoxSize, std::min(width_, height_)) & ~1;
+	if (box > 0) {
+		int x = static_cast<int>((frame_index_ * 8) % (width_ - box + 1)) & ~1;
+		int y = static_cast<int>((frame_index_ * 4) % (height_ - box + 1)) & ~1;
+		libyuv::I420Rect(buffer->MutableDataY(), buffer->StrideY(),
+			buffer->MutableDataU(), buffer->StrideU(),
+			buffer->MutableDataV(), buffer->StrideV(),
+			x, y, box, box, 235, 128, 128);
+	}
+	if (options_.stamp_frames) {
+		StampFrame(buffer, static_cast<uint32_t>(frame_index_));
+	}
+	frame_index_++;
+	return buffer;
+}
+
+int64_t SyntheticVideoCapturer::StampCaptureTimeUs(uint32_t stamp) const {
+	std::lock_guard<std::mutex> lock(stamp_mutex_);
+	if (stamp >= stamp_times_us_.size()) {
+		return -1;
+	}
+	return stamp_times_us_[stamp];
+}
+
+bool SyntheticVideoCapturer::ReadY4mFrame(webrtc::I420Buffer* buffer) {
+	char line[256];
+	if (!fgets(line, sizeof(line), file_) || strncmp(line, "FRAME", 5) != 0) {
+		return false;
+	}
+	for (int y = 0; y < height_; ++y) {
+		if (fread(buffer->MutableDataY() + y * buffer->StrideY(), 1, width_, file_) !=
+			static_cast<size_t>(width_)) {
+			return false;
+		}
+	}
+	int chroma_width = buffer->ChromaWidth();
+	int chroma_height = buffer->ChromaHeight();
+	uint8_t* planes[2] = { buffer->MutableDataU(), buffer->MutableDataV() };
+	int strides[2] = { buffer->StrideU(), buffer->StrideV() };
+	for (int p = 0; p < 2; ++p) {
+		for (int y = 0; y < chroma_height; ++y) {
+			if (fread(planes[p] + y * strides[p], 1, chroma_width, file_) !=
+				static_cast<size_t>(chroma_width)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
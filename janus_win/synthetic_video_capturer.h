@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common_video/include/i420_buffer_pool.h"
+#include "media/base/fakeframesource.h"
+#include "media/base/videocapturer.h"
+
+struct SyntheticVideoOptions {
+	std::string y4m_path;//empty: generated pattern
+	int width = 1280;//pattern only, a Y4M file keeps its own size
+	int height = 720;
+	int fps = 30;
+	// Draws the frame index into every frame, see frame_stamp.h.
+	bool stamp_frames = false;
+};
+
+// Camera replacement for headless publishers. Plays a 4:2:0 Y4M file in a
+// loop or generates a moving pattern on top of cricket::FakeFrameSource.
+// Frames are produced on their own thread against absolute deadlines, so the
+// rate does not drift, and are stamped with rtc::TimeMicros() at the moment
+// they are produced, which makes them usable for end-to-end latency.
+class SyntheticVideoCapturer : public cricket::VideoCapturer {
+public:
+	explicit SyntheticVideoCapturer(const SyntheticVideoOptions& options);
+	~SyntheticVideoCapturer() override;
+
+	// False if the Y4M file cannot be opened or is not 4:2:0.
+	bool Init();
+
+	// cricket::VideoCapturer implementation
+	cricket::CaptureState Start(const cricket::VideoFormat& capture_format) override;
+	void Stop() override;
+	bool IsRunning() override;
+	bool IsScreencast() const override { return false; }
+
+	// Exposed for CPU adaptation.
+	using cricket::VideoCapturer::video_adapter;
+
+	int64_t frames_produced() const { return frames_produced_; }
+	int64_t deadlines_missed() const { return deadlines_missed_; }
+
+	// rtc::TimeMicros() at which the frame carrying |stamp| was produced, -1
+	// if none was yet. Needs stamp_frames; stamps repeat after 2^16 frames.
+	int64_t StampCaptureTimeUs(uint32_t stamp) const;
+
+protected:
+	bool GetPreferredFourccs(std::vector<uint32_t>* fourccs) override;
+
+private:
+	void Run(int64_t interval_us);
+	rtc::scoped_refptr<webrtc::VideoFrameBuffer> NextBuffer();
+	bool ReadY4mFrame(webrtc::I420Buffer* buffer);
+
+	SyntheticVideoOptions options_;
+	int width_ = 0;
+	int height_ = 0;
+	int file_fps_ = 0;
+
+	// Used on the capture thread only.
+	FILE* file_ = nullptr;
+	long first_frame_offset_ = 0;
+	std::unique_ptr<cricket::FakeFrameSource> frame_source_;
+	webrtc::I420BufferPool buffer_pool_;
+	webrtc::I420BufferPool adapted_pool_;
+	int64_t frame_index_ = 0;
+
+	std::mutex stop_mutex_;
+	std::condition_variable stop_cv_;
+	bool stopping_ = false;//guarded by stop_mutex_
+	std::thread thread_;
+
+	// Capture time by stamp, only when stamp_frames.
+	mutable std::mutex stamp_mutex_;
+	std::vector<int64_t> stamp_times_us_;
+
+	std::atomic<int64_t> frames_produced_;
+	std::atomic<int64_t> deadlines_missed_;
+};
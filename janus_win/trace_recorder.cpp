@@ -0,0 +1,447 @@
+#include "trace_recorder.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event_tracer.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/stringencode.h"
+#include "rtc_base/stringutils.h"
+#include "rtc_base/timeutils.h"
+#include "rtc_base/trace_event.h"
+
+namespace {
+
+const int kMaxArgs = 2;
+const size_t kCopyLength = 48;
+const int kMaxCategories = 256;
+const char kDisabledByDefault[] = "disabled-by-default-";
+
+struct Category {
+	// First, its address is the flag the trace sites keep.
+	unsigned char enabled;
+	bool selected;
+	char name[64];
+};
+
+struct Event {
+	int64_t time_us;
+	rtc::PlatformThreadId thread_id;
+	const Category* category;
+	const char* name;
+	unsigned long long id;
+	char phase;
+	unsigned char flags;
+	int num_args;
+	const char* arg_names[kMaxArgs];
+	unsigned char arg_types[kMaxArgs];
+	unsigned long long arg_values[kMaxArgs];
+	// The name with TRACE_EVENT_FLAG_COPY, then the copied string arguments.
+	char copies[kMaxArgs + 1][kCopyLength];
+};
+
+// The events of a stopped trace, waiting for the writer thread.
+struct StoppedTrace {
+	std::string path;
+	int64_t start_us;
+	uint64_t recorded;//including the overwritten ones
+	std::vector<Event> events;
+};
+
+// A seqlock per slot: 2 * index + 1 while event |index| is written into it,
+// 2 * index + 2 once it is complete, 0 when empty.
+struct Slot {
+	std::atomic<uint64_t> sequence;
+	Event event;
+};
+
+void AppendString(std::string* out, const char* str) {
+	out->push_back('"');
+	for (const char* c = str; *c; ++c) {
+		unsigned char ch = static_cast<unsigned char>(*c);
+		if (ch == '"' || ch == '\\') {
+			out->push_back('\\');
+			out->push_back(*c);
+		}
+		else if (ch < 0x20) {
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+			out->append(escaped);
+		}
+		else {
+			out->push_back(*c);
+		}
+	}
+	out->push_back('"');
+}
+
+void AppendArg(std::string* out, const Event& event, int i) {
+	char number[32];
+	unsigned long long value = event.arg_values[i];
+	switch (event.arg_types[i]) {
+	case TRACE_VALUE_TYPE_BOOL:
+		out->append(value ? "true" : "false");
+		break;
+	case TRACE_VALUE_TYPE_UINT:
+		snprintf(number, sizeof(number), "%llu", value);
+		out->append(number);
+		break;
+	case TRACE_VALUE_TYPE_INT:
+		snprintf(number, sizeof(number), "%lld", static_cast<long long>(value));
+		out->append(number);
+		break;
+	case TRACE_VALUE_TYPE_DOUBLE: {
+		double d;
+		memcpy(&d, &value, sizeof(d));
+		if (isfinite(d)) {
+			snprintf(number, sizeof(number), "%.17g", d);
+			out->append(number);
+		}
+		else {
+			out->append("null");
+		}
+		break;
+	}
+	case TRACE_VALUE_TYPE_POINTER:
+		snprintf(number, sizeof(number), "\"0x%llx\"", value);
+		out->append(number);
+		break;
+	case TRACE_VALUE_TYPE_STRING:
+		AppendString(out, reinterpret_cast<const char*>(static_cast<uintptr_t>(value)));
+		break;
+	case TRACE_VALUE_TYPE_COPY_STRING:
+		AppendString(out, event.copies[i + 1]);
+		break;
+	default:
+		out->append("null");
+		break;
+	}
+}
+
+class TraceRecorder {
+public:
+	TraceRecorder(const std::string& path, const std::string& categories, size_t capacity)
+		: path_(path), capacity_(std::max<size_t>(capacity, 1)), slots_(new Slot[capacity_]),
+		next_(0) {
+		rtc::split(categories, ',', &selection_);
+		for (size_t i = 0; i < capacity_; ++i) {
+			slots_[i].sequence.store(0);
+		}
+	}
+
+	const unsigned char* GetCategoryEnabled(const char* name) {
+		static const unsigned char kDisabled = 0;
+		rtc::CritScope cs(&lock_);
+		for (int i = 0; i < num_categories_; ++i) {
+			if (strcmp(categories_[i].name, name) == 0) {
+				return &categories_[i].enabled;
+			}
+		}
+		if (num_categories_ == kMaxCategories) {
+			return &kDisabled;
+		}
+		Category& category = categories_[num_categories_++];
+		rtc::strcpyn(category.name, sizeof(category.name), name);
+		category.selected = Selected(name);
+		category.enabled = recording_ && category.selected ? 1 : 0;
+		return &category.enabled;
+	}
+
+	// Called on any thread, by the trace sites whose category is enabled.
+	void AddEvent(char phase, const unsigned char* category_enabled, const char* name,
+		unsigned long long id, int num_args, const char** arg_names,
+		const unsigned char* arg_types, const unsigned long long* arg_values,
+		unsigned char flags) {
+		int64_t now_us = rtc::TimeMicros();
+		uint64_t index = next_.fetch_add(1, std::memory_order_relaxed);
+		Slot& slot = slots_[index % capacity_];
+		slot.sequence.store(index * 2 + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		Event& event = slot.event;
+		event.time_us = now_us;
+		event.thread_id = rtc::CurrentThreadId();
+		event.category = reinterpret_cast<const Category*>(category_enabled);
+		event.name = name;
+		event.id = id;
+		event.phase = phase;
+		event.flags = flags;
+		if (flags & TRACE_EVENT_FLAG_COPY) {
+			rtc::strcpyn(event.copies[0], kCopyLength, name);
+		}
+		event.num_args = std::min(num_args, kMaxArgs);
+		for (int i = 0; i < event.num_args; ++i) {
+			event.arg_names[i] = arg_names[i];
+			event.arg_types[i] = arg_types[i];
+			event.arg_values[i] = arg_values[i];
+			if (arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING) {
+				rtc::strcpyn(event.copies[i + 1], kCopyLength,
+					reinterpret_cast<const char*>(static_cast<uintptr_t>(arg_values[i])));
+			}
+		}
+
+		slot.sequence.store(index * 2 + 2, std::memory_order_release);
+	}
+
+	void Start() {
+		rtc::CritScope cs(&lock_);
+		if (recording_) {
+			return;
+		}
+		for (size_t i = 0; i < capacity_; ++i) {
+			slots_[i].sequence.store(0, std::memory_order_relaxed);
+		}
+		next_.store(0);
+		start_us_ = rtc::TimeMicros();
+		recording_ = true;
+		for (int i = 0; i < num_categories_; ++i) {
+			categories_[i].enabled = categories_[i].selected ? 1 : 0;
+		}
+		RTC_LOG(INFO) << "Tracing started, " << capacity_ << " events kept";
+	}
+
+	// Only copies the ring; formatting and writing the file would hold up the
+	// caller (the UI thread for F9) and every thread looking up a category.
+	bool Stop() {
+		StoppedTrace trace;
+		{
+			rtc::CritScope cs(&lock_);
+			if (!recording_) {
+				return false;
+			}
+			recording_ = false;
+			for (int i = 0; i < num_categories_; ++i) {
+				categories_[i].enabled = 0;
+			}
+			trace.path = NextPath();
+			traces_written_++;
+			trace.start_us = start_us_;
+			Snapshot(&trace);
+		}
+		{
+			std::lock_guard<std::mutex> lock(queue_mutex_);
+			queue_.push_back(std::move(trace));
+			if (!writer_.joinable()) {
+				writer_ = std::thread([this]() { WriteStoppedTraces(); });
+			}
+		}
+		queue_cv_.notify_one();
+		return true;
+	}
+
+	// Blocks until the traces stopped so far are written.
+	void Flush() {
+		std::unique_lock<std::mutex> lock(queue_mutex_);
+		written_cv_.wait(lock, [this]() { return queue_.empty(); });
+	}
+
+	bool recording() const {
+		rtc::CritScope cs(&lock_);
+		return recording_;
+	}
+
+private:
+	bool Selected(const char* name) const {
+		bool disabled_by_default = strncmp(name, kDisabledByDefault,
+			sizeof(kDisabledByDefault) - 1) == 0;
+		for (const auto& selected : selection_) {
+			if ((selected == "*" && !disabled_by_default) || selected == name) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::string NextPath() const {
+		if (traces_written_ == 0) {
+			return path_;
+		}
+		std::string base = path_;
+		size_t dot = path_.rfind('.');
+		size_t separator = path_.find_last_of("/\\");
+		if (dot != std::string::npos && (separator == std::string::npos || dot > separator)) {
+			base = path_.substr(0, dot);
+		}
+		return base + "." + std::to_string(traces_written_) + ".json";
+	}
+
+	void Snapshot(StoppedTrace* trace) const {
+		uint64_t end = next_.load();
+		uint64_t begin = end > capacity_ ? end - capacity_ : 0;
+		trace->recorded = end;
+		trace->events.reserve(static_cast<size_t>(end - begin));
+		std::unique_ptr<Event> event(new Event());
+		for (uint64_t index = begin; index < end; ++index) {
+			if (Read(index, event.get())) {
+				trace->events.push_back(*event);
+			}
+		}
+	}
+
+	// Copies event |index| out of its slot, false if the slot was overwritten
+	// or is still being written.
+	bool Read(uint64_t index, Event* event) const {
+		const Slot& slot = slots_[index % capacity_];
+		uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+		if (sequence != index * 2 + 2) {
+			return false;
+		}
+		memcpy(event, &slot.event, sizeof(Event));
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return slot.sequence.load(std::memory_order_relaxed) == sequence;
+	}
+
+	static void AppendEvent(std::string* out, const Event& event, int64_t start_us) {
+		char buffer[128];
+		out->append("{\"name\":");
+		AppendString(out, (event.flags & TRACE_EVENT_FLAG_COPY) ? event.copies[0] : event.name);
+		out->append(",\"cat\":");
+		AppendString(out, event.category->name);
+		snprintf(buffer, sizeof(buffer), ",\"ph\":\"%c\",\"ts\":%lld,\"pid\":1,\"tid\":%llu",
+			event.phase, static_cast<long long>(event.time_us - start_us),
+			static_cast<unsigned long long>(event.thread_id));
+		out->append(buffer);
+		if (event.flags & TRACE_EVENT_FLAG_HAS_ID) {
+			snprintf(buffer, sizeof(buffer), ",\"id\":\"0x%llx\"", event.id);
+			out->append(buffer);
+		}
+		if (event.phase == TRACE_EVENT_PHASE_INSTANT) {
+			out->append(",\"s\":\"t\"");
+		}
+		out->append(",\"args\":{");
+		for (int i = 0; i < event.num_args; ++i) {
+			if (i > 0) {
+				out->push_back(',');
+			}
+			AppendString(out, event.arg_names[i]);
+			out->push_back(':');
+			AppendArg(out, event, i);
+		}
+		out->append("}}");
+	}
+
+	// Writer thread, never returns.
+	void WriteStoppedTraces() {
+		std::unique_lock<std::mutex> lock(queue_mutex_);
+		while (true) {
+			queue_cv_.wait(lock, [this]() { return !queue_.empty(); });
+			StoppedTrace& trace = queue_.front();
+			lock.unlock();
+			Write(trace);
+			lock.lock();
+			queue_.pop_front();//after writing, for Flush()
+			written_cv_.notify_all();
+		}
+	}
+
+	static bool Write(const StoppedTrace& trace) {
+		FILE* file = fopen(trace.path.c_str(), "w");
+		if (!file) {
+			RTC_LOG(LS_ERROR) << "Failed to open the trace file " << trace.path;
+			return false;
+		}
+		fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+			"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"janus_win\"}}",
+			file);
+		std::string line;
+		for (const Event& event : trace.events) {
+			line = ",\n";
+			AppendEvent(&line, event, trace.start_us);
+			fputs(line.c_str(), file);
+		}
+		fputs("\n]}\n", file);
+		bool ok = ferror(file) == 0;
+		fclose(file);
+		RTC_LOG(INFO) << "Tracing stopped, wrote " << trace.events.size() << " of "
+			<< trace.recorded << " events to " << trace.path;
+		return ok;
+	}
+
+	const std::string path_;
+	const size_t capacity_;
+	const std::unique_ptr<Slot[]> slots_;
+	std::atomic<uint64_t> next_;
+	std::vector<std::string> selection_;
+	rtc::CriticalSection lock_;
+	Category categories_[kMaxCategories];
+	int num_categories_ = 0;
+	bool recording_ = false;
+	int64_t start_us_ = 0;
+	int traces_written_ = 0;
+
+	std::mutex queue_mutex_;
+	std::condition_variable queue_cv_;
+	std::condition_variable written_cv_;
+	std::deque<StoppedTrace> queue_;//guarded by queue_mutex_
+	std::thread writer_;//started by the first Stop()
+};
+
+// Never deleted, WebRTC threads may trace until the process exits; neither is
+// its writer thread joined.
+TraceRecorder* g_recorder = nullptr;
+
+const unsigned char* RecorderCategoryEnabled(const char* name) {
+	return g_recorder->GetCategoryEnabled(name);
+}
+
+void RecorderAddEvent(char phase, const unsigned char* category_enabled, const char* name,
+	unsigned long long id, int num_args, const char** arg_names,
+	const unsigned char* arg_types, const unsigned long long* arg_values,
+	unsigned char flags) {
+	g_recorder->AddEvent(phase, category_enabled, name, id, num_args, arg_names, arg_types,
+		arg_values, flags);
+}
+
+}  // namespace
+
+void InstallTraceRecorder(const std::string& path, const std::string& categories,
+	size_t capacity) {
+	if (g_recorder) {
+		return;
+	}
+	g_recorder = new TraceRecorder(path, categories, capacity);
+	webrtc::SetupEventTracer(&RecorderCategoryEnabled, &RecorderAddEvent);
+}
+
+void StartTracing() {
+	if (g_recorder) {
+		g_recorder->Start();
+	}
+}
+
+bool StopTracing() {
+	return g_recorder && g_recorder->Stop();
+}
+
+void FinishTracing() {
+	if (g_recorder) {
+		g_recorder->Stop();
+		g_recorder->Flush();
+	}
+}
+
+void ToggleTracing() {
+	if (IsTracing()) {
+		StopTracing();
+	}
+	else {
+		StartTracing();
+	}
+}
+
+bool IsTracing() {
+	return g_recorder && g_recorder->recording();
+}
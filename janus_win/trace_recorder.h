@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <string>
+
+// Records the TRACE_EVENT macros of rtc_base/trace_event.h, those of the
+// client and those inside WebRTC, into a fixed ring of events and writes them
+// out in the Chrome trace_event JSON format (chrome://tracing, Perfetto).
+// Recording an event takes an atomic increment and a few stores, no lock or
+// allocation; once the ring is full the oldest events are overwritten, so a
+// trace holds the last |capacity| events before it was stopped. Names and
+// string arguments that WebRTC does not keep alive are copied, truncated to
+// 47 characters.
+//
+// Every trace site looks its category up once and keeps the answer, so the
+// recorder must be installed before anything else uses WebRTC. Recording is
+// then switched on and off at runtime through the flags it handed out.
+
+// |categories| is a comma separated list of categories to record, "*" for
+// every category except the disabled-by-default ones, which are only
+// recorded when listed. Does not start recording.
+void InstallTraceRecorder(const std::string& path, const std::string& categories,
+	size_t capacity);
+
+// Starts recording into an empty ring. No-op if not installed or already
+// recording.
+void StartTracing();
+
+// Stops recording and copies the ring out; a writer thread then writes it to
+// the path given at install, later traces to "<path without
+// extension>.<n>.json". False if nothing was being recorded.
+bool StopTracing();
+
+// Stops recording and blocks until every stopped trace is written, for
+// process exit.
+void FinishTracing();
+
+// Stops or starts recording, e.g. from a hotkey.
+void ToggleTracing();
+
+bool IsTracing();
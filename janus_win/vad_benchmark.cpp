@@ -0,0 +1,177 @@
+#include "vad_benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "common_audio/vad/include/webrtc_vad.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/system/arch.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+
+namespace {
+
+enum VadPath { kPathC, kPathSSE2, kPathAVX2, kNumPaths };
+
+const char* const kPathNames[kNumPaths] = { "C", "SSE2", "AVX2" };
+
+const size_t kMaxChannels = 64;
+// Distance between the start of two channels in the shared input signal.
+const size_t kChannelOffset = 997;
+
+// WebRtcVad_Init() picks the batch kernels through WebRtc_GetCPUInfo, so the
+// benchmark swaps in this one to hide the features above |g_max_path|.
+VadPath g_max_path = kPathC;
+WebRtc_CPUInfo g_cpu_info = nullptr;
+
+int CappedCPUInfo(CPUFeature feature) {
+	if (feature == kAVX2 && g_max_path < kPathAVX2) {
+		return 0;
+	}
+	if (feature == kSSE2 && g_max_path < kPathSSE2) {
+		return 0;
+	}
+	return g_cpu_info(feature);
+}
+
+// Talk spurts and pauses over a noise floor. Each channel reads it from a
+// different offset, so the channels do not switch at the same time.
+std::vector<int16_t> MakeInput(int fs, int frames) {
+	std::mt19937 rng(1);
+	std::normal_distribution<double> noise(0.0, 200.0);
+	size_t frame_length = static_cast<size_t>(fs / 100);
+	std::vector<int16_t> input(frames * frame_length + kMaxChannels * kChannelOffset);
+	for (size_t i = 0; i < input.size(); ++i) {
+		double t = static_cast<double>(i) / fs;
+		double envelope = static_cast<int>(t / 0.7) % 2 ? 0.0 : 0.5 + 0.5 * sin(2 * M_PI * 4 * t);
+		double sample = 9000 * envelope * (sin(2 * M_PI * 150 * t) +
+			0.5 * sin(2 * M_PI * 900 * t)) + noise(rng);
+		input[i] = static_cast<int16_t>(std::max(-32768.0, std::min(32767.0, sample)));
+	}
+	return input;
+}
+
+// Runs |channels| fresh instances over |input|, one WebRtcVad_Process() per
+// channel or one WebRtcVad_ProcessBatch() per frame, and returns a hash of
+// the decisions; the elapsed time goes to |elapsed_us|.
+uint64_t Process(int fs, size_t channels, bool batch, int frames,
+	const std::vector<int16_t>& input, int64_t* elapsed_us) {
+	size_t frame_length = static_cast<size_t>(fs / 100);
+	std::vector<VadInst*> handles(channels);
+	for (size_t ch = 0; ch < channels; ++ch) {
+		handles[ch] = WebRtcVad_Create();
+		WebRtcVad_Init(handles[ch]);
+		WebRtcVad_set_mode(handles[ch], static_cast<int>(ch % 4));
+	}
+
+	std::vector<const int16_t*> audio_frames(channels);
+	std::vector<int> decisions(channels);
+	uint64_t hash = 0;
+	int64_t start_us = rtc::TimeMicros();
+	for (int frame = 0; frame < frames; ++frame) {
+		for (size_t ch = 0; ch < channels; ++ch) {
+			audio_frames[ch] = input.data() + frame * frame_length + ch * kChannelOffset;
+		}
+		if (batch) {
+			WebRtcVad_ProcessBatch(handles.data(), channels, fs, audio_frames.data(),
+				frame_length, decisions.data());
+		}
+		else {
+			for (size_t ch = 0; ch < channels; ++ch) {
+				decisions[ch] = WebRtcVad_Process(handles[ch], fs, audio_frames[ch],
+					frame_length);
+			}
+		}
+		for (size_t ch = 0; ch < channels; ++ch) {
+			hash = hash * 31 + decisions[ch] + 1;
+		}
+	}
+	*elapsed_us = rtc::TimeMicros() - start_us;
+
+	for (VadInst* handle : handles) {
+		WebRtcVad_Free(handle);
+	}
+	return hash;
+}
+
+}  // namespace
+
+void RunVadBenchmark(int frames) {
+	frames = std::max(frames, 1);
+	g_cpu_info = WebRtc_GetCPUInfo;
+
+	bool supported[kNumPaths] = { true, g_cpu_info(kSSE2) != 0,
+		g_cpu_info(kAVX2) != 0 };
+	const int kRates[] = { 16000, 48000 };
+	const size_t kChannels[] = { 1, 2, 4, 8, 16, 32, 64 };
+	const int kRounds = 3;
+
+	printf("frames=%d\n", frames);
+	printf("rate\tchannels\tper-channel us\tbatch C us\tbatch SSE2 us\t"
+		"batch AVX2 us\tbit-exact\n");
+	for (int fs : kRates) {
+		std::vector<int16_t> input = MakeInput(fs, frames);
+		for (size_t channels : kChannels) {
+			// The per-channel loop is the reference; WebRtcVad_Process() does
+			// not use the batch kernels, so its path does not matter.
+			int64_t loop_us = INT64_MAX;
+			uint64_t reference = 0;
+			for (int round = 0; round < kRounds; ++round) {
+				int64_t elapsed_us = 0;
+				reference = Process(fs, channels, false, frames, input, &elapsed_us);
+				loop_us = std::min(loop_us, elapsed_us);
+			}
+
+			double us_per_frame[kNumPaths] = { 0, 0, 0 };
+			bool exact = true;
+			for (int path = 0; path < kNumPaths; ++path) {
+				if (!supported[path]) {
+					continue;
+				}
+				g_max_path = static_cast<VadPath>(path);
+				WebRtc_GetCPUInfo = CappedCPUInfo;
+				// Best of a few rounds, to keep interrupts and frequency ramps out.
+				int64_t best_us = INT64_MAX;
+				for (int round = 0; round < kRounds; ++round) {
+					int64_t elapsed_us = 0;
+					if (Process(fs, channels, true, frames, input, &elapsed_us) !=
+						reference) {
+						exact = false;
+						RTC_LOG(LS_ERROR) << "VAD batch " << kPathNames[path] << " at "
+							<< fs << " Hz on " << channels
+							<< " channels differs from WebRtcVad_Process";
+					}
+					best_us = std::min(best_us, elapsed_us);
+				}
+				WebRtc_GetCPUInfo = g_cpu_info;
+				us_per_frame[path] = static_cast<double>(best_us) / frames;
+			}
+
+			printf("%d\t%zu\t%.2f", fs, channels,
+				static_cast<double>(loop_us) / frames);
+			for (int path = 0; path < kNumPaths; ++path) {
+				if (supported[path]) {
+					printf("\t%.2f", us_per_frame[path]);
+				}
+				else {
+					printf("\t-");
+				}
+			}
+			printf("\t%s\n", exact ? "yes" : "NO");
+		}
+	}
+}
+
+#else
+
+void RunVadBenchmark(int frames) {
+	printf("The VAD benchmark needs an x86 CPU\n");
+}
+
+#endif  // WEBRTC_ARCH_X86_FAMILY
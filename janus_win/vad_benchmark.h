@@ -0,0 +1,8 @@
+#pragma once
+
+// Runs |frames| 10 ms frames of synthetic speech on 1 to 64 channels through
+// the VAD, once with WebRtcVad_Process() per channel and once with
+// WebRtcVad_ProcessBatch() on each x86 path the CPU supports (C, SSE2, AVX2),
+// and prints microseconds per 10 ms of all channels, and whether every batch
+// made the same decisions as the per-channel calls.
+void RunVadBenchmark(int frames);
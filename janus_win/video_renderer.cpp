@@ -0,0 +1,230 @@
+#include "video_renderer.h"
+
+#include <math.h>
+
+#include "frame_worker_pool.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+#include "rtc_base/trace_event.h"
+#include "third_party/libyuv/include/libyuv/convert_argb.h"
+#include "third_party/libyuv/include/libyuv/planar_functions.h"
+#include "third_party/libyuv/include/libyuv/rotate.h"
+
+namespace {
+
+size_t I420Bytes(const webrtc::I420BufferInterface& buffer) {
+	return static_cast<size_t>(buffer.StrideY()) * buffer.height() +
+		static_cast<size_t>(buffer.StrideU()) * buffer.ChromaHeight() +
+		static_cast<size_t>(buffer.StrideV()) * buffer.ChromaHeight();
+}
+
+}  // namespace
+
+// VideoRenderer Class Implementation
+//
+
+VideoRenderer::VideoRenderer(
+	VideoRenderBackend* backend,
+	webrtc::VideoTrackInterface* track_to_render)
+	: backend_(backend),
+	rendered_track_(track_to_render),
+	scratch_bytes_(0) {
+	if (rendered_track_) {
+		rendered_track_->AddOrUpdateSink(this, rtc::VideoSinkWants());
+	}
+}
+
+VideoRenderer::~VideoRenderer() {
+	if (rendered_track_) {
+		rendered_track_->RemoveSink(this);
+	}
+}
+
+void VideoRenderer::OnFrame(const webrtc::VideoFrame& video_frame) {
+	TRACE_EVENT2("render", "VideoRenderer::OnFrame", "width", video_frame.width(),
+		"height", video_frame.height());
+	int64_t now_ms = rtc::TimeMillis();
+	stats_.OnFrameReceived(now_ms, video_frame.width(), video_frame.height());
+	bool log_stats = false;
+	std::function<void(int64_t)> on_first_frame;
+	{
+		rtc::CritScope cs(&frame_lock_);
+		if (first_frame_us_ < 0) {
+			first_frame_us_ = rtc::TimeMicros();
+			on_first_frame.swap(on_first_frame_);
+		}
+		if (!latest_rendered_) {
+			stats_.OnFrameDropped();
+		}
+		latest_buffer_ = video_frame.video_frame_buffer();
+		latest_rotation_ = video_frame.rotation();
+		latest_rendered_ = false;
+
+		int64_t interval_ms = backend_ ? backend_->stats_log_interval_ms() : 0;
+		if (interval_ms > 0 && now_ms - last_stats_log_ms_ >= interval_ms) {
+			last_stats_log_ms_ = now_ms;
+			log_stats = true;
+		}
+	}
+	if (on_first_frame) {
+		on_first_frame(first_frame_us_);
+	}
+	if (log_stats) {
+		RTC_LOG(INFO) << "render stats " << label_ << ": " << GetStats().ToString();
+	}
+	if (backend_) {
+		backend_->OnFrameAvailable(this);
+	}
+}
+
+bool VideoRenderer::RenderTo(uint8_t* dst_argb, int dst_stride, int width, int height) {
+	TRACE_EVENT2("render", "VideoRenderer::RenderTo", "width", width, "height", height);
+	rtc::CritScope render_cs(&render_lock_);
+
+	rtc::scoped_refptr<webrtc::VideoFrameBuffer> frame_buffer;
+	webrtc::VideoRotation rotation;
+	bool new_frame;
+	{
+		rtc::CritScope cs(&frame_lock_);
+		frame_buffer = latest_buffer_;
+		rotation = latest_rotation_;
+		new_frame = !latest_rendered_;
+		latest_rendered_ = true;
+	}
+	if (!frame_buffer || width <= 0 || height <= 0) {
+		return false;
+	}
+
+	int64_t start_us = rtc::TimeMicros();
+
+	size_t scratch = 0;
+	rtc::scoped_refptr<webrtc::I420BufferInterface> buffer = frame_buffer->ToI420();
+	if (rotation != webrtc::kVideoRotation_0) {
+		bool swap = rotation == webrtc::kVideoRotation_90 ||
+			rotation == webrtc::kVideoRotation_270;
+		rtc::scoped_refptr<webrtc::I420Buffer> rotated = rotate_pool_.CreateBuffer(
+			swap ? buffer->height() : buffer->width(),
+			swap ? buffer->width() : buffer->height());
+		libyuv::I420Rotate(buffer->DataY(), buffer->StrideY(), buffer->DataU(),
+			buffer->StrideU(), buffer->DataV(), buffer->StrideV(),
+			rotated->MutableDataY(), rotated->StrideY(), rotated->MutableDataU(),
+			rotated->StrideU(), rotated->MutableDataV(), rotated->StrideV(),
+			buffer->width(), buffer->height(),
+			static_cast<libyuv::RotationMode>(rotation));
+		scratch += I420Bytes(*rotated);
+		buffer = rotated;
+	}
+	if (buffer->width() != width || buffer->height() != height) {
+		rtc::scoped_refptr<webrtc::I420Buffer> scaled =
+			scale_pool_.CreateBuffer(width, height);
+		scaled->ScaleFrom(*buffer);
+		scratch += I420Bytes(*scaled);
+		buffer = scaled;
+	}
+	scratch_bytes_ = scratch;
+
+	libyuv::I420ToARGB(buffer->DataY(), buffer->StrideY(), buffer->DataU(),
+		buffer->StrideU(), buffer->DataV(), buffer->StrideV(),
+		dst_argb, dst_stride, width, height);
+	int64_t end_us = rtc::TimeMicros();
+	stats_.OnFrameRendered(new_frame, end_us - start_us);
+
+	std::function<void(int64_t)> on_first_render;
+	{
+		rtc::CritScope cs(&frame_lock_);
+		if (first_render_us_ < 0) {
+			first_render_us_ = end_us;
+			on_first_render.swap(on_first_render_);
+		}
+	}
+	if (on_first_render) {
+		on_first_render(end_us);
+	}
+	return true;
+}
+
+void VideoRenderer::SetFirstFrameCallbacks(std::function<void(int64_t)> decoded,
+	std::function<void(int64_t)> rendered) {
+	int64_t first_frame_us;
+	int64_t first_render_us;
+	{
+		rtc::CritScope cs(&frame_lock_);
+		first_frame_us = first_frame_us_;
+		first_render_us = first_render_us_;
+		if (first_frame_us < 0) {
+			on_first_frame_ = decoded;
+		}
+		if (first_render_us < 0) {
+			on_first_render_ = rendered;
+		}
+	}
+	if (first_frame_us >= 0 && decoded) {
+		decoded(first_frame_us);
+	}
+	if (first_render_us >= 0 && rendered) {
+		rendered(first_render_us);
+	}
+}
+
+size_t VideoRenderer::ResidentBytes() const {
+	size_t bytes = scratch_bytes_;
+	rtc::CritScope cs(&frame_lock_);
+	if (latest_buffer_) {
+		if (latest_buffer_->type() == webrtc::VideoFrameBuffer::Type::kI420) {
+			bytes += I420Bytes(*latest_buffer_->GetI420());
+		}
+		else {
+			bytes += static_cast<size_t>(latest_buffer_->width()) *
+				latest_buffer_->height() * 3 / 2;
+		}
+	}
+	return bytes;
+}
+
+RenderStatsSnapshot VideoRenderer::GetStats() const {
+	RenderStatsSnapshot snapshot = stats_.GetSnapshot();
+	snapshot.resident_bytes = ResidentBytes();
+	return snapshot;
+}
+
+TileRect GetTileRect(int index, int count, int width, int height) {
+	int columns = 3;
+	int rows = 2;
+	if (count > columns * rows) {
+		columns = static_cast<int>(ceil(sqrt(static_cast<double>(count))));
+		rows = (count + columns - 1) / columns;
+	}
+	TileRect rect;
+	rect.width = width / columns;
+	rect.height = height / rows;
+	rect.x = (index % columns) * rect.width;
+	rect.y = (index / columns) * rect.height;
+	return rect;
+}
+
+void ComposeTiles(const std::vector<VideoRenderer*>& renderers,
+	FrameWorkerPool* pool, uint8_t* surface, int stride, int width, int height) {
+	libyuv::ARGBRect(surface, stride, 0, 0, width, height, 0xff000000);
+
+	int count = static_cast<int>(renderers.size());
+	for (int nIndex = 0; nIndex < count; nIndex++) {
+		VideoRenderer* renderer = renderers[nIndex];
+		TileRect tile = GetTileRect(nIndex, count, width, height);
+		if (tile.width <= 0 || tile.height <= 0) {
+			continue;
+		}
+		uint8_t* dst = surface + tile.y * stride + tile.x * 4;
+		if (pool) {
+			pool->PostTask(nIndex, [renderer, dst, stride, tile]() {
+				renderer->RenderTo(dst, stride, tile.width, tile.height);
+			});
+		}
+		else {
+			renderer->RenderTo(dst, stride, tile.width, tile.height);
+		}
+	}
+	if (pool) {
+		pool->WaitIdle();
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/mediastreaminterface.h"
+#include "api/video/video_frame.h"
+#include "api/video/video_frame_buffer.h"
+#include "common_video/include/i420_buffer_pool.h"
+#include "render_stats.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/scoped_ref_ptr.h"
+
+class FrameWorkerPool;
+class VideoRenderer;
+
+// Presentation side of the tile grid. A backend is told whenever one of its
+// renderers received a new frame and decides how and when to compose them.
+class VideoRenderBackend {
+public:
+	virtual ~VideoRenderBackend() {}
+
+	// Called on the thread that delivered the frame.
+	virtual void OnFrameAvailable(VideoRenderer* renderer) = 0;
+
+	// Tiles are converted in parallel on this pool during composition when set.
+	void SetWorkerPool(FrameWorkerPool* pool) { worker_pool_ = pool; }
+	FrameWorkerPool* worker_pool() const { return worker_pool_; }
+
+	// Renderers log their stats at most every |interval_ms|; 0 disables.
+	void SetStatsLogInterval(int64_t interval_ms) { stats_log_interval_ms_ = interval_ms; }
+	int64_t stats_log_interval_ms() const { return stats_log_interval_ms_; }
+
+private:
+	FrameWorkerPool* worker_pool_ = nullptr;
+	int64_t stats_log_interval_ms_ = 0;
+};
+
+// Sink attached to a video track. Retains the most recent decoded buffer as
+// delivered (ref-counted I420 or NV12, no copy); rotation, scaling and ARGB
+// conversion happen only when a backend draws the renderer into a visible
+// tile. A frame replaced before it was ever drawn is counted as dropped.
+class VideoRenderer : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+public:
+	// |track_to_render| may be null, frames are then pushed through OnFrame().
+	VideoRenderer(VideoRenderBackend* backend,
+		webrtc::VideoTrackInterface* track_to_render);
+	virtual ~VideoRenderer();
+
+	// VideoSinkInterface implementation
+	void OnFrame(const webrtc::VideoFrame& frame) override;
+
+	// Converts the latest frame into a |width| x |height| ARGB rectangle at
+	// |dst_argb|. Returns false if no frame arrived yet. Calls for one renderer
+	// are serialized, different renderers may render in parallel.
+	bool RenderTo(uint8_t* dst_argb, int dst_stride, int width, int height);
+
+	// Bytes held by this renderer: the retained buffer plus conversion scratch.
+	size_t ResidentBytes() const;
+
+	int64_t frames_dropped() const { return GetStats().frames_dropped; }
+
+	RenderStatsSnapshot GetStats() const;
+
+	// Name used in the periodic stats log line.
+	void SetLabel(const std::string& label) { label_ = label; }
+
+	// |decoded| runs once on the first delivered frame and |rendered| once
+	// when a frame is first drawn, with the rtc::TimeMicros() of that moment.
+	// A callback whose moment has already passed runs right away.
+	void SetFirstFrameCallbacks(std::function<void(int64_t)> decoded,
+		std::function<void(int64_t)> rendered);
+
+protected:
+	VideoRenderBackend* backend_;
+	rtc::scoped_refptr<webrtc::VideoTrackInterface> rendered_track_;
+
+	rtc::CriticalSection frame_lock_;
+	rtc::scoped_refptr<webrtc::VideoFrameBuffer> latest_buffer_;
+	webrtc::VideoRotation latest_rotation_ = webrtc::kVideoRotation_0;
+	bool latest_rendered_ = true;
+	int64_t last_stats_log_ms_ = 0;
+	int64_t first_frame_us_ = -1;
+	int64_t first_render_us_ = -1;
+	std::function<void(int64_t)> on_first_frame_;
+	std::function<void(int64_t)> on_first_render_;
+
+	// Scratch for rotation and scaling, only used under render_lock_.
+	rtc::CriticalSection render_lock_;
+	webrtc::I420BufferPool rotate_pool_;
+	webrtc::I420BufferPool scale_pool_;
+	std::atomic<size_t> scratch_bytes_;
+
+	RenderStats stats_;
+	std::string label_;
+};
+
+struct TileRect {
+	int x;
+	int y;
+	int width;
+	int height;
+};
+
+// Position of tile |index| out of |count| on a |width| x |height| surface.
+// Up to six tiles keep the 3x2 grid, more tiles switch to a square grid.
+TileRect GetTileRect(int index, int count, int width, int height);
+
+// Clears |surface| to black and renders every renderer into its tile, on
+// |pool| when given.
+void ComposeTiles(const std::vector<VideoRenderer*>& renderers,
+	FrameWorkerPool* pool, uint8_t* surface, int stride, int width, int height);
@@ -0,0 +1,196 @@
+#include "y4m_dump_sink.h"
+
+#include <stdio.h>
+
+#include "rtc_base/filerotatingstream.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/platform_thread_types.h"
+#include "third_party/libyuv/include/libyuv/planar_functions.h"
+
+// Rotating stream that starts every file with the Y4M stream header and
+// rotates on frame boundaries only, so each file can be played on its own.
+class Y4mFileStream : public rtc::FileRotatingStream {
+public:
+	Y4mFileStream(const std::string& dir, const std::string& prefix,
+		size_t max_file_size, size_t num_files)
+		: rtc::FileRotatingStream(dir, prefix, max_file_size, num_files),
+		max_file_size_(max_file_size) {
+	}
+
+	// Writes one frame record of |record_size| bytes through |write|.
+	template <typename WriteFn>
+	bool WriteRecord(int width, int height, size_t record_size, WriteFn write) {
+		if (needs_header_) {
+			char header[64];
+			int len = snprintf(header, sizeof(header),
+				"YUV4MPEG2 W%d H%d F30:1 C420\n", width, height);
+			if (!WriteBytes(header, len)) {
+				return false;
+			}
+			bytes_in_file_ = len;
+			needs_header_ = false;
+		}
+		// All records of a file have the same size. If the next one would
+		// not fit, end the file right after this one: the base class rotates
+		// as soon as a write reaches the limit.
+		if (bytes_in_file_ + 2 * record_size > max_file_size_) {
+			SetMaxFileSize(bytes_in_file_ + record_size);
+		}
+		if (!write()) {
+			return false;
+		}
+		if (!needs_header_) {
+			bytes_in_file_ += record_size;
+		}
+		return true;
+	}
+
+	bool WriteBytes(const void* data, size_t len) {
+		return WriteAll(data, len, nullptr, nullptr) == rtc::SR_SUCCESS;
+	}
+
+protected:
+	void OnRotation() override {
+		SetMaxFileSize(max_file_size_);
+		bytes_in_file_ = 0;
+		needs_header_ = true;
+	}
+
+private:
+	const size_t max_file_size_;
+	size_t bytes_in_file_ = 0;
+	bool needs_header_ = true;
+};
+
+Y4mDumpSink::Y4mDumpSink(
+	webrtc::VideoTrackInterface* track,
+	const std::string& dir,
+	const std::string& prefix,
+	size_t max_file_size,
+	size_t num_files,
+	size_t max_queued_frames)
+	: track_(track),
+	stream_(new Y4mFileStream(dir, prefix, max_file_size, num_files)),
+	buffer_pool_(false, max_queued_frames),
+	frames_written_(0),
+	frames_dropped_(0) {
+	if (!stream_->Open()) {
+		RTC_LOG(LS_ERROR) << "Failed to open frame dump " << dir << "/" << prefix;
+		stream_.reset();
+		return;
+	}
+	writer_ = std::thread([this]() { Run(); });
+	if (track_) {
+		track_->AddOrUpdateSink(this, rtc::VideoSinkWants());
+	}
+}
+
+Y4mDumpSink::~Y4mDumpSink() {
+	if (!stream_) {
+		return;
+	}
+	if (track_) {
+		track_->RemoveSink(this);
+	}
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex_);
+		stopping_ = true;
+	}
+	queue_cv_.notify_one();
+	writer_.join();
+	stream_->Close();
+	RTC_LOG(INFO) << "Frame dump closed: " << frames_written_ << " frames written, "
+		<< frames_dropped_ << " dropped";
+}
+
+void Y4mDumpSink::OnFrame(const webrtc::VideoFrame& video_frame) {
+	if (!stream_) {
+		return;
+	}
+	rtc::scoped_refptr<webrtc::I420BufferInterface> src =
+		video_frame.video_frame_buffer()->ToI420();
+	if (width_ == 0) {
+		width_ = src->width();
+		height_ = src->height();
+	}
+
+	// Null once every pooled buffer is queued or being written.
+	rtc::scoped_refptr<webrtc::I420Buffer> copy =
+		buffer_pool_.CreateBuffer(width_, height_);
+	if (!copy) {
+		frames_dropped_++;
+		return;
+	}
+	if (src->width() == width_ && src->height() == height_) {
+		libyuv::I420Copy(src->DataY(), src->StrideY(), src->DataU(), src->StrideU(),
+			src->DataV(), src->StrideV(), copy->MutableDataY(), copy->StrideY(),
+			copy->MutableDataU(), copy->StrideU(), copy->MutableDataV(),
+			copy->StrideV(), width_, height_);
+	}
+	else {
+		copy->ScaleFrom(*src);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex_);
+		queue_.push_back({ copy, video_frame.timestamp_us() });
+	}
+	queue_cv_.notify_one();
+}
+
+void Y4mDumpSink::Run() {
+	rtc::SetCurrentThreadName("Y4mWriter");
+	for (;;) {
+		PendingFrame frame;
+		{
+			std::unique_lock<std::mutex> lock(queue_mutex_);
+			queue_cv_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+			if (queue_.empty()) {
+				return;
+			}
+			frame = std::move(queue_.front());
+			queue_.pop_front();
+		}
+		if (WriteFrame(frame)) {
+			frames_written_++;
+		}
+		else {
+			frames_dropped_++;
+		}
+	}
+}
+
+bool Y4mDumpSink::WriteFrame(const PendingFrame& frame) {
+	const webrtc::I420Buffer& buffer = *frame.buffer;
+	// Fixed width keeps every record of a file the same size.
+	char header[64];
+	int header_len = snprintf(header, sizeof(header), "FRAME XTS=%020lld\n",
+		static_cast<long long>(frame.timestamp_us));
+	int chroma_width = buffer.ChromaWidth();
+	int chroma_height = buffer.ChromaHeight();
+	size_t record_size = header_len +
+		static_cast<size_t>(buffer.width()) * buffer.height() +
+		2 * static_cast<size_t>(chroma_width) * chroma_height;
+
+	return stream_->WriteRecord(buffer.width(), buffer.height(), record_size, [&]() {
+		if (!stream_->WriteBytes(header, header_len)) {
+			return false;
+		}
+		for (int y = 0; y < buffer.height(); ++y) {
+			if (!stream_->WriteBytes(buffer.DataY() + y * buffer.StrideY(), buffer.width())) {
+				return false;
+			}
+		}
+		for (int y = 0; y < chroma_height; ++y) {
+			if (!stream_->WriteBytes(buffer.DataU() + y * buffer.StrideU(), chroma_width)) {
+				return false;
+			}
+		}
+		for (int y = 0; y < chroma_height; ++y) {
+			if (!stream_->WriteBytes(buffer.DataV() + y * buffer.StrideV(), chroma_width)) {
+				return false;
+			}
+		}
+		return true;
+	});
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "api/mediastreaminterface.h"
+#include "api/video/i420_buffer.h"
+#include "api/video/video_frame.h"
+#include "common_video/include/i420_buffer_pool.h"
+#include "rtc_base/scoped_ref_ptr.h"
+
+class Y4mFileStream;
+
+// Sink that records the frames of a track as received to Y4M files, for
+// quality investigations. OnFrame() only copies the frame into a buffer from
+// a bounded pool; a dedicated thread writes it out. When the pool is
+// exhausted because the disk falls behind, the frame is dropped and counted.
+//
+// Output goes through rtc::FileRotatingStream: <dir>/<prefix>_0 is the
+// newest file, every file is a complete Y4M stream of at most
+// |max_file_size| bytes. All frames are written at the resolution of the
+// first one, later resolution changes are scaled. The capture timestamp is
+// stored as an X parameter on every FRAME header.
+class Y4mDumpSink : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+public:
+	// |track| may be null, frames are then pushed through OnFrame().
+	Y4mDumpSink(webrtc::VideoTrackInterface* track,
+		const std::string& dir,
+		const std::string& prefix,
+		size_t max_file_size,
+		size_t num_files,
+		size_t max_queued_frames);
+	~Y4mDumpSink() override;
+
+	// VideoSinkInterface implementation
+	void OnFrame(const webrtc::VideoFrame& frame) override;
+
+	int64_t frames_written() const { return frames_written_; }
+	int64_t frames_dropped() const { return frames_dropped_; }
+
+private:
+	struct PendingFrame {
+		rtc::scoped_refptr<webrtc::I420Buffer> buffer;
+		int64_t timestamp_us;
+	};
+
+	void Run();
+	bool WriteFrame(const PendingFrame& frame);
+
+	rtc::scoped_refptr<webrtc::VideoTrackInterface> track_;
+	std::unique_ptr<Y4mFileStream> stream_;//only used on the writer thread
+
+	// Decode thread only.
+	webrtc::I420BufferPool buffer_pool_;
+	int width_ = 0;
+	int height_ = 0;
+
+	std::mutex queue_mutex_;
+	std::condition_variable queue_cv_;
+	std::deque<PendingFrame> queue_;//guarded by queue_mutex_
+	bool stopping_ = false;//guarded by queue_mutex_
+	std::thread writer_;
+
+	std::atomic<int64_t> frames_written_;
+	std::atomic<int64_t> frames_dropped_;
+};
@@ -0,0 +1,360 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file must be compiled with -mavx2 (or /arch:AVX2).
+
+#include "common_audio/real_fourier_avx2.h"
+
+#include <immintrin.h>
+#include <math.h>
+
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+// Eight complex points, as separate real and imaginary parts.
+struct Complex8 {
+  __m256 re;
+  __m256 im;
+};
+
+std::unique_ptr<float[], AlignedFreeDeleter> AllocFloats(size_t count) {
+  return std::unique_ptr<float[], AlignedFreeDeleter>(
+      static_cast<float*>(AlignedMalloc(sizeof(float) * count,
+                                        RealFourier::kFftBufferAlignment)));
+}
+
+inline Complex8 Load(const float* re, const float* im) {
+  return {_mm256_loadu_ps(re), _mm256_loadu_ps(im)};
+}
+
+inline void Store(const Complex8& v, float* re, float* im) {
+  _mm256_storeu_ps(re, v.re);
+  _mm256_storeu_ps(im, v.im);
+}
+
+inline Complex8 Multiply(const Complex8& a, __m256 w_re, __m256 w_im) {
+  return {_mm256_sub_ps(_mm256_mul_ps(a.re, w_re), _mm256_mul_ps(a.im, w_im)),
+          _mm256_add_ps(_mm256_mul_ps(a.re, w_im), _mm256_mul_ps(a.im, w_re))};
+}
+
+// The radix-4 butterfly of the Stockham FFT, with the twiddles w^p, w^2p and
+// w^3p in |w|: real and imaginary parts of each.
+inline void Radix4(const Complex8& a,
+                   const Complex8& b,
+                   const Complex8& c,
+                   const Complex8& d,
+                   const __m256 w[6],
+                   Complex8 out[4]) {
+  const __m256 apc_re = _mm256_add_ps(a.re, c.re);
+  const __m256 apc_im = _mm256_add_ps(a.im, c.im);
+  const __m256 amc_re = _mm256_sub_ps(a.re, c.re);
+  const __m256 amc_im = _mm256_sub_ps(a.im, c.im);
+  const __m256 bpd_re = _mm256_add_ps(b.re, d.re);
+  const __m256 bpd_im = _mm256_add_ps(b.im, d.im);
+  const __m256 bmd_re = _mm256_sub_ps(b.re, d.re);
+  const __m256 bmd_im = _mm256_sub_ps(b.im, d.im);
+  out[0] = {_mm256_add_ps(apc_re, bpd_re), _mm256_add_ps(apc_im, bpd_im)};
+  // (a - c) -/+ i (b - d).
+  out[1] = Multiply({_mm256_add_ps(amc_re, bmd_im),
+                     _mm256_sub_ps(amc_im, bmd_re)}, w[0], w[1]);
+  out[2] = Multiply({_mm256_sub_ps(apc_re, bpd_re),
+                     _mm256_sub_ps(apc_im, bpd_im)}, w[2], w[3]);
+  out[3] = Multiply({_mm256_sub_ps(amc_re, bmd_im),
+                     _mm256_add_ps(amc_im, bmd_re)}, w[4], w[5]);
+}
+
+// Interleaves four vectors: out holds v0[0], v1[0], v2[0], v3[0], v0[1], ...
+inline void Transpose4(const __m256 v[4], float* out) {
+  const __m256 t0 = _mm256_unpacklo_ps(v[0], v[1]);
+  const __m256 t1 = _mm256_unpacklo_ps(v[2], v[3]);
+  const __m256 t2 = _mm256_unpackhi_ps(v[0], v[1]);
+  const __m256 t3 = _mm256_unpackhi_ps(v[2], v[3]);
+  const __m256 u0 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 u1 = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+  const __m256 u2 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  const __m256 u3 = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  _mm256_storeu_ps(out, _mm256_permute2f128_ps(u0, u1, 0x20));
+  _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(u2, u3, 0x20));
+  _mm256_storeu_ps(out + 16, _mm256_permute2f128_ps(u0, u1, 0x31));
+  _mm256_storeu_ps(out + 24, _mm256_permute2f128_ps(u2, u3, 0x31));
+}
+
+// Splits 16 interleaved floats into the even ones and the odd ones.
+inline Complex8 Deinterleave(const float* in) {
+  const __m256 a = _mm256_loadu_ps(in);
+  const __m256 b = _mm256_loadu_ps(in + 8);
+  const __m256 even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+  const __m256 odd = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+  // The shuffles work within 128-bit lanes.
+  return {_mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even),
+                                                 _MM_SHUFFLE(3, 1, 2, 0))),
+          _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd),
+                                                 _MM_SHUFFLE(3, 1, 2, 0)))};
+}
+
+inline void Interleave(__m256 even, __m256 odd, float* out) {
+  const __m256 lo = _mm256_unpacklo_ps(even, odd);
+  const __m256 hi = _mm256_unpackhi_ps(even, odd);
+  _mm256_storeu_ps(out, _mm256_permute2f128_ps(lo, hi, 0x20));
+  _mm256_storeu_ps(out + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+}
+
+inline __m256 Reverse(__m256 v) {
+  return _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+// Stores the 128-bit lanes of |a| and |b| that |select| picks, as
+// _mm256_permute2f128_ps() does.
+template <int select>
+inline void StoreLanes(const Complex8& a,
+                       const Complex8& b,
+                       float* re,
+                       float* im) {
+  _mm256_storeu_ps(re, _mm256_permute2f128_ps(a.re, b.re, select));
+  _mm256_storeu_ps(im, _mm256_permute2f128_ps(a.im, b.im, select));
+}
+
+// |w[p]| in the low 128-bit lane and |w[p + 1]| in the high one.
+inline __m256 Pair(const float* w, size_t p) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(w[p])),
+                              _mm_set1_ps(w[p + 1]), 1);
+}
+
+}  // namespace
+
+RealFourierAVX2::RealFourierAVX2(int fft_order)
+    : order_(fft_order),
+      length_(FftLength(order_)),
+      half_length_(length_ / 2) {
+  RTC_CHECK_GE(order_, kMinOrder);
+  const double kPi = 3.14159265358979323846;
+
+  // A radix-4 stage of length n needs 6 * n / 4 twiddles.
+  size_t twiddle_count = 0;
+  for (size_t n = half_length_; n >= 4; n /= 4) {
+    twiddle_count += 6 * (n / 4);
+  }
+  twiddles_ = AllocFloats(twiddle_count);
+  float* w = twiddles_.get();
+  for (size_t n = half_length_; n >= 4; n /= 4) {
+    const size_t m = n / 4;
+    for (size_t p = 0; p < m; ++p) {
+      for (size_t k = 1; k <= 3; ++k) {
+        const double angle = -2 * kPi * static_cast<double>(k * p) / n;
+        w[(2 * k - 2) * m + p] = static_cast<float>(cos(angle));
+        w[(2 * k - 1) * m + p] = static_cast<float>(sin(angle));
+      }
+    }
+    w += 6 * m;
+  }
+
+  split_re_ = AllocFloats(half_length_);
+  split_im_ = AllocFloats(half_length_);
+  for (size_t k = 0; k < half_length_; ++k) {
+    const double angle = -2 * kPi * static_cast<double>(k) / length_;
+    split_re_[k] = static_cast<float>(cos(angle));
+    split_im_[k] = static_cast<float>(sin(angle));
+  }
+
+  work_re_ = AllocFloats(half_length_ + 8);
+  work_im_ = AllocFloats(half_length_ + 8);
+  temp_re_ = AllocFloats(half_length_ + 8);
+  temp_im_ = AllocFloats(half_length_ + 8);
+}
+
+RealFourierAVX2::~RealFourierAVX2() {}
+
+void RealFourierAVX2::ComplexFft(float** re, float** im) const {
+  float* x_re = work_re_.get();
+  float* x_im = work_im_.get();
+  float* y_re = temp_re_.get();
+  float* y_im = temp_im_.get();
+  const float* w = twiddles_.get();
+  size_t n = half_length_;
+  size_t m = n / 4;
+
+  // First stage, s == 1: eight butterflies p per vector, whose outputs
+  // y[4 * p + k] are transposed into place.
+  for (size_t p = 0; p < m; p += 8) {
+    const __m256 twiddles[6] = {
+        _mm256_loadu_ps(&w[p]),         _mm256_loadu_ps(&w[m + p]),
+        _mm256_loadu_ps(&w[2 * m + p]), _mm256_loadu_ps(&w[3 * m + p]),
+        _mm256_loadu_ps(&w[4 * m + p]), _mm256_loadu_ps(&w[5 * m + p])};
+    Complex8 out[4];
+    Radix4(Load(&x_re[p], &x_im[p]), Load(&x_re[p + m], &x_im[p + m]),
+           Load(&x_re[p + 2 * m], &x_im[p + 2 * m]),
+           Load(&x_re[p + 3 * m], &x_im[p + 3 * m]), twiddles, out);
+    const __m256 out_re[4] = {out[0].re, out[1].re, out[2].re, out[3].re};
+    const __m256 out_im[4] = {out[0].im, out[1].im, out[2].im, out[3].im};
+    Transpose4(out_re, &y_re[4 * p]);
+    Transpose4(out_im, &y_im[4 * p]);
+  }
+  std::swap(x_re, y_re);
+  std::swap(x_im, y_im);
+  w += 6 * m;
+  n = m;
+  m = n / 4;
+
+  // Second stage, s == 4: two butterflies p per vector, four points q each.
+  for (size_t p = 0; p < m; p += 2) {
+    const __m256 twiddles[6] = {Pair(w, p),         Pair(w + m, p),
+                                Pair(w + 2 * m, p), Pair(w + 3 * m, p),
+                                Pair(w + 4 * m, p), Pair(w + 5 * m, p)};
+    Complex8 out[4];
+    const size_t in = 4 * p;
+    Radix4(Load(&x_re[in], &x_im[in]),
+           Load(&x_re[in + 4 * m], &x_im[in + 4 * m]),
+           Load(&x_re[in + 8 * m], &x_im[in + 8 * m]),
+           Load(&x_re[in + 12 * m], &x_im[in + 12 * m]), twiddles, out);
+    // y[16 * p + 4 * k + q] for the low lanes, then the same for p + 1.
+    StoreLanes<0x20>(out[0], out[1], &y_re[16 * p], &y_im[16 * p]);
+    StoreLanes<0x20>(out[2], out[3], &y_re[16 * p + 8], &y_im[16 * p + 8]);
+    StoreLanes<0x31>(out[0], out[1], &y_re[16 * p + 16], &y_im[16 * p + 16]);
+    StoreLanes<0x31>(out[2], out[3], &y_re[16 * p + 24], &y_im[16 * p + 24]);
+  }
+  std::swap(x_re, y_re);
+  std::swap(x_im, y_im);
+  w += 6 * m;
+  n = m;
+  size_t s = 16;
+
+  // Remaining radix-4 stages, s >= 16: vectors over q.
+  for (; n >= 4; n /= 4, s *= 4) {
+    m = n / 4;
+    for (size_t p = 0; p < m; ++p) {
+      const __m256 twiddles[6] = {
+          _mm256_set1_ps(w[p]),         _mm256_set1_ps(w[m + p]),
+          _mm256_set1_ps(w[2 * m + p]), _mm256_set1_ps(w[3 * m + p]),
+          _mm256_set1_ps(w[4 * m + p]), _mm256_set1_ps(w[5 * m + p])};
+      const float* a_re = &x_re[s * p];
+      const float* a_im = &x_im[s * p];
+      float* out_re = &y_re[4 * s * p];
+      float* out_im = &y_im[4 * s * p];
+      for (size_t q = 0; q < s; q += 8) {
+        Complex8 out[4];
+        Radix4(Load(&a_re[q], &a_im[q]),
+               Load(&a_re[q + s * m], &a_im[q + s * m]),
+               Load(&a_re[q + 2 * s * m], &a_im[q + 2 * s * m]),
+               Load(&a_re[q + 3 * s * m], &a_im[q + 3 * s * m]), twiddles,
+               out);
+        for (size_t k = 0; k < 4; ++k) {
+          Store(out[k], &out_re[k * s + q], &out_im[k * s + q]);
+        }
+      }
+    }
+    std::swap(x_re, y_re);
+    std::swap(x_im, y_im);
+    w += 6 * m;
+  }
+
+  // Odd orders end with a radix-2 stage.
+  if (n == 2) {
+    for (size_t q = 0; q < s; q += 8) {
+      const Complex8 a = Load(&x_re[q], &x_im[q]);
+      const Complex8 b = Load(&x_re[q + s], &x_im[q + s]);
+      Store({_mm256_add_ps(a.re, b.re), _mm256_add_ps(a.im, b.im)}, &y_re[q],
+            &y_im[q]);
+      Store({_mm256_sub_ps(a.re, b.re), _mm256_sub_ps(a.im, b.im)},
+            &y_re[q + s], &y_im[q + s]);
+    }
+    std::swap(x_re, y_re);
+    std::swap(x_im, y_im);
+  }
+
+  *re = x_re;
+  *im = x_im;
+}
+
+void RealFourierAVX2::Forward(const float* src,
+                              std::complex<float>* dest) const {
+  // The even and odd samples are the real and imaginary parts of a complex
+  // signal z of half the length.
+  float* re = work_re_.get();
+  float* im = work_im_.get();
+  for (size_t i = 0; i < half_length_; i += 8) {
+    Store(Deinterleave(&src[2 * i]), &re[i], &im[i]);
+  }
+  ComplexFft(&re, &im);
+  re[half_length_] = re[0];
+  im[half_length_] = im[0];
+
+  // X[k] = (Z[k] + Z*[M - k]) / 2 - i/2 w^k (Z[k] - Z*[M - k]), for
+  // M = half_length_ and w = e^(-2 pi i / length_).
+  const __m256 kHalf = _mm256_set1_ps(0.5f);
+  float* out = reinterpret_cast<float*>(dest);
+  for (size_t k = 0; k < half_length_; k += 8) {
+    const size_t mirror = half_length_ - k - 7;
+    const __m256 z_re = _mm256_loadu_ps(&re[k]);
+    const __m256 z_im = _mm256_loadu_ps(&im[k]);
+    const __m256 c_re = Reverse(_mm256_loadu_ps(&re[mirror]));
+    const __m256 c_im = Reverse(_mm256_loadu_ps(&im[mirror]));
+    // The conjugate flips the sign of c_im.
+    const __m256 sum_re = _mm256_add_ps(z_re, c_re);
+    const __m256 sum_im = _mm256_sub_ps(z_im, c_im);
+    const Complex8 diff = Multiply(
+        {_mm256_sub_ps(z_re, c_re), _mm256_add_ps(z_im, c_im)},
+        _mm256_loadu_ps(&split_re_[k]), _mm256_loadu_ps(&split_im_[k]));
+    Interleave(_mm256_mul_ps(_mm256_add_ps(sum_re, diff.im), kHalf),
+               _mm256_mul_ps(_mm256_sub_ps(sum_im, diff.re), kHalf),
+               &out[2 * k]);
+  }
+  dest[half_length_] = std::complex<float>(re[0] - im[0], 0.0f);
+}
+
+void RealFourierAVX2::Inverse(const std::complex<float>* src,
+                              float* dest) const {
+  // Z[k] = X[k] + X*[M - k] + i w^-k (X[k] - X*[M - k]), twice the DFT of z,
+  // conjugated so the forward FFT gives the inverse.
+  float* re = work_re_.get();
+  float* im = work_im_.get();
+  const float* in = reinterpret_cast<const float*>(src);
+  for (size_t k = 0; k < half_length_; k += 8) {
+    const size_t mirror = half_length_ - k - 7;
+    const Complex8 x = Deinterleave(&in[2 * k]);
+    const Complex8 y = Deinterleave(&in[2 * mirror]);
+    const __m256 y_re = Reverse(y.re);
+    const __m256 y_im = Reverse(y.im);
+    const __m256 sum_re = _mm256_add_ps(x.re, y_re);
+    const __m256 sum_im = _mm256_sub_ps(x.im, y_im);
+    // Multiplying by w^-k is multiplying by the conjugate of w^k.
+    const Complex8 diff = Multiply(
+        {_mm256_sub_ps(x.re, y_re), _mm256_add_ps(x.im, y_im)},
+        _mm256_loadu_ps(&split_re_[k]),
+        _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&split_im_[k])));
+    _mm256_storeu_ps(&re[k], _mm256_sub_ps(sum_re, diff.im));
+    _mm256_storeu_ps(&im[k],
+                     _mm256_sub_ps(_mm256_setzero_ps(),
+                                   _mm256_add_ps(sum_im, diff.re)));
+  }
+  // Like the Ooura backend, ignore the imaginary parts of DC and Nyquist.
+  re[0] = src[0].real() + src[half_length_].real();
+  im[0] = src[half_length_].real() - src[0].real();
+
+  ComplexFft(&re, &im);
+
+  const __m256 scale = _mm256_set1_ps(1.0f / length_);
+  const __m256 negative_scale = _mm256_set1_ps(-1.0f / length_);
+  for (size_t i = 0; i < half_length_; i += 8) {
+    Interleave(_mm256_mul_ps(_mm256_loadu_ps(&re[i]), scale),
+               _mm256_mul_ps(_mm256_loadu_ps(&im[i]), negative_scale),
+               &dest[2 * i]);
+  }
+}
+
+int RealFourierAVX2::order() const {
+  return order_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_REAL_FOURIER_AVX2_H_
+#define COMMON_AUDIO_REAL_FOURIER_AVX2_H_
+
+#include <complex>
+#include <memory>
+
+#include "common_audio/real_fourier.h"
+#include "rtc_base/memory/aligned_malloc.h"
+
+namespace webrtc {
+
+// Real DFT of length 2^order, order >= kMinOrder, as a complex FFT of half the
+// length on the even and odd samples followed by a split step. The complex
+// FFT is a radix-4 Stockham FFT, with one radix-2 stage for odd orders, on
+// separate real and imaginary arrays, eight points per AVX2 vector.
+// Must only be created on CPUs with AVX2; see CreateRealFourier().
+class RealFourierAVX2 : public RealFourier {
+ public:
+  static const int kMinOrder = 6;
+
+  explicit RealFourierAVX2(int fft_order);
+  ~RealFourierAVX2() override;
+
+  void Forward(const float* src, std::complex<float>* dest) const override;
+  void Inverse(const std::complex<float>* src, float* dest) const override;
+
+  int order() const override;
+
+ private:
+  typedef std::unique_ptr<float[], AlignedFreeDeleter> AlignedFloats;
+
+  // Transforms the |half_length_| points in |work_re_| and |work_im_|, and
+  // returns the buffers holding the result.
+  void ComplexFft(float** re, float** im) const;
+
+  const int order_;
+  const size_t length_;
+  const size_t half_length_;
+  // Twiddles of every radix-4 stage, w^p, w^2p and w^3p for p < n / 4, real
+  // parts followed by imaginary parts.
+  AlignedFloats twiddles_;
+  // e^(-2 pi i k / length_) for the split step, k < half_length_.
+  AlignedFloats split_re_;
+  AlignedFloats split_im_;
+  // Ping-pong buffers of the complex FFT, with one extra point so the split
+  // step can read index half_length_.
+  AlignedFloats work_re_;
+  AlignedFloats work_im_;
+  AlignedFloats temp_re_;
+  AlignedFloats temp_im_;
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_REAL_FOURIER_AVX2_H_
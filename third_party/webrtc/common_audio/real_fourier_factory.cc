@@ -0,0 +1,31 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/real_fourier_factory.h"
+
+#include "rtc_base/system/arch.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include "common_audio/real_fourier_avx2.h"
+#endif
+
+namespace webrtc {
+
+std::unique_ptr<RealFourier> CreateRealFourier(int fft_order) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (fft_order >= RealFourierAVX2::kMinOrder && WebRtc_GetCPUInfo(kAVX2)) {
+    return std::unique_ptr<RealFourier>(new RealFourierAVX2(fft_order));
+  }
+#endif
+  return RealFourier::Create(fft_order);
+}
+
+}  // namespace webrtc
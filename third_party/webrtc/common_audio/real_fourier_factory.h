@@ -0,0 +1,27 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_AUDIO_REAL_FOURIER_FACTORY_H_
+#define COMMON_AUDIO_REAL_FOURIER_FACTORY_H_
+
+#include <memory>
+
+#include "common_audio/real_fourier.h"
+
+namespace webrtc {
+
+// Creates the fastest RealFourier backend the CPU supports for the given
+// order: RealFourierAVX2 on x86 CPUs with AVX2 for orders of at least
+// RealFourierAVX2::kMinOrder, otherwise the one of RealFourier::Create().
+std::unique_ptr<RealFourier> CreateRealFourier(int fft_order);
+
+}  // namespace webrtc
+
+#endif  // COMMON_AUDIO_REAL_FOURIER_FACTORY_H_
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file must be compiled with AVX2 enabled (-mavx2); it is only called
+// after WebRtc_GetCPUInfo(kAVX2) succeeded.
+
+#include <immintrin.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+static inline int32_t SumLanes(__m256i v) {
+  __m128i x = _mm_add_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(x);
+}
+
+// Like the C version every product is shifted before it is accumulated, and
+// the 32-bit sums wrap the same way, so the result is bit-exact.
+static inline int32_t DotProductWithScaleAVX2(const int16_t* vector1,
+                                              const int16_t* vector2,
+                                              size_t length,
+                                              int right_shifts) {
+  size_t j = 0;
+  int32_t corr = 0;
+  __m256i sum = _mm256_setzero_si256();
+
+  if (right_shifts == 0) {
+    for (; j + 16 <= length; j += 16) {
+      __m256i a = _mm256_loadu_si256((const __m256i*)&vector1[j]);
+      __m256i b = _mm256_loadu_si256((const __m256i*)&vector2[j]);
+      sum = _mm256_add_epi32(sum, _mm256_madd_epi16(a, b));
+    }
+  } else {
+    __m128i shift = _mm_cvtsi32_si128(right_shifts);
+    for (; j + 16 <= length; j += 16) {
+      __m256i a = _mm256_loadu_si256((const __m256i*)&vector1[j]);
+      __m256i b = _mm256_loadu_si256((const __m256i*)&vector2[j]);
+      __m256i lo = _mm256_mullo_epi16(a, b);
+      __m256i hi = _mm256_mulhi_epi16(a, b);
+      // The unpacks work per 128-bit lane, which does not matter for a sum.
+      sum = _mm256_add_epi32(
+          sum, _mm256_sra_epi32(_mm256_unpacklo_epi16(lo, hi), shift));
+      sum = _mm256_add_epi32(
+          sum, _mm256_sra_epi32(_mm256_unpackhi_epi16(lo, hi), shift));
+    }
+  }
+  corr = SumLanes(sum);
+
+  for (; j < length; j++)
+    corr += (vector1[j] * vector2[j]) >> right_shifts;
+  return corr;
+}
+
+/* AVX2 version of WebRtcSpl_CrossCorrelation() for x86 platforms. */
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2) {
+  size_t i = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    *cross_correlation++ =
+        DotProductWithScaleAVX2(seq1, seq2, dim_seq, right_shifts);
+    seq2 += step_seq2;
+  }
+}
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file must be compiled with AVX2 enabled (-mavx2); it is only called
+// after WebRtc_GetCPUInfo(kAVX2) succeeded.
+
+#include <immintrin.h>
+#include <stddef.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// Filters longer than this many 16-tap chunks use the C version.
+enum { kMaxCoefficientChunks = 8 };
+
+static inline __m128i Reverse8(const int16_t* coefficients) {
+  const __m128i kReverse =
+      _mm_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+  return _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)coefficients),
+                          kReverse);
+}
+
+static inline int32_t SumLanes(__m256i v) {
+  __m128i x = _mm_add_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(x);
+}
+
+// AVX2 intrinsics version of WebRtcSpl_DownsampleFast() for x86 platforms.
+// Same scheme as the SSE2 version with sixteen taps per step and one
+// optional eight-tap step; the output is bit-exact with the C version.
+int WebRtcSpl_DownsampleFastAVX2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  size_t i = 0;
+  size_t j = 0;
+  int32_t out_s32 = 0;
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+  size_t chunks = coefficients_length >> 4;
+  int half_chunk = (coefficients_length & 8) != 0;
+  size_t scalar_start = (coefficients_length >> 3) << 3;
+  __m256i coefficients_reversed[kMaxCoefficientChunks];
+  __m128i half_reversed = _mm_setzero_si128();
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+  if (chunks > kMaxCoefficientChunks) {
+    return WebRtcSpl_DownsampleFastC(data_in, data_in_length, data_out,
+                                     data_out_length, coefficients,
+                                     coefficients_length, factor, delay);
+  }
+
+  // Lane l of chunk j holds coefficients[16 * j + 15 - l], which multiplies
+  // data_in[i - 16 * j - 15 + l].
+  for (j = 0; j < chunks; j++) {
+    coefficients_reversed[j] = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(Reverse8(&coefficients[16 * j + 8])),
+        Reverse8(&coefficients[16 * j]), 1);
+  }
+  if (half_chunk) {
+    half_reversed = Reverse8(&coefficients[16 * chunks]);
+  }
+
+  for (i = delay; i < endpos; i += factor) {
+    const int16_t* in = &data_in[i];
+    __m256i sum = _mm256_setzero_si256();
+
+    // Negative overflow is permitted here, because this is
+    // auto-regressive filters, and the state for each batch run is
+    // stored in the "negative" positions of the output vector.
+    for (j = 0; j < chunks; j++) {
+      __m256i data = _mm256_loadu_si256((const __m256i*)(in - 16 * j - 15));
+      sum = _mm256_add_epi32(sum,
+                             _mm256_madd_epi16(data, coefficients_reversed[j]));
+    }
+    if (half_chunk) {
+      __m128i data = _mm_loadu_si128((const __m128i*)(in - scalar_start + 1));
+      sum = _mm256_add_epi32(sum, _mm256_inserti128_si256(
+          _mm256_setzero_si256(), _mm_madd_epi16(data, half_reversed), 0));
+    }
+
+    out_s32 = 2048 + SumLanes(sum);  // Round value, 0.5 in Q12.
+    for (j = scalar_start; j < coefficients_length; j++) {
+      out_s32 += coefficients[j] * in[-(ptrdiff_t) j];
+    }
+
+    out_s32 >>= 12;  // Q0.
+
+    // Saturate and store the output.
+    *data_out++ = WebRtcSpl_SatW32ToW16(out_s32);
+  }
+
+  return 0;
+}
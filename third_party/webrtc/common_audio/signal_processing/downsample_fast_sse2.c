@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <emmintrin.h>
+#include <stddef.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// Filters longer than this many 8-tap chunks use the C version.
+enum { kMaxCoefficientChunks = 16 };
+
+static inline int32_t SumLanes(__m128i v) {
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(v);
+}
+
+// SSE2 intrinsics version of WebRtcSpl_DownsampleFast() for x86 platforms.
+// The filter is applied as a dot product of eight taps at a time against the
+// input read forward in memory, which needs the taps in reverse order. The
+// 32-bit sums wrap like the C version, so the output is bit-exact.
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  size_t i = 0;
+  size_t j = 0;
+  int32_t out_s32 = 0;
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+  size_t chunks = coefficients_length >> 3;
+  __m128i coefficients_reversed[kMaxCoefficientChunks];
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+  if (chunks > kMaxCoefficientChunks) {
+    return WebRtcSpl_DownsampleFastC(data_in, data_in_length, data_out,
+                                     data_out_length, coefficients,
+                                     coefficients_length, factor, delay);
+  }
+
+  // Lane l of chunk j holds coefficients[8 * j + 7 - l], which multiplies
+  // data_in[i - 8 * j - 7 + l].
+  for (j = 0; j < chunks; j++) {
+    __m128i c = _mm_loadu_si128((const __m128i*)&coefficients[8 * j]);
+    c = _mm_shuffle_epi32(c, _MM_SHUFFLE(0, 1, 2, 3));
+    c = _mm_shufflelo_epi16(c, _MM_SHUFFLE(2, 3, 0, 1));
+    coefficients_reversed[j] = _mm_shufflehi_epi16(c, _MM_SHUFFLE(2, 3, 0, 1));
+  }
+
+  for (i = delay; i < endpos; i += factor) {
+    const int16_t* in = &data_in[i];
+    __m128i sum = _mm_setzero_si128();
+
+    // Negative overflow is permitted here, because this is
+    // auto-regressive filters, and the state for each batch run is
+    // stored in the "negative" positions of the output vector.
+    for (j = 0; j < chunks; j++) {
+      __m128i data = _mm_loadu_si128((const __m128i*)(in - 8 * j - 7));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(data, coefficients_reversed[j]));
+    }
+
+    out_s32 = 2048 + SumLanes(sum);  // Round value, 0.5 in Q12.
+    for (j = chunks << 3; j < coefficients_length; j++) {
+      out_s32 += coefficients[j] * in[-(ptrdiff_t) j];
+    }
+
+    out_s32 >>= 12;  // Q0.
+
+    // Saturate and store the output.
+    *data_out++ = WebRtcSpl_SatW32ToW16(out_s32);
+  }
+
+  return 0;
+}
@@ -0,0 +1,209 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file must be compiled with AVX2 enabled (-mavx2); it is only called
+// after WebRtc_GetCPUInfo(kAVX2) succeeded.
+
+#include <immintrin.h>
+#include <stdlib.h>
+
+#include "rtc_base/checks.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// Horizontal reductions of the sixteen 16-bit and eight 32-bit lanes.
+static inline int16_t MaxLaneW16(__m256i v) {
+  __m128i x = _mm_max_epi16(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  x = _mm_max_epi16(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_max_epi16(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  x = _mm_max_epi16(x, _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(x);
+}
+
+static inline int16_t MinLaneW16(__m256i v) {
+  __m128i x = _mm_min_epi16(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  x = _mm_min_epi16(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_min_epi16(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  x = _mm_min_epi16(x, _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(x);
+}
+
+static inline uint32_t MaxLaneU32(__m256i v) {
+  __m128i x = _mm_max_epu32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  x = _mm_max_epu32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_max_epu32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (uint32_t)_mm_cvtsi128_si32(x);
+}
+
+static inline int32_t MaxLaneW32(__m256i v) {
+  __m128i x = _mm_max_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  x = _mm_max_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_max_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(x);
+}
+
+static inline int32_t MinLaneW32(__m256i v) {
+  __m128i x = _mm_min_epi32(_mm256_castsi256_si128(v),
+                            _mm256_extracti128_si256(v, 1));
+  x = _mm_min_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+  x = _mm_min_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(x);
+}
+
+// Maximum absolute value of word16 vector. AVX2 version.
+int16_t WebRtcSpl_MaxAbsValueW16AVX2(const int16_t* vector, size_t length) {
+  size_t i = 0;
+  int absolute = 0, maximum = 0;
+  __m256i max_v = _mm256_setzero_si256();
+
+  RTC_DCHECK_GT(length, 0);
+
+  // vpabsw leaves -32768 as 0x8000; compared unsigned it is 32768 and gets
+  // clamped below like in the C version.
+  for (; i + 16 <= length; i += 16) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)&vector[i]);
+    max_v = _mm256_max_epu16(max_v, _mm256_abs_epi16(v));
+  }
+  {
+    __m128i x = _mm_max_epu16(_mm256_castsi256_si128(max_v),
+                              _mm256_extracti128_si256(max_v, 1));
+    // phminposuw finds the minimum, so search the complement.
+    x = _mm_minpos_epu16(_mm_xor_si128(x, _mm_set1_epi16(-1)));
+    maximum = 0xffff - (_mm_cvtsi128_si32(x) & 0xffff);
+  }
+
+  for (; i < length; i++) {
+    absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  // Guard the case for abs(-32768).
+  if (maximum > WEBRTC_SPL_WORD16_MAX) {
+    maximum = WEBRTC_SPL_WORD16_MAX;
+  }
+
+  return (int16_t)maximum;
+}
+
+// Maximum absolute value of word32 vector. AVX2 version.
+int32_t WebRtcSpl_MaxAbsValueW32AVX2(const int32_t* vector, size_t length) {
+  size_t i = 0;
+  uint32_t absolute = 0, maximum = 0;
+  __m256i max_v = _mm256_setzero_si256();
+
+  RTC_DCHECK_GT(length, 0);
+
+  // vpabsd leaves 0x80000000 unchanged, which is abs() as an unsigned value.
+  for (; i + 8 <= length; i += 8) {
+    __m256i v = _mm256_loadu_si256((const __m256i*)&vector[i]);
+    max_v = _mm256_max_epu32(max_v, _mm256_abs_epi32(v));
+  }
+  maximum = MaxLaneU32(max_v);
+
+  for (; i < length; i++) {
+    absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  maximum = WEBRTC_SPL_MIN(maximum, WEBRTC_SPL_WORD32_MAX);
+
+  return (int32_t)maximum;
+}
+
+// Maximum value of word16 vector. AVX2 version.
+int16_t WebRtcSpl_MaxValueW16AVX2(const int16_t* vector, size_t length) {
+  int16_t maximum = WEBRTC_SPL_WORD16_MIN;
+  size_t i = 0;
+  __m256i max_v = _mm256_set1_epi16(WEBRTC_SPL_WORD16_MIN);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 16 <= length; i += 16) {
+    max_v = _mm256_max_epi16(max_v,
+                             _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  maximum = MaxLaneW16(max_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Maximum value of word32 vector. AVX2 version.
+int32_t WebRtcSpl_MaxValueW32AVX2(const int32_t* vector, size_t length) {
+  int32_t maximum = WEBRTC_SPL_WORD32_MIN;
+  size_t i = 0;
+  __m256i max_v = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    max_v = _mm256_max_epi32(max_v,
+                             _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  maximum = MaxLaneW32(max_v);
+
+  for (; i < length; i++) {
+    if (vector[i] > maximum)
+      maximum = vector[i];
+  }
+  return maximum;
+}
+
+// Minimum value of word16 vector. AVX2 version.
+int16_t WebRtcSpl_MinValueW16AVX2(const int16_t* vector, size_t length) {
+  int16_t minimum = WEBRTC_SPL_WORD16_MAX;
+  size_t i = 0;
+  __m256i min_v = _mm256_set1_epi16(WEBRTC_SPL_WORD16_MAX);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 16 <= length; i += 16) {
+    min_v = _mm256_min_epi16(min_v,
+                             _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  minimum = MinLaneW16(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
+
+// Minimum value of word32 vector. AVX2 version.
+int32_t WebRtcSpl_MinValueW32AVX2(const int32_t* vector, size_t length) {
+  int32_t minimum = WEBRTC_SPL_WORD32_MAX;
+  size_t i = 0;
+  __m256i min_v = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MAX);
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    min_v = _mm256_min_epi32(min_v,
+                             _mm256_loadu_si256((const __m256i*)&vector[i]));
+  }
+  minimum = MinLaneW32(min_v);
+
+  for (; i < length; i++) {
+    if (vector[i] < minimum)
+      minimum = vector[i];
+  }
+  return minimum;
+}
@@ -30,8 +30,8 @@ static const int16_t kResampleAllpass[2][3] = {
 // state:  filter state array; length = 8
 
 void RTC_NO_SANITIZE("signed-integer-overflow")  // bugs.webrtc.org/5486
-WebRtcSpl_DownBy2IntToShort(int32_t *in, int32_t len, int16_t *out,
-                            int32_t *state)
+WebRtcSpl_DownBy2IntToShortC(int32_t *in, int32_t len, int16_t *out,
+                             int32_t *state)
 {
     int32_t tmp0, tmp1, diff;
     int32_t i;
@@ -126,10 +126,10 @@ WebRtcSpl_DownBy2IntToShort(int32_t *in, int32_t len, int16_t *out,
 // state:  filter state array; length = 8
 
 void RTC_NO_SANITIZE("signed-integer-overflow")  // bugs.webrtc.org/5486
-WebRtcSpl_DownBy2ShortToInt(const int16_t *in,
-                            int32_t len,
-                            int32_t *out,
-                            int32_t *state)
+WebRtcSpl_DownBy2ShortToIntC(const int16_t *in,
+                             int32_t len,
+                             int32_t *out,
+                             int32_t *state)
 {
     int32_t tmp0, tmp1, diff;
     int32_t i;
@@ -204,8 +204,8 @@ WebRtcSpl_DownBy2ShortToInt(const int16_t *in,
 // input:  int16_t
 // output: int32_t (normalized, not saturated) (of length len*2)
 // state:  filter state array; length = 8
-void WebRtcSpl_UpBy2ShortToInt(const int16_t *in, int32_t len, int32_t *out,
-                               int32_t *state)
+void WebRtcSpl_UpBy2ShortToIntC(const int16_t *in, int32_t len, int32_t *out,
+                                int32_t *state)
 {
     int32_t tmp0, tmp1, diff;
     int32_t i;
@@ -274,8 +274,8 @@ void WebRtcSpl_UpBy2ShortToInt(const int16_t *in, int32_t len, int32_t *out,
 // input:  int32_t (shifted 15 positions to the left, + offset 16384)
 // output: int32_t (shifted 15 positions to the left, + offset 16384) (of length len*2)
 // state:  filter state array; length = 8
-void WebRtcSpl_UpBy2IntToInt(const int32_t *in, int32_t len, int32_t *out,
-                             int32_t *state)
+void WebRtcSpl_UpBy2IntToIntC(const int32_t *in, int32_t len, int32_t *out,
+                              int32_t *state)
 {
     int32_t tmp0, tmp1, diff;
     int32_t i;
@@ -344,8 +344,8 @@ void WebRtcSpl_UpBy2IntToInt(const int32_t *in, int32_t len, int32_t *out,
 // input:  int32_t (shifted 15 positions to the left, + offset 16384)
 // output: int16_t (saturated) (of length len*2)
 // state:  filter state array; length = 8
-void WebRtcSpl_UpBy2IntToShort(const int32_t *in, int32_t len, int16_t *out,
-                               int32_t *state)
+void WebRtcSpl_UpBy2IntToShortC(const int32_t *in, int32_t len, int16_t *out,
+                                int32_t *state)
 {
     int32_t tmp0, tmp1, diff;
     int32_t i;
@@ -423,8 +423,8 @@ void WebRtcSpl_UpBy2IntToShort(const int32_t *in, int32_t len, int16_t *out,
 // input:  int16_t
 // output: int32_t (normalized, not saturated)
 // state:  filter state array; length = 8
-void WebRtcSpl_LPBy2ShortToInt(const int16_t* in, int32_t len, int32_t* out,
-                               int32_t* state)
+void WebRtcSpl_LPBy2ShortToIntC(const int16_t* in, int32_t len, int32_t* out,
+                                int32_t* state)
 {
     int32_t tmp0, tmp1, diff;
     int32_t i;
@@ -557,8 +557,8 @@ void WebRtcSpl_LPBy2ShortToInt(const int16_t* in, int32_t len, int32_t* out,
 // output: int32_t (normalized, not saturated)
 // state:  filter state array; length = 8
 void RTC_NO_SANITIZE("signed-integer-overflow")  // bugs.webrtc.org/5486
-WebRtcSpl_LPBy2IntToInt(const int32_t* in, int32_t len, int32_t* out,
-                        int32_t* state)
+WebRtcSpl_LPBy2IntToIntC(const int32_t* in, int32_t len, int32_t* out,
+                         int32_t* state)
 {
     int32_t tmp0, tmp1, diff;
     int32_t i;
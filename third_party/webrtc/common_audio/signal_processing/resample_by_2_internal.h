@@ -18,43 +18,135 @@
 
 #include <stdint.h>
 
+#include "rtc_base/system/arch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /*******************************************************************
- * resample_by_2_fast.c
+ * resample_by_2_internal.c
  * Functions for internal use in the other resample functions
+ *
+ * The functions are called through pointers that start out at the C
+ * versions. WebRtcSpl_Init() switches them to the SSE2 versions on x86 (the
+ * filters are latency bound, so there are no AVX2 versions).
  ******************************************************************/
-void WebRtcSpl_DownBy2IntToShort(int32_t* in,
+
+typedef void (*DownBy2IntToShort)(int32_t* in,
+                                  int32_t len,
+                                  int16_t* out,
+                                  int32_t* state);
+extern DownBy2IntToShort WebRtcSpl_DownBy2IntToShort;
+void WebRtcSpl_DownBy2IntToShortC(int32_t* in,
+                                  int32_t len,
+                                  int16_t* out,
+                                  int32_t* state);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_DownBy2IntToShortSSE2(int32_t* in,
+                                     int32_t len,
+                                     int16_t* out,
+                                     int32_t* state);
+#endif
+
+typedef void (*DownBy2ShortToInt)(const int16_t* in,
+                                  int32_t len,
+                                  int32_t* out,
+                                  int32_t* state);
+extern DownBy2ShortToInt WebRtcSpl_DownBy2ShortToInt;
+void WebRtcSpl_DownBy2ShortToIntC(const int16_t* in,
+                                  int32_t len,
+                                  int32_t* out,
+                                  int32_t* state);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_DownBy2ShortToIntSSE2(const int16_t* in,
+                                     int32_t len,
+                                     int32_t* out,
+                                     int32_t* state);
+#endif
+
+typedef void (*UpBy2ShortToInt)(const int16_t* in,
+                                int32_t len,
+                                int32_t* out,
+                                int32_t* state);
+extern UpBy2ShortToInt WebRtcSpl_UpBy2ShortToInt;
+void WebRtcSpl_UpBy2ShortToIntC(const int16_t* in,
+                                int32_t len,
+                                int32_t* out,
+                                int32_t* state);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_UpBy2ShortToIntSSE2(const int16_t* in,
+                                   int32_t len,
+                                   int32_t* out,
+                                   int32_t* state);
+#endif
+
+typedef void (*UpBy2IntToInt)(const int32_t* in,
+                              int32_t len,
+                              int32_t* out,
+                              int32_t* state);
+extern UpBy2IntToInt WebRtcSpl_UpBy2IntToInt;
+void WebRtcSpl_UpBy2IntToIntC(const int32_t* in,
+                              int32_t len,
+                              int32_t* out,
+                              int32_t* state);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_UpBy2IntToIntSSE2(const int32_t* in,
                                  int32_t len,
-                                 int16_t* out,
+                                 int32_t* out,
                                  int32_t* state);
+#endif
+
+typedef void (*UpBy2IntToShort)(const int32_t* in,
+                                int32_t len,
+                                int16_t* out,
+                                int32_t* state);
+extern UpBy2IntToShort WebRtcSpl_UpBy2IntToShort;
+void WebRtcSpl_UpBy2IntToShortC(const int32_t* in,
+                                int32_t len,
+                                int16_t* out,
+                                int32_t* state);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_UpBy2IntToShortSSE2(const int32_t* in,
+                                   int32_t len,
+                                   int16_t* out,
+                                   int32_t* state);
+#endif
+
+typedef void (*LPBy2ShortToInt)(const int16_t* in,
+                                int32_t len,
+                                int32_t* out,
+                                int32_t* state);
+extern LPBy2ShortToInt WebRtcSpl_LPBy2ShortToInt;
+void WebRtcSpl_LPBy2ShortToIntC(const int16_t* in,
+                                int32_t len,
+                                int32_t* out,
+                                int32_t* state);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_LPBy2ShortToIntSSE2(const int16_t* in,
+                                   int32_t len,
+                                   int32_t* out,
+                                   int32_t* state);
+#endif
 
-void WebRtcSpl_DownBy2ShortToInt(const int16_t* in,
+typedef void (*LPBy2IntToInt)(const int32_t* in,
+                              int32_t len,
+                              int32_t* out,
+                              int32_t* state);
+extern LPBy2IntToInt WebRtcSpl_LPBy2IntToInt;
+void WebRtcSpl_LPBy2IntToIntC(const int32_t* in,
+                              int32_t len,
+                              int32_t* out,
+                              int32_t* state);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_LPBy2IntToIntSSE2(const int32_t* in,
                                  int32_t len,
                                  int32_t* out,
                                  int32_t* state);
+#endif
 
-void WebRtcSpl_UpBy2ShortToInt(const int16_t* in,
-                               int32_t len,
-                               int32_t* out,
-                               int32_t* state);
-
-void WebRtcSpl_UpBy2IntToInt(const int32_t* in,
-                             int32_t len,
-                             int32_t* out,
-                             int32_t* state);
-
-void WebRtcSpl_UpBy2IntToShort(const int32_t* in,
-                               int32_t len,
-                               int16_t* out,
-                               int32_t* state);
-
-void WebRtcSpl_LPBy2ShortToInt(const int16_t* in,
-                               int32_t len,
-                               int32_t* out,
-                               int32_t* state);
-
-void WebRtcSpl_LPBy2IntToInt(const int32_t* in,
-                             int32_t len,
-                             int32_t* out,
-                             int32_t* state);
+#ifdef __cplusplus
+}
+#endif  // __cplusplus
 
 #endif  // COMMON_AUDIO_SIGNAL_PROCESSING_RESAMPLE_BY_2_INTERNAL_H_
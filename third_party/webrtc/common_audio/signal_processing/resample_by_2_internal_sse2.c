@@ -0,0 +1,473 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file contains the SSE2 versions of the allpass resamplers in
+ * resample_by_2_internal.c. The results are bit exact with the C code.
+ *
+ * Each allpass filter is a chain of three first-order sections, and every
+ * section feeds its output back into itself, so the samples of one filter
+ * cannot be computed side by side. The functions instead keep the filters
+ * that run on the same input (two, or four for the lowpass filters) in the
+ * lanes of one vector and pipeline the sections: while section 1 works on
+ * sample t, section 2 works on sample t - 1 and section 3 on sample t - 2.
+ * The three sections are independent within a step and overlap, which leaves
+ * one section's feedback latency per step for all filters together.
+ */
+
+#include <emmintrin.h>
+#include <string.h>
+
+#include "common_audio/signal_processing/resample_by_2_internal.h"
+
+// The allpass coefficients of resample_by_2_internal.c. The filters that
+// use kResampleAllpass[1] ("lower") are in lanes 0 and 1, the ones that use
+// kResampleAllpass[0] ("upper") in lanes 2 and 3. Two filters use lanes 0
+// and 2 only, which lets a single _mm_mul_epu32() do their multiplications.
+static const int32_t kAllpassLanes[3][4] = {
+    {3050, 3050, 821, 821},
+    {9368, 9368, 6110, 6110},
+    {15063, 15063, 12382, 12382}};
+
+// The lane of filter f, whose state is state[4 * f] to state[4 * f + 3].
+// The filters alternate between the lower and the upper coefficients.
+static const int kFilterLane[4] = {0, 2, 1, 3};
+
+// One first-order section: its previous input and output in every lane.
+typedef struct {
+  __m128i in;
+  __m128i out;
+  __m128i coef;
+  __m128i coef_odd;
+} AllpassSection;
+
+// The three sections of all filters and the pipeline between them. |y1| is
+// the output of section 1 for the previous step, |y2| the one of section 2.
+typedef struct {
+  AllpassSection section[3];
+  __m128i y1;
+  __m128i y2;
+} AllpassBank;
+
+// The low 32 bits of a * coef in the lanes of |num_filters| filters, which
+// is what the C code keeps when the product wraps. SSE2 has no 32-bit low
+// multiply; _mm_mul_epu32() covers the even lanes and, for four filters, a
+// second one the odd lanes.
+static __inline __m128i MulLow32(__m128i a,
+                                 const AllpassSection* s,
+                                 int num_filters) {
+  __m128i even = _mm_mul_epu32(a, s->coef);
+  __m128i odd;
+  if (num_filters == 2) {
+    return even;
+  }
+  odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), s->coef_odd);
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// Section 1 scales the difference down with rounding.
+static __inline __m128i Section1(AllpassSection* s,
+                                 __m128i x,
+                                 int num_filters) {
+  __m128i diff = _mm_srai_epi32(
+      _mm_add_epi32(_mm_sub_epi32(x, s->out), _mm_set1_epi32(1 << 13)), 14);
+  __m128i y = _mm_add_epi32(s->in, MulLow32(diff, s, num_filters));
+  s->in = x;
+  s->out = y;
+  return y;
+}
+
+// Sections 2 and 3 scale it down with truncation towards zero.
+static __inline __m128i Section23(AllpassSection* s,
+                                  __m128i x,
+                                  int num_filters) {
+  __m128i diff = _mm_sub_epi32(x, s->out);
+  __m128i y;
+  diff = _mm_sub_epi32(_mm_srai_epi32(diff, 14),
+                       _mm_cmplt_epi32(diff, _mm_setzero_si128()));
+  y = _mm_add_epi32(s->in, MulLow32(diff, s, num_filters));
+  s->in = x;
+  s->out = y;
+  return y;
+}
+
+// Loads the states of |num_filters| filters, four values per filter in the
+// order of the C code: previous input, then the outputs of sections 1 to 3.
+static void BankLoad(AllpassBank* bank,
+                     const int32_t* state,
+                     int num_filters) {
+  __m128i rows[4];
+  __m128i t0, t1, t2, t3;
+  int k;
+  rows[1] = _mm_setzero_si128();
+  rows[3] = _mm_setzero_si128();
+  for (k = 0; k < num_filters; k++) {
+    rows[kFilterLane[k]] = _mm_loadu_si128((const __m128i*)&state[4 * k]);
+  }
+  t0 = _mm_unpacklo_epi32(rows[0], rows[1]);
+  t1 = _mm_unpacklo_epi32(rows[2], rows[3]);
+  t2 = _mm_unpackhi_epi32(rows[0], rows[1]);
+  t3 = _mm_unpackhi_epi32(rows[2], rows[3]);
+  bank->section[0].in = _mm_unpacklo_epi64(t0, t1);
+  bank->section[0].out = _mm_unpackhi_epi64(t0, t1);
+  bank->section[1].in = bank->section[0].out;
+  bank->section[1].out = _mm_unpacklo_epi64(t2, t3);
+  bank->section[2].in = bank->section[1].out;
+  bank->section[2].out = _mm_unpackhi_epi64(t2, t3);
+  for (k = 0; k < 3; k++) {
+    bank->section[k].coef =
+        _mm_loadu_si128((const __m128i*)kAllpassLanes[k]);
+    bank->section[k].coef_odd = _mm_srli_epi64(bank->section[k].coef, 32);
+  }
+}
+
+static void BankStore(const AllpassBank* bank,
+                      int32_t* state,
+                      int num_filters) {
+  __m128i t0 = _mm_unpacklo_epi32(bank->section[0].in, bank->section[0].out);
+  __m128i t1 = _mm_unpacklo_epi32(bank->section[1].out, bank->section[2].out);
+  __m128i t2 = _mm_unpackhi_epi32(bank->section[0].in, bank->section[0].out);
+  __m128i t3 = _mm_unpackhi_epi32(bank->section[1].out, bank->section[2].out);
+  __m128i rows[4];
+  int k;
+  rows[0] = _mm_unpacklo_epi64(t0, t1);
+  rows[1] = _mm_unpackhi_epi64(t0, t1);
+  rows[2] = _mm_unpacklo_epi64(t2, t3);
+  rows[3] = _mm_unpackhi_epi64(t2, t3);
+  for (k = 0; k < num_filters; k++) {
+    _mm_storeu_si128((__m128i*)&state[4 * k], rows[kFilterLane[k]]);
+  }
+}
+
+// The first two samples fill the pipeline.
+static __inline void BankPush0(AllpassBank* bank, __m128i x, int num_filters) {
+  bank->y1 = Section1(&bank->section[0], x, num_filters);
+}
+
+static __inline void BankPush1(AllpassBank* bank, __m128i x, int num_filters) {
+  bank->y2 = Section23(&bank->section[1], bank->y1, num_filters);
+  bank->y1 = Section1(&bank->section[0], x, num_filters);
+}
+
+// Pushes sample t and returns the output for sample t - 2.
+static __inline __m128i BankPush(AllpassBank* bank,
+                                 __m128i x,
+                                 int num_filters) {
+  __m128i y = Section23(&bank->section[2], bank->y2, num_filters);
+  bank->y2 = Section23(&bank->section[1], bank->y1, num_filters);
+  bank->y1 = Section1(&bank->section[0], x, num_filters);
+  return y;
+}
+
+// Drains the pipeline after the last sample. With |len| >= 2 samples pushed
+// it returns the outputs for samples len - 2 and len - 1, with one sample
+// only the output for sample 0 in |y[1]|.
+static __inline void BankFlush(AllpassBank* bank,
+                               int32_t len,
+                               __m128i* y,
+                               int num_filters) {
+  if (len >= 2) {
+    y[0] = Section23(&bank->section[2], bank->y2, num_filters);
+  }
+  bank->y2 = Section23(&bank->section[1], bank->y1, num_filters);
+  y[1] = Section23(&bank->section[2], bank->y2, num_filters);
+}
+
+// The input of the C code, ((int32_t)in << 15) + (1 << 14), for the 16-bit
+// samples in the low lanes of |in|.
+static __inline __m128i ScaleUp(__m128i in) {
+  return _mm_add_epi32(
+      _mm_srai_epi32(_mm_unpacklo_epi16(_mm_setzero_si128(), in), 1),
+      _mm_set1_epi32(1 << 14));
+}
+
+static __inline int32_t ScaleUpScalar(int16_t in) {
+  return ((int32_t)in << 15) + (1 << 14);
+}
+
+// in[0] for the lower and in[1] for the upper filter.
+static __inline __m128i LoadPair(const int32_t* in) {
+  __m128i a = _mm_loadl_epi64((const __m128i*)in);
+  return _mm_unpacklo_epi32(a, a);
+}
+
+static __inline __m128i LoadPairScaled(const int16_t* in) {
+  int32_t pair;
+  __m128i a;
+  memcpy(&pair, in, sizeof(pair));
+  a = ScaleUp(_mm_cvtsi32_si128(pair));
+  return _mm_unpacklo_epi32(a, a);
+}
+
+// Saturates the lanes of |a| to 16 bits and returns lane 0.
+static __inline int16_t SatW16Lane0(__m128i a) {
+  return (int16_t)_mm_cvtsi128_si32(_mm_packs_epi32(a, a));
+}
+
+// Lanes 0 and 1 plus lanes 2 and 3, each divided by two first.
+static __inline __m128i AddHalves(__m128i y) {
+  y = _mm_srai_epi32(y, 1);
+  return _mm_add_epi32(y, _mm_srli_si128(y, 8));
+}
+
+// The decimators run the lower filter on the even input samples and the
+// upper filter on the odd ones, and average the two outputs.
+
+void WebRtcSpl_DownBy2IntToShortSSE2(int32_t* in,
+                                     int32_t len,
+                                     int16_t* out,
+                                     int32_t* state) {
+  AllpassBank bank;
+  __m128i y[2];
+  int32_t i;
+
+  len >>= 1;
+  if (len <= 0) {
+    return;
+  }
+  BankLoad(&bank, state, 2);
+
+  BankPush0(&bank, LoadPair(&in[0]), 2);
+  if (len >= 2) {
+    BankPush1(&bank, LoadPair(&in[2]), 2);
+  }
+  for (i = 2; i < len; i++) {
+    y[0] = BankPush(&bank, LoadPair(&in[i << 1]), 2);
+    out[i - 2] = SatW16Lane0(_mm_srai_epi32(AddHalves(y[0]), 15));
+  }
+  BankFlush(&bank, len, y, 2);
+  if (len >= 2) {
+    out[len - 2] = SatW16Lane0(_mm_srai_epi32(AddHalves(y[0]), 15));
+  }
+  out[len - 1] = SatW16Lane0(_mm_srai_epi32(AddHalves(y[1]), 15));
+
+  BankStore(&bank, state, 2);
+}
+
+void WebRtcSpl_DownBy2ShortToIntSSE2(const int16_t* in,
+                                     int32_t len,
+                                     int32_t* out,
+                                     int32_t* state) {
+  AllpassBank bank;
+  __m128i y[2];
+  int32_t i;
+
+  len >>= 1;
+  if (len <= 0) {
+    return;
+  }
+  BankLoad(&bank, state, 2);
+
+  BankPush0(&bank, LoadPairScaled(&in[0]), 2);
+  if (len >= 2) {
+    BankPush1(&bank, LoadPairScaled(&in[2]), 2);
+  }
+  for (i = 2; i < len; i++) {
+    y[0] = BankPush(&bank, LoadPairScaled(&in[i << 1]), 2);
+    out[i - 2] = _mm_cvtsi128_si32(AddHalves(y[0]));
+  }
+  BankFlush(&bank, len, y, 2);
+  if (len >= 2) {
+    out[len - 2] = _mm_cvtsi128_si32(AddHalves(y[0]));
+  }
+  out[len - 1] = _mm_cvtsi128_si32(AddHalves(y[1]));
+
+  BankStore(&bank, state, 2);
+}
+
+// The interpolators run both filters on every input sample. The upper filter
+// gives the even output samples and the lower one the odd output samples.
+static __inline void StoreUpBy2Int(__m128i y, int32_t* out) {
+  _mm_storel_epi64((__m128i*)out,
+                   _mm_shuffle_epi32(y, _MM_SHUFFLE(0, 0, 0, 2)));
+}
+
+static __inline void StoreUpBy2Short(__m128i y, int16_t* out) {
+  int32_t pair;
+  y = _mm_shuffle_epi32(_mm_srai_epi32(y, 15), _MM_SHUFFLE(0, 0, 0, 2));
+  pair = _mm_cvtsi128_si32(_mm_packs_epi32(y, y));
+  memcpy(out, &pair, sizeof(pair));
+}
+
+void WebRtcSpl_UpBy2ShortToIntSSE2(const int16_t* in,
+                                   int32_t len,
+                                   int32_t* out,
+                                   int32_t* state) {
+  AllpassBank bank;
+  __m128i y[2];
+  int32_t i;
+
+  if (len <= 0) {
+    return;
+  }
+  BankLoad(&bank, state, 2);
+
+  BankPush0(&bank, _mm_set1_epi32(ScaleUpScalar(in[0])), 2);
+  if (len >= 2) {
+    BankPush1(&bank, _mm_set1_epi32(ScaleUpScalar(in[1])), 2);
+  }
+  for (i = 2; i < len; i++) {
+    y[0] = BankPush(&bank, _mm_set1_epi32(ScaleUpScalar(in[i])), 2);
+    StoreUpBy2Int(_mm_srai_epi32(y[0], 15), &out[(i - 2) << 1]);
+  }
+  BankFlush(&bank, len, y, 2);
+  if (len >= 2) {
+    StoreUpBy2Int(_mm_srai_epi32(y[0], 15), &out[(len - 2) << 1]);
+  }
+  StoreUpBy2Int(_mm_srai_epi32(y[1], 15), &out[(len - 1) << 1]);
+
+  BankStore(&bank, state, 2);
+}
+
+void WebRtcSpl_UpBy2IntToIntSSE2(const int32_t* in,
+                                 int32_t len,
+                                 int32_t* out,
+                                 int32_t* state) {
+  AllpassBank bank;
+  __m128i y[2];
+  int32_t i;
+
+  if (len <= 0) {
+    return;
+  }
+  BankLoad(&bank, state, 2);
+
+  BankPush0(&bank, _mm_set1_epi32(in[0]), 2);
+  if (len >= 2) {
+    BankPush1(&bank, _mm_set1_epi32(in[1]), 2);
+  }
+  for (i = 2; i < len; i++) {
+    y[0] = BankPush(&bank, _mm_set1_epi32(in[i]), 2);
+    StoreUpBy2Int(y[0], &out[(i - 2) << 1]);
+  }
+  BankFlush(&bank, len, y, 2);
+  if (len >= 2) {
+    StoreUpBy2Int(y[0], &out[(len - 2) << 1]);
+  }
+  StoreUpBy2Int(y[1], &out[(len - 1) << 1]);
+
+  BankStore(&bank, state, 2);
+}
+
+void WebRtcSpl_UpBy2IntToShortSSE2(const int32_t* in,
+                                   int32_t len,
+                                   int16_t* out,
+                                   int32_t* state) {
+  AllpassBank bank;
+  __m128i y[2];
+  int32_t i;
+
+  if (len <= 0) {
+    return;
+  }
+  BankLoad(&bank, state, 2);
+
+  BankPush0(&bank, _mm_set1_epi32(in[0]), 2);
+  if (len >= 2) {
+    BankPush1(&bank, _mm_set1_epi32(in[1]), 2);
+  }
+  for (i = 2; i < len; i++) {
+    y[0] = BankPush(&bank, _mm_set1_epi32(in[i]), 2);
+    StoreUpBy2Short(y[0], &out[(i - 2) << 1]);
+  }
+  BankFlush(&bank, len, y, 2);
+  if (len >= 2) {
+    StoreUpBy2Short(y[0], &out[(len - 2) << 1]);
+  }
+  StoreUpBy2Short(y[1], &out[(len - 1) << 1]);
+
+  BankStore(&bank, state, 2);
+}
+
+// The lowpass filters run four filters. The first one works on the odd input
+// samples delayed by one and the second one on the even input samples; they
+// give the even output samples. The third one works on the even and the
+// fourth one on the odd input samples; they give the odd output samples.
+// With kFilterLane, the inputs are in lanes 0 to 3 in that order of the
+// input samples, and AddHalves() leaves the even output in lane 0 and the
+// odd output in lane 1.
+static __inline void StoreLPBy2(__m128i y, int32_t* out) {
+  _mm_storel_epi64((__m128i*)out, _mm_srai_epi32(AddHalves(y), 15));
+}
+
+void WebRtcSpl_LPBy2ShortToIntSSE2(const int16_t* in,
+                                   int32_t len,
+                                   int32_t* out,
+                                   int32_t* state) {
+  AllpassBank bank;
+  __m128i y[2];
+  int32_t i;
+
+  len >>= 1;
+  if (len <= 0) {
+    return;
+  }
+  // The delayed filter starts from the odd sample kept in state[12], which
+  // the fourth filter overwrites.
+  y[0] = _mm_setr_epi32(state[12], ScaleUpScalar(in[0]), ScaleUpScalar(in[0]),
+                        ScaleUpScalar(in[1]));
+  BankLoad(&bank, state, 4);
+
+  BankPush0(&bank, y[0], 4);
+  if (len >= 2) {
+    BankPush1(&bank, ScaleUp(_mm_shufflelo_epi16(
+                         _mm_loadl_epi64((const __m128i*)&in[0]),
+                         _MM_SHUFFLE(3, 2, 2, 1))), 4);
+  }
+  for (i = 2; i < len; i++) {
+    // in[2 * i - 1], in[2 * i] twice and in[2 * i + 1].
+    y[0] = ScaleUp(_mm_shufflelo_epi16(
+        _mm_loadl_epi64((const __m128i*)&in[(i - 1) << 1]),
+        _MM_SHUFFLE(3, 2, 2, 1)));
+    StoreLPBy2(BankPush(&bank, y[0], 4), &out[(i - 2) << 1]);
+  }
+  BankFlush(&bank, len, y, 4);
+  if (len >= 2) {
+    StoreLPBy2(y[0], &out[(len - 2) << 1]);
+  }
+  StoreLPBy2(y[1], &out[(len - 1) << 1]);
+
+  BankStore(&bank, state, 4);
+}
+
+void WebRtcSpl_LPBy2IntToIntSSE2(const int32_t* in,
+                                 int32_t len,
+                                 int32_t* out,
+                                 int32_t* state) {
+  AllpassBank bank;
+  __m128i y[2];
+  int32_t i;
+
+  len >>= 1;
+  if (len <= 0) {
+    return;
+  }
+  y[0] = _mm_setr_epi32(state[12], in[0], in[0], in[1]);
+  BankLoad(&bank, state, 4);
+
+  BankPush0(&bank, y[0], 4);
+  if (len >= 2) {
+    BankPush1(&bank, _mm_setr_epi32(in[1], in[2], in[2], in[3]), 4);
+  }
+  for (i = 2; i < len; i++) {
+    y[0] = _mm_shuffle_epi32(
+        _mm_loadu_si128((const __m128i*)&in[(i - 1) << 1]),
+        _MM_SHUFFLE(3, 2, 2, 1));
+    StoreLPBy2(BankPush(&bank, y[0], 4), &out[(i - 2) << 1]);
+  }
+  BankFlush(&bank, len, y, 4);
+  if (len >= 2) {
+    StoreLPBy2(y[0], &out[(len - 2) << 1]);
+  }
+  StoreLPBy2(y[1], &out[(len - 1) << 1]);
+
+  BankStore(&bank, state, 4);
+}
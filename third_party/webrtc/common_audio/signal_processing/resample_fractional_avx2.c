@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file contains the AVX2 versions of WebRtcSpl_Resample48khzTo32khz()
+ * and WebRtcSpl_Resample32khzTo24khz(). They split the inputs as the SSE2
+ * versions do and compute two filters per 256-bit vector, one in each
+ * 128-bit lane. The results are bit exact with the C versions.
+ */
+
+#include <immintrin.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// The coefficients of resample_fractional.c.
+static const int16_t kCoefficients48To32[2][8] = {
+    {778, -2050, 1087, 23285, 12903, -3783, 441, 222},
+    {222, 441, -3783, 12903, 23285, 1087, -2050, 778}};
+
+static const int16_t kCoefficients32To24[3][8] = {
+    {767, -2362, 2434, 24406, 10620, -3838, 721, 90},
+    {386, -381, -2646, 19062, 19062, -2646, -381, 386},
+    {90, 721, -3838, 10620, 24406, 2434, -2362, 767}};
+
+// Number of blocks split at a time.
+enum { kChunkBlocks = 32 };
+
+static void SplitW32(const int32_t* in, size_t len, int16_t* lo, int16_t* hi) {
+  const __m256i kHalf = _mm256_set1_epi32(1 << 15);
+  size_t i;
+  for (i = 0; i + 16 <= len; i += 16) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)&in[i]);
+    __m256i b = _mm256_loadu_si256((const __m256i*)&in[i + 8]);
+    // _mm256_packs_epi32() packs within the 128-bit lanes.
+    _mm256_storeu_si256(
+        (__m256i*)&lo[i],
+        _mm256_permute4x64_epi64(
+            _mm256_packs_epi32(
+                _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16),
+                _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16)),
+            _MM_SHUFFLE(3, 1, 2, 0)));
+    _mm256_storeu_si256(
+        (__m256i*)&hi[i],
+        _mm256_permute4x64_epi64(
+            _mm256_packs_epi32(
+                _mm256_srai_epi32(_mm256_add_epi32(a, kHalf), 16),
+                _mm256_srai_epi32(_mm256_add_epi32(b, kHalf), 16)),
+            _MM_SHUFFLE(3, 1, 2, 0)));
+  }
+  for (; i < len; i++) {
+    lo[i] = (int16_t)in[i];
+    hi[i] = (int16_t)(((uint32_t)in[i] + (1 << 15)) >> 16);
+  }
+}
+
+static __inline __m256i LoadTwo(const int16_t* a, const int16_t* b) {
+  return _mm256_inserti128_si256(
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)a)),
+      _mm_loadu_si128((const __m128i*)b), 1);
+}
+
+// The partial sums of the 8-tap filters at |offset_a| in the low lane and at
+// |offset_b| in the high lane.
+static __inline __m256i Dot8x2(const int16_t* lo,
+                               const int16_t* hi,
+                               size_t offset_a,
+                               size_t offset_b,
+                               __m256i coefficients) {
+  __m256i sum_lo = _mm256_madd_epi16(
+      LoadTwo(&lo[offset_a], &lo[offset_b]), coefficients);
+  __m256i sum_hi = _mm256_madd_epi16(
+      LoadTwo(&hi[offset_a], &hi[offset_b]), coefficients);
+  return _mm256_add_epi32(sum_lo, _mm256_slli_epi32(sum_hi, 16));
+}
+
+// The sums of the low lanes of |a| to |d| followed by the sums of their high
+// lanes, plus the rounding offset of the C code.
+static __inline __m256i Sum8(__m256i a, __m256i b, __m256i c, __m256i d) {
+  __m256i ab = _mm256_add_epi32(_mm256_unpacklo_epi32(a, b),
+                                _mm256_unpackhi_epi32(a, b));
+  __m256i cd = _mm256_add_epi32(_mm256_unpacklo_epi32(c, d),
+                                _mm256_unpackhi_epi32(c, d));
+  return _mm256_add_epi32(_mm256_add_epi32(_mm256_unpacklo_epi64(ab, cd),
+                                           _mm256_unpackhi_epi64(ab, cd)),
+                          _mm256_set1_epi32(1 << 14));
+}
+
+static __inline __m256i LoadCoefficients(const int16_t* a, const int16_t* b) {
+  return LoadTwo(a, b);
+}
+
+void WebRtcSpl_Resample48khzTo32khzAVX2(const int32_t* In,
+                                        int32_t* Out,
+                                        size_t K) {
+  const __m256i c0 =
+      LoadCoefficients(kCoefficients48To32[0], kCoefficients48To32[0]);
+  const __m256i c1 =
+      LoadCoefficients(kCoefficients48To32[1], kCoefficients48To32[1]);
+  int16_t lo[3 * kChunkBlocks + 6];
+  int16_t hi[3 * kChunkBlocks + 6];
+  size_t blocks = K & ~(size_t)3;
+  size_t n, m;
+
+  // Four blocks give eight outputs.
+  for (; blocks > 0; blocks -= n) {
+    n = blocks < kChunkBlocks ? blocks : kChunkBlocks;
+    SplitW32(In, 3 * n + 6, lo, hi);
+    for (m = 0; m < n; m += 4) {
+      size_t i = 3 * m;
+      _mm256_storeu_si256((__m256i*)&Out[2 * m],
+                          Sum8(Dot8x2(lo, hi, i, i + 6, c0),
+                               Dot8x2(lo, hi, i + 1, i + 7, c1),
+                               Dot8x2(lo, hi, i + 3, i + 9, c0),
+                               Dot8x2(lo, hi, i + 4, i + 10, c1)));
+    }
+    In += 3 * n;
+    Out += 2 * n;
+  }
+  if ((K & 3) != 0) {
+    WebRtcSpl_Resample48khzTo32khzSSE2(In, Out, K & 3);
+  }
+}
+
+void WebRtcSpl_Resample32khzTo24khzAVX2(const int32_t* In,
+                                        int32_t* Out,
+                                        size_t K) {
+  // The outputs in a group of 24 cycle through the three filters; the low
+  // and high lanes of a vector are four outputs apart.
+  const __m256i c01 =
+      LoadCoefficients(kCoefficients32To24[0], kCoefficients32To24[1]);
+  const __m256i c12 =
+      LoadCoefficients(kCoefficients32To24[1], kCoefficients32To24[2]);
+  const __m256i c20 =
+      LoadCoefficients(kCoefficients32To24[2], kCoefficients32To24[0]);
+  int16_t lo[4 * kChunkBlocks + 6];
+  int16_t hi[4 * kChunkBlocks + 6];
+  size_t blocks = K & ~(size_t)7;
+  size_t n, m;
+
+  // Eight blocks give 24 outputs.
+  for (; blocks > 0; blocks -= n) {
+    n = blocks < kChunkBlocks ? blocks : kChunkBlocks;
+    SplitW32(In, 4 * n + 6, lo, hi);
+    for (m = 0; m < n; m += 8) {
+      size_t i = 4 * m;
+      _mm256_storeu_si256((__m256i*)&Out[3 * m],
+                          Sum8(Dot8x2(lo, hi, i, i + 5, c01),
+                               Dot8x2(lo, hi, i + 1, i + 6, c12),
+                               Dot8x2(lo, hi, i + 2, i + 8, c20),
+                               Dot8x2(lo, hi, i + 4, i + 9, c01)));
+      _mm256_storeu_si256((__m256i*)&Out[3 * m + 8],
+                          Sum8(Dot8x2(lo, hi, i + 10, i + 16, c20),
+                               Dot8x2(lo, hi, i + 12, i + 17, c01),
+                               Dot8x2(lo, hi, i + 13, i + 18, c12),
+                               Dot8x2(lo, hi, i + 14, i + 20, c20)));
+      _mm256_storeu_si256((__m256i*)&Out[3 * m + 16],
+                          Sum8(Dot8x2(lo, hi, i + 21, i + 26, c12),
+                               Dot8x2(lo, hi, i + 22, i + 28, c20),
+                               Dot8x2(lo, hi, i + 24, i + 29, c01),
+                               Dot8x2(lo, hi, i + 25, i + 30, c12)));
+    }
+    In += 4 * n;
+    Out += 3 * n;
+  }
+  if ((K & 7) != 0) {
+    WebRtcSpl_Resample32khzTo24khzSSE2(In, Out, K & 7);
+  }
+}
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file contains the SSE2 versions of WebRtcSpl_Resample48khzTo32khz()
+ * and WebRtcSpl_Resample32khzTo24khz(). The results are bit exact with the C
+ * versions in resample_fractional.c.
+ *
+ * The inputs are 32-bit and the C code keeps the low 32 bits of the sums of
+ * products. The functions split every input into its low 16 bits, as a
+ * signed value, and the rest, in[i] == (hi[i] << 16) + lo[i] modulo 2^32,
+ * and sum the coefficients times both halves with _mm_madd_epi16(). The sums
+ * combine into (sum_hi << 16) + sum_lo, which equals the C sum modulo 2^32.
+ * The inputs are split in chunks before any output of the chunk is written,
+ * so the output may overlap the input the same way the C code allows.
+ */
+
+#include <emmintrin.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// The coefficients of resample_fractional.c.
+static const int16_t kCoefficients48To32[2][8] = {
+    {778, -2050, 1087, 23285, 12903, -3783, 441, 222},
+    {222, 441, -3783, 12903, 23285, 1087, -2050, 778}};
+
+static const int16_t kCoefficients32To24[3][8] = {
+    {767, -2362, 2434, 24406, 10620, -3838, 721, 90},
+    {386, -381, -2646, 19062, 19062, -2646, -381, 386},
+    {90, 721, -3838, 10620, 24406, 2434, -2362, 767}};
+
+// Number of blocks split at a time.
+enum { kChunkBlocks = 32 };
+
+static void SplitW32(const int32_t* in, size_t len, int16_t* lo, int16_t* hi) {
+  const __m128i kHalf = _mm_set1_epi32(1 << 15);
+  size_t i;
+  for (i = 0; i + 8 <= len; i += 8) {
+    __m128i a = _mm_loadu_si128((const __m128i*)&in[i]);
+    __m128i b = _mm_loadu_si128((const __m128i*)&in[i + 4]);
+    _mm_storeu_si128(
+        (__m128i*)&lo[i],
+        _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+                        _mm_srai_epi32(_mm_slli_epi32(b, 16), 16)));
+    _mm_storeu_si128(
+        (__m128i*)&hi[i],
+        _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(a, kHalf), 16),
+                        _mm_srai_epi32(_mm_add_epi32(b, kHalf), 16)));
+  }
+  for (; i < len; i++) {
+    lo[i] = (int16_t)in[i];
+    hi[i] = (int16_t)(((uint32_t)in[i] + (1 << 15)) >> 16);
+  }
+}
+
+// The four partial sums of an 8-tap filter on the split inputs at |offset|.
+static __inline __m128i Dot8(const int16_t* lo,
+                             const int16_t* hi,
+                             size_t offset,
+                             __m128i coefficients) {
+  __m128i sum_lo = _mm_madd_epi16(
+      _mm_loadu_si128((const __m128i*)&lo[offset]), coefficients);
+  __m128i sum_hi = _mm_madd_epi16(
+      _mm_loadu_si128((const __m128i*)&hi[offset]), coefficients);
+  return _mm_add_epi32(sum_lo, _mm_slli_epi32(sum_hi, 16));
+}
+
+// The sums of the lanes of |a|, |b|, |c| and |d|, plus the rounding offset of
+// the C code.
+static __inline __m128i Sum4(__m128i a, __m128i b, __m128i c, __m128i d) {
+  __m128i ab = _mm_add_epi32(_mm_unpacklo_epi32(a, b),
+                             _mm_unpackhi_epi32(a, b));
+  __m128i cd = _mm_add_epi32(_mm_unpacklo_epi32(c, d),
+                             _mm_unpackhi_epi32(c, d));
+  return _mm_add_epi32(
+      _mm_add_epi32(_mm_unpacklo_epi64(ab, cd), _mm_unpackhi_epi64(ab, cd)),
+      _mm_set1_epi32(1 << 14));
+}
+
+void WebRtcSpl_Resample48khzTo32khzSSE2(const int32_t* In,
+                                        int32_t* Out,
+                                        size_t K) {
+  const __m128i c0 = _mm_loadu_si128((const __m128i*)kCoefficients48To32[0]);
+  const __m128i c1 = _mm_loadu_si128((const __m128i*)kCoefficients48To32[1]);
+  const __m128i zero = _mm_setzero_si128();
+  int16_t lo[3 * kChunkBlocks + 6];
+  int16_t hi[3 * kChunkBlocks + 6];
+  size_t n, m;
+
+  for (; K > 0; K -= n) {
+    n = K < kChunkBlocks ? K : kChunkBlocks;
+    // Block m reads In[3 * m] to In[3 * m + 8].
+    SplitW32(In, 3 * n + 6, lo, hi);
+    for (m = 0; m + 2 <= n; m += 2) {
+      _mm_storeu_si128((__m128i*)&Out[2 * m],
+                       Sum4(Dot8(lo, hi, 3 * m, c0),
+                            Dot8(lo, hi, 3 * m + 1, c1),
+                            Dot8(lo, hi, 3 * m + 3, c0),
+                            Dot8(lo, hi, 3 * m + 4, c1)));
+    }
+    if (m < n) {
+      _mm_storel_epi64((__m128i*)&Out[2 * m],
+                       Sum4(Dot8(lo, hi, 3 * m, c0),
+                            Dot8(lo, hi, 3 * m + 1, c1), zero, zero));
+    }
+    In += 3 * n;
+    Out += 2 * n;
+  }
+}
+
+void WebRtcSpl_Resample32khzTo24khzSSE2(const int32_t* In,
+                                        int32_t* Out,
+                                        size_t K) {
+  const __m128i c0 = _mm_loadu_si128((const __m128i*)kCoefficients32To24[0]);
+  const __m128i c1 = _mm_loadu_si128((const __m128i*)kCoefficients32To24[1]);
+  const __m128i c2 = _mm_loadu_si128((const __m128i*)kCoefficients32To24[2]);
+  const __m128i zero = _mm_setzero_si128();
+  int16_t lo[4 * kChunkBlocks + 6];
+  int16_t hi[4 * kChunkBlocks + 6];
+  size_t n, m;
+
+  for (; K > 0; K -= n) {
+    n = K < kChunkBlocks ? K : kChunkBlocks;
+    // Block m reads In[4 * m] to In[4 * m + 9].
+    SplitW32(In, 4 * n + 6, lo, hi);
+    // Four blocks give twelve outputs.
+    for (m = 0; m + 4 <= n; m += 4) {
+      size_t i = 4 * m;
+      _mm_storeu_si128((__m128i*)&Out[3 * m],
+                       Sum4(Dot8(lo, hi, i, c0), Dot8(lo, hi, i + 1, c1),
+                            Dot8(lo, hi, i + 2, c2), Dot8(lo, hi, i + 4, c0)));
+      _mm_storeu_si128((__m128i*)&Out[3 * m + 4],
+                       Sum4(Dot8(lo, hi, i + 5, c1), Dot8(lo, hi, i + 6, c2),
+                            Dot8(lo, hi, i + 8, c0), Dot8(lo, hi, i + 9, c1)));
+      _mm_storeu_si128(
+          (__m128i*)&Out[3 * m + 8],
+          Sum4(Dot8(lo, hi, i + 10, c2), Dot8(lo, hi, i + 12, c0),
+               Dot8(lo, hi, i + 13, c1), Dot8(lo, hi, i + 14, c2)));
+    }
+    for (; m < n; m++) {
+      __m128i out = Sum4(Dot8(lo, hi, 4 * m, c0), Dot8(lo, hi, 4 * m + 1, c1),
+                         Dot8(lo, hi, 4 * m + 2, c2), zero);
+      _mm_storel_epi64((__m128i*)&Out[3 * m], out);
+      Out[3 * m + 2] = _mm_cvtsi128_si32(_mm_srli_si128(out, 8));
+    }
+    In += 4 * n;
+    Out += 3 * n;
+  }
+}
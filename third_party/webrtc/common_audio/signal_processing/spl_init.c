@@ -9,12 +9,13 @@
  */
 
 /* The global function contained in this file initializes SPL function
- * pointers, currently only for ARM platforms.
+ * pointers for ARM, MIPS and x86 platforms.
  *
  * Some code came from common/rtcd.c in the WebM project.
  */
 
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "common_audio/signal_processing/resample_by_2_internal.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
 
 /* Declare function pointers. */
@@ -27,6 +28,20 @@ MinValueW32 WebRtcSpl_MinValueW32;
 CrossCorrelation WebRtcSpl_CrossCorrelation;
 DownsampleFast WebRtcSpl_DownsampleFast;
 ScaleAndAddVectorsWithRound WebRtcSpl_ScaleAndAddVectorsWithRound;
+/* The resamplers predate WebRtcSpl_Init() and their callers (Resampler,
+ * PushResampler) never call it, so these start out at the C versions and
+ * WebRtcSpl_Init() only upgrades them. */
+Resample48khzTo32khz WebRtcSpl_Resample48khzTo32khz =
+    WebRtcSpl_Resample48khzTo32khzC;
+Resample32khzTo24khz WebRtcSpl_Resample32khzTo24khz =
+    WebRtcSpl_Resample32khzTo24khzC;
+DownBy2IntToShort WebRtcSpl_DownBy2IntToShort = WebRtcSpl_DownBy2IntToShortC;
+DownBy2ShortToInt WebRtcSpl_DownBy2ShortToInt = WebRtcSpl_DownBy2ShortToIntC;
+UpBy2ShortToInt WebRtcSpl_UpBy2ShortToInt = WebRtcSpl_UpBy2ShortToIntC;
+UpBy2IntToInt WebRtcSpl_UpBy2IntToInt = WebRtcSpl_UpBy2IntToIntC;
+UpBy2IntToShort WebRtcSpl_UpBy2IntToShort = WebRtcSpl_UpBy2IntToShortC;
+LPBy2ShortToInt WebRtcSpl_LPBy2ShortToInt = WebRtcSpl_LPBy2ShortToIntC;
+LPBy2IntToInt WebRtcSpl_LPBy2IntToInt = WebRtcSpl_LPBy2IntToIntC;
 
 #if (!defined(WEBRTC_HAS_NEON)) && !defined(MIPS32_LE)
 /* Initialize function pointers to the generic C version. */
@@ -41,6 +56,15 @@ static void InitPointersToC(void) {
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastC;
   WebRtcSpl_ScaleAndAddVectorsWithRound =
       WebRtcSpl_ScaleAndAddVectorsWithRoundC;
+  WebRtcSpl_Resample48khzTo32khz = WebRtcSpl_Resample48khzTo32khzC;
+  WebRtcSpl_Resample32khzTo24khz = WebRtcSpl_Resample32khzTo24khzC;
+  WebRtcSpl_DownBy2IntToShort = WebRtcSpl_DownBy2IntToShortC;
+  WebRtcSpl_DownBy2ShortToInt = WebRtcSpl_DownBy2ShortToIntC;
+  WebRtcSpl_UpBy2ShortToInt = WebRtcSpl_UpBy2ShortToIntC;
+  WebRtcSpl_UpBy2IntToInt = WebRtcSpl_UpBy2IntToIntC;
+  WebRtcSpl_UpBy2IntToShort = WebRtcSpl_UpBy2IntToShortC;
+  WebRtcSpl_LPBy2ShortToInt = WebRtcSpl_LPBy2ShortToIntC;
+  WebRtcSpl_LPBy2IntToInt = WebRtcSpl_LPBy2IntToIntC;
 }
 #endif
 
@@ -57,6 +81,63 @@ static void InitPointersToNeon(void) {
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastNeon;
   WebRtcSpl_ScaleAndAddVectorsWithRound =
       WebRtcSpl_ScaleAndAddVectorsWithRoundC;
+  WebRtcSpl_Resample48khzTo32khz = WebRtcSpl_Resample48khzTo32khzC;
+  WebRtcSpl_Resample32khzTo24khz = WebRtcSpl_Resample32khzTo24khzC;
+  WebRtcSpl_DownBy2IntToShort = WebRtcSpl_DownBy2IntToShortC;
+  WebRtcSpl_DownBy2ShortToInt = WebRtcSpl_DownBy2ShortToIntC;
+  WebRtcSpl_UpBy2ShortToInt = WebRtcSpl_UpBy2ShortToIntC;
+  WebRtcSpl_UpBy2IntToInt = WebRtcSpl_UpBy2IntToIntC;
+  WebRtcSpl_UpBy2IntToShort = WebRtcSpl_UpBy2IntToShortC;
+  WebRtcSpl_LPBy2ShortToInt = WebRtcSpl_LPBy2ShortToIntC;
+  WebRtcSpl_LPBy2IntToInt = WebRtcSpl_LPBy2IntToIntC;
+}
+#endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+/* Initialize function pointers to the SSE2 version. */
+static void InitPointersToSSE2(void) {
+  WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16SSE2;
+  WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32SSE2;
+  WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16SSE2;
+  WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32SSE2;
+  WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16SSE2;
+  WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32SSE2;
+  WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSSE2;
+  WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastSSE2;
+  WebRtcSpl_ScaleAndAddVectorsWithRound =
+      WebRtcSpl_ScaleAndAddVectorsWithRoundSSE2;
+  WebRtcSpl_Resample48khzTo32khz = WebRtcSpl_Resample48khzTo32khzSSE2;
+  WebRtcSpl_Resample32khzTo24khz = WebRtcSpl_Resample32khzTo24khzSSE2;
+  WebRtcSpl_DownBy2IntToShort = WebRtcSpl_DownBy2IntToShortSSE2;
+  WebRtcSpl_DownBy2ShortToInt = WebRtcSpl_DownBy2ShortToIntSSE2;
+  WebRtcSpl_UpBy2ShortToInt = WebRtcSpl_UpBy2ShortToIntSSE2;
+  WebRtcSpl_UpBy2IntToInt = WebRtcSpl_UpBy2IntToIntSSE2;
+  WebRtcSpl_UpBy2IntToShort = WebRtcSpl_UpBy2IntToShortSSE2;
+  WebRtcSpl_LPBy2ShortToInt = WebRtcSpl_LPBy2ShortToIntSSE2;
+  WebRtcSpl_LPBy2IntToInt = WebRtcSpl_LPBy2IntToIntSSE2;
+}
+
+/* Initialize function pointers to the AVX2 version. */
+static void InitPointersToAVX2(void) {
+  WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16AVX2;
+  WebRtcSpl_MaxAbsValueW32 = WebRtcSpl_MaxAbsValueW32AVX2;
+  WebRtcSpl_MaxValueW16 = WebRtcSpl_MaxValueW16AVX2;
+  WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32AVX2;
+  WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16AVX2;
+  WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32AVX2;
+  WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationAVX2;
+  WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastAVX2;
+  WebRtcSpl_ScaleAndAddVectorsWithRound =
+      WebRtcSpl_ScaleAndAddVectorsWithRoundAVX2;
+  WebRtcSpl_Resample48khzTo32khz = WebRtcSpl_Resample48khzTo32khzAVX2;
+  WebRtcSpl_Resample32khzTo24khz = WebRtcSpl_Resample32khzTo24khzAVX2;
+  WebRtcSpl_DownBy2IntToShort = WebRtcSpl_DownBy2IntToShortSSE2;
+  WebRtcSpl_DownBy2ShortToInt = WebRtcSpl_DownBy2ShortToIntSSE2;
+  WebRtcSpl_UpBy2ShortToInt = WebRtcSpl_UpBy2ShortToIntSSE2;
+  WebRtcSpl_UpBy2IntToInt = WebRtcSpl_UpBy2IntToIntSSE2;
+  WebRtcSpl_UpBy2IntToShort = WebRtcSpl_UpBy2IntToShortSSE2;
+  WebRtcSpl_LPBy2ShortToInt = WebRtcSpl_LPBy2ShortToIntSSE2;
+  WebRtcSpl_LPBy2IntToInt = WebRtcSpl_LPBy2IntToIntSSE2;
 }
 #endif
 
@@ -79,6 +160,15 @@ static void InitPointersToMIPS(void) {
   WebRtcSpl_ScaleAndAddVectorsWithRound =
       WebRtcSpl_ScaleAndAddVectorsWithRoundC;
 #endif
+  WebRtcSpl_Resample48khzTo32khz = WebRtcSpl_Resample48khzTo32khzC;
+  WebRtcSpl_Resample32khzTo24khz = WebRtcSpl_Resample32khzTo24khzC;
+  WebRtcSpl_DownBy2IntToShort = WebRtcSpl_DownBy2IntToShortC;
+  WebRtcSpl_DownBy2ShortToInt = WebRtcSpl_DownBy2ShortToIntC;
+  WebRtcSpl_UpBy2ShortToInt = WebRtcSpl_UpBy2ShortToIntC;
+  WebRtcSpl_UpBy2IntToInt = WebRtcSpl_UpBy2IntToIntC;
+  WebRtcSpl_UpBy2IntToShort = WebRtcSpl_UpBy2IntToShortC;
+  WebRtcSpl_LPBy2ShortToInt = WebRtcSpl_LPBy2ShortToIntC;
+  WebRtcSpl_LPBy2IntToInt = WebRtcSpl_LPBy2IntToIntC;
 }
 #endif
 
@@ -87,6 +177,14 @@ static void InitFunctionPointers(void) {
   InitPointersToNeon();
 #elif defined(MIPS32_LE)
   InitPointersToMIPS();
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    InitPointersToAVX2();
+  } else if (WebRtc_GetCPUInfo(kSSE2)) {
+    InitPointersToSSE2();
+  } else {
+    InitPointersToC();
+  }
 #else
   InitPointersToC();
 #endif  /* WEBRTC_HAS_NEON */
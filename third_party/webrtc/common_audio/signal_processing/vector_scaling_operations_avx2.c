@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file must be compiled with AVX2 enabled (-mavx2); it is only called
+// after WebRtc_GetCPUInfo(kAVX2) succeeded.
+
+#include <immintrin.h>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+// Keeps the low 16 bits of each 32-bit lane, like the (int16_t) cast of the
+// C version; packs_epi32 alone would saturate.
+static inline __m256i TruncateToW16(__m256i lo, __m256i hi) {
+  lo = _mm256_srai_epi32(_mm256_slli_epi32(lo, 16), 16);
+  hi = _mm256_srai_epi32(_mm256_slli_epi32(hi, 16), 16);
+  return _mm256_packs_epi32(lo, hi);
+}
+
+// AVX2 version of WebRtcSpl_ScaleAndAddVectorsWithRound() for x86 platforms.
+// The unpacks and the pack both work per 128-bit lane, so the samples come
+// out in their original order.
+int WebRtcSpl_ScaleAndAddVectorsWithRoundAVX2(const int16_t* in_vector1,
+                                              int16_t in_vector1_scale,
+                                              const int16_t* in_vector2,
+                                              int16_t in_vector2_scale,
+                                              int right_shifts,
+                                              int16_t* out_vector,
+                                              size_t length) {
+  size_t i = 0;
+  int round_value = (1 << right_shifts) >> 1;
+  __m256i scales;
+  __m256i round;
+  __m128i shift;
+
+  if (in_vector1 == NULL || in_vector2 == NULL || out_vector == NULL ||
+      length == 0 || right_shifts < 0) {
+    return -1;
+  }
+
+  scales = _mm256_set1_epi32(
+      (int32_t)(((uint32_t)(uint16_t)in_vector2_scale << 16) |
+                (uint16_t)in_vector1_scale));
+  round = _mm256_set1_epi32(round_value);
+  shift = _mm_cvtsi32_si128(right_shifts);
+  for (; i + 16 <= length; i += 16) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)&in_vector1[i]);
+    __m256i b = _mm256_loadu_si256((const __m256i*)&in_vector2[i]);
+    __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), scales);
+    __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), scales);
+    lo = _mm256_sra_epi32(_mm256_add_epi32(lo, round), shift);
+    hi = _mm256_sra_epi32(_mm256_add_epi32(hi, round), shift);
+    _mm256_storeu_si256((__m256i*)&out_vector[i], TruncateToW16(lo, hi));
+  }
+
+  for (; i < length; i++) {
+    out_vector[i] = (int16_t)((
+        in_vector1[i] * in_vector1_scale + in_vector2[i] * in_vector2_scale +
+        round_value) >> right_shifts);
+  }
+
+  return 0;
+}
@@ -71,6 +71,37 @@ int WebRtcVad_Process(VadInst* handle,
                       const int16_t* audio_frame,
                       size_t frame_length);
 
+// Calculates VAD decisions for |num_channels| channels at once, e.g., the
+// decoded audio of every stream in a call. All frames share |fs| and
+// |frame_length|. The decision for |audio_frames[i]| is written to
+// |vad_decisions[i]| and is the same as
+// WebRtcVad_Process(handles[i], fs, audio_frames[i], frame_length) would have
+// returned; the instances are updated the same way too. The filter bank and
+// energy calculations run on several channels in parallel where the CPU
+// allows it.
+//
+// - handles       [i/o] : |num_channels| distinct VAD instances. Each needs to
+//                         be initialized by WebRtcVad_Init() before the call.
+// - num_channels  [i]   : Number of channels.
+// - fs            [i]   : Sampling frequency (Hz): 8000, 16000, 32000 or
+//                         48000
+// - audio_frames  [i]   : One audio frame buffer per channel.
+// - frame_length  [i]   : Length of each audio frame buffer in number of
+//                         samples.
+// - vad_decisions [o]   : 1 - (Active Voice), 0 - (Non-active Voice) per
+//                         channel.
+//
+// returns               : 0 - (OK),
+//                        -1 - (null pointer, an instance not initialized or
+//                              invalid rate or frame length; no channel is
+//                              processed).
+int WebRtcVad_ProcessBatch(VadInst* const* handles,
+                           size_t num_channels,
+                           int fs,
+                           const int16_t* const* audio_frames,
+                           size_t frame_length,
+                           int* vad_decisions);
+
 // Checks for valid combinations of |rate| and |frame_length|. We support 10,
 // 20 and 30 ms frames and the rates 8000, 16000 and 32000 Hz.
 //
@@ -15,6 +15,7 @@
 #include "common_audio/vad/vad_filterbank.h"
 #include "common_audio/vad/vad_gmm.h"
 #include "common_audio/vad/vad_sp.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 
 // Spectrum Weighting
 static const int16_t kSpectrumWeight[kNumChannels] = { 6, 8, 10, 12, 14, 16 };
@@ -65,6 +66,10 @@ static const int16_t kMinStd = 384;
 static const short kDefaultMode = 0;
 static const int kInitCheck = 42;
 
+// Number of instances per WebRtcVad_CalculateFeaturesBatch() call in
+// WebRtcVad_CalcVadBatch().
+enum { kBatchSize = 16 };
+
 // Constants used in WebRtcVad_set_mode_core().
 //
 // Thresholds for different frame lengths (10 ms, 20 ms and 30 ms).
@@ -534,6 +539,16 @@ int WebRtcVad_InitCore(VadInstT* self) {
     self->mean_value[i] = 1600;
   }
 
+  // Select the batch feature extraction for this CPU.
+  WebRtcVad_CalculateFeaturesBatch = WebRtcVad_CalculateFeaturesBatchC;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    WebRtcVad_CalculateFeaturesBatch = WebRtcVad_CalculateFeaturesBatchAVX2;
+  } else if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcVad_CalculateFeaturesBatch = WebRtcVad_CalculateFeaturesBatchSSE2;
+  }
+#endif
+
   // Set aggressiveness mode to default (=|kDefaultMode|).
   if (WebRtcVad_set_mode_core(self, kDefaultMode) != 0) {
     return -1;
@@ -604,11 +619,11 @@ int WebRtcVad_set_mode_core(VadInstT* self, int mode) {
 // Calculate VAD decision by first extracting feature values and then calculate
 // probability for both speech and background noise.
 
-int WebRtcVad_CalcVad48khz(VadInstT* inst, const int16_t* speech_frame,
-                           size_t frame_length) {
-  int vad;
+// Resamples |speech_frame| from 48 kHz to 8 kHz into |speech_nb|, which has
+// room for |frame_length| / 6 samples.
+static void Resample48khzTo8khz(VadInstT* inst, const int16_t* speech_frame,
+                                size_t frame_length, int16_t* speech_nb) {
   size_t i;
-  int16_t speech_nb[240];  // 30 ms in 8 kHz.
   // |tmp_mem| is a temporary memory used by resample function, length is
   // frame length in 10 ms (480 samples) + 256 extra.
   int32_t tmp_mem[480 + 256] = { 0 };
@@ -622,6 +637,14 @@ int WebRtcVad_CalcVad48khz(VadInstT* inst, const int16_t* speech_frame,
                                   &inst->state_48_to_8,
                                   tmp_mem);
   }
+}
+
+int WebRtcVad_CalcVad48khz(VadInstT* inst, const int16_t* speech_frame,
+                           size_t frame_length) {
+  int vad;
+  int16_t speech_nb[240];  // 30 ms in 8 kHz.
+
+  Resample48khzTo8khz(inst, speech_frame, frame_length, speech_nb);
 
   // Do VAD on an 8 kHz signal
   vad = WebRtcVad_CalcVad8khz(inst, speech_nb, frame_length / 6);
@@ -683,3 +706,51 @@ int WebRtcVad_CalcVad8khz(VadInstT* inst, const int16_t* speech_frame,
 
     return inst->vad;
 }
+
+void WebRtcVad_CalcVadBatch(VadInstT* const* insts,
+                            size_t num_insts,
+                            int fs,
+                            const int16_t* const* speech_frames,
+                            size_t frame_length,
+                            int* vads) {
+  int16_t feature_vectors[kBatchSize * kNumChannels];
+  int16_t total_power[kBatchSize];
+  int16_t speech_nb[kBatchSize][240];  // 30 ms in 8 kHz, for 48 kHz input.
+  const int16_t* frames_nb[kBatchSize];
+  // Frame length after the downsampling to 8 kHz.
+  const size_t frame_length_nb = frame_length / (size_t)(fs / 8000);
+  size_t i, j;
+
+  for (i = 0; i < num_insts; i += kBatchSize) {
+    const size_t batch_size =
+        num_insts - i < kBatchSize ? num_insts - i : kBatchSize;
+    const int16_t* const* frames = &speech_frames[i];
+    int batch_fs = fs;
+    size_t batch_length = frame_length;
+
+    // The 48 kHz resampler stays per instance; the batch starts at 8 kHz.
+    if (fs == 48000) {
+      for (j = 0; j < batch_size; j++) {
+        Resample48khzTo8khz(insts[i + j], speech_frames[i + j], frame_length,
+                            speech_nb[j]);
+        frames_nb[j] = speech_nb[j];
+      }
+      frames = frames_nb;
+      batch_fs = 8000;
+      batch_length = frame_length_nb;
+    }
+
+    // Get power in the bands
+    WebRtcVad_CalculateFeaturesBatch(&insts[i], frames, batch_size, batch_fs,
+                                     batch_length, feature_vectors,
+                                     total_power);
+
+    // Make a VAD
+    for (j = 0; j < batch_size; j++) {
+      VadInstT* inst = insts[i + j];
+      inst->vad = GmmProbability(inst, &feature_vectors[j * kNumChannels],
+                                 total_power[j], frame_length_nb);
+      vads[i + j] = inst->vad;
+    }
+  }
+}
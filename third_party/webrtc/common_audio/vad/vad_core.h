@@ -111,4 +111,31 @@ int WebRtcVad_CalcVad8khz(VadInstT* inst,
                           const int16_t* speech_frame,
                           size_t frame_length);
 
+/****************************************************************************
+ * WebRtcVad_CalcVadBatch(...)
+ *
+ * Calculates the VAD decisions of several instances on one frame each. The
+ * results and state updates are the same as calling WebRtcVad_CalcVad*khz()
+ * on each instance, but the feature extraction runs through
+ * WebRtcVad_CalculateFeaturesBatch() on many instances at once.
+ *
+ * Input:
+ *      - insts         : |num_insts| distinct, initialized instances
+ *      - num_insts     : Number of instances
+ *      - fs            : Sampling frequency of all frames
+ *      - speech_frames : One input frame per instance
+ *      - frame_length  : Number of samples of each frame
+ *
+ * Output:
+ *      - insts         : Updated filter states etc.
+ *      - vads          : VAD decision per instance, as returned by
+ *                        WebRtcVad_CalcVad*khz()
+ */
+void WebRtcVad_CalcVadBatch(VadInstT* const* insts,
+                            size_t num_insts,
+                            int fs,
+                            const int16_t* const* speech_frames,
+                            size_t frame_length,
+                            int* vads);
+
 #endif  // COMMON_AUDIO_VAD_VAD_CORE_H_
@@ -12,6 +12,7 @@
 
 #include "rtc_base/checks.h"
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "common_audio/vad/vad_sp.h"
 
 // Constants used in LogOfEnergy().
 static const int16_t kLogConst = 24660;  // 160*log10(2) in Q9.
@@ -28,6 +29,8 @@ static const int16_t kAllPassCoefsQ15[2] = { 20972, 5571 };
 // Adjustment for division with two in SplitFilter.
 static const int16_t kOffsetVector[6] = { 368, 368, 272, 176, 176, 176 };
 
+CalculateFeaturesBatch WebRtcVad_CalculateFeaturesBatch;
+
 // High pass filtering, with a cut-off frequency at 80 Hz, if the |data_in| is
 // sampled at 500 Hz.
 //
@@ -164,6 +167,14 @@ static void LogOfEnergy(const int16_t* data_in, size_t data_length,
   energy = (uint32_t) WebRtcSpl_Energy((int16_t*) data_in, data_length,
                                        &tot_rshifts);
 
+  WebRtcVad_LogOfEnergy(energy, tot_rshifts, offset, total_energy, log_energy);
+}
+
+void WebRtcVad_LogOfEnergy(uint32_t energy,
+                           int tot_rshifts,
+                           int16_t offset,
+                           int16_t* total_energy,
+                           int16_t* log_energy) {
   if (energy != 0) {
     // By construction, normalizing to 15 bits is equivalent with 17 leading
     // zeros of an unsigned 32 bit value.
@@ -327,3 +338,41 @@ int16_t WebRtcVad_CalculateFeatures(VadInstT* self, const int16_t* data_in,
 
   return total_energy;
 }
+
+void WebRtcVad_CalculateFeaturesBatchC(VadInstT* const* insts,
+                                       const int16_t* const* data_in,
+                                       size_t num_insts,
+                                       int fs,
+                                       size_t data_length,
+                                       int16_t* features,
+                                       int16_t* total_energy) {
+  int16_t speech_wb[480];  // 30 ms in 16 kHz.
+  int16_t speech_nb[240];  // 30 ms in 8 kHz.
+  size_t i;
+
+  RTC_DCHECK(fs == 8000 || fs == 16000 || fs == 32000);
+
+  for (i = 0; i < num_insts; i++) {
+    VadInstT* self = insts[i];
+    const int16_t* in_ptr = data_in[i];
+    size_t length = data_length;
+
+    // Downsample 32->16->8 kHz with the states WebRtcVad_CalcVad32khz() and
+    // WebRtcVad_CalcVad16khz() use.
+    if (fs == 32000) {
+      WebRtcVad_Downsampling(in_ptr, speech_wb,
+                             &self->downsampling_filter_states[2], length);
+      in_ptr = speech_wb;
+      length /= 2;
+    }
+    if (fs >= 16000) {
+      WebRtcVad_Downsampling(in_ptr, speech_nb,
+                             self->downsampling_filter_states, length);
+      in_ptr = speech_nb;
+      length /= 2;
+    }
+
+    total_energy[i] = WebRtcVad_CalculateFeatures(
+        self, in_ptr, length, &features[i * kNumChannels]);
+  }
+}
@@ -16,6 +16,7 @@
 #define COMMON_AUDIO_VAD_VAD_FILTERBANK_H_
 
 #include "common_audio/vad/vad_core.h"
+#include "rtc_base/system/arch.h"
 
 // Takes |data_length| samples of |data_in| and calculates the logarithm of the
 // energy of each of the |kNumChannels| = 6 frequency bands used by the VAD:
@@ -42,4 +43,70 @@ int16_t WebRtcVad_CalculateFeatures(VadInstT* self,
                                     size_t data_length,
                                     int16_t* features);
 
+// Converts an |energy| and its |tot_rshifts| as returned by WebRtcSpl_Energy()
+// into 10 * log10(energy) in Q4 plus |offset|, and updates |total_energy| the
+// same way WebRtcVad_CalculateFeatures() does for each band.
+//
+// - energy       [i]   : Energy of a band, right shifted |tot_rshifts| times.
+// - tot_rshifts  [i]   : Number of right shifts applied to |energy|.
+// - offset       [i]   : Offset value added to |log_energy|.
+// - total_energy [i/o] : Only updated while it is <= |kMinEnergy|.
+// - log_energy   [o]   : 10 * log10("energy of the band") given in Q4.
+void WebRtcVad_LogOfEnergy(uint32_t energy,
+                           int tot_rshifts,
+                           int16_t offset,
+                           int16_t* total_energy,
+                           int16_t* log_energy);
+
+// Batch version of the feature extraction: for each of the |num_insts|
+// instances, downsamples |data_in[i]| from |fs| (8000, 16000 or 32000 Hz) to
+// 8 kHz as WebRtcVad_CalcVad16khz() and WebRtcVad_CalcVad32khz() do, and then
+// runs WebRtcVad_CalculateFeatures() on it.
+//
+// - insts        [i/o] : |num_insts| distinct VAD instances.
+// - data_in      [i]   : One audio frame per instance.
+// - num_insts    [i]   : Number of instances.
+// - fs           [i]   : Sampling frequency of |data_in|.
+// - data_length  [i]   : Length of each frame, at most 30 ms.
+// - features     [o]   : |kNumChannels| features per instance, Q4.
+// - total_energy [o]   : Total energy of each instance's frame.
+typedef void (*CalculateFeaturesBatch)(VadInstT* const* insts,
+                                       const int16_t* const* data_in,
+                                       size_t num_insts,
+                                       int fs,
+                                       size_t data_length,
+                                       int16_t* features,
+                                       int16_t* total_energy);
+extern CalculateFeaturesBatch WebRtcVad_CalculateFeaturesBatch;
+
+// Generic version, one instance after the other.
+void WebRtcVad_CalculateFeaturesBatchC(VadInstT* const* insts,
+                                       const int16_t* const* data_in,
+                                       size_t num_insts,
+                                       int fs,
+                                       size_t data_length,
+                                       int16_t* features,
+                                       int16_t* total_energy);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// The x86 versions keep one instance per 32-bit lane, four (SSE2) or eight
+// (AVX2) at a time, and run the remaining instances through the C version.
+// They are defined in vad_filterbank_sse2.c and vad_filterbank_avx2.c and
+// are bit-exact with WebRtcVad_CalculateFeaturesBatchC().
+void WebRtcVad_CalculateFeaturesBatchSSE2(VadInstT* const* insts,
+                                          const int16_t* const* data_in,
+                                          size_t num_insts,
+                                          int fs,
+                                          size_t data_length,
+                                          int16_t* features,
+                                          int16_t* total_energy);
+void WebRtcVad_CalculateFeaturesBatchAVX2(VadInstT* const* insts,
+                                          const int16_t* const* data_in,
+                                          size_t num_insts,
+                                          int fs,
+                                          size_t data_length,
+                                          int16_t* features,
+                                          int16_t* total_energy);
+#endif
+
 #endif  // COMMON_AUDIO_VAD_VAD_FILTERBANK_H_
@@ -0,0 +1,362 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// SSE2 version of WebRtcVad_CalculateFeaturesBatch(). The filters are
+// recursive in time, so instead of vectorizing over samples each 32-bit lane
+// holds one VAD instance and four instances run the downsampling, the split
+// filters, the high pass filter and the band energies together. The
+// arithmetic is the same as in vad_sp.c, vad_filterbank.c and
+// WebRtcSpl_Energy(); only the conversion of the energies to dB is scalar.
+
+#include "common_audio/vad/vad_filterbank.h"
+
+#include <emmintrin.h>
+
+#include "rtc_base/checks.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+enum { kLanes = 4 };
+
+// Coefficients of vad_filterbank.c and vad_sp.c.
+static const int16_t kHpZeroCoefs[3] = { 6631, -13262, 6631 };
+static const int16_t kHpPoleCoefs[3] = { 16384, -7756, 5620 };
+static const int16_t kAllPassCoefsQ15[2] = { 20972, 5571 };
+static const int16_t kAllPassCoefsQ13[2] = { 5243, 1392 };
+static const int16_t kOffsetVector[6] = { 368, 368, 272, 176, 176, 176 };
+
+// (int16_t) cast of each 32-bit lane.
+static inline __m128i TruncateW16(__m128i a) {
+  return _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+}
+
+// |a| * |coef| for lanes that hold int16_t values. _mm_madd_epi16() multiplies
+// the low halves and adds zero for the high halves.
+static inline __m128i MulW16(__m128i a, int16_t coef) {
+  return _mm_madd_epi16(a, _mm_set1_epi32((uint16_t)coef));
+}
+
+// Loads samples |n| to |n| + 7 of |kLanes| frames, one vector per sample.
+static void LoadTransposed(const int16_t* const* data_in, size_t n,
+                           __m128i* out) {
+  const __m128i c0 = _mm_loadu_si128((const __m128i*)&data_in[0][n]);
+  const __m128i c1 = _mm_loadu_si128((const __m128i*)&data_in[1][n]);
+  const __m128i c2 = _mm_loadu_si128((const __m128i*)&data_in[2][n]);
+  const __m128i c3 = _mm_loadu_si128((const __m128i*)&data_in[3][n]);
+  const __m128i a0 = _mm_unpacklo_epi16(c0, c1);
+  const __m128i a1 = _mm_unpackhi_epi16(c0, c1);
+  const __m128i b0 = _mm_unpacklo_epi16(c2, c3);
+  const __m128i b1 = _mm_unpackhi_epi16(c2, c3);
+  // Each of |pairs| holds two samples of all four frames.
+  __m128i pairs[4];
+  int k;
+
+  pairs[0] = _mm_unpacklo_epi32(a0, b0);
+  pairs[1] = _mm_unpackhi_epi32(a0, b0);
+  pairs[2] = _mm_unpacklo_epi32(a1, b1);
+  pairs[3] = _mm_unpackhi_epi32(a1, b1);
+  for (k = 0; k < 4; k++) {
+    out[2 * k] = _mm_srai_epi32(_mm_unpacklo_epi16(pairs[k], pairs[k]), 16);
+    out[2 * k + 1] =
+        _mm_srai_epi32(_mm_unpackhi_epi16(pairs[k], pairs[k]), 16);
+  }
+}
+
+// WebRtcVad_Downsampling() on vectors. |out| may be the same as |in|.
+static void Downsampling(const __m128i* in, __m128i* out, __m128i* state,
+                         size_t in_length) {
+  __m128i tmp32_1 = state[0];
+  __m128i tmp32_2 = state[1];
+  size_t n;
+
+  for (n = 0; n < (in_length >> 1); n++) {
+    const __m128i in_1 = in[2 * n];
+    const __m128i in_2 = in[2 * n + 1];
+    // All-pass filtering upper branch.
+    const __m128i tmp16_1 = TruncateW16(_mm_add_epi32(
+        _mm_srai_epi32(tmp32_1, 1),
+        _mm_srai_epi32(MulW16(in_1, kAllPassCoefsQ13[0]), 14)));
+    // All-pass filtering lower branch.
+    const __m128i tmp16_2 = TruncateW16(_mm_add_epi32(
+        _mm_srai_epi32(tmp32_2, 1),
+        _mm_srai_epi32(MulW16(in_2, kAllPassCoefsQ13[1]), 14)));
+    tmp32_1 = _mm_sub_epi32(
+        in_1, _mm_srai_epi32(MulW16(tmp16_1, kAllPassCoefsQ13[0]), 12));
+    tmp32_2 = _mm_sub_epi32(
+        in_2, _mm_srai_epi32(MulW16(tmp16_2, kAllPassCoefsQ13[1]), 12));
+    out[n] = TruncateW16(_mm_add_epi32(tmp16_1, tmp16_2));
+  }
+  state[0] = tmp32_1;
+  state[1] = tmp32_2;
+}
+
+// Downsamples |data_length| samples of |kLanes| frames by two, or by four if
+// |state2| is given, eight input samples at a time.
+static void DownsampleInput(const int16_t* const* data_in, size_t data_length,
+                            __m128i* state, __m128i* state2, __m128i* out) {
+  __m128i block[8];
+  size_t n;
+
+  for (n = 0; n < data_length; n += 8) {
+    LoadTransposed(data_in, n, block);
+    if (state2 != NULL) {
+      Downsampling(block, block, state, 8);
+      Downsampling(block, &out[n >> 2], state2, 4);
+    } else {
+      Downsampling(block, &out[n >> 1], state, 8);
+    }
+  }
+}
+
+// SplitFilter() of vad_filterbank.c, with both all-pass branches in one loop.
+static void SplitFilter(const __m128i* data_in, size_t data_length,
+                        __m128i* upper_state, __m128i* lower_state,
+                        __m128i* hp_data_out, __m128i* lp_data_out) {
+  const size_t half_length = data_length >> 1;
+  // All-pass states in Q15.
+  __m128i upper32 = _mm_slli_epi32(*upper_state, 16);
+  __m128i lower32 = _mm_slli_epi32(*lower_state, 16);
+  size_t i;
+
+  for (i = 0; i < half_length; i++) {
+    const __m128i upper_in = data_in[2 * i];
+    const __m128i lower_in = data_in[2 * i + 1];
+    const __m128i upper_out = _mm_srai_epi32(
+        _mm_add_epi32(upper32, MulW16(upper_in, kAllPassCoefsQ15[0])), 16);
+    const __m128i lower_out = _mm_srai_epi32(
+        _mm_add_epi32(lower32, MulW16(lower_in, kAllPassCoefsQ15[1])), 16);
+    upper32 = _mm_slli_epi32(
+        _mm_sub_epi32(_mm_slli_epi32(upper_in, 14),
+                      MulW16(upper_out, kAllPassCoefsQ15[0])), 1);
+    lower32 = _mm_slli_epi32(
+        _mm_sub_epi32(_mm_slli_epi32(lower_in, 14),
+                      MulW16(lower_out, kAllPassCoefsQ15[1])), 1);
+
+    // Make LP and HP signals.
+    hp_data_out[i] = TruncateW16(_mm_sub_epi32(upper_out, lower_out));
+    lp_data_out[i] = TruncateW16(_mm_add_epi32(lower_out, upper_out));
+  }
+  *upper_state = _mm_srai_epi32(upper32, 16);
+  *lower_state = _mm_srai_epi32(lower32, 16);
+}
+
+// HighPassFilter() of vad_filterbank.c.
+static void HighPassFilter(const __m128i* data_in, size_t data_length,
+                           __m128i* filter_state, __m128i* data_out) {
+  size_t i;
+
+  for (i = 0; i < data_length; i++) {
+    // All-zero section (filter coefficients in Q14).
+    __m128i tmp32 = MulW16(data_in[i], kHpZeroCoefs[0]);
+    tmp32 = _mm_add_epi32(tmp32, MulW16(filter_state[0], kHpZeroCoefs[1]));
+    tmp32 = _mm_add_epi32(tmp32, MulW16(filter_state[1], kHpZeroCoefs[2]));
+    filter_state[1] = filter_state[0];
+    filter_state[0] = data_in[i];
+
+    // All-pole section (filter coefficients in Q14).
+    tmp32 = _mm_sub_epi32(tmp32, MulW16(filter_state[2], kHpPoleCoefs[1]));
+    tmp32 = _mm_sub_epi32(tmp32, MulW16(filter_state[3], kHpPoleCoefs[2]));
+    filter_state[3] = filter_state[2];
+    filter_state[2] = TruncateW16(_mm_srai_epi32(tmp32, 14));
+    data_out[i] = filter_state[2];
+  }
+}
+
+// WebRtcSpl_Energy() of each lane. The scaling differs between lanes; SSE2
+// has no per-lane shift, so the shift is applied one bit at a time.
+static void Energy(const __m128i* data_in, size_t data_length,
+                   int32_t* energy, int* scaling) {
+  const int16_t nbits = WebRtcSpl_GetSizeInBits((uint32_t)data_length);
+  const __m128i low16 = _mm_set1_epi32(0xFFFF);
+  __m128i smax = _mm_set1_epi32(-1);
+  __m128i shift, shift1, shift2, shift4;
+  __m128i en = _mm_setzero_si128();
+  int16_t max_values[2 * kLanes];
+  size_t i;
+  int lane;
+
+  // The scaling never exceeds |nbits|, at most 6 for 30 ms frames.
+  RTC_DCHECK_LT(nbits, 8);
+
+  for (i = 0; i < data_length; i++) {
+    const __m128i sign = _mm_srai_epi32(data_in[i], 31);
+    // As in WebRtcSpl_GetScalingSquare(), the absolute value of -32768 wraps
+    // to -32768. The lanes stay sign-extended, so _mm_max_epi16() gives the
+    // maximum of the 32-bit lanes.
+    const __m128i abs_value = TruncateW16(
+        _mm_sub_epi32(_mm_xor_si128(data_in[i], sign), sign));
+    smax = _mm_max_epi16(smax, abs_value);
+  }
+  _mm_storeu_si128((__m128i*)max_values, smax);
+  for (lane = 0; lane < kLanes; lane++) {
+    const int16_t lane_max = max_values[2 * lane];
+    const int16_t t = WebRtcSpl_NormW32(WEBRTC_SPL_MUL(lane_max, lane_max));
+    scaling[lane] = (lane_max == 0 || t > nbits) ? 0 : nbits - t;
+  }
+
+  shift = _mm_loadu_si128((const __m128i*)scaling);
+  shift1 = _mm_cmpeq_epi32(_mm_and_si128(shift, _mm_set1_epi32(1)),
+                           _mm_set1_epi32(1));
+  shift2 = _mm_cmpeq_epi32(_mm_and_si128(shift, _mm_set1_epi32(2)),
+                           _mm_set1_epi32(2));
+  shift4 = _mm_cmpeq_epi32(_mm_and_si128(shift, _mm_set1_epi32(4)),
+                           _mm_set1_epi32(4));
+  for (i = 0; i < data_length; i++) {
+    __m128i square =
+        _mm_madd_epi16(data_in[i], _mm_and_si128(data_in[i], low16));
+    square = _mm_or_si128(_mm_andnot_si128(shift1, square),
+                          _mm_and_si128(shift1, _mm_srli_epi32(square, 1)));
+    square = _mm_or_si128(_mm_andnot_si128(shift2, square),
+                          _mm_and_si128(shift2, _mm_srli_epi32(square, 2)));
+    square = _mm_or_si128(_mm_andnot_si128(shift4, square),
+                          _mm_and_si128(shift4, _mm_srli_epi32(square, 4)));
+    en = _mm_add_epi32(en, square);
+  }
+  _mm_storeu_si128((__m128i*)energy, en);
+}
+
+// WebRtcVad_CalculateFeaturesBatchC() for exactly |kLanes| instances.
+static void CalculateFeatures(VadInstT* const* insts,
+                              const int16_t* const* data_in, int fs,
+                              size_t data_length, int16_t* features,
+                              int16_t* total_energy) {
+  // Buffers of WebRtcVad_CalculateFeatures(), plus the 8 kHz input.
+  __m128i speech_nb[240];
+  __m128i hp_120[120], lp_120[120];
+  __m128i hp_60[60], lp_60[60];
+  __m128i downsampling_state[4];
+  __m128i upper_state[5], lower_state[5];
+  __m128i hp_filter_state[4];
+  int32_t tmp[kLanes];
+  int32_t energy[kNumChannels][kLanes];
+  int scaling[kNumChannels][kLanes];
+  size_t length;
+  size_t n;
+  int k, lane;
+
+  RTC_DCHECK_GT(data_length, 0);
+  RTC_DCHECK_EQ(0, data_length % 8);
+
+  for (k = 0; k < 4; k++) {
+    for (lane = 0; lane < kLanes; lane++) {
+      tmp[lane] = insts[lane]->downsampling_filter_states[k];
+    }
+    downsampling_state[k] = _mm_loadu_si128((const __m128i*)tmp);
+    for (lane = 0; lane < kLanes; lane++) {
+      tmp[lane] = insts[lane]->hp_filter_state[k];
+    }
+    hp_filter_state[k] = _mm_loadu_si128((const __m128i*)tmp);
+  }
+  for (k = 0; k < 5; k++) {
+    for (lane = 0; lane < kLanes; lane++) {
+      tmp[lane] = insts[lane]->upper_state[k];
+    }
+    upper_state[k] = _mm_loadu_si128((const __m128i*)tmp);
+    for (lane = 0; lane < kLanes; lane++) {
+      tmp[lane] = insts[lane]->lower_state[k];
+    }
+    lower_state[k] = _mm_loadu_si128((const __m128i*)tmp);
+  }
+
+  if (fs == 32000) {
+    DownsampleInput(data_in, data_length, &downsampling_state[2],
+                    &downsampling_state[0], speech_nb);
+    length = data_length >> 2;
+  } else if (fs == 16000) {
+    DownsampleInput(data_in, data_length, &downsampling_state[0], NULL,
+                    speech_nb);
+    length = data_length >> 1;
+  } else {
+    // At least one block, which lets the compiler see that |speech_nb| is
+    // written on every path.
+    n = 0;
+    do {
+      LoadTransposed(data_in, n, &speech_nb[n]);
+      n += 8;
+    } while (n < data_length);
+    length = data_length;
+  }
+  RTC_DCHECK_LE(length, 240);
+
+  // The band splits of WebRtcVad_CalculateFeatures(): 2000 Hz, then 3000 Hz
+  // and 1000 Hz, then 500 Hz and 250 Hz, followed by the 80 Hz high pass.
+  SplitFilter(speech_nb, length, &upper_state[0], &lower_state[0], hp_120,
+              lp_120);
+  SplitFilter(hp_120, length >> 1, &upper_state[1], &lower_state[1], hp_60,
+              lp_60);
+  Energy(hp_60, length >> 2, energy[5], scaling[5]);
+  Energy(lp_60, length >> 2, energy[4], scaling[4]);
+  SplitFilter(lp_120, length >> 1, &upper_state[2], &lower_state[2], hp_60,
+              lp_60);
+  Energy(hp_60, length >> 2, energy[3], scaling[3]);
+  SplitFilter(lp_60, length >> 2, &upper_state[3], &lower_state[3], hp_120,
+              lp_120);
+  Energy(hp_120, length >> 3, energy[2], scaling[2]);
+  SplitFilter(lp_120, length >> 3, &upper_state[4], &lower_state[4], hp_60,
+              lp_60);
+  Energy(hp_60, length >> 4, energy[1], scaling[1]);
+  HighPassFilter(lp_60, length >> 4, hp_filter_state, hp_120);
+  Energy(hp_120, length >> 4, energy[0], scaling[0]);
+
+  for (k = 0; k < 4; k++) {
+    _mm_storeu_si128((__m128i*)tmp, downsampling_state[k]);
+    for (lane = 0; lane < kLanes; lane++) {
+      insts[lane]->downsampling_filter_states[k] = tmp[lane];
+    }
+    _mm_storeu_si128((__m128i*)tmp, hp_filter_state[k]);
+    for (lane = 0; lane < kLanes; lane++) {
+      insts[lane]->hp_filter_state[k] = (int16_t)tmp[lane];
+    }
+  }
+  for (k = 0; k < 5; k++) {
+    _mm_storeu_si128((__m128i*)tmp, upper_state[k]);
+    for (lane = 0; lane < kLanes; lane++) {
+      insts[lane]->upper_state[k] = (int16_t)tmp[lane];
+    }
+    _mm_storeu_si128((__m128i*)tmp, lower_state[k]);
+    for (lane = 0; lane < kLanes; lane++) {
+      insts[lane]->lower_state[k] = (int16_t)tmp[lane];
+    }
+  }
+
+  // |total_energy| depends on the order, which is from the highest band down
+  // as in WebRtcVad_CalculateFeatures().
+  for (lane = 0; lane < kLanes; lane++) {
+    int16_t lane_total_energy = 0;
+    for (k = kNumChannels - 1; k >= 0; k--) {
+      WebRtcVad_LogOfEnergy((uint32_t)energy[k][lane], scaling[k][lane],
+                            kOffsetVector[k], &lane_total_energy,
+                            &features[lane * kNumChannels + k]);
+    }
+    total_energy[lane] = lane_total_energy;
+  }
+}
+
+void WebRtcVad_CalculateFeaturesBatchSSE2(VadInstT* const* insts,
+                                          const int16_t* const* data_in,
+                                          size_t num_insts,
+                                          int fs,
+                                          size_t data_length,
+                                          int16_t* features,
+                                          int16_t* total_energy) {
+  size_t i = 0;
+
+  RTC_DCHECK(fs == 8000 || fs == 16000 || fs == 32000);
+
+  for (; i + kLanes <= num_insts; i += kLanes) {
+    CalculateFeatures(&insts[i], &data_in[i], fs, data_length,
+                      &features[i * kNumChannels], &total_energy[i]);
+  }
+  if (i < num_insts) {
+    WebRtcVad_CalculateFeaturesBatchC(&insts[i], &data_in[i], num_insts - i,
+                                      fs, data_length,
+                                      &features[i * kNumChannels],
+                                      &total_energy[i]);
+  }
+}
@@ -89,6 +89,43 @@ int WebRtcVad_Process(VadInst* handle, int fs, const int16_t* audio_frame,
   return vad;
 }
 
+int WebRtcVad_ProcessBatch(VadInst* const* handles,
+                           size_t num_channels,
+                           int fs,
+                           const int16_t* const* audio_frames,
+                           size_t frame_length,
+                           int* vad_decisions) {
+  size_t i;
+
+  if (handles == NULL || audio_frames == NULL || vad_decisions == NULL) {
+    return -1;
+  }
+  if (WebRtcVad_ValidRateAndFrameLength(fs, frame_length) != 0) {
+    return -1;
+  }
+  // Check every channel first so that an error leaves all instances as they
+  // were.
+  for (i = 0; i < num_channels; i++) {
+    const VadInstT* self = (const VadInstT*) handles[i];
+    if (self == NULL || self->init_flag != kInitCheck) {
+      return -1;
+    }
+    if (audio_frames[i] == NULL) {
+      return -1;
+    }
+  }
+
+  WebRtcVad_CalcVadBatch((VadInstT* const*) handles, num_channels, fs,
+                         audio_frames, frame_length, vad_decisions);
+
+  for (i = 0; i < num_channels; i++) {
+    if (vad_decisions[i] > 0) {
+      vad_decisions[i] = 1;
+    }
+  }
+  return 0;
+}
+
 int WebRtcVad_ValidRateAndFrameLength(int rate, size_t frame_length) {
   int return_value = -1;
   size_t i;
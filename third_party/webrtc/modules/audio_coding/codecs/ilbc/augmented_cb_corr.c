@@ -20,7 +20,9 @@
 #include "modules/audio_coding/codecs/ilbc/constants.h"
 #include "modules/audio_coding/codecs/ilbc/augmented_cb_corr.h"
 
-void WebRtcIlbcfix_AugmentedCbCorr(
+AugmentedCbCorr WebRtcIlbcfix_AugmentedCbCorr;
+
+void WebRtcIlbcfix_AugmentedCbCorrC(
     int16_t *target,   /* (i) Target vector */
     int16_t *buffer,   /* (i) Memory buffer */
     int16_t *interpSamples, /* (i) buffer with
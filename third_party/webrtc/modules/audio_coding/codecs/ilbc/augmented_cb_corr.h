@@ -25,7 +25,7 @@
  *  Calculate correlation between target and Augmented codebooks
  *---------------------------------------------------------------*/
 
-void WebRtcIlbcfix_AugmentedCbCorr(
+typedef void (*AugmentedCbCorr)(
     int16_t* target,        /* (i) Target vector */
     int16_t* buffer,        /* (i) Memory buffer */
     int16_t* interpSamples, /* (i) buffer with
@@ -38,4 +38,28 @@ void WebRtcIlbcfix_AugmentedCbCorr(
     size_t high,            /* (i) Lag to end at (typically 39 */
     int scale);             /* (i) Scale factor to use for the crossDot */
 
+/* Function pointer set by WebRtcIlbcfix_InitEncode(). */
+extern AugmentedCbCorr WebRtcIlbcfix_AugmentedCbCorr;
+
+void WebRtcIlbcfix_AugmentedCbCorrC(int16_t* target,
+                                    int16_t* buffer,
+                                    int16_t* interpSamples,
+                                    int32_t* crossDot,
+                                    size_t low,
+                                    size_t high,
+                                    int scale);
+
+/* Defined in cb_search_sse2.c and used by the AVX2 set as well. Bit-exact
+ * with the C version; it falls back to C when the scaled products could
+ * saturate the sum. */
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIlbcfix_AugmentedCbCorrSSE2(int16_t* target,
+                                       int16_t* buffer,
+                                       int16_t* interpSamples,
+                                       int32_t* crossDot,
+                                       size_t low,
+                                       size_t high,
+                                       int scale);
+#endif
+
 #endif
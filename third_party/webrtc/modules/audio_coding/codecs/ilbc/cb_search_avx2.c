@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* This file contains the AVX2 versions of WebRtcIlbcfix_CbSearchCore() and
+ * WebRtcIlbcfix_FilteredCbVecs(). The results are bit exact with the C
+ * versions.
+ */
+
+#include <immintrin.h>
+
+#include "modules/audio_coding/codecs/ilbc/cb_search_core.h"
+#include "modules/audio_coding/codecs/ilbc/constants.h"
+#include "modules/audio_coding/codecs/ilbc/defines.h"
+#include "modules/audio_coding/codecs/ilbc/filtered_cb_vecs.h"
+
+static __inline int32_t HorizontalMax32(__m256i a) {
+  __m128i b = _mm_max_epi32(_mm256_castsi256_si128(a),
+                            _mm256_extracti128_si256(a, 1));
+  b = _mm_max_epi32(b, _mm_shuffle_epi32(b, _MM_SHUFFLE(1, 0, 3, 2)));
+  b = _mm_max_epi32(b, _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(b);
+}
+
+void WebRtcIlbcfix_CbSearchCoreAVX2(int32_t* cDot,
+                                    size_t range,
+                                    int16_t stage,
+                                    int16_t* inverseEnergy,
+                                    int16_t* inverseEnergyShift,
+                                    int32_t* Crit,
+                                    size_t* bestIndex,
+                                    int32_t* bestCrit,
+                                    int16_t* bestCritSh) {
+  const __m256i kMinShift = _mm256_set1_epi32(WEBRTC_SPL_WORD16_MIN);
+  __m256i max_v = kMinShift;
+  __m256i crit_max, max_shift, crit_max_v;
+  __m128i sh_v;
+  int32_t maxW32, critMax;
+  int16_t max, sh;
+  size_t i;
+
+  /* Don't allow negative values for stage 0 */
+  if (stage == 0) {
+    for (i = 0; i + 8 <= range; i += 8) {
+      __m256i c = _mm256_loadu_si256((const __m256i*)&cDot[i]);
+      _mm256_storeu_si256((__m256i*)&cDot[i],
+                          _mm256_max_epi32(c, _mm256_setzero_si256()));
+    }
+    for (; i < range; i++) {
+      cDot[i] = WEBRTC_SPL_MAX(0, cDot[i]);
+    }
+  }
+
+  maxW32 = WebRtcSpl_MaxAbsValueW32(cDot, range);
+  sh = (int16_t)WebRtcSpl_NormW32(maxW32);
+  sh_v = _mm_cvtsi32_si128(sh);
+
+  /* The criteria cDot*cDot/energy, and the maximum shift of the non-zero
+     ones. */
+  for (i = 0; i + 8 <= range; i += 8) {
+    __m256i t = _mm256_srai_epi32(
+        _mm256_sll_epi32(_mm256_loadu_si256((const __m256i*)&cDot[i]), sh_v),
+        16);
+    __m256i sq = _mm256_srai_epi32(_mm256_mullo_epi32(t, t), 16);
+    __m256i crit = _mm256_mullo_epi32(
+        sq, _mm256_cvtepi16_epi32(
+                _mm_loadu_si128((const __m128i*)&inverseEnergy[i])));
+    __m256i shift = _mm256_cvtepi16_epi32(
+        _mm_loadu_si128((const __m128i*)&inverseEnergyShift[i]));
+    __m256i zero_crit = _mm256_cmpeq_epi32(crit, _mm256_setzero_si256());
+    _mm256_storeu_si256((__m256i*)&Crit[i], crit);
+    max_v = _mm256_max_epi32(max_v,
+                             _mm256_blendv_epi8(shift, kMinShift, zero_crit));
+  }
+  max = (int16_t)HorizontalMax32(max_v);
+  for (; i < range; i++) {
+    int32_t tmp32 = cDot[i] << sh;
+    int16_t tmp16 = (int16_t)(tmp32 >> 16);
+    int16_t cDotSqW16 = (int16_t)(((int32_t)(tmp16)*(tmp16))>>16);
+    Crit[i] = cDotSqW16 * inverseEnergy[i];
+    if (Crit[i] != 0) {
+      max = WEBRTC_SPL_MAX(inverseEnergyShift[i], max);
+    }
+  }
+
+  /* If no max shifts still at initialization value, set shift to zero */
+  if (max == WEBRTC_SPL_WORD16_MIN) {
+    max = 0;
+  }
+
+  /* Bring all criteria to the same Q domain. A non-zero criterion has a
+     shift of at most |max|, so it is shifted right by 0 to 16. The shift of
+     a zero criterion does not matter. */
+  max_shift = _mm256_set1_epi32(max);
+  crit_max_v = _mm256_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  for (i = 0; i + 8 <= range; i += 8) {
+    __m256i shift = _mm256_sub_epi32(
+        max_shift, _mm256_cvtepi16_epi32(_mm_loadu_si128(
+                       (const __m128i*)&inverseEnergyShift[i])));
+    __m256i crit = _mm256_srav_epi32(
+        _mm256_loadu_si256((const __m256i*)&Crit[i]),
+        _mm256_min_epi32(shift, _mm256_set1_epi32(16)));
+    _mm256_storeu_si256((__m256i*)&Crit[i], crit);
+    crit_max_v = _mm256_max_epi32(crit_max_v, crit);
+  }
+  critMax = HorizontalMax32(crit_max_v);
+  for (; i < range; i++) {
+    int16_t tmp16 = WEBRTC_SPL_MIN(16, max - inverseEnergyShift[i]);
+    Crit[i] = WEBRTC_SPL_SHIFT_W32(Crit[i], -tmp16);
+    critMax = WEBRTC_SPL_MAX(critMax, Crit[i]);
+  }
+
+  /* Find the index of the best value, the first one equal to the maximum
+     as in WebRtcSpl_MaxIndexW32(). */
+  crit_max = _mm256_set1_epi32(critMax);
+  for (i = 0; i + 8 <= range; i += 8) {
+    if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(
+            _mm256_loadu_si256((const __m256i*)&Crit[i]), crit_max)) != 0) {
+      break;
+    }
+  }
+  while (i < range && Crit[i] != critMax) {
+    i++;
+  }
+  *bestIndex = i < range ? i : 0;
+  *bestCrit = Crit[*bestIndex];
+
+  /* Calculate total shifts of this criteria */
+  *bestCritSh = 32 - 2*sh + max;
+}
+
+/* Sixteen outputs of the 8-tap filter in WebRtcSpl_FilterMAFastQ12(), as in
+ * the SSE2 version. The unpacks and the pack all work within 128-bit lanes,
+ * so the outputs come out in order. */
+static __inline __m256i FilterMAFastQ12x16(const int16_t* in,
+                                           const __m256i* taps) {
+  __m256i lo = _mm256_setzero_si256();
+  __m256i hi = _mm256_setzero_si256();
+  int j;
+  for (j = 0; j < CB_FILTERLEN; j += 2) {
+    __m256i a = _mm256_loadu_si256((const __m256i*)(in - j));
+    __m256i b = _mm256_loadu_si256((const __m256i*)(in - j - 1));
+    lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b),
+                                                taps[j / 2]));
+    hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b),
+                                                taps[j / 2]));
+  }
+  lo = _mm256_srai_epi32(
+      _mm256_add_epi32(_mm256_srai_epi32(lo, 1), _mm256_set1_epi32(1024)), 11);
+  hi = _mm256_srai_epi32(
+      _mm256_add_epi32(_mm256_srai_epi32(hi, 1), _mm256_set1_epi32(1024)), 11);
+  return _mm256_packs_epi32(lo, hi);
+}
+
+void WebRtcIlbcfix_FilteredCbVecsAVX2(int16_t* cbvectors,
+                                      int16_t* CBmem,
+                                      size_t lMem,
+                                      size_t samples) {
+  const int16_t* B = WebRtcIlbcfix_kCbFiltersRev;
+  const int16_t* in = CBmem + CB_HALFFILTERLEN + lMem - samples;
+  int16_t* out = cbvectors + lMem - samples;
+  __m256i taps[CB_FILTERLEN / 2];
+  size_t i;
+  int j;
+
+  if (samples < 16) {
+    WebRtcIlbcfix_FilteredCbVecsSSE2(cbvectors, CBmem, lMem, samples);
+    return;
+  }
+
+  /* Set up the memory, start with zero state */
+  WebRtcSpl_MemSetW16(CBmem+lMem, 0, CB_HALFFILTERLEN);
+  WebRtcSpl_MemSetW16(CBmem-CB_HALFFILTERLEN, 0, CB_HALFFILTERLEN);
+  WebRtcSpl_MemSetW16(cbvectors, 0, lMem-samples);
+
+  for (j = 0; j < CB_FILTERLEN; j += 2) {
+    taps[j / 2] = _mm256_set1_epi32(
+        (int32_t)(((uint32_t)(uint16_t)B[j + 1] << 16) | (uint16_t)B[j]));
+  }
+
+  /* The outputs only depend on the input, so the last block may overlap the
+     one before it. */
+  for (i = 0; i + 16 <= samples; i += 16) {
+    _mm256_storeu_si256((__m256i*)&out[i], FilterMAFastQ12x16(&in[i], taps));
+  }
+  if (i < samples) {
+    _mm256_storeu_si256((__m256i*)&out[samples - 16],
+                        FilterMAFastQ12x16(&in[samples - 16], taps));
+  }
+}
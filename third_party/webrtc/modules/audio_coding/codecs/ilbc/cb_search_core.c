@@ -18,8 +18,11 @@
 
 #include "modules/audio_coding/codecs/ilbc/defines.h"
 #include "modules/audio_coding/codecs/ilbc/constants.h"
+#include "modules/audio_coding/codecs/ilbc/cb_search_core.h"
 
-void WebRtcIlbcfix_CbSearchCore(
+CbSearchCore WebRtcIlbcfix_CbSearchCore;
+
+void WebRtcIlbcfix_CbSearchCoreC(
     int32_t *cDot,    /* (i) Cross Correlation */
     size_t range,    /* (i) Search range */
     int16_t stage,    /* (i) Stage of this search */
@@ -21,7 +21,7 @@
 
 #include "modules/audio_coding/codecs/ilbc/defines.h"
 
-void WebRtcIlbcfix_CbSearchCore(
+typedef void (*CbSearchCore)(
     int32_t* cDot,               /* (i) Cross Correlation */
     size_t range,                /* (i) Search range */
     int16_t stage,               /* (i) Stage of this search */
@@ -37,4 +37,40 @@ void WebRtcIlbcfix_CbSearchCore(
     int16_t* bestCritSh); /* (o) The domain of the chosen
                                    criteria */
 
+/* Function pointer set by WebRtcIlbcfix_InitEncode(). */
+extern CbSearchCore WebRtcIlbcfix_CbSearchCore;
+
+void WebRtcIlbcfix_CbSearchCoreC(int32_t* cDot,
+                                 size_t range,
+                                 int16_t stage,
+                                 int16_t* inverseEnergy,
+                                 int16_t* inverseEnergyShift,
+                                 int32_t* Crit,
+                                 size_t* bestIndex,
+                                 int32_t* bestCrit,
+                                 int16_t* bestCritSh);
+
+/* The x86 versions are defined in cb_search_sse2.c and cb_search_avx2.c and
+ * are bit-exact with the C version. */
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIlbcfix_CbSearchCoreSSE2(int32_t* cDot,
+                                    size_t range,
+                                    int16_t stage,
+                                    int16_t* inverseEnergy,
+                                    int16_t* inverseEnergyShift,
+                                    int32_t* Crit,
+                                    size_t* bestIndex,
+                                    int32_t* bestCrit,
+                                    int16_t* bestCritSh);
+void WebRtcIlbcfix_CbSearchCoreAVX2(int32_t* cDot,
+                                    size_t range,
+                                    int16_t stage,
+                                    int16_t* inverseEnergy,
+                                    int16_t* inverseEnergyShift,
+                                    int32_t* Crit,
+                                    size_t* bestIndex,
+                                    int32_t* bestCrit,
+                                    int16_t* bestCritSh);
+#endif
+
 #endif
@@ -0,0 +1,330 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* This file contains the SSE2 versions of the codebook search functions
+ * WebRtcIlbcfix_AugmentedCbCorr(), WebRtcIlbcfix_CbSearchCore() and
+ * WebRtcIlbcfix_FilteredCbVecs(). The results are bit exact with the C
+ * versions.
+ */
+
+#include <emmintrin.h>
+
+#include "modules/audio_coding/codecs/ilbc/augmented_cb_corr.h"
+#include "modules/audio_coding/codecs/ilbc/cb_search_core.h"
+#include "modules/audio_coding/codecs/ilbc/constants.h"
+#include "modules/audio_coding/codecs/ilbc/defines.h"
+#include "modules/audio_coding/codecs/ilbc/filtered_cb_vecs.h"
+
+/* Eight zero lanes followed by eight all-ones lanes. Loading eight values at
+ * &kTailMask[n] keeps the last n lanes of a vector. */
+static const int16_t kTailMask[16] = {0,  0,  0,  0,  0,  0,  0,  0,
+                                      -1, -1, -1, -1, -1, -1, -1, -1};
+
+static __inline __m128i Max32(__m128i a, __m128i b) {
+  __m128i gt = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(gt, a), _mm_andnot_si128(gt, b));
+}
+
+static __inline __m128i Min32(__m128i a, __m128i b) {
+  __m128i gt = _mm_cmpgt_epi32(a, b);
+  return _mm_or_si128(_mm_and_si128(gt, b), _mm_andnot_si128(gt, a));
+}
+
+static __inline int32_t HorizontalMax32(__m128i a) {
+  a = Max32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)));
+  a = Max32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(a);
+}
+
+/* Sum of (a[i] * b[i]) >> |scale| over the eight lanes, in four lanes. */
+static __inline __m128i MulScale16(__m128i a, __m128i b, __m128i scale) {
+  __m128i lo = _mm_mullo_epi16(a, b);
+  __m128i hi = _mm_mulhi_epi16(a, b);
+  return _mm_add_epi32(
+      _mm_sra_epi32(_mm_unpacklo_epi16(lo, hi), scale),
+      _mm_sra_epi32(_mm_unpackhi_epi16(lo, hi), scale));
+}
+
+/* Dot product of |length| >= 8 samples, where the products are scaled one by
+ * one as in WebRtcSpl_DotProductWithScale(). The last, partial block is read
+ * so that it ends at the last sample, and masks the lanes it shares with the
+ * block before it. */
+static __inline __m128i DotProductWithScale(const int16_t* a,
+                                            const int16_t* b,
+                                            size_t length,
+                                            __m128i scale,
+                                            __m128i sum) {
+  size_t i;
+  for (i = 0; i + 8 <= length; i += 8) {
+    sum = _mm_add_epi32(
+        sum, MulScale16(_mm_loadu_si128((const __m128i*)&a[i]),
+                        _mm_loadu_si128((const __m128i*)&b[i]), scale));
+  }
+  if (i < length) {
+    __m128i mask =
+        _mm_loadu_si128((const __m128i*)&kTailMask[length - i]);
+    sum = _mm_add_epi32(
+        sum, MulScale16(
+                 _mm_and_si128(
+                     _mm_loadu_si128((const __m128i*)&a[length - 8]), mask),
+                 _mm_loadu_si128((const __m128i*)&b[length - 8]), scale));
+  }
+  return sum;
+}
+
+void WebRtcIlbcfix_AugmentedCbCorrSSE2(int16_t* target,
+                                       int16_t* buffer,
+                                       int16_t* interpSamples,
+                                       int32_t* crossDot,
+                                       size_t low,
+                                       size_t high,
+                                       int scale) {
+  const __m128i scale_v = _mm_cvtsi32_si128(scale);
+  int16_t* iSPtr = interpSamples;
+  int64_t max_target, max_buffer;
+  size_t lagcount;
+
+  /* The C version saturates each of its three partial sums. Keep the whole
+     sum in 32 bits only when no partial sum can reach that limit. */
+  max_target = WebRtcSpl_MaxAbsValueW16(target, SUBL) + 1;
+  max_buffer = WEBRTC_SPL_MAX(
+      WebRtcSpl_MaxAbsValueW16(buffer - high, high),
+      WebRtcSpl_MaxAbsValueW16(interpSamples, 4 * (high - low + 1))) + 1;
+  if (low < 20 || high > 39 || low > high ||
+      SUBL * (((max_target * max_buffer) >> scale) + 1) >
+          WEBRTC_SPL_WORD32_MAX) {
+    WebRtcIlbcfix_AugmentedCbCorrC(target, buffer, interpSamples, crossDot,
+                                   low, high, scale);
+    return;
+  }
+
+  for (lagcount = low; lagcount <= high; lagcount++) {
+    size_t ilow = lagcount - 4;
+    __m128i sum = _mm_setzero_si128();
+    __m128i t, s;
+
+    /* The first (lagcount-4) samples. */
+    sum = DotProductWithScale(target, buffer - lagcount, ilow, scale_v, sum);
+
+    /* The interpolated samples. */
+    t = _mm_loadl_epi64((const __m128i*)&target[ilow]);
+    s = _mm_loadl_epi64((const __m128i*)iSPtr);
+    sum = _mm_add_epi32(
+        sum, _mm_sra_epi32(_mm_unpacklo_epi16(_mm_mullo_epi16(t, s),
+                                              _mm_mulhi_epi16(t, s)),
+                           scale_v));
+    iSPtr += 4;
+
+    /* The remaining samples repeat the start of the lag. There may be fewer
+       than eight of them, so read the block that ends at the last one. */
+    if (SUBL - lagcount >= 8) {
+      sum = DotProductWithScale(target + lagcount, buffer - lagcount,
+                                SUBL - lagcount, scale_v, sum);
+    } else {
+      const size_t rest = SUBL - lagcount;
+      __m128i mask = _mm_loadu_si128((const __m128i*)&kTailMask[rest]);
+      sum = _mm_add_epi32(
+          sum, MulScale16(
+                   _mm_and_si128(
+                       _mm_loadu_si128((const __m128i*)&target[SUBL - 8]),
+                       mask),
+                   _mm_loadu_si128(
+                       (const __m128i*)(buffer - lagcount - 8 + rest)),
+                   scale_v));
+    }
+
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    *crossDot++ = _mm_cvtsi128_si32(sum);
+  }
+}
+
+/* Shifts each lane of |a| right by the matching lane of |shift|, for shifts
+ * in [0, 31]. */
+static __inline __m128i ShiftRightVariable(__m128i a, __m128i shift) {
+  int b;
+  for (b = 1; b < 32; b <<= 1) {
+    const __m128i bit = _mm_set1_epi32(b);
+    __m128i sel = _mm_cmpeq_epi32(_mm_and_si128(shift, bit), bit);
+    a = _mm_or_si128(_mm_and_si128(sel, _mm_sra_epi32(a, _mm_cvtsi32_si128(b))),
+                     _mm_andnot_si128(sel, a));
+  }
+  return a;
+}
+
+void WebRtcIlbcfix_CbSearchCoreSSE2(int32_t* cDot,
+                                    size_t range,
+                                    int16_t stage,
+                                    int16_t* inverseEnergy,
+                                    int16_t* inverseEnergyShift,
+                                    int32_t* Crit,
+                                    size_t* bestIndex,
+                                    int32_t* bestCrit,
+                                    int16_t* bestCritSh) {
+  const __m128i kLow16 = _mm_set1_epi32(0xffff);
+  const __m128i kMinShift = _mm_set1_epi32(WEBRTC_SPL_WORD16_MIN);
+  __m128i max_v = kMinShift;
+  __m128i sh_v, crit_max;
+  int32_t maxW32, critMax;
+  int16_t max, sh;
+  size_t i;
+
+  /* Don't allow negative values for stage 0 */
+  if (stage == 0) {
+    for (i = 0; i + 4 <= range; i += 4) {
+      __m128i c = _mm_loadu_si128((const __m128i*)&cDot[i]);
+      c = _mm_and_si128(c, _mm_cmpgt_epi32(c, _mm_setzero_si128()));
+      _mm_storeu_si128((__m128i*)&cDot[i], c);
+    }
+    for (; i < range; i++) {
+      cDot[i] = WEBRTC_SPL_MAX(0, cDot[i]);
+    }
+  }
+
+  maxW32 = WebRtcSpl_MaxAbsValueW32(cDot, range);
+  sh = (int16_t)WebRtcSpl_NormW32(maxW32);
+  sh_v = _mm_cvtsi32_si128(sh);
+
+  /* The criteria cDot*cDot/energy, and the maximum shift of the non-zero
+     ones. The squares of the upper halves and the inverse energies fit in
+     16 bits, so _mm_madd_epi16 forms the products from the low halves. */
+  for (i = 0; i + 4 <= range; i += 4) {
+    __m128i t = _mm_srai_epi32(
+        _mm_sll_epi32(_mm_loadu_si128((const __m128i*)&cDot[i]), sh_v), 16);
+    __m128i sq = _mm_srai_epi32(
+        _mm_madd_epi16(t, _mm_and_si128(t, kLow16)), 16);
+    __m128i inv = _mm_loadl_epi64((const __m128i*)&inverseEnergy[i]);
+    __m128i shift = _mm_loadl_epi64((const __m128i*)&inverseEnergyShift[i]);
+    __m128i crit = _mm_madd_epi16(
+        sq, _mm_srai_epi32(_mm_unpacklo_epi16(inv, inv), 16));
+    __m128i zero_crit = _mm_cmpeq_epi32(crit, _mm_setzero_si128());
+    shift = _mm_srai_epi32(_mm_unpacklo_epi16(shift, shift), 16);
+    _mm_storeu_si128((__m128i*)&Crit[i], crit);
+    /* On sign-extended lanes the 16-bit maximum is the 32-bit maximum. */
+    max_v = _mm_max_epi16(
+        max_v, _mm_or_si128(_mm_and_si128(zero_crit, kMinShift),
+                            _mm_andnot_si128(zero_crit, shift)));
+  }
+  max = (int16_t)HorizontalMax32(max_v);
+  for (; i < range; i++) {
+    int32_t tmp32 = cDot[i] << sh;
+    int16_t tmp16 = (int16_t)(tmp32 >> 16);
+    int16_t cDotSqW16 = (int16_t)(((int32_t)(tmp16)*(tmp16))>>16);
+    Crit[i] = cDotSqW16 * inverseEnergy[i];
+    if (Crit[i] != 0) {
+      max = WEBRTC_SPL_MAX(inverseEnergyShift[i], max);
+    }
+  }
+
+  /* If no max shifts still at initialization value, set shift to zero */
+  if (max == WEBRTC_SPL_WORD16_MIN) {
+    max = 0;
+  }
+
+  /* Bring all criteria to the same Q domain. A non-zero criterion is
+     positive and has a shift of at most |max|, so it is shifted right by
+     0 to 16. The shift of a zero criterion does not matter. */
+  crit_max = _mm_set1_epi32(WEBRTC_SPL_WORD32_MIN);
+  for (i = 0; i + 4 <= range; i += 4) {
+    __m128i shift = _mm_loadl_epi64((const __m128i*)&inverseEnergyShift[i]);
+    __m128i crit = _mm_loadu_si128((const __m128i*)&Crit[i]);
+    shift = _mm_sub_epi32(_mm_set1_epi32(max),
+                          _mm_srai_epi32(_mm_unpacklo_epi16(shift, shift), 16));
+    crit = ShiftRightVariable(crit, Min32(shift, _mm_set1_epi32(16)));
+    _mm_storeu_si128((__m128i*)&Crit[i], crit);
+    crit_max = Max32(crit_max, crit);
+  }
+  critMax = HorizontalMax32(crit_max);
+  for (; i < range; i++) {
+    int16_t tmp16 = WEBRTC_SPL_MIN(16, max - inverseEnergyShift[i]);
+    Crit[i] = WEBRTC_SPL_SHIFT_W32(Crit[i], -tmp16);
+    critMax = WEBRTC_SPL_MAX(critMax, Crit[i]);
+  }
+
+  /* Find the index of the best value, the first one equal to the maximum
+     as in WebRtcSpl_MaxIndexW32(). */
+  for (i = 0; i + 4 <= range; i += 4) {
+    int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(
+        _mm_loadu_si128((const __m128i*)&Crit[i]), _mm_set1_epi32(critMax))));
+    if (mask != 0) {
+      break;
+    }
+  }
+  while (i < range && Crit[i] != critMax) {
+    i++;
+  }
+  *bestIndex = i < range ? i : 0;
+  *bestCrit = Crit[*bestIndex];
+
+  /* Calculate total shifts of this criteria */
+  *bestCritSh = 32 - 2*sh + max;
+}
+
+/* Eight outputs of the 8-tap filter in WebRtcSpl_FilterMAFastQ12(). The taps
+ * are applied in pairs with _mm_madd_epi16. The sum is rounded to Q0 as
+ * ((o >> 1) + 1024) >> 11, which equals (o + 2048) >> 12 without the risk of
+ * overflow, and _mm_packs_epi32 then saturates it the way the C code
+ * saturates o. */
+static __inline __m128i FilterMAFastQ12x8(const int16_t* in,
+                                          const __m128i* taps) {
+  __m128i lo = _mm_setzero_si128();
+  __m128i hi = _mm_setzero_si128();
+  int j;
+  for (j = 0; j < CB_FILTERLEN; j += 2) {
+    __m128i a = _mm_loadu_si128((const __m128i*)(in - j));
+    __m128i b = _mm_loadu_si128((const __m128i*)(in - j - 1));
+    lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(a, b),
+                                          taps[j / 2]));
+    hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(a, b),
+                                          taps[j / 2]));
+  }
+  lo = _mm_srai_epi32(
+      _mm_add_epi32(_mm_srai_epi32(lo, 1), _mm_set1_epi32(1024)), 11);
+  hi = _mm_srai_epi32(
+      _mm_add_epi32(_mm_srai_epi32(hi, 1), _mm_set1_epi32(1024)), 11);
+  return _mm_packs_epi32(lo, hi);
+}
+
+void WebRtcIlbcfix_FilteredCbVecsSSE2(int16_t* cbvectors,
+                                      int16_t* CBmem,
+                                      size_t lMem,
+                                      size_t samples) {
+  const int16_t* B = WebRtcIlbcfix_kCbFiltersRev;
+  const int16_t* in = CBmem + CB_HALFFILTERLEN + lMem - samples;
+  int16_t* out = cbvectors + lMem - samples;
+  __m128i taps[CB_FILTERLEN / 2];
+  size_t i;
+  int j;
+
+  if (samples < 8) {
+    WebRtcIlbcfix_FilteredCbVecsC(cbvectors, CBmem, lMem, samples);
+    return;
+  }
+
+  /* Set up the memory, start with zero state */
+  WebRtcSpl_MemSetW16(CBmem+lMem, 0, CB_HALFFILTERLEN);
+  WebRtcSpl_MemSetW16(CBmem-CB_HALFFILTERLEN, 0, CB_HALFFILTERLEN);
+  WebRtcSpl_MemSetW16(cbvectors, 0, lMem-samples);
+
+  for (j = 0; j < CB_FILTERLEN; j += 2) {
+    taps[j / 2] = _mm_set1_epi32(
+        (int32_t)(((uint32_t)(uint16_t)B[j + 1] << 16) | (uint16_t)B[j]));
+  }
+
+  /* The outputs only depend on the input, so the last block may overlap the
+     one before it. */
+  for (i = 0; i + 8 <= samples; i += 8) {
+    _mm_storeu_si128((__m128i*)&out[i], FilterMAFastQ12x8(&in[i], taps));
+  }
+  if (i < samples) {
+    _mm_storeu_si128((__m128i*)&out[samples - 8],
+                     FilterMAFastQ12x8(&in[samples - 8], taps));
+  }
+}
@@ -18,6 +18,9 @@
 
 #include "modules/audio_coding/codecs/ilbc/defines.h"
 #include "modules/audio_coding/codecs/ilbc/constants.h"
+#include "modules/audio_coding/codecs/ilbc/filtered_cb_vecs.h"
+
+FilteredCbVecs WebRtcIlbcfix_FilteredCbVecs;
 
 /*----------------------------------------------------------------*
  *  Construct an additional codebook vector by filtering the
@@ -25,7 +28,7 @@
  *  the codebook with an additional section.
  *---------------------------------------------------------------*/
 
-void WebRtcIlbcfix_FilteredCbVecs(
+void WebRtcIlbcfix_FilteredCbVecsC(
     int16_t *cbvectors, /* (o) Codebook vector for the higher section */
     int16_t *CBmem,  /* (i) Codebook memory that is filtered to create a
                                            second CB section */
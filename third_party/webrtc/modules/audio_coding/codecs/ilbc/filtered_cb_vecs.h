@@ -27,7 +27,7 @@
  *  the codebook with an additional section.
  *---------------------------------------------------------------*/
 
-void WebRtcIlbcfix_FilteredCbVecs(
+typedef void (*FilteredCbVecs)(
     int16_t* cbvectors, /* (o) Codebook vector for the higher section */
     int16_t* CBmem,     /* (i) Codebook memory that is filtered to create a
                                               second CB section */
@@ -35,4 +35,25 @@ void WebRtcIlbcfix_FilteredCbVecs(
     size_t samples      /* (i) Number of samples to filter */
     );
 
+/* Function pointer set by WebRtcIlbcfix_InitEncode(). */
+extern FilteredCbVecs WebRtcIlbcfix_FilteredCbVecs;
+
+void WebRtcIlbcfix_FilteredCbVecsC(int16_t* cbvectors,
+                                   int16_t* CBmem,
+                                   size_t lMem,
+                                   size_t samples);
+
+/* The x86 versions are defined in cb_search_sse2.c and cb_search_avx2.c and
+ * are bit-exact with the C version. */
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcIlbcfix_FilteredCbVecsSSE2(int16_t* cbvectors,
+                                      int16_t* CBmem,
+                                      size_t lMem,
+                                      size_t samples);
+void WebRtcIlbcfix_FilteredCbVecsAVX2(int16_t* cbvectors,
+                                      int16_t* CBmem,
+                                      size_t lMem,
+                                      size_t samples);
+#endif
+
 #endif
@@ -18,6 +18,36 @@
 
 #include "modules/audio_coding/codecs/ilbc/defines.h"
 #include "modules/audio_coding/codecs/ilbc/constants.h"
+#include "modules/audio_coding/codecs/ilbc/augmented_cb_corr.h"
+#include "modules/audio_coding/codecs/ilbc/cb_search_core.h"
+#include "modules/audio_coding/codecs/ilbc/filtered_cb_vecs.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+/*----------------------------------------------------------------*
+ *  Select the codebook search functions for this CPU. The AVX2
+ *  set keeps the SSE2 augmented correlation, whose dot products
+ *  are too short to fill 256 bits. WebRtcIlbcfix_CbMemEnergyCalc
+ *  stays scalar: its clamped recursion measured no faster with
+ *  SSE2.
+ *---------------------------------------------------------------*/
+
+static void InitCbSearchFunctions(void) {
+  WebRtcIlbcfix_AugmentedCbCorr = WebRtcIlbcfix_AugmentedCbCorrC;
+  WebRtcIlbcfix_CbSearchCore = WebRtcIlbcfix_CbSearchCoreC;
+  WebRtcIlbcfix_FilteredCbVecs = WebRtcIlbcfix_FilteredCbVecsC;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    WebRtcIlbcfix_AugmentedCbCorr = WebRtcIlbcfix_AugmentedCbCorrSSE2;
+    WebRtcIlbcfix_CbSearchCore = WebRtcIlbcfix_CbSearchCoreAVX2;
+    WebRtcIlbcfix_FilteredCbVecs = WebRtcIlbcfix_FilteredCbVecsAVX2;
+  } else if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcIlbcfix_AugmentedCbCorr = WebRtcIlbcfix_AugmentedCbCorrSSE2;
+    WebRtcIlbcfix_CbSearchCore = WebRtcIlbcfix_CbSearchCoreSSE2;
+    WebRtcIlbcfix_FilteredCbVecs = WebRtcIlbcfix_FilteredCbVecsSSE2;
+  }
+#endif
+}
 
 /*----------------------------------------------------------------*
  *  Initiation of encoder instance.
@@ -51,6 +81,8 @@ int WebRtcIlbcfix_InitEncode(  /* (o) Number of bytes encoded */
     return(-1);
   }
 
+  InitCbSearchFunctions();
+
   /* Clear the buffers and set the previous LSF and LSP to the mean value */
   WebRtcSpl_MemSetW16(iLBCenc_inst->anaMem, 0, LPC_FILTERORDER);
   WEBRTC_SPL_MEMCPY_W16(iLBCenc_inst->lsfold, WebRtcIlbcfix_kLsfMean, LPC_FILTERORDER);
@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/* This file contains WebRtcIsacfix_MatrixProduct1SSE41() and
+ * WebRtcIsacfix_MatrixProduct2SSE41() for x86 SSE4.1. API's are in
+ * entropy_coding.c. Results are bit exact with the c code for
+ * generic platforms.
+ */
+
+#include <smmintrin.h>
+
+#include "modules/audio_coding/codecs/isac/fix/source/entropy_coding.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "rtc_base/checks.h"
+
+// WEBRTC_SPL_MUL_16_32_RSFT16(a, b) on four lanes; |a| is sign-extended.
+static __inline __m128i Mul16x32Rsft16(__m128i a, __m128i b) {
+  const __m128i kLow16 = _mm_set1_epi32(0xffff);
+  __m128i hi = _mm_mullo_epi32(a, _mm_srai_epi32(b, 16));
+  __m128i lo = _mm_mullo_epi32(
+      a, _mm_srli_epi32(_mm_and_si128(b, kLow16), 1));
+  lo = _mm_srai_epi32(_mm_add_epi32(lo, _mm_set1_epi32(0x4000)), 15);
+  return _mm_add_epi32(hi, lo);
+}
+
+void WebRtcIsacfix_MatrixProduct1SSE41(const int16_t matrix0[],
+                                       const int32_t matrix1[],
+                                       int32_t matrix_product[],
+                                       const int matrix1_index_factor1,
+                                       const int matrix0_index_factor1,
+                                       const int matrix1_index_init_case,
+                                       const int matrix1_index_step,
+                                       const int matrix0_index_step,
+                                       const int inner_loop_count,
+                                       const int mid_loop_count,
+                                       const int shift) {
+  int j = 0, k = 0, n = 0;
+  int matrix0_index = 0, matrix1_index = 0, matrix_prod_index = 0;
+  int* matrix0_index_factor2 = &k;
+  int* matrix1_index_factor2 = &j;
+  const __m128i shift_v = _mm_cvtsi32_si128(shift);
+  if (matrix1_index_init_case != 0) {
+    matrix0_index_factor2 = &j;
+    matrix1_index_factor2 = &k;
+  }
+
+  for (j = 0; j < SUBFRAMES; j++) {
+    matrix_prod_index = mid_loop_count * j;
+    k = 0;
+    if (matrix1_index_init_case != 0 && matrix1_index_factor1 == 1) {
+      // matrix1 is read at consecutive indexes for consecutive k, while the
+      // matrix0 element is the same for all k.
+      for (; k + 4 <= mid_loop_count; k += 4) {
+        __m128i sum_v = _mm_setzero_si128();
+        matrix0_index = matrix0_index_factor1 * j;
+        matrix1_index = k;
+        for (n = 0; n < inner_loop_count; n++) {
+          __m128i matrix1_v = _mm_sll_epi32(
+              _mm_loadu_si128((const __m128i*)&matrix1[matrix1_index]),
+              shift_v);
+          sum_v = _mm_add_epi32(
+              sum_v, Mul16x32Rsft16(_mm_set1_epi32(matrix0[matrix0_index]),
+                                    matrix1_v));
+          matrix0_index += matrix0_index_step;
+          matrix1_index += matrix1_index_step;
+        }
+        _mm_storeu_si128((__m128i*)&matrix_product[matrix_prod_index], sum_v);
+        matrix_prod_index += 4;
+      }
+    } else if (matrix1_index_init_case == 0 && matrix0_index_factor1 == 1) {
+      // The same with the roles of matrix0 and matrix1 swapped.
+      for (; k + 4 <= mid_loop_count; k += 4) {
+        __m128i sum_v = _mm_setzero_si128();
+        matrix0_index = k;
+        matrix1_index = matrix1_index_factor1 * j;
+        for (n = 0; n < inner_loop_count; n++) {
+          __m128i matrix0_v = _mm_cvtepi16_epi32(
+              _mm_loadl_epi64((const __m128i*)&matrix0[matrix0_index]));
+          __m128i matrix1_v = _mm_sll_epi32(
+              _mm_set1_epi32(matrix1[matrix1_index]), shift_v);
+          sum_v = _mm_add_epi32(sum_v, Mul16x32Rsft16(matrix0_v, matrix1_v));
+          matrix0_index += matrix0_index_step;
+          matrix1_index += matrix1_index_step;
+        }
+        _mm_storeu_si128((__m128i*)&matrix_product[matrix_prod_index], sum_v);
+        matrix_prod_index += 4;
+      }
+    }
+
+    for (; k < mid_loop_count; k++) {
+      int32_t sum32 = 0;
+      matrix0_index = matrix0_index_factor1 * (*matrix0_index_factor2);
+      matrix1_index = matrix1_index_factor1 * (*matrix1_index_factor2);
+      for (n = 0; n < inner_loop_count; n++) {
+        sum32 += WEBRTC_SPL_MUL_16_32_RSFT16(
+            matrix0[matrix0_index], matrix1[matrix1_index] * (1 << shift));
+        matrix0_index += matrix0_index_step;
+        matrix1_index += matrix1_index_step;
+      }
+      matrix_product[matrix_prod_index] = sum32;
+      matrix_prod_index++;
+    }
+  }
+}
+
+// Two rows of the product at a time, in the lanes {j, j, j + 1, j + 1} for
+// the two columns of matrix1.
+void WebRtcIsacfix_MatrixProduct2SSE41(const int16_t matrix0[],
+                                       const int32_t matrix1[],
+                                       int32_t matrix_product[],
+                                       const int matrix0_index_factor,
+                                       const int matrix0_index_step) {
+  int j = 0, n = 0;
+  int matrix1_index = 0, matrix0_index = 0;
+  RTC_DCHECK_EQ(0, SUBFRAMES % 2);
+  for (j = 0; j < SUBFRAMES; j += 2) {
+    __m128i sum_v = _mm_setzero_si128();
+    matrix1_index = 0;
+    matrix0_index = matrix0_index_factor * j;
+    for (n = SUBFRAMES; n > 0; n--) {
+      __m128i matrix1_v =
+          _mm_loadl_epi64((const __m128i*)&matrix1[matrix1_index]);
+      __m128i matrix0_v = _mm_set_epi32(
+          matrix0[matrix0_index + matrix0_index_factor],
+          matrix0[matrix0_index + matrix0_index_factor],
+          matrix0[matrix0_index], matrix0[matrix0_index]);
+      matrix1_v = _mm_unpacklo_epi64(matrix1_v, matrix1_v);
+      sum_v = _mm_add_epi32(sum_v, Mul16x32Rsft16(matrix0_v, matrix1_v));
+      matrix1_index += 2;
+      matrix0_index += matrix0_index_step;
+    }
+    _mm_storeu_si128((__m128i*)&matrix_product[2 * j],
+                     _mm_srai_epi32(sum_v, 3));
+  }
+}
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This file must be compiled with AVX2 enabled (-mavx2); it is only called
+// after WebRtc_GetCPUInfo(kAVX2) succeeded.
+
+#include <immintrin.h>
+
+#include "rtc_base/checks.h"
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+
+// Sum of a[n] * b[n] in 64 bits. See DotProductW16() in filters_sse41.c for
+// how the single _mm256_madd_epi16() overflow case is corrected.
+static int64_t DotProductW16(const int16_t* a, const int16_t* b, int length) {
+  const __m256i kWrapped = _mm256_set1_epi32(INT32_MIN);
+  __m256i sum_lo = _mm256_setzero_si256();
+  __m256i sum_hi = _mm256_setzero_si256();
+  __m256i wraps = _mm256_setzero_si256();
+  __m128i sum;
+  __m128i wraps128;
+  int64_t prod = 0;
+  int n = 0;
+
+  for (; n + 16 <= length; n += 16) {
+    __m256i a_v = _mm256_loadu_si256((const __m256i*)&a[n]);
+    __m256i b_v = _mm256_loadu_si256((const __m256i*)&b[n]);
+    __m256i pairs = _mm256_madd_epi16(a_v, b_v);
+    sum_lo = _mm256_add_epi64(
+        sum_lo, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pairs)));
+    sum_hi = _mm256_add_epi64(
+        sum_hi, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pairs, 1)));
+    wraps = _mm256_sub_epi32(wraps, _mm256_cmpeq_epi32(pairs, kWrapped));
+  }
+  sum_lo = _mm256_add_epi64(sum_lo, sum_hi);
+  sum = _mm_add_epi64(_mm256_castsi256_si128(sum_lo),
+                      _mm256_extracti128_si256(sum_lo, 1));
+  sum = _mm_add_epi64(sum, _mm_srli_si128(sum, 8));
+  _mm_storel_epi64((__m128i*)&prod, sum);
+  wraps128 = _mm_add_epi32(_mm256_castsi256_si128(wraps),
+                           _mm256_extracti128_si256(wraps, 1));
+  wraps128 = _mm_add_epi32(wraps128, _mm_srli_si128(wraps128, 8));
+  wraps128 = _mm_add_epi32(wraps128, _mm_srli_si128(wraps128, 4));
+  prod += (int64_t)_mm_cvtsi128_si32(wraps128) << 32;
+
+  for (; n < length; n++) {
+    prod += a[n] * b[n];
+  }
+  return prod;
+}
+
+// Autocorrelation function in fixed point.
+// NOTE! Different from SPLIB-version in how it scales the signal.
+int WebRtcIsacfix_AutocorrAVX2(int32_t* __restrict r,
+                               const int16_t* __restrict x,
+                               int16_t N,
+                               int16_t order,
+                               int16_t* __restrict scale) {
+  int i = 0;
+  int16_t scaling = 0;
+  uint32_t temp = 0;
+  int64_t prod = 0;
+
+  RTC_DCHECK_EQ(0, N % 4);
+  RTC_DCHECK_GE(N, 8);
+
+  // Calculate r[0].
+  prod = DotProductW16(x, x, N);
+
+  // Calculate scaling (the value of shifting).
+  temp = (uint32_t)(prod >> 31);
+  scaling = temp ? 32 - WebRtcSpl_NormU32(temp) : 0;
+  r[0] = (int32_t)(prod >> scaling);
+
+  // Perform the actual correlation calculation.
+  for (i = 1; i < order + 1; i++) {
+    prod = DotProductW16(x, x + i, N - i);
+    r[i] = (int32_t)(prod >> scaling);
+  }
+
+  *scale = scaling;
+
+  return order + 1;
+}
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <smmintrin.h>
+
+#include "rtc_base/checks.h"
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+
+// Sum of a[n] * b[n] in 64 bits, like the int64_t accumulation in
+// WebRtcIsacfix_AutocorrC(). _mm_madd_epi16() adds two products in 32 bits,
+// which only overflows for (-32768 * -32768) * 2 = 2^31, and then gives
+// INT32_MIN, a sum no other input pair can produce. Those lanes are counted
+// and 2^32 is added back per occurrence.
+static int64_t DotProductW16(const int16_t* a, const int16_t* b, int length) {
+  const __m128i kWrapped = _mm_set1_epi32(INT32_MIN);
+  __m128i sum_lo = _mm_setzero_si128();
+  __m128i sum_hi = _mm_setzero_si128();
+  __m128i wraps = _mm_setzero_si128();
+  int64_t prod = 0;
+  int n = 0;
+
+  for (; n + 8 <= length; n += 8) {
+    __m128i a_v = _mm_loadu_si128((const __m128i*)&a[n]);
+    __m128i b_v = _mm_loadu_si128((const __m128i*)&b[n]);
+    __m128i pairs = _mm_madd_epi16(a_v, b_v);
+    sum_lo = _mm_add_epi64(sum_lo, _mm_cvtepi32_epi64(pairs));
+    sum_hi = _mm_add_epi64(sum_hi,
+                           _mm_cvtepi32_epi64(_mm_srli_si128(pairs, 8)));
+    wraps = _mm_sub_epi32(wraps, _mm_cmpeq_epi32(pairs, kWrapped));
+  }
+  sum_lo = _mm_add_epi64(sum_lo, sum_hi);
+  sum_lo = _mm_add_epi64(sum_lo, _mm_srli_si128(sum_lo, 8));
+  _mm_storel_epi64((__m128i*)&prod, sum_lo);
+  wraps = _mm_add_epi32(wraps, _mm_srli_si128(wraps, 8));
+  wraps = _mm_add_epi32(wraps, _mm_srli_si128(wraps, 4));
+  prod += (int64_t)_mm_cvtsi128_si32(wraps) << 32;
+
+  for (; n < length; n++) {
+    prod += a[n] * b[n];
+  }
+  return prod;
+}
+
+// Autocorrelation function in fixed point.
+// NOTE! Different from SPLIB-version in how it scales the signal.
+int WebRtcIsacfix_AutocorrSSE41(int32_t* __restrict r,
+                                const int16_t* __restrict x,
+                                int16_t N,
+                                int16_t order,
+                                int16_t* __restrict scale) {
+  int i = 0;
+  int16_t scaling = 0;
+  uint32_t temp = 0;
+  int64_t prod = 0;
+
+  RTC_DCHECK_EQ(0, N % 4);
+  RTC_DCHECK_GE(N, 8);
+
+  // Calculate r[0].
+  prod = DotProductW16(x, x, N);
+
+  // Calculate scaling (the value of shifting).
+  temp = (uint32_t)(prod >> 31);
+  scaling = temp ? 32 - WebRtcSpl_NormU32(temp) : 0;
+  r[0] = (int32_t)(prod >> scaling);
+
+  // Perform the actual correlation calculation.
+  for (i = 1; i < order + 1; i++) {
+    prod = DotProductW16(x, x + i, N - i);
+    r[i] = (int32_t)(prod >> scaling);
+  }
+
+  *scale = scaling;
+
+  return order + 1;
+}
@@ -241,6 +241,35 @@ static void WebRtcIsacfix_InitMIPS(void) {
 }
 #endif
 
+/****************************************************************************
+ * WebRtcIsacfix_InitSSE41(...)
+ * WebRtcIsacfix_InitAVX2(...)
+ *
+ * These functions initialize function pointers for x86 platforms. The AVX2
+ * set keeps the SSE4.1 matrix products, which work on fewer than eight values
+ * at a time. AllpassFilter2FixDec16 stays on C: its recursion leaves nothing
+ * to vectorize beyond the four filter sections C already interleaves.
+ */
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+static void WebRtcIsacfix_InitSSE41(void) {
+  WebRtcIsacfix_AutocorrFix = WebRtcIsacfix_AutocorrSSE41;
+  WebRtcIsacfix_FilterMaLoopFix = WebRtcIsacfix_FilterMaLoopSSE41;
+  WebRtcIsacfix_Spec2Time = WebRtcIsacfix_Spec2TimeSSE41;
+  WebRtcIsacfix_Time2Spec = WebRtcIsacfix_Time2SpecSSE41;
+  WebRtcIsacfix_MatrixProduct1 = WebRtcIsacfix_MatrixProduct1SSE41;
+  WebRtcIsacfix_MatrixProduct2 = WebRtcIsacfix_MatrixProduct2SSE41;
+}
+
+static void WebRtcIsacfix_InitAVX2(void) {
+  WebRtcIsacfix_InitSSE41();
+  WebRtcIsacfix_AutocorrFix = WebRtcIsacfix_AutocorrAVX2;
+  WebRtcIsacfix_FilterMaLoopFix = WebRtcIsacfix_FilterMaLoopAVX2;
+  WebRtcIsacfix_Spec2Time = WebRtcIsacfix_Spec2TimeAVX2;
+  WebRtcIsacfix_Time2Spec = WebRtcIsacfix_Time2SpecAVX2;
+}
+#endif
+
 static void InitFunctionPointers(void) {
   WebRtcIsacfix_AutocorrFix = WebRtcIsacfix_AutocorrC;
   WebRtcIsacfix_FilterMaLoopFix = WebRtcIsacfix_FilterMaLoopC;
@@ -257,6 +286,14 @@ static void InitFunctionPointers(void) {
   WebRtcIsacfix_InitNeon();
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kSSE4_1)) {
+    WebRtcIsacfix_InitAVX2();
+  } else if (WebRtc_GetCPUInfo(kSSE4_1)) {
+    WebRtcIsacfix_InitSSE41();
+  }
+#endif
+
 #if defined(MIPS32_LE)
   WebRtcIsacfix_InitMIPS();
 #endif
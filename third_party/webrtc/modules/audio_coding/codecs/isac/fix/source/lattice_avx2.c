@@ -0,0 +1,93 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// The core loop of the normalized lattice MA filter for AVX2, bit-exact with
+// the C version. See lattice_sse41.c for the arithmetic.
+//
+// This file must be compiled with AVX2 enabled (-mavx2); it is only called
+// after WebRtc_GetCPUInfo(kAVX2) succeeded.
+
+#include <immintrin.h>
+
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "modules/audio_coding/codecs/isac/fix/source/settings.h"
+
+// WEBRTC_SPL_MUL_16_32_RSFT15(a, b) on eight lanes; |a| is sign-extended.
+static __inline __m256i Mul16x32Rsft15(__m256i a, __m256i b) {
+  const __m256i kLow16 = _mm256_set1_epi32(0xffff);
+  __m256i hi = _mm256_mullo_epi32(a, _mm256_srai_epi32(b, 16));
+  __m256i lo = _mm256_mullo_epi32(a, _mm256_and_si256(b, kLow16));
+  lo = _mm256_add_epi32(_mm256_srai_epi32(lo, 1), _mm256_set1_epi32(0x2000));
+  return _mm256_add_epi32(_mm256_slli_epi32(hi, 1),
+                          _mm256_srai_epi32(lo, 14));
+}
+
+// LATTICE_MUL_32_32_RSFT16(a_hi, a_lo, b) on eight lanes.
+static __inline __m256i LatticeMul(__m256i a_hi, __m256i a_lo, __m256i b) {
+  const __m256i kLow16 = _mm256_set1_epi32(0xffff);
+  __m256i hi = _mm256_mullo_epi32(a_lo, _mm256_srai_epi32(b, 16));
+  __m256i lo = _mm256_mullo_epi32(
+      a_lo, _mm256_srli_epi32(_mm256_and_si256(b, kLow16), 1));
+  lo = _mm256_srai_epi32(_mm256_add_epi32(lo, _mm256_set1_epi32(0x4000)), 15);
+  return _mm256_add_epi32(_mm256_mullo_epi32(a_hi, b),
+                          _mm256_add_epi32(hi, lo));
+}
+
+void WebRtcIsacfix_FilterMaLoopAVX2(int16_t input0,  // Filter coefficient
+                                    int16_t input1,  // Filter coefficient
+                                    int32_t input2,  // Inverse coefficient
+                                    int32_t* ptr0,   // Sample buffer
+                                    int32_t* ptr1,   // Sample buffer
+                                    int32_t* ptr2)   // Sample buffer
+{
+  int n = 0;
+
+  // Separate the 32-bit variable input2 into two 16-bit integers (high 16 and
+  // low 16 bits), for using LATTICE_MUL_32_32_RSFT16 in the loop.
+  int16_t t16a = (int16_t)(input2 >> 16);
+  int16_t t16b = (int16_t)input2;
+  if (t16b < 0) t16a++;
+
+  const __m256i input0_v = _mm256_set1_epi32(input0);
+  const __m256i input1_v = _mm256_set1_epi32(input1);
+  const __m256i t16a_v = _mm256_set1_epi32(t16a);
+  const __m256i t16b_v = _mm256_set1_epi32(t16b);
+
+  for (; n + 8 <= HALF_SUBFRAMELEN - 1; n += 8) {
+    __m256i ptr0_v = _mm256_loadu_si256((const __m256i*)&ptr0[n]);
+    __m256i ptr2_v = _mm256_loadu_si256((const __m256i*)&ptr2[n]);
+
+    // Calculate *ptr2 = input2 * (*ptr2 + input0 * (*ptr0)).
+    ptr2_v = _mm256_add_epi32(ptr2_v, Mul16x32Rsft15(input0_v, ptr0_v));
+    ptr2_v = LatticeMul(t16a_v, t16b_v, ptr2_v);
+    _mm256_storeu_si256((__m256i*)&ptr2[n], ptr2_v);
+
+    // Calculate *ptr1 = input1 * (*ptr0) + input0 * (*ptr2).
+    _mm256_storeu_si256((__m256i*)&ptr1[n],
+                        _mm256_add_epi32(Mul16x32Rsft15(input1_v, ptr0_v),
+                                         Mul16x32Rsft15(input0_v, ptr2_v)));
+  }
+
+  for (; n < HALF_SUBFRAMELEN - 1; n++) {
+    int32_t tmp32a = 0;
+    int32_t tmp32b = 0;
+
+    // Calculate *ptr2 = input2 * (*ptr2 + input0 * (*ptr0)).
+    tmp32a = WEBRTC_SPL_MUL_16_32_RSFT15(input0, ptr0[n]);
+    tmp32b = ptr2[n] + tmp32a;
+    ptr2[n] = (int32_t)(WEBRTC_SPL_MUL(t16a, tmp32b) +
+                        (WEBRTC_SPL_MUL_16_32_RSFT16(t16b, tmp32b)));
+
+    // Calculate *ptr1 = input1 * (*ptr0) + input0 * (*ptr2).
+    tmp32a = WEBRTC_SPL_MUL_16_32_RSFT15(input1, ptr0[n]);
+    tmp32b = WEBRTC_SPL_MUL_16_32_RSFT15(input0, ptr2[n]);
+    ptr1[n] = tmp32a + tmp32b;
+  }
+}
@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Contains a function for the core loop in the normalized lattice MA
+// filter routine for iSAC codec, optimized for x86 SSE4.1. It does:
+//  for 0 <= n < HALF_SUBFRAMELEN - 1:
+//    *ptr2 = input2 * ((*ptr2) + input0 * (*ptr0));
+//    *ptr1 = input1 * (*ptr0) + input0 * (*ptr2);
+// Unlike the Neon version, the output is bit-exact with the C version: the
+// 16x32 bit products are split into the same two 16x16 bit halves as
+// WEBRTC_SPL_MUL_16_32_RSFT15 and LATTICE_MUL_32_32_RSFT16.
+
+#include <smmintrin.h>
+
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "modules/audio_coding/codecs/isac/fix/source/settings.h"
+
+// WEBRTC_SPL_MUL_16_32_RSFT15(a, b) on four lanes; |a| is sign-extended.
+static __inline __m128i Mul16x32Rsft15(__m128i a, __m128i b) {
+  const __m128i kLow16 = _mm_set1_epi32(0xffff);
+  __m128i hi = _mm_mullo_epi32(a, _mm_srai_epi32(b, 16));
+  __m128i lo = _mm_mullo_epi32(a, _mm_and_si128(b, kLow16));
+  lo = _mm_add_epi32(_mm_srai_epi32(lo, 1), _mm_set1_epi32(0x2000));
+  return _mm_add_epi32(_mm_slli_epi32(hi, 1), _mm_srai_epi32(lo, 14));
+}
+
+// LATTICE_MUL_32_32_RSFT16(a_hi, a_lo, b) on four lanes, with the 32-bit
+// coefficient split into |a_hi| and |a_lo| as in the C version.
+static __inline __m128i LatticeMul(__m128i a_hi, __m128i a_lo, __m128i b) {
+  const __m128i kLow16 = _mm_set1_epi32(0xffff);
+  __m128i hi = _mm_mullo_epi32(a_lo, _mm_srai_epi32(b, 16));
+  __m128i lo = _mm_mullo_epi32(
+      a_lo, _mm_srli_epi32(_mm_and_si128(b, kLow16), 1));
+  lo = _mm_srai_epi32(_mm_add_epi32(lo, _mm_set1_epi32(0x4000)), 15);
+  return _mm_add_epi32(_mm_mullo_epi32(a_hi, b), _mm_add_epi32(hi, lo));
+}
+
+void WebRtcIsacfix_FilterMaLoopSSE41(int16_t input0,  // Filter coefficient
+                                     int16_t input1,  // Filter coefficient
+                                     int32_t input2,  // Inverse coefficient
+                                     int32_t* ptr0,   // Sample buffer
+                                     int32_t* ptr1,   // Sample buffer
+                                     int32_t* ptr2)   // Sample buffer
+{
+  int n = 0;
+
+  // Separate the 32-bit variable input2 into two 16-bit integers (high 16 and
+  // low 16 bits), for using LATTICE_MUL_32_32_RSFT16 in the loop.
+  int16_t t16a = (int16_t)(input2 >> 16);
+  int16_t t16b = (int16_t)input2;
+  if (t16b < 0) t16a++;
+
+  const __m128i input0_v = _mm_set1_epi32(input0);
+  const __m128i input1_v = _mm_set1_epi32(input1);
+  const __m128i t16a_v = _mm_set1_epi32(t16a);
+  const __m128i t16b_v = _mm_set1_epi32(t16b);
+
+  for (; n + 4 <= HALF_SUBFRAMELEN - 1; n += 4) {
+    __m128i ptr0_v = _mm_loadu_si128((const __m128i*)&ptr0[n]);
+    __m128i ptr2_v = _mm_loadu_si128((const __m128i*)&ptr2[n]);
+
+    // Calculate *ptr2 = input2 * (*ptr2 + input0 * (*ptr0)).
+    ptr2_v = _mm_add_epi32(ptr2_v, Mul16x32Rsft15(input0_v, ptr0_v));
+    ptr2_v = LatticeMul(t16a_v, t16b_v, ptr2_v);
+    _mm_storeu_si128((__m128i*)&ptr2[n], ptr2_v);
+
+    // Calculate *ptr1 = input1 * (*ptr0) + input0 * (*ptr2).
+    _mm_storeu_si128((__m128i*)&ptr1[n],
+                     _mm_add_epi32(Mul16x32Rsft15(input1_v, ptr0_v),
+                                   Mul16x32Rsft15(input0_v, ptr2_v)));
+  }
+
+  for (; n < HALF_SUBFRAMELEN - 1; n++) {
+    int32_t tmp32a = 0;
+    int32_t tmp32b = 0;
+
+    // Calculate *ptr2 = input2 * (*ptr2 + input0 * (*ptr0)).
+    tmp32a = WEBRTC_SPL_MUL_16_32_RSFT15(input0, ptr0[n]);
+    tmp32b = ptr2[n] + tmp32a;
+    ptr2[n] = (int32_t)(WEBRTC_SPL_MUL(t16a, tmp32b) +
+                        (WEBRTC_SPL_MUL_16_32_RSFT16(t16b, tmp32b)));
+
+    // Calculate *ptr1 = input1 * (*ptr0) + input0 * (*ptr2).
+    tmp32a = WEBRTC_SPL_MUL_16_32_RSFT15(input1, ptr0[n]);
+    tmp32b = WEBRTC_SPL_MUL_16_32_RSFT15(input0, ptr2[n]);
+    ptr1[n] = tmp32a + tmp32b;
+  }
+}
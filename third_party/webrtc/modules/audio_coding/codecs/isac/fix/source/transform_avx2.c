@@ -0,0 +1,276 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * WebRtcIsacfix_Time2Spec() and WebRtcIsacfix_Spec2Time() for x86 AVX2, on
+ * eight samples at a time and bit-exact with transform.c. See
+ * transform_sse41.c.
+ *
+ * This file must be compiled with AVX2 enabled (-mavx2); it is only called
+ * after WebRtc_GetCPUInfo(kAVX2) succeeded.
+ */
+
+#include <immintrin.h>
+
+#include "modules/audio_coding/codecs/isac/fix/source/codec.h"
+#include "modules/audio_coding/codecs/isac/fix/source/fft.h"
+#include "modules/audio_coding/codecs/isac/fix/source/settings.h"
+
+/* Tables are defined in transform_tables.c file. */
+/* Cosine table 1 in Q14 */
+extern const int16_t WebRtcIsacfix_kCosTab1[FRAMESAMPLES/2];
+/* Sine table 1 in Q14 */
+extern const int16_t WebRtcIsacfix_kSinTab1[FRAMESAMPLES/2];
+/* Sine table 2 in Q14 */
+extern const int16_t WebRtcIsacfix_kSinTab2[FRAMESAMPLES/4];
+
+// Eight int16_t at |p|, sign-extended.
+static __inline __m256i LoadW16(const int16_t* p) {
+  return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)p));
+}
+
+static __inline __m256i Reverse(__m256i v) {
+  return _mm256_permutevar8x32_epi32(v,
+                                     _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+// Eight int16_t ending at |p|, in reverse order: {p[0], p[-1], ..., p[-7]}.
+static __inline __m256i LoadReversedW16(const int16_t* p) {
+  return Reverse(LoadW16(p - 7));
+}
+
+static __inline __m256i LoadReversedW32(const int32_t* p) {
+  return Reverse(_mm256_loadu_si256((const __m256i*)(p - 7)));
+}
+
+// Stores {v[0], ..., v[7]} at p[0], p[-1], ..., p[-7].
+static __inline void StoreReversedW32(int32_t* p, __m256i v) {
+  _mm256_storeu_si256((__m256i*)(p - 7), Reverse(v));
+}
+
+// (int16_t) casts of eight lanes, stored at |p|.
+static __inline void StoreTruncatedW16(int16_t* p, __m256i v) {
+  v = _mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16);
+  // Packing works per 128-bit lane; gather the two low quarters.
+  v = _mm256_permute4x64_epi64(_mm256_packs_epi32(v, v), 0x08);
+  _mm_storeu_si128((__m128i*)p, _mm256_castsi256_si128(v));
+}
+
+static __inline void StoreReversedTruncatedW16(int16_t* p, __m256i v) {
+  StoreTruncatedW16(p - 7, Reverse(v));
+}
+
+// WEBRTC_SPL_MUL_16_32_RSFT16(a, b) on eight lanes; |a| is sign-extended.
+static __inline __m256i Mul16x32Rsft16(__m256i a, __m256i b) {
+  const __m256i kLow16 = _mm256_set1_epi32(0xffff);
+  __m256i hi = _mm256_mullo_epi32(a, _mm256_srai_epi32(b, 16));
+  __m256i lo = _mm256_mullo_epi32(
+      a, _mm256_srli_epi32(_mm256_and_si256(b, kLow16), 1));
+  lo = _mm256_srai_epi32(_mm256_add_epi32(lo, _mm256_set1_epi32(0x4000)), 15);
+  return _mm256_add_epi32(hi, lo);
+}
+
+// WEBRTC_SPL_MUL_16_32_RSFT14(a, b) on eight lanes.
+static __inline __m256i Mul16x32Rsft14(__m256i a, __m256i b) {
+  const __m256i kLow16 = _mm256_set1_epi32(0xffff);
+  __m256i hi = _mm256_mullo_epi32(a, _mm256_srai_epi32(b, 16));
+  __m256i lo = _mm256_mullo_epi32(a, _mm256_and_si256(b, kLow16));
+  lo = _mm256_add_epi32(_mm256_srai_epi32(lo, 1), _mm256_set1_epi32(0x1000));
+  return _mm256_add_epi32(_mm256_slli_epi32(hi, 2),
+                          _mm256_srai_epi32(lo, 13));
+}
+
+// WEBRTC_SPL_MUL_16_32_RSFT11(a, b) on eight lanes.
+static __inline __m256i Mul16x32Rsft11(__m256i a, __m256i b) {
+  const __m256i kLow16 = _mm256_set1_epi32(0xffff);
+  __m256i hi = _mm256_mullo_epi32(a, _mm256_srai_epi32(b, 16));
+  __m256i lo = _mm256_mullo_epi32(a, _mm256_and_si256(b, kLow16));
+  lo = _mm256_add_epi32(_mm256_srai_epi32(lo, 1), _mm256_set1_epi32(0x0200));
+  return _mm256_add_epi32(_mm256_slli_epi32(hi, 5),
+                          _mm256_srai_epi32(lo, 10));
+}
+
+// Scales |re| and |im| to Q(16 + sh) in 16 bits, where sh makes the largest
+// magnitude use 8 bits of headroom, and returns sh.
+static int16_t ScaleToW16(const int32_t* re,
+                          const int32_t* im,
+                          int16_t* out_re,
+                          int16_t* out_im) {
+  int k;
+  int32_t max_re = WebRtcSpl_MaxAbsValueW32(re, FRAMESAMPLES/2);
+  int32_t max_im = WebRtcSpl_MaxAbsValueW32(im, FRAMESAMPLES/2);
+  int16_t sh = WebRtcSpl_NormW32(max_im > max_re ? max_im : max_re) - 24;
+
+  if (sh >= 0) {
+    const __m128i shift = _mm_cvtsi32_si128(sh);
+    for (k = 0; k < FRAMESAMPLES/2; k += 8) {
+      StoreTruncatedW16(&out_re[k], _mm256_sll_epi32(
+          _mm256_loadu_si256((const __m256i*)&re[k]), shift));
+      StoreTruncatedW16(&out_im[k], _mm256_sll_epi32(
+          _mm256_loadu_si256((const __m256i*)&im[k]), shift));
+    }
+  } else {
+    const __m128i shift = _mm_cvtsi32_si128(-sh);
+    const __m256i round = _mm256_set1_epi32(1 << (-sh - 1));
+    for (k = 0; k < FRAMESAMPLES/2; k += 8) {
+      StoreTruncatedW16(&out_re[k], _mm256_sra_epi32(_mm256_add_epi32(
+          _mm256_loadu_si256((const __m256i*)&re[k]), round), shift));
+      StoreTruncatedW16(&out_im[k], _mm256_sra_epi32(_mm256_add_epi32(
+          _mm256_loadu_si256((const __m256i*)&im[k]), round), shift));
+    }
+  }
+  return sh;
+}
+
+// Brings eight FFT outputs from Q(16 + sh) back to Q16.
+static __inline __m256i UnscaleW16(const int16_t* p, int16_t sh) {
+  if (sh >= 0) {
+    return _mm256_sra_epi32(LoadW16(p), _mm_cvtsi32_si128(sh));
+  }
+  return _mm256_sll_epi32(LoadW16(p), _mm_cvtsi32_si128(-sh));
+}
+
+void WebRtcIsacfix_Time2SpecAVX2(int16_t* inre1Q9,
+                                 int16_t* inre2Q9,
+                                 int16_t* outreQ7,
+                                 int16_t* outimQ7) {
+  int k;
+  int32_t tmpreQ16[FRAMESAMPLES/2], tmpimQ16[FRAMESAMPLES/2];
+  int16_t sh;
+  const __m256i factQ19 = _mm256_set1_epi32(16921);  // 0.5/sqrt(240) in Q19
+  const __m256i round4 = _mm256_set1_epi32(4);
+
+  /* Multiply with complex exponentials and combine into one complex vector */
+  for (k = 0; k < FRAMESAMPLES/2; k += 8) {
+    __m256i cos_v = LoadW16(&WebRtcIsacfix_kCosTab1[k]);
+    __m256i sin_v = LoadW16(&WebRtcIsacfix_kSinTab1[k]);
+    __m256i re1 = LoadW16(&inre1Q9[k]);
+    __m256i re2 = LoadW16(&inre2Q9[k]);
+    __m256i xr = _mm256_srai_epi32(
+        _mm256_add_epi32(_mm256_mullo_epi32(cos_v, re1),
+                         _mm256_mullo_epi32(sin_v, re2)), 7);
+    __m256i xi = _mm256_srai_epi32(
+        _mm256_sub_epi32(_mm256_mullo_epi32(cos_v, re2),
+                         _mm256_mullo_epi32(sin_v, re1)), 7);
+    // Q-domains below: (Q16*Q19>>16)>>3 = Q16
+    _mm256_storeu_si256((__m256i*)&tmpreQ16[k], _mm256_srai_epi32(
+        _mm256_add_epi32(Mul16x32Rsft16(factQ19, xr), round4), 3));
+    _mm256_storeu_si256((__m256i*)&tmpimQ16[k], _mm256_srai_epi32(
+        _mm256_add_epi32(Mul16x32Rsft16(factQ19, xi), round4), 3));
+  }
+
+  sh = ScaleToW16(tmpreQ16, tmpimQ16, inre1Q9, inre2Q9);
+
+  /* Get DFT */
+  WebRtcIsacfix_FftRadix16Fastest(inre1Q9, inre2Q9, -1); // real call
+
+  for (k = 0; k < FRAMESAMPLES/2; k += 8) {
+    _mm256_storeu_si256((__m256i*)&tmpreQ16[k], UnscaleW16(&inre1Q9[k], sh));
+    _mm256_storeu_si256((__m256i*)&tmpimQ16[k], UnscaleW16(&inre2Q9[k], sh));
+  }
+
+  /* Use symmetry to separate into two complex vectors and center frames in time around zero */
+  for (k = 0; k < FRAMESAMPLES/4; k += 8) {
+    __m256i re = _mm256_loadu_si256((const __m256i*)&tmpreQ16[k]);
+    __m256i im = _mm256_loadu_si256((const __m256i*)&tmpimQ16[k]);
+    __m256i re_rev = LoadReversedW32(&tmpreQ16[FRAMESAMPLES/2 - 1 - k]);
+    __m256i im_rev = LoadReversedW32(&tmpimQ16[FRAMESAMPLES/2 - 1 - k]);
+    __m256i xr = _mm256_add_epi32(re, re_rev);
+    __m256i yi = _mm256_sub_epi32(re_rev, re);
+    __m256i xi = _mm256_sub_epi32(im, im_rev);
+    __m256i yr = _mm256_add_epi32(im, im_rev);
+    __m256i tmp1r = _mm256_sub_epi32(_mm256_setzero_si256(), LoadReversedW16(
+        &WebRtcIsacfix_kSinTab2[FRAMESAMPLES/4 - 1 - k]));
+    __m256i tmp1i = LoadW16(&WebRtcIsacfix_kSinTab2[k]);
+    __m256i v1 = _mm256_sub_epi32(Mul16x32Rsft14(tmp1r, xr),
+                                  Mul16x32Rsft14(tmp1i, xi));
+    __m256i v2 = _mm256_add_epi32(Mul16x32Rsft14(tmp1i, xr),
+                                  Mul16x32Rsft14(tmp1r, xi));
+    StoreTruncatedW16(&outreQ7[k], _mm256_srai_epi32(v1, 9));
+    StoreTruncatedW16(&outimQ7[k], _mm256_srai_epi32(v2, 9));
+    v1 = _mm256_sub_epi32(_mm256_sub_epi32(_mm256_setzero_si256(),
+                                           Mul16x32Rsft14(tmp1i, yr)),
+                          Mul16x32Rsft14(tmp1r, yi));
+    v2 = _mm256_add_epi32(_mm256_sub_epi32(_mm256_setzero_si256(),
+                                           Mul16x32Rsft14(tmp1r, yr)),
+                          Mul16x32Rsft14(tmp1i, yi));
+    StoreReversedTruncatedW16(&outreQ7[FRAMESAMPLES/2 - 1 - k],
+                              _mm256_srai_epi32(v1, 9));
+    StoreReversedTruncatedW16(&outimQ7[FRAMESAMPLES/2 - 1 - k],
+                              _mm256_srai_epi32(v2, 9));
+  }
+}
+
+void WebRtcIsacfix_Spec2TimeAVX2(int16_t* inreQ7,
+                                 int16_t* inimQ7,
+                                 int32_t* outre1Q16,
+                                 int32_t* outre2Q16) {
+  int k;
+  int16_t sh;
+  const __m256i fact273 = _mm256_set1_epi32(273);  // 1/240 in Q16
+  const __m256i factQ11 = _mm256_set1_epi32(31727);  // sqrt(240) in Q11
+
+  for (k = 0; k < FRAMESAMPLES/4; k += 8) {
+    /* Move zero in time to beginning of frames */
+    __m256i tmp1r = _mm256_sub_epi32(_mm256_setzero_si256(), LoadReversedW16(
+        &WebRtcIsacfix_kSinTab2[FRAMESAMPLES/4 - 1 - k]));
+    __m256i tmp1i = LoadW16(&WebRtcIsacfix_kSinTab2[k]);
+    // Q7 -> Q16
+    __m256i in_re = _mm256_slli_epi32(LoadW16(&inreQ7[k]), 9);
+    __m256i in_im = _mm256_slli_epi32(LoadW16(&inimQ7[k]), 9);
+    __m256i in_re2 = _mm256_slli_epi32(
+        LoadReversedW16(&inreQ7[FRAMESAMPLES/2 - 1 - k]), 9);
+    __m256i in_im2 = _mm256_slli_epi32(
+        LoadReversedW16(&inimQ7[FRAMESAMPLES/2 - 1 - k]), 9);
+
+    __m256i xr = _mm256_add_epi32(Mul16x32Rsft14(tmp1r, in_re),
+                                  Mul16x32Rsft14(tmp1i, in_im));
+    __m256i xi = _mm256_sub_epi32(Mul16x32Rsft14(tmp1r, in_im),
+                                  Mul16x32Rsft14(tmp1i, in_re));
+    __m256i yr = _mm256_sub_epi32(
+        _mm256_sub_epi32(_mm256_setzero_si256(),
+                         Mul16x32Rsft14(tmp1r, in_im2)),
+        Mul16x32Rsft14(tmp1i, in_re2));
+    __m256i yi = _mm256_add_epi32(
+        _mm256_sub_epi32(_mm256_setzero_si256(),
+                         Mul16x32Rsft14(tmp1r, in_re2)),
+        Mul16x32Rsft14(tmp1i, in_im2));
+
+    /* Combine into one vector,  z = x + j * y */
+    _mm256_storeu_si256((__m256i*)&outre1Q16[k], _mm256_sub_epi32(xr, yi));
+    StoreReversedW32(&outre1Q16[FRAMESAMPLES/2 - 1 - k],
+                     _mm256_add_epi32(xr, yi));
+    _mm256_storeu_si256((__m256i*)&outre2Q16[k], _mm256_add_epi32(xi, yr));
+    StoreReversedW32(&outre2Q16[FRAMESAMPLES/2 - 1 - k],
+                     _mm256_sub_epi32(yr, xi));
+  }
+
+  /* Get IDFT */
+  sh = ScaleToW16(outre1Q16, outre2Q16, inreQ7, inimQ7);
+
+  WebRtcIsacfix_FftRadix16Fastest(inreQ7, inimQ7, 1); // real call
+
+  /* Divide through by the normalizing constant (273 in Q16 ~= 1/240), then
+     demodulate and separate. */
+  for (k = 0; k < FRAMESAMPLES/2; k += 8) {
+    __m256i re = Mul16x32Rsft16(fact273, UnscaleW16(&inreQ7[k], sh));
+    __m256i im = Mul16x32Rsft16(fact273, UnscaleW16(&inimQ7[k], sh));
+    __m256i cos_v = LoadW16(&WebRtcIsacfix_kCosTab1[k]);
+    __m256i sin_v = LoadW16(&WebRtcIsacfix_kSinTab1[k]);
+    __m256i xr = _mm256_sub_epi32(Mul16x32Rsft14(cos_v, re),
+                                  Mul16x32Rsft14(sin_v, im));
+    __m256i xi = _mm256_add_epi32(Mul16x32Rsft14(cos_v, im),
+                                  Mul16x32Rsft14(sin_v, re));
+    _mm256_storeu_si256((__m256i*)&outre1Q16[k],
+                        Mul16x32Rsft11(factQ11, xr));
+    _mm256_storeu_si256((__m256i*)&outre2Q16[k],
+                        Mul16x32Rsft11(factQ11, xi));
+  }
+}
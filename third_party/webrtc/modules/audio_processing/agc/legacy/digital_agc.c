@@ -21,6 +21,10 @@
 
 #include "rtc_base/checks.h"
 #include "modules/audio_processing/agc/legacy/gain_control.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+CalculateEnvelope WebRtcAgc_CalculateEnvelope;
+ApplyDigitalGains WebRtcAgc_ApplyDigitalGains;
 
 // To generate the gaintable, copy&paste the following lines to a Matlab window:
 // MaxGain = 6; MinGain = 0; CompRatio = 3; Knee = 1;
@@ -258,6 +262,19 @@ int32_t WebRtcAgc_InitDigital(DigitalAgc* stt, int16_t agcMode) {
   stt->frameCounter = 0;
 #endif
 
+  // Initialize function pointers.
+  WebRtcAgc_CalculateEnvelope = WebRtcAgc_CalculateEnvelopeC;
+  WebRtcAgc_ApplyDigitalGains = WebRtcAgc_ApplyDigitalGainsC;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    WebRtcAgc_CalculateEnvelope = WebRtcAgc_CalculateEnvelopeAVX2;
+    WebRtcAgc_ApplyDigitalGains = WebRtcAgc_ApplyDigitalGainsAVX2;
+  } else if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcAgc_CalculateEnvelope = WebRtcAgc_CalculateEnvelopeSSE2;
+    WebRtcAgc_ApplyDigitalGains = WebRtcAgc_ApplyDigitalGainsSSE2;
+  }
+#endif
+
   // initialize VADs
   WebRtcAgc_InitVad(&stt->vadNearend);
   WebRtcAgc_InitVad(&stt->vadFarend);
@@ -275,6 +292,76 @@ int32_t WebRtcAgc_AddFarendToDigital(DigitalAgc* stt,
   return 0;
 }
 
+void WebRtcAgc_CalculateEnvelopeC(const int16_t* in, size_t L, int32_t* env) {
+  int32_t max_nrg;
+  size_t k, n;
+
+  // iterate over sub frames
+  for (k = 0; k < 10; k++) {
+    // iterate over samples
+    max_nrg = 0;
+    for (n = 0; n < L; n++) {
+      int32_t nrg = in[k * L + n] * in[k * L + n];
+      if (nrg > max_nrg) {
+        max_nrg = nrg;
+      }
+    }
+    env[k] = max_nrg;
+  }
+}
+
+void WebRtcAgc_ApplyDigitalGainsC(const int32_t* gains,
+                                  size_t num_bands,
+                                  size_t L,
+                                  int16_t* const* out) {
+  int32_t out_tmp, tmp32;
+  int32_t gain32, delta;
+  int16_t L2 = L == 8 ? 3 : 4;  // log2(L)
+  size_t k, n, i;
+
+  // handle first sub frame separately
+  delta = (gains[1] - gains[0]) * (1 << (4 - L2));
+  gain32 = gains[0] * (1 << 4);
+  // iterate over samples
+  for (n = 0; n < L; n++) {
+    for (i = 0; i < num_bands; ++i) {
+      out_tmp = (int64_t)out[i][n] * ((gain32 + 127) >> 7) >> 16;
+      if (out_tmp > 4095) {
+        out[i][n] = (int16_t)32767;
+      } else if (out_tmp < -4096) {
+        out[i][n] = (int16_t)-32768;
+      } else {
+        tmp32 = ((int64_t)out[i][n] * (gain32 >> 4)) >> 16;
+        out[i][n] = (int16_t)tmp32;
+      }
+    }
+
+    gain32 += delta;
+  }
+  // iterate over subframes
+  for (k = 1; k < 10; k++) {
+    delta = (gains[k + 1] - gains[k]) * (1 << (4 - L2));
+    gain32 = gains[k] * (1 << 4);
+    // iterate over samples
+    for (n = 0; n < L; n++) {
+      for (i = 0; i < num_bands; ++i) {
+        int64_t tmp64 = ((int64_t)(out[i][k * L + n])) * (gain32 >> 4);
+        tmp64 = tmp64 >> 16;
+        if (tmp64 > 32767) {
+          out[i][k * L + n] = 32767;
+        }
+        else if (tmp64 < -32768) {
+          out[i][k * L + n] = -32768;
+        }
+        else {
+          out[i][k * L + n] = (int16_t)(tmp64);
+        }
+      }
+      gain32 += delta;
+    }
+  }
+}
+
 int32_t WebRtcAgc_ProcessDigital(DigitalAgc* stt,
                                  const int16_t* const* in_near,
                                  size_t num_bands,
@@ -284,27 +371,23 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc* stt,
   // array for gains (one value per ms, incl start & end)
   int32_t gains[11];
 
-  int32_t out_tmp, tmp32;
+  int32_t tmp32;
   int32_t env[10];
-  int32_t max_nrg;
   int32_t cur_level;
-  int32_t gain32, delta;
+  int32_t gain32;
   int16_t logratio;
   int16_t lower_thr, upper_thr;
   int16_t zeros = 0, zeros_fast, frac = 0;
   int16_t decay;
   int16_t gate, gain_adj;
   int16_t k;
-  size_t n, i, L;
-  int16_t L2;  // samples/subframe
+  size_t i, L;  // samples/subframe
 
   // determine number of samples per ms
   if (FS == 8000) {
     L = 8;
-    L2 = 3;
   } else if (FS == 16000 || FS == 32000 || FS == 48000) {
     L = 16;
-    L2 = 4;
   } else {
     return -1;
   }
@@ -364,18 +447,7 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc* stt,
           logratio, decay, stt->vadNearend.stdLongTerm);
 #endif
   // Find max amplitude per sub frame
-  // iterate over sub frames
-  for (k = 0; k < 10; k++) {
-    // iterate over samples
-    max_nrg = 0;
-    for (n = 0; n < L; n++) {
-      int32_t nrg = out[0][k * L + n] * out[0][k * L + n];
-      if (nrg > max_nrg) {
-        max_nrg = nrg;
-      }
-    }
-    env[k] = max_nrg;
-  }
+  WebRtcAgc_CalculateEnvelope(out[0], L, env);
 
   // Calculate gain per sub frame
   gains[0] = stt->gain;
@@ -499,47 +571,7 @@ int32_t WebRtcAgc_ProcessDigital(DigitalAgc* stt,
   stt->gain = gains[10];
 
   // Apply gain
-  // handle first sub frame separately
-  delta = (gains[1] - gains[0]) * (1 << (4 - L2));
-  gain32 = gains[0] * (1 << 4);
-  // iterate over samples
-  for (n = 0; n < L; n++) {
-    for (i = 0; i < num_bands; ++i) {
-      out_tmp = (int64_t)out[i][n] * ((gain32 + 127) >> 7) >> 16;
-      if (out_tmp > 4095) {
-        out[i][n] = (int16_t)32767;
-      } else if (out_tmp < -4096) {
-        out[i][n] = (int16_t)-32768;
-      } else {
-        tmp32 = ((int64_t)out[i][n] * (gain32 >> 4)) >> 16;
-        out[i][n] = (int16_t)tmp32;
-      }
-    }
-
-    gain32 += delta;
-  }
-  // iterate over subframes
-  for (k = 1; k < 10; k++) {
-    delta = (gains[k + 1] - gains[k]) * (1 << (4 - L2));
-    gain32 = gains[k] * (1 << 4);
-    // iterate over samples
-    for (n = 0; n < L; n++) {
-      for (i = 0; i < num_bands; ++i) {
-        int64_t tmp64 = ((int64_t)(out[i][k * L + n])) * (gain32 >> 4);
-        tmp64 = tmp64 >> 16;
-        if (tmp64 > 32767) {
-          out[i][k * L + n] = 32767;
-        }
-        else if (tmp64 < -32768) {
-          out[i][k * L + n] = -32768;
-        }
-        else {
-          out[i][k * L + n] = (int16_t)(tmp64);
-        }
-      }
-      gain32 += delta;
-    }
-  }
+  WebRtcAgc_ApplyDigitalGains(gains, num_bands, L, out);
 
   return 0;
 }
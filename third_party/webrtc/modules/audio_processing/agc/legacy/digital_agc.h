@@ -15,6 +15,7 @@
 #include <stdio.h>
 #endif
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "rtc_base/system/arch.h"
 
 // the 32 most significant bits of A(19) * B(26) >> 13
 #define AGC_MUL32(A, B) (((B) >> 13) * (A) + (((0x00001FFF & (B)) * (A)) >> 13))
@@ -50,6 +51,49 @@ typedef struct {
 #endif
 } DigitalAgc;
 
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// Function pointers for the per-sample loops of WebRtcAgc_ProcessDigital(),
+// set by WebRtcAgc_InitDigital().
+
+// Finds the maximum energy, env[k], of each of the ten |L|-sample subframes of
+// the frame |in|.
+typedef void (*CalculateEnvelope)(const int16_t* in, size_t L, int32_t* env);
+extern CalculateEnvelope WebRtcAgc_CalculateEnvelope;
+
+// Applies the gains (Q16) to the ten |L|-sample subframes of every band in
+// |out|, interpolating linearly from gains[k] to gains[k + 1] over subframe k.
+typedef void (*ApplyDigitalGains)(const int32_t* gains,
+                                  size_t num_bands,
+                                  size_t L,
+                                  int16_t* const* out);
+extern ApplyDigitalGains WebRtcAgc_ApplyDigitalGains;
+
+void WebRtcAgc_CalculateEnvelopeC(const int16_t* in, size_t L, int32_t* env);
+void WebRtcAgc_ApplyDigitalGainsC(const int32_t* gains,
+                                  size_t num_bands,
+                                  size_t L,
+                                  int16_t* const* out);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcAgc_CalculateEnvelopeSSE2(const int16_t* in,
+                                     size_t L,
+                                     int32_t* env);
+void WebRtcAgc_ApplyDigitalGainsSSE2(const int32_t* gains,
+                                     size_t num_bands,
+                                     size_t L,
+                                     int16_t* const* out);
+void WebRtcAgc_CalculateEnvelopeAVX2(const int16_t* in,
+                                     size_t L,
+                                     int32_t* env);
+void WebRtcAgc_ApplyDigitalGainsAVX2(const int32_t* gains,
+                                     size_t num_bands,
+                                     size_t L,
+                                     int16_t* const* out);
+#endif
+
 int32_t WebRtcAgc_InitDigital(DigitalAgc* digitalAgcInst, int16_t agcMode);
 
 int32_t WebRtcAgc_ProcessDigital(DigitalAgc* digitalAgcInst,
@@ -75,4 +119,8 @@ int32_t WebRtcAgc_CalculateGainTable(int32_t* gainTable,         // Q16
                                      uint8_t limiterEnable,
                                      int16_t analogTarget);
 
+#if defined(__cplusplus)
+}
+#endif
+
 #endif  // MODULES_AUDIO_PROCESSING_AGC_LEGACY_DIGITAL_AGC_H_
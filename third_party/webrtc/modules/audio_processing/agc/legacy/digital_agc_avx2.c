@@ -0,0 +1,181 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file contains the AVX2 versions of WebRtcAgc_CalculateEnvelope() and
+ * WebRtcAgc_ApplyDigitalGains(). They split the gains as the SSE2 versions
+ * do and work on sixteen samples per vector, which may span two 8 kHz
+ * subframes. The results are bit exact with the C versions.
+ */
+
+#include "modules/audio_processing/agc/legacy/digital_agc.h"
+
+#include <immintrin.h>
+
+// A gain of sixteen samples, split for Multiply().
+typedef struct {
+  __m256i lo;       // Low halves.
+  __m256i pairs_lo; // High halves of samples 0-3 and 8-11, with ones.
+  __m256i pairs_hi; // High halves of samples 4-7 and 12-15, with ones.
+} SplitGain;
+
+// |gain0| holds samples 0-3 and 8-11 and |gain1| samples 4-7 and 12-15, the
+// order _mm256_packs_epi32() expects.
+static __inline SplitGain Split(__m256i gain0, __m256i gain1) {
+  const __m256i kHalf = _mm256_set1_epi32(1 << 15);
+  const __m256i kOne = _mm256_set1_epi16(1);
+  __m256i hi = _mm256_packs_epi32(
+      _mm256_srai_epi32(_mm256_add_epi32(gain0, kHalf), 16),
+      _mm256_srai_epi32(_mm256_add_epi32(gain1, kHalf), 16));
+  SplitGain split;
+  split.lo =
+      _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(gain0, 16), 16),
+                         _mm256_srai_epi32(_mm256_slli_epi32(gain1, 16), 16));
+  split.pairs_lo = _mm256_unpacklo_epi16(hi, kOne);
+  split.pairs_hi = _mm256_unpackhi_epi16(hi, kOne);
+  return split;
+}
+
+// (x * gain) >> 16 of the sixteen samples |x|, as 32-bit lanes in the order
+// of Split().
+static __inline void Multiply(__m256i x,
+                              const SplitGain* gain,
+                              __m256i* out0,
+                              __m256i* out1) {
+  __m256i lo_products = _mm256_mulhi_epi16(x, gain->lo);
+  *out0 =
+      _mm256_madd_epi16(_mm256_unpacklo_epi16(x, lo_products), gain->pairs_lo);
+  *out1 =
+      _mm256_madd_epi16(_mm256_unpackhi_epi16(x, lo_products), gain->pairs_hi);
+}
+
+// The first subframe of the C code saturates on the gain >> 3 product, and
+// otherwise truncates the product to 16 bits.
+static __inline __m256i LimitFirst(__m256i product, __m256i product7) {
+  __m256i out = _mm256_srai_epi32(_mm256_slli_epi32(product, 16), 16);
+  out = _mm256_blendv_epi8(
+      out, _mm256_set1_epi32(32767),
+      _mm256_cmpgt_epi32(product7, _mm256_set1_epi32(4095)));
+  return _mm256_blendv_epi8(
+      out, _mm256_set1_epi32(-32768),
+      _mm256_cmpgt_epi32(_mm256_set1_epi32(-4096), product7));
+}
+
+// Horizontal maximum and minimum of the eight lanes.
+static __inline int16_t MaxW16(__m128i v) {
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 8));
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 4));
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 2));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+static __inline int16_t MinW16(__m128i v) {
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 8));
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 4));
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 2));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+static __inline int32_t MaxSquare(__m128i max_value, __m128i min_value) {
+  int32_t max_abs = -MinW16(min_value);
+  int32_t max_pos = MaxW16(max_value);
+  if (max_pos > max_abs) {
+    max_abs = max_pos;
+  }
+  return max_abs * max_abs;
+}
+
+void WebRtcAgc_CalculateEnvelopeAVX2(const int16_t* in,
+                                     size_t L,
+                                     int32_t* env) {
+  size_t k;
+
+  // Two 8 kHz subframes, or one wideband subframe, per vector.
+  for (k = 0; k < 10; k += 16 / L) {
+    __m256i x = _mm256_loadu_si256((const __m256i*)&in[k * L]);
+    __m128i x0 = _mm256_castsi256_si128(x);
+    __m128i x1 = _mm256_extracti128_si256(x, 1);
+    if (L == 8) {
+      env[k] = MaxSquare(x0, x0);
+      env[k + 1] = MaxSquare(x1, x1);
+    } else {
+      env[k] = MaxSquare(_mm_max_epi16(x0, x1), _mm_min_epi16(x0, x1));
+    }
+  }
+}
+
+void WebRtcAgc_ApplyDigitalGainsAVX2(const int32_t* gains,
+                                     size_t num_bands,
+                                     size_t L,
+                                     int16_t* const* out) {
+  const __m256i kRamp = _mm256_setr_epi32(0, 1, 2, 3, 0, 1, 2, 3);
+  const __m256i kRound = _mm256_set1_epi32(127);
+  uint32_t start[10], delta[10];
+  size_t k, n, i;
+
+  // The gain ramp of each subframe, wrapping modulo 2^32 like the repeated
+  // additions of the C code; 16 / L is (1 << (4 - L2)).
+  for (k = 0; k < 10; k++) {
+    start[k] = (uint32_t)gains[k] << 4;
+    delta[k] =
+        ((uint32_t)gains[k + 1] - (uint32_t)gains[k]) * (uint32_t)(16 / L);
+  }
+
+  for (n = 0; n < 10 * L; n += 16) {
+    // Each 128-bit lane covers eight samples of one subframe.
+    const size_t k0 = n / L, k1 = (n + 8) / L;
+    const uint32_t gain0 = start[k0] + (uint32_t)(n - k0 * L) * delta[k0];
+    const uint32_t gain1 = start[k1] + (uint32_t)(n + 8 - k1 * L) * delta[k1];
+    const __m256i deltas =
+        _mm256_setr_m128i(_mm_set1_epi32((int32_t)delta[k0]),
+                          _mm_set1_epi32((int32_t)delta[k1]));
+    const __m256i ramp0 = _mm256_add_epi32(
+        _mm256_setr_m128i(_mm_set1_epi32((int32_t)gain0),
+                          _mm_set1_epi32((int32_t)gain1)),
+        _mm256_mullo_epi32(deltas, kRamp));
+    const __m256i ramp1 =
+        _mm256_add_epi32(ramp0, _mm256_slli_epi32(deltas, 2));
+    const SplitGain gain =
+        Split(_mm256_srai_epi32(ramp0, 4), _mm256_srai_epi32(ramp1, 4));
+    if (n < L) {
+      // The first subframe also needs (gain32 + 127) >> 7. At 8 kHz it is
+      // only the low half of the vector.
+      const __m256i first = _mm256_cmpgt_epi16(
+          _mm256_set1_epi16((int16_t)L),
+          _mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+                            15));
+      const SplitGain gain7 = Split(
+          _mm256_srai_epi32(_mm256_add_epi32(ramp0, kRound), 7),
+          _mm256_srai_epi32(_mm256_add_epi32(ramp1, kRound), 7));
+      for (i = 0; i < num_bands; ++i) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)&out[i][n]);
+        __m256i product0, product1, product7_0, product7_1;
+        Multiply(x, &gain, &product0, &product1);
+        Multiply(x, &gain7, &product7_0, &product7_1);
+        _mm256_storeu_si256(
+            (__m256i*)&out[i][n],
+            _mm256_blendv_epi8(
+                _mm256_packs_epi32(product0, product1),
+                _mm256_packs_epi32(LimitFirst(product0, product7_0),
+                                   LimitFirst(product1, product7_1)),
+                first));
+      }
+    } else {
+      for (i = 0; i < num_bands; ++i) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)&out[i][n]);
+        __m256i product0, product1;
+        Multiply(x, &gain, &product0, &product1);
+        // _mm256_packs_epi32() saturates like the C code.
+        _mm256_storeu_si256((__m256i*)&out[i][n],
+                            _mm256_packs_epi32(product0, product1));
+      }
+    }
+  }
+}
@@ -0,0 +1,163 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+/*
+ * This file contains the SSE2 versions of WebRtcAgc_CalculateEnvelope() and
+ * WebRtcAgc_ApplyDigitalGains(). The results are bit exact with the C
+ * versions in digital_agc.c.
+ *
+ * The C code multiplies each sample by gain32 >> 4, which has at most 28
+ * significant bits, and keeps the product >> 16. The SSE2 version splits the
+ * gain into a signed low half, lo, and a high half, hi, with
+ * gain == hi * 2^16 + lo, so that
+ *   (x * gain) >> 16 == x * hi + ((x * lo) >> 16).
+ * _mm_mulhi_epi16() gives the second term and _mm_madd_epi16() adds the first
+ * one exactly, since |hi| <= 2^11.
+ */
+
+#include "modules/audio_processing/agc/legacy/digital_agc.h"
+
+#include <emmintrin.h>
+
+// A gain of eight samples, split for Multiply().
+typedef struct {
+  __m128i lo;       // Low halves.
+  __m128i pairs_lo; // High halves of samples 0 to 3, interleaved with ones.
+  __m128i pairs_hi; // High halves of samples 4 to 7, interleaved with ones.
+} SplitGain;
+
+static __inline SplitGain Split(__m128i gain0, __m128i gain1) {
+  const __m128i kHalf = _mm_set1_epi32(1 << 15);
+  const __m128i kOne = _mm_set1_epi16(1);
+  __m128i hi = _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(gain0, kHalf), 16),
+                               _mm_srai_epi32(_mm_add_epi32(gain1, kHalf), 16));
+  SplitGain split;
+  split.lo = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(gain0, 16), 16),
+                             _mm_srai_epi32(_mm_slli_epi32(gain1, 16), 16));
+  split.pairs_lo = _mm_unpacklo_epi16(hi, kOne);
+  split.pairs_hi = _mm_unpackhi_epi16(hi, kOne);
+  return split;
+}
+
+// (x * gain) >> 16 of the eight samples |x|, as 32-bit lanes.
+static __inline void Multiply(__m128i x,
+                              const SplitGain* gain,
+                              __m128i* out0,
+                              __m128i* out1) {
+  __m128i lo_products = _mm_mulhi_epi16(x, gain->lo);
+  *out0 = _mm_madd_epi16(_mm_unpacklo_epi16(x, lo_products), gain->pairs_lo);
+  *out1 = _mm_madd_epi16(_mm_unpackhi_epi16(x, lo_products), gain->pairs_hi);
+}
+
+// Picks |a| where |mask| is set and |b| elsewhere.
+static __inline __m128i Select(__m128i mask, __m128i a, __m128i b) {
+  return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// The first subframe of the C code saturates on the gain >> 3 product, and
+// otherwise truncates the product to 16 bits.
+static __inline __m128i LimitFirst(__m128i product, __m128i product7) {
+  const __m128i kMax = _mm_set1_epi32(32767);
+  const __m128i kMin = _mm_set1_epi32(-32768);
+  __m128i out = _mm_srai_epi32(_mm_slli_epi32(product, 16), 16);
+  out = Select(_mm_cmpgt_epi32(product7, _mm_set1_epi32(4095)), kMax, out);
+  return Select(_mm_cmplt_epi32(product7, _mm_set1_epi32(-4096)), kMin, out);
+}
+
+// Horizontal maximum and minimum of the eight lanes.
+static __inline int16_t MaxW16(__m128i v) {
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 8));
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 4));
+  v = _mm_max_epi16(v, _mm_srli_si128(v, 2));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+static __inline int16_t MinW16(__m128i v) {
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 8));
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 4));
+  v = _mm_min_epi16(v, _mm_srli_si128(v, 2));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+// The largest squared sample is the square of the largest magnitude, which
+// the subframe maximum and minimum give without overflowing 16 bits.
+void WebRtcAgc_CalculateEnvelopeSSE2(const int16_t* in,
+                                     size_t L,
+                                     int32_t* env) {
+  size_t k, n;
+
+  for (k = 0; k < 10; k++) {
+    __m128i max_value = _mm_loadu_si128((const __m128i*)&in[k * L]);
+    __m128i min_value = max_value;
+    int32_t max_abs, max_pos;
+    for (n = 8; n < L; n += 8) {
+      __m128i x = _mm_loadu_si128((const __m128i*)&in[k * L + n]);
+      max_value = _mm_max_epi16(max_value, x);
+      min_value = _mm_min_epi16(min_value, x);
+    }
+    max_abs = -MinW16(min_value);
+    max_pos = MaxW16(max_value);
+    if (max_pos > max_abs) {
+      max_abs = max_pos;
+    }
+    env[k] = max_abs * max_abs;
+  }
+}
+
+// Gains are computed once per eight samples and shared by the bands. The gain
+// ramps wrap modulo 2^32 like the repeated additions of the C code.
+void WebRtcAgc_ApplyDigitalGainsSSE2(const int32_t* gains,
+                                     size_t num_bands,
+                                     size_t L,
+                                     int16_t* const* out) {
+  size_t k, n, i;
+
+  for (k = 0; k < 10; k++) {
+    // (1 << (4 - L2)) of the C code.
+    const uint32_t delta =
+        ((uint32_t)gains[k + 1] - (uint32_t)gains[k]) * (uint32_t)(16 / L);
+    const __m128i delta4 = _mm_set1_epi32((int32_t)(delta * 4));
+    for (n = 0; n < L; n += 8) {
+      const uint32_t gain32 = ((uint32_t)gains[k] << 4) + (uint32_t)n * delta;
+      const __m128i ramp0 = _mm_setr_epi32(
+          (int32_t)gain32, (int32_t)(gain32 + delta),
+          (int32_t)(gain32 + 2 * delta), (int32_t)(gain32 + 3 * delta));
+      const __m128i ramp1 = _mm_add_epi32(ramp0, delta4);
+      const SplitGain gain =
+          Split(_mm_srai_epi32(ramp0, 4), _mm_srai_epi32(ramp1, 4));
+      const size_t offset = k * L + n;
+      if (k == 0) {
+        // The first subframe also needs (gain32 + 127) >> 7.
+        const __m128i kRound = _mm_set1_epi32(127);
+        const SplitGain gain7 =
+            Split(_mm_srai_epi32(_mm_add_epi32(ramp0, kRound), 7),
+                  _mm_srai_epi32(_mm_add_epi32(ramp1, kRound), 7));
+        for (i = 0; i < num_bands; ++i) {
+          __m128i x = _mm_loadu_si128((const __m128i*)&out[i][offset]);
+          __m128i product0, product1, product7_0, product7_1;
+          Multiply(x, &gain, &product0, &product1);
+          Multiply(x, &gain7, &product7_0, &product7_1);
+          _mm_storeu_si128((__m128i*)&out[i][offset],
+                           _mm_packs_epi32(LimitFirst(product0, product7_0),
+                                           LimitFirst(product1, product7_1)));
+        }
+      } else {
+        for (i = 0; i < num_bands; ++i) {
+          __m128i x = _mm_loadu_si128((const __m128i*)&out[i][offset]);
+          __m128i product0, product1;
+          Multiply(x, &gain, &product0, &product1);
+          // _mm_packs_epi32() saturates like the C code.
+          _mm_storeu_si128((__m128i*)&out[i][offset],
+                           _mm_packs_epi32(product0, product1));
+        }
+      }
+    }
+  }
+}
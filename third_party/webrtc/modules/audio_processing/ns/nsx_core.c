@@ -19,17 +19,13 @@
 #include "modules/audio_processing/ns/nsx_core.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
 
-#if defined(WEBRTC_HAS_NEON)
-/* Tables are defined in ARM assembly files. */
-extern const int16_t WebRtcNsx_kLogTable[9];
-extern const int16_t WebRtcNsx_kCounterDiv[201];
-extern const int16_t WebRtcNsx_kLogTableFrac[256];
-#else
-static const int16_t WebRtcNsx_kLogTable[9] = {
+#if !defined(WEBRTC_HAS_NEON)
+/* For Neon the tables are defined in nsx_core_neon.c. */
+const int16_t WebRtcNsx_kLogTable[9] = {
   0, 177, 355, 532, 710, 887, 1065, 1242, 1420
 };
 
-static const int16_t WebRtcNsx_kCounterDiv[201] = {
+const int16_t WebRtcNsx_kCounterDiv[201] = {
   32767, 16384, 10923, 8192, 6554, 5461, 4681, 4096, 3641, 3277, 2979, 2731,
   2521, 2341, 2185, 2048, 1928, 1820, 1725, 1638, 1560, 1489, 1425, 1365, 1311,
   1260, 1214, 1170, 1130, 1092, 1057, 1024, 993, 964, 936, 910, 886, 862, 840,
@@ -46,7 +42,7 @@ static const int16_t WebRtcNsx_kCounterDiv[201] = {
   172, 172, 171, 170, 169, 168, 167, 166, 165, 165, 164, 163
 };
 
-static const int16_t WebRtcNsx_kLogTableFrac[256] = {
+const int16_t WebRtcNsx_kLogTableFrac[256] = {
   0,   1,   3,   4,   6,   7,   9,  10,  11,  13,  14,  16,  17,  18,  20,  21,
   22,  24,  25,  26,  28,  29,  30,  32,  33,  34,  36,  37,  38,  40,  41,  42,
   44,  45,  46,  47,  49,  50,  51,  52,  54,  55,  56,  57,  59,  60,  61,  62,
@@ -65,7 +61,7 @@ static const int16_t WebRtcNsx_kLogTableFrac[256] = {
   237, 238, 238, 239, 240, 241, 241, 242, 243, 244, 244, 245, 246, 247, 247,
   248, 249, 249, 250, 251, 252, 252, 253, 254, 255, 255
 };
-#endif  // WEBRTC_HAS_NEON
+#endif  // !WEBRTC_HAS_NEON
 
 // Skip first frequency bins during estimation. (0 <= value < 64)
 static const size_t kStartBand = 5;
@@ -300,7 +296,7 @@ static const int16_t kDeterminantEstMatrix[66] = {
 };
 
 // Update the noise estimation information.
-static void UpdateNoiseEstimate(NoiseSuppressionFixedC* inst, int offset) {
+void WebRtcNsx_UpdateNoiseEstimate(NoiseSuppressionFixedC* inst, int offset) {
   int32_t tmp32no1 = 0;
   int32_t tmp32no2 = 0;
   int16_t tmp16 = 0;
@@ -434,7 +430,7 @@ static void NoiseEstimationC(NoiseSuppressionFixedC* inst,
     if (counter >= END_STARTUP_LONG) {
       inst->noiseEstCounter[s] = 0;
       if (inst->blockIndex >= END_STARTUP_LONG) {
-        UpdateNoiseEstimate(inst, offset);
+        WebRtcNsx_UpdateNoiseEstimate(inst, offset);
       }
     }
     inst->noiseEstCounter[s]++;
@@ -443,7 +439,7 @@ static void NoiseEstimationC(NoiseSuppressionFixedC* inst,
 
   // Sequentially update the noise during startup
   if (inst->blockIndex < END_STARTUP_LONG) {
-    UpdateNoiseEstimate(inst, offset);
+    WebRtcNsx_UpdateNoiseEstimate(inst, offset);
   }
 
   for (i = 0; i < inst->magnLen; i++) {
@@ -567,6 +563,24 @@ static void WebRtcNsx_InitNeon(void) {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Initialize function pointers for x86 platforms with SSE2.
+static void WebRtcNsx_InitSSE2(void) {
+  WebRtcNsx_NoiseEstimation = WebRtcNsx_NoiseEstimationSSE2;
+  WebRtcNsx_PrepareSpectrum = WebRtcNsx_PrepareSpectrumSSE2;
+  WebRtcNsx_SynthesisUpdate = WebRtcNsx_SynthesisUpdateSSE2;
+  WebRtcNsx_AnalysisUpdate = WebRtcNsx_AnalysisUpdateSSE2;
+}
+
+// Initialize function pointers for x86 platforms with AVX2.
+static void WebRtcNsx_InitAVX2(void) {
+  WebRtcNsx_NoiseEstimation = WebRtcNsx_NoiseEstimationAVX2;
+  WebRtcNsx_PrepareSpectrum = WebRtcNsx_PrepareSpectrumAVX2;
+  WebRtcNsx_SynthesisUpdate = WebRtcNsx_SynthesisUpdateAVX2;
+  WebRtcNsx_AnalysisUpdate = WebRtcNsx_AnalysisUpdateAVX2;
+}
+#endif
+
 #if defined(MIPS32_LE)
 // Initialize function pointers for MIPS platform.
 static void WebRtcNsx_InitMips(void) {
@@ -766,6 +780,14 @@ int32_t WebRtcNsx_InitCore(NoiseSuppressionFixedC* inst, uint32_t fs) {
   WebRtcNsx_InitNeon();
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    WebRtcNsx_InitAVX2();
+  } else if (WebRtc_GetCPUInfo(kSSE2)) {
+    WebRtcNsx_InitSSE2();
+  }
+#endif
+
 #if defined(MIPS32_LE)
   WebRtcNsx_InitMips();
 #endif
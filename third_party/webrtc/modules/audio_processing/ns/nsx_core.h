@@ -206,6 +206,15 @@ typedef void (*NormalizeRealBuffer)(NoiseSuppressionFixedC* inst,
                                     int16_t* out);
 extern NormalizeRealBuffer WebRtcNsx_NormalizeRealBuffer;
 
+// Recompute the noise quantile in Q(qNoise) from the log quantile estimate
+// starting at |offset|. Intended to be private.
+void WebRtcNsx_UpdateNoiseEstimate(NoiseSuppressionFixedC* inst, int offset);
+
+// Log and counter tables shared by the generic and the SIMD versions.
+extern const int16_t WebRtcNsx_kLogTable[9];
+extern const int16_t WebRtcNsx_kCounterDiv[201];
+extern const int16_t WebRtcNsx_kLogTableFrac[256];
+
 // Compute speech/noise probability.
 // Intended to be private.
 void WebRtcNsx_SpeechNoiseProb(NoiseSuppressionFixedC* inst,
@@ -231,6 +240,36 @@ void WebRtcNsx_PrepareSpectrumNeon(NoiseSuppressionFixedC* inst,
                                    int16_t* freq_buff);
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// For the above function pointers, the x86 versions are declared below and
+// defined in nsx_core_sse2.c and nsx_core_avx2.c. WebRtcNsx_InitCore() picks
+// one of them at runtime; both are bit-exact with the generic C code.
+void WebRtcNsx_NoiseEstimationSSE2(NoiseSuppressionFixedC* inst,
+                                   uint16_t* magn,
+                                   uint32_t* noise,
+                                   int16_t* q_noise);
+void WebRtcNsx_SynthesisUpdateSSE2(NoiseSuppressionFixedC* inst,
+                                   int16_t* out_frame,
+                                   int16_t gain_factor);
+void WebRtcNsx_AnalysisUpdateSSE2(NoiseSuppressionFixedC* inst,
+                                  int16_t* out,
+                                  int16_t* new_speech);
+void WebRtcNsx_PrepareSpectrumSSE2(NoiseSuppressionFixedC* inst,
+                                   int16_t* freq_buff);
+void WebRtcNsx_NoiseEstimationAVX2(NoiseSuppressionFixedC* inst,
+                                   uint16_t* magn,
+                                   uint32_t* noise,
+                                   int16_t* q_noise);
+void WebRtcNsx_SynthesisUpdateAVX2(NoiseSuppressionFixedC* inst,
+                                   int16_t* out_frame,
+                                   int16_t gain_factor);
+void WebRtcNsx_AnalysisUpdateAVX2(NoiseSuppressionFixedC* inst,
+                                  int16_t* out,
+                                  int16_t* new_speech);
+void WebRtcNsx_PrepareSpectrumAVX2(NoiseSuppressionFixedC* inst,
+                                   int16_t* freq_buff);
+#endif
+
 #if defined(MIPS32_LE)
 // For the above function pointers, functions for generic platforms are declared
 // and defined as static in file nsx_core.c, while those for MIPS platforms
@@ -0,0 +1,339 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/ns/nsx_core.h"
+
+#include <emmintrin.h>
+#include <string.h>
+
+#include "rtc_base/checks.h"
+
+// (int16_t) casts of the generic code keep the low 16 bits of each 32-bit
+// lane; _mm_packs_epi32() alone would saturate.
+static inline __m128i TruncatePackW32(__m128i lo, __m128i hi) {
+  lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+  hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+  return _mm_packs_epi32(lo, hi);
+}
+
+// (int16_t)((a * b + round) >> shift) for eight lanes, where |round| is
+// either 0 or 1 << (shift - 1).
+static inline __m128i MulShiftW16(__m128i a, __m128i b, int round, int shift) {
+  __m128i lo16 = _mm_mullo_epi16(a, b);
+  __m128i hi16 = _mm_mulhi_epi16(a, b);
+  __m128i rounding = _mm_set1_epi32(round);
+  __m128i count = _mm_cvtsi32_si128(shift);
+  __m128i lo = _mm_sra_epi32(
+      _mm_add_epi32(_mm_unpacklo_epi16(lo16, hi16), rounding), count);
+  __m128i hi = _mm_sra_epi32(
+      _mm_add_epi32(_mm_unpackhi_epi16(lo16, hi16), rounding), count);
+  return TruncatePackW32(lo, hi);
+}
+
+// Noise Estimation. Same as NoiseEstimationC(); the quantile and density
+// updates run on eight bins at a time.
+void WebRtcNsx_NoiseEstimationSSE2(NoiseSuppressionFixedC* inst,
+                                   uint16_t* magn,
+                                   uint32_t* noise,
+                                   int16_t* q_noise) {
+  int16_t lmagn[HALF_ANAL_BLOCKL], counter, countDiv;
+  int16_t countProd, delta, zeros, frac;
+  int16_t log2, tabind, logval, tmp16, tmp16no1, tmp16no2;
+  const int16_t log2_const = 22713; // Q15
+  const int16_t width_factor = 21845;
+  int16_t default_delta = FACTOR_Q7;
+
+  size_t i, s, offset;
+
+  tabind = inst->stages - inst->normData;
+  RTC_DCHECK_LT(tabind, 9);
+  RTC_DCHECK_GT(tabind, -9);
+  if (tabind < 0) {
+    logval = -WebRtcNsx_kLogTable[-tabind];
+  } else {
+    logval = WebRtcNsx_kLogTable[tabind];
+  }
+
+  // lmagn(i)=log(magn(i))=log(2)*log2(magn(i))
+  // magn is in Q(-stages), and the real lmagn values are:
+  // real_lmagn(i)=log(magn(i)*2^stages)=log(magn(i))+log(2^stages)
+  // lmagn in Q8
+  for (i = 0; i < inst->magnLen; i++) {
+    if (magn[i]) {
+      zeros = WebRtcSpl_NormU32((uint32_t)magn[i]);
+      frac = (int16_t)((((uint32_t)magn[i] << zeros)
+                              & 0x7FFFFFFF) >> 23);
+      // log2(magn(i))
+      RTC_DCHECK_LT(frac, 256);
+      log2 = (int16_t)(((31 - zeros) << 8)
+                             + WebRtcNsx_kLogTableFrac[frac]);
+      // log2(magn(i))*log(2)
+      lmagn[i] = (int16_t)((log2 * log2_const) >> 15);
+      // + log(2^stages)
+      lmagn[i] += logval;
+    } else {
+      lmagn[i] = logval;//0;
+    }
+  }
+
+  if (inst->blockIndex < END_STARTUP_LONG) {
+    // Smaller step size during startup. This prevents from using
+    // unrealistic values causing overflow.
+    default_delta = FACTOR_Q7_STARTUP;
+  }
+
+  // loop over simultaneous estimates
+  for (s = 0; s < SIMULT; s++) {
+    const __m128i logval_v = _mm_set1_epi16(logval);
+    const __m128i width_v = _mm_set1_epi16(WIDTH_Q8);
+    __m128i count_div_v;
+    __m128i count_prod_v;
+    __m128i width_term_v;
+    int16_t* log_quantile;
+    int16_t* density;
+
+    offset = s * inst->magnLen;
+    log_quantile = &inst->noiseEstLogQuantile[offset];
+    density = &inst->noiseEstDensity[offset];
+
+    // Get counter values from state
+    counter = inst->noiseEstCounter[s];
+    RTC_DCHECK_LT(counter, 201);
+    countDiv = WebRtcNsx_kCounterDiv[counter];
+    countProd = (int16_t)(counter * countDiv);
+    tmp16no2 = (int16_t)WEBRTC_SPL_MUL_16_16_RSFT_WITH_ROUND(
+                 width_factor, countDiv, 15);
+    count_div_v = _mm_set1_epi16(countDiv);
+    count_prod_v = _mm_set1_epi16(countProd);
+    width_term_v = _mm_set1_epi16(tmp16no2);
+
+    // quant_est(...)
+    for (i = 0; i + 8 <= inst->magnLen; i += 8) {
+      __m128i lmagn_v = _mm_loadu_si128((const __m128i*)&lmagn[i]);
+      __m128i quantile_v = _mm_loadu_si128((const __m128i*)&log_quantile[i]);
+      __m128i density_v = _mm_loadu_si128((const __m128i*)&density[i]);
+      __m128i above = _mm_cmpgt_epi16(density_v, _mm_set1_epi16(512));
+      __m128i delta_v;
+      __m128i up_v;
+      __m128i down_v;
+      __m128i diff_v;
+      __m128i near_v;
+      int threshold;
+
+      // For a density above 512, FACTOR_Q16 >> (14 - NormW16(density)) is
+      // FACTOR_Q7 halved once per power of two from 1024 up to the density.
+      delta_v = _mm_or_si128(_mm_and_si128(above, _mm_set1_epi16(FACTOR_Q7)),
+                             _mm_andnot_si128(above,
+                                              _mm_set1_epi16(default_delta)));
+      for (threshold = 1024; threshold <= 16384; threshold <<= 1) {
+        __m128i halve = _mm_cmpgt_epi16(density_v,
+                                         _mm_set1_epi16(threshold - 1));
+        delta_v = _mm_sub_epi16(
+            delta_v, _mm_and_si128(halve, _mm_srli_epi16(delta_v, 1)));
+      }
+
+      // update log quantile estimate
+      // tmp16 = (int16_t)((delta * countDiv) >> 14), never negative here.
+      delta_v = MulShiftW16(delta_v, count_div_v, 0, 14);
+      // Above: += (tmp16 + 2) / 4.
+      up_v = _mm_add_epi16(
+          quantile_v,
+          _mm_srai_epi16(_mm_add_epi16(delta_v, _mm_set1_epi16(2)), 2));
+      // Below: -= ((tmp16 + 1) / 2) * 3 / 2, limited to logval.
+      down_v = _mm_srai_epi16(_mm_add_epi16(delta_v, _mm_set1_epi16(1)), 1);
+      down_v = _mm_srai_epi16(
+          _mm_add_epi16(down_v, _mm_add_epi16(down_v, down_v)), 1);
+      down_v = _mm_max_epi16(_mm_sub_epi16(quantile_v, down_v), logval_v);
+      above = _mm_cmpgt_epi16(lmagn_v, quantile_v);
+      quantile_v = _mm_or_si128(_mm_and_si128(above, up_v),
+                                _mm_andnot_si128(above, down_v));
+      _mm_storeu_si128((__m128i*)&log_quantile[i], quantile_v);
+
+      // update density estimate
+      // The generic code takes the absolute difference in int; a saturated
+      // difference gives the same answer against WIDTH_Q8.
+      diff_v = _mm_subs_epi16(lmagn_v, quantile_v);
+      diff_v = _mm_max_epi16(diff_v,
+                             _mm_subs_epi16(_mm_setzero_si128(), diff_v));
+      near_v = _mm_cmplt_epi16(diff_v, width_v);
+      density_v = _mm_or_si128(
+          _mm_and_si128(near_v,
+                        _mm_add_epi16(MulShiftW16(density_v, count_prod_v,
+                                                  1 << 14, 15),
+                                      width_term_v)),
+          _mm_andnot_si128(near_v, density_v));
+      _mm_storeu_si128((__m128i*)&density[i], density_v);
+    }
+
+    for (; i < inst->magnLen; i++) {
+      // compute delta
+      if (density[i] > 512) {
+        // Get the value for delta by shifting intead of dividing.
+        int factor = WebRtcSpl_NormW16(density[i]);
+        delta = (int16_t)(FACTOR_Q16 >> (14 - factor));
+      } else {
+        delta = default_delta;
+      }
+
+      // update log quantile estimate
+      tmp16 = (int16_t)((delta * countDiv) >> 14);
+      if (lmagn[i] > log_quantile[i]) {
+        // +=QUANTILE*delta/(inst->counter[s]+1) QUANTILE=0.25, =1 in Q2
+        // CounterDiv=1/(inst->counter[s]+1) in Q15
+        tmp16 += 2;
+        log_quantile[i] += tmp16 / 4;
+      } else {
+        tmp16 += 1;
+        // *(1-QUANTILE), in Q2 QUANTILE=0.25, 1-0.25=0.75=3 in Q2
+        tmp16no1 = (int16_t)((tmp16 / 2) * 3 / 2);
+        log_quantile[i] -= tmp16no1;
+        if (log_quantile[i] < logval) {
+          // This is the smallest fixed point representation we can
+          // have, hence we limit the output.
+          log_quantile[i] = logval;
+        }
+      }
+
+      // update density estimate
+      if (WEBRTC_SPL_ABS_W16(lmagn[i] - log_quantile[i]) < WIDTH_Q8) {
+        tmp16no1 = (int16_t)WEBRTC_SPL_MUL_16_16_RSFT_WITH_ROUND(
+                     density[i], countProd, 15);
+        density[i] = tmp16no1 + tmp16no2;
+      }
+    }  // end loop over magnitude spectrum
+
+    if (counter >= END_STARTUP_LONG) {
+      inst->noiseEstCounter[s] = 0;
+      if (inst->blockIndex >= END_STARTUP_LONG) {
+        WebRtcNsx_UpdateNoiseEstimate(inst, (int)offset);
+      }
+    }
+    inst->noiseEstCounter[s]++;
+
+  }  // end loop over simultaneous estimates
+
+  // Sequentially update the noise during startup
+  if (inst->blockIndex < END_STARTUP_LONG) {
+    WebRtcNsx_UpdateNoiseEstimate(inst, (int)offset);
+  }
+
+  for (i = 0; i < inst->magnLen; i++) {
+    noise[i] = (uint32_t)(inst->noiseEstQuantile[i]); // Q(qNoise)
+  }
+  (*q_noise) = (int16_t)inst->qNoise;
+}
+
+// Filter the data in the frequency domain, and create spectrum.
+void WebRtcNsx_PrepareSpectrumSSE2(NoiseSuppressionFixedC* inst,
+                                   int16_t* freq_buf) {
+  size_t i = 0;
+
+  // Filter eight bins at a time and store them interleaved with the negated
+  // imaginary part; anaLen2 + 1 == magnLen bins make up freq_buf.
+  for (; i + 8 <= inst->magnLen; i += 8) {
+    __m128i filter = _mm_loadu_si128((const __m128i*)&inst->noiseSupFilter[i]);
+    __m128i real = MulShiftW16(_mm_loadu_si128((const __m128i*)&inst->real[i]),
+                               filter, 0, 14);  // Q(normData-stages)
+    __m128i imag = MulShiftW16(_mm_loadu_si128((const __m128i*)&inst->imag[i]),
+                               filter, 0, 14);  // Q(normData-stages)
+    _mm_storeu_si128((__m128i*)&inst->real[i], real);
+    _mm_storeu_si128((__m128i*)&inst->imag[i], imag);
+    imag = _mm_sub_epi16(_mm_setzero_si128(), imag);
+    _mm_storeu_si128((__m128i*)&freq_buf[2 * i],
+                     _mm_unpacklo_epi16(real, imag));
+    _mm_storeu_si128((__m128i*)&freq_buf[2 * i + 8],
+                     _mm_unpackhi_epi16(real, imag));
+  }
+
+  for (; i < inst->magnLen; i++) {
+    inst->real[i] = (int16_t)((inst->real[i] *
+        (int16_t)(inst->noiseSupFilter[i])) >> 14);  // Q(normData-stages)
+    inst->imag[i] = (int16_t)((inst->imag[i] *
+        (int16_t)(inst->noiseSupFilter[i])) >> 14);  // Q(normData-stages)
+    freq_buf[2 * i] = inst->real[i];
+    freq_buf[2 * i + 1] = -inst->imag[i];
+  }
+}
+
+// For the noise supression process, synthesis, read out fully processed
+// segment, and update synthesis buffer.
+void WebRtcNsx_SynthesisUpdateSSE2(NoiseSuppressionFixedC* inst,
+                                   int16_t* out_frame,
+                                   int16_t gain_factor) {
+  size_t i = 0;
+  int16_t tmp16a = 0;
+  int16_t tmp16b = 0;
+  int32_t tmp32 = 0;
+  const __m128i gain = _mm_set1_epi16(gain_factor);
+
+  // synthesis
+  for (; i + 8 <= inst->anaLen; i += 8) {
+    __m128i window = _mm_loadu_si128((const __m128i*)&inst->window[i]);
+    __m128i real = _mm_loadu_si128((const __m128i*)&inst->real[i]);
+    __m128i synthesis =
+        _mm_loadu_si128((const __m128i*)&inst->synthesisBuffer[i]);
+    // Q0, window in Q14
+    __m128i windowed = MulShiftW16(window, real, 1 << 13, 14);
+    __m128i lo16 = _mm_mullo_epi16(windowed, gain);
+    __m128i hi16 = _mm_mulhi_epi16(windowed, gain);
+    __m128i rounding = _mm_set1_epi32(1 << 12);
+    __m128i lo = _mm_srai_epi32(
+        _mm_add_epi32(_mm_unpacklo_epi16(lo16, hi16), rounding), 13);
+    __m128i hi = _mm_srai_epi32(
+        _mm_add_epi32(_mm_unpackhi_epi16(lo16, hi16), rounding), 13);
+    // Saturating pack and add match SatW32ToW16() and AddSatW16().
+    synthesis = _mm_adds_epi16(synthesis, _mm_packs_epi32(lo, hi));
+    _mm_storeu_si128((__m128i*)&inst->synthesisBuffer[i], synthesis);
+  }
+  for (; i < inst->anaLen; i++) {
+    tmp16a = (int16_t)WEBRTC_SPL_MUL_16_16_RSFT_WITH_ROUND(
+                 inst->window[i], inst->real[i], 14); // Q0, window in Q14
+    tmp32 = WEBRTC_SPL_MUL_16_16_RSFT_WITH_ROUND(tmp16a, gain_factor, 13); // Q0
+    // Down shift with rounding
+    tmp16b = WebRtcSpl_SatW32ToW16(tmp32); // Q0
+    inst->synthesisBuffer[i] = WebRtcSpl_AddSatW16(inst->synthesisBuffer[i],
+                                                   tmp16b); // Q0
+  }
+
+  // read out fully processed segment
+  memcpy(out_frame, inst->synthesisBuffer,
+         inst->blockLen10ms * sizeof(*inst->synthesisBuffer));
+
+  // update synthesis buffer
+  memcpy(inst->synthesisBuffer, inst->synthesisBuffer + inst->blockLen10ms,
+      (inst->anaLen - inst->blockLen10ms) * sizeof(*inst->synthesisBuffer));
+  WebRtcSpl_ZerosArrayW16(inst->synthesisBuffer
+      + inst->anaLen - inst->blockLen10ms, inst->blockLen10ms);
+}
+
+// Update analysis buffer for lower band, and window data before FFT.
+void WebRtcNsx_AnalysisUpdateSSE2(NoiseSuppressionFixedC* inst,
+                                  int16_t* out,
+                                  int16_t* new_speech) {
+  size_t i = 0;
+
+  // For lower band update analysis buffer.
+  memcpy(inst->analysisBuffer, inst->analysisBuffer + inst->blockLen10ms,
+      (inst->anaLen - inst->blockLen10ms) * sizeof(*inst->analysisBuffer));
+  memcpy(inst->analysisBuffer + inst->anaLen - inst->blockLen10ms, new_speech,
+      inst->blockLen10ms * sizeof(*inst->analysisBuffer));
+
+  // Window data before FFT.
+  for (; i + 8 <= inst->anaLen; i += 8) {
+    __m128i window = _mm_loadu_si128((const __m128i*)&inst->window[i]);
+    __m128i data = _mm_loadu_si128((const __m128i*)&inst->analysisBuffer[i]);
+    _mm_storeu_si128((__m128i*)&out[i],
+                     MulShiftW16(window, data, 1 << 13, 14));  // Q0
+  }
+  for (; i < inst->anaLen; i++) {
+    out[i] = (int16_t)WEBRTC_SPL_MUL_16_16_RSFT_WITH_ROUND(
+               inst->window[i], inst->analysisBuffer[i], 14); // Q0
+  }
+}